@@ -504,6 +504,8 @@ enum error_codes : s32 {
 	error_code_crypto_missing_api = -(error_code_flag_crypto|4),
 	error_code_crypto_unsupported_operation = -(error_code_flag_crypto|5),
 	error_code_crypto_bad_iv_size = -(error_code_flag_crypto|6),
+	error_code_crypto_bad_key_size = -(error_code_flag_crypto|7),
+	error_code_crypto_authentication_failed = -(error_code_flag_crypto|8),
 
 	error_code_fs_failed_to_open = -(error_code_flag_fs|1),
 	error_code_fs_failed_to_read = -(error_code_flag_fs|2),
@@ -521,6 +523,7 @@ enum error_codes : s32 {
   error_code_fs_failed_to_close = -(error_code_flag_fs|14),
   error_code_fs_failed_to_unlink = -(error_code_flag_fs|15),
   error_code_fs_failed_to_rmdir = -(error_code_flag_fs|16),
+  error_code_fs_cancelled = -(error_code_flag_fs|17),
 
 	error_code_inet_failed_to_create_socket /*! Failed to create a socket (1) */ = -(error_code_flag_inet|1),
 	error_code_inet_failed_to_connect_to_socket /*! Failed to connect to socket (2) */ = -(error_code_flag_inet|2),
@@ -532,6 +535,9 @@ enum error_codes : s32 {
 	error_code_inet_failed_to_get_header /*! Failed to receive the header (8) */ = -(error_code_flag_inet|8),
 	error_code_inet_failed_wrong_domain = -(error_code_flag_inet|9),
 	error_code_inet_wifi_api_missing = -(error_code_flag_inet|10),
+	error_code_inet_failed_to_listen = -(error_code_flag_inet|11),
+	error_code_inet_failed_to_receive_data /*! Connection closed before the response body was received (12) */ = -(error_code_flag_inet|12),
+	error_code_inet_failed_to_parse_chunk /*! Chunked response body is not formatted correctly (13) */ = -(error_code_flag_inet|13),
 
 	error_code_var_json_unknown = -(error_code_flag_var|1),
 	error_code_var_json_out_of_memory = -(error_code_flag_var|2),
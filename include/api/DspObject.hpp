@@ -2,13 +2,60 @@
 #ifndef SAPI_API_DSP_OBJECT_HPP_
 #define SAPI_API_DSP_OBJECT_HPP_
 
-#if !defined __link
-
-#include <arm_dsp_api.h>
 #include "WorkObject.hpp"
 #include "InfoObject.hpp"
+
+/*! \cond */
+#if defined __link
+#include "../dsp/dsp_host_api.h"
+
+#if !defined DSP_Q7_API_REQUEST
+#define DSP_Q7_API_REQUEST &dsp_host_api_q7
+#endif
+
+#if !defined DSP_Q15_API_REQUEST
+#define DSP_Q15_API_REQUEST &dsp_host_api_q15
+#endif
+
+#if !defined DSP_Q31_API_REQUEST
+#define DSP_Q31_API_REQUEST &dsp_host_api_q31
+#endif
+
+#if !defined DSP_F32_API_REQUEST
+#define DSP_F32_API_REQUEST &dsp_host_api_f32
+#endif
+
+#if !defined DSP_CONVERSION_API_REQUEST
+#define DSP_CONVERSION_API_REQUEST &dsp_host_api_conversion
+#endif
+
+#else
+#include <arm_dsp_api.h>
 #include "../sys/requests.h"
 
+#if !defined DSP_Q7_API_REQUEST
+#define DSP_Q7_API_REQUEST SAPI_API_REQUEST_ARM_DSP_Q7
+#endif
+
+#if !defined DSP_Q15_API_REQUEST
+#define DSP_Q15_API_REQUEST SAPI_API_REQUEST_ARM_DSP_Q15
+#endif
+
+#if !defined DSP_Q31_API_REQUEST
+#define DSP_Q31_API_REQUEST SAPI_API_REQUEST_ARM_DSP_Q31
+#endif
+
+#if !defined DSP_F32_API_REQUEST
+#define DSP_F32_API_REQUEST SAPI_API_REQUEST_ARM_DSP_F32
+#endif
+
+#if !defined DSP_CONVERSION_API_REQUEST
+#define DSP_CONVERSION_API_REQUEST SAPI_API_REQUEST_ARM_DSP_CONVERSION
+#endif
+
+#endif
+/*! \endcond */
+
 namespace api {
 
 /*! \brief DSP Information Object
@@ -21,11 +68,11 @@ class DspInfoObject : public virtual InfoObject {
 
 };
 
-typedef api::Api<arm_dsp_api_q7_t, SAPI_API_REQUEST_ARM_DSP_Q7> DspQ7Api;
-typedef api::Api<arm_dsp_api_q15_t, SAPI_API_REQUEST_ARM_DSP_Q15> DspQ15Api;
-typedef api::Api<arm_dsp_api_q31_t, SAPI_API_REQUEST_ARM_DSP_Q31> DspQ31Api;
-typedef api::Api<arm_dsp_api_f32_t, SAPI_API_REQUEST_ARM_DSP_F32> DspF32Api;
-typedef api::Api<arm_dsp_conversion_api_t, SAPI_API_REQUEST_ARM_DSP_CONVERSION> DspConversionApi;
+typedef api::Api<arm_dsp_api_q7_t, DSP_Q7_API_REQUEST> DspQ7Api;
+typedef api::Api<arm_dsp_api_q15_t, DSP_Q15_API_REQUEST> DspQ15Api;
+typedef api::Api<arm_dsp_api_q31_t, DSP_Q31_API_REQUEST> DspQ31Api;
+typedef api::Api<arm_dsp_api_f32_t, DSP_F32_API_REQUEST> DspF32Api;
+typedef api::Api<arm_dsp_conversion_api_t, DSP_CONVERSION_API_REQUEST> DspConversionApi;
 
 
 /*! \brief DSP Work Object
@@ -56,6 +103,4 @@ protected:
 
 }
 
-#endif
-
 #endif // SAPI_API_DSP_OBJECT_HPP_
@@ -21,6 +21,10 @@ class Base64Options {
  * transmitting data over certain serial links that do not support binary
  * transfers.
  *
+ * On host builds, blocks are encoded and decoded using SSSE3 or AVX2
+ * (x86) or NEON (aarch64) when the processor supports them. Other builds
+ * use a table-driven implementation.
+ *
  * The following example can be used to encode and decode
  * using Base64.
  *
@@ -67,10 +71,17 @@ public:
 	using Size = var::Reference::Size;
 	using SourceFile = fs::File::Source;
 	using DestinationFile = fs::File::Destination;
+	using BufferSize = arg::Argument<u32, struct Base64BufferSizeTag>;
+
+	/*! \details Base64 alphabets */
+	enum alphabets {
+		alphabet_standard /*! Uses + and / with = padding (RFC 4648 section 4) */,
+		alphabet_url /*! Uses - and _ without padding (RFC 4648 section 5) */
+	};
 
 	/*! \details Encodes data to the base64 format.
 	 *
-	 * @return Number of bytes in the encoded string
+	 * @return The encoded string
 	 *
 	 * ```
 	 * //md2code:main
@@ -82,25 +93,22 @@ public:
 	 *
 	 */
 	static var::String encode(
-			const var::Reference & input
-			);
-
-	static int encode(
-			SourceFile source,
-			DestinationFile destination,
-			Size size
+			const var::Reference & input,
+			enum alphabets alphabet = alphabet_standard
 			);
 
-
-	/*! \details Reads binary data from *input* and writes a Base64
-	 * encoded string to *output*.
-	 *
-	 * @return Number of encoded bytes written to *output*
+	/*! \details Reads binary data from *source* and writes a Base64
+	 * encoded string to *destination*.
 	 *
-	 * The method reads *size* bytes (or to EOF if *size* is zero) from *input*
-	 * start at the current location. The output string is written to *output*
-	 * at the current location.
+	 * @param source The file to read (a socket or any other fs::File)
+	 * @param destination The file to write
+	 * @param size The number of bytes to read or zero to read to the end of the file
+	 * @param alphabet The alphabet to encode with
+	 * @param buffer_size The number of bytes read at a time
+	 * @return Number of bytes read from *source* or less than zero if a write failed
 	 *
+	 * The buffers are allocated once for each call. The method reads and writes
+	 * starting at the current locations.
 	 *
 	 * ```
 	 * //md2code:main
@@ -118,24 +126,28 @@ public:
 	 *   );
 	 *
 	 *	Base64::encode(
-	 *   arg::SourceFile(source),
-	 *   arg::DestinationFile(destination)
+	 *   Base64::SourceFile(source),
+	 *   Base64::DestinationFile(destination)
 	 *   );
 	 * ```
 	 *
-	 *
-	 *
 	 */
 	static int encode(
-			const var::Reference & source,
-			var::String & destination,
-			const Size size = Size(0)
+			SourceFile source,
+			DestinationFile destination,
+			Size size = Size(0),
+			enum alphabets alphabet = alphabet_standard,
+			BufferSize buffer_size = BufferSize(3072)
 			);
 
 	/*! \details Decodes base64 encoded data.
 	 *
-	 * @return Zero
+	 * @return The decoded data or empty data if \a input isn't valid
 	 *
+	 * The input is validated strictly: every character must be
+	 * in the alphabet and padding is only allowed at the end. Use
+	 * decode(const var::String &, var::Data &, enum alphabets) to tell
+	 * an empty input from an invalid one.
 	 *
 	 * ```
 	 * //md2code:main
@@ -148,35 +160,72 @@ public:
 	 *
 	 */
 	static var::Data decode(
-			const var::String & input
+			const var::String & input,
+			enum alphabets alphabet = alphabet_standard
 			);
 
-	/*! \details Reads base64 encoded data from *input* and writes raw,
-	 * decoded data to *output*.
+	/*! \details Decodes base64 encoded data to \a output.
 	 *
-	 * @return Number of decoded bytes written to *output*
+	 * @return The number of decoded bytes or -1 if \a input isn't valid
 	 *
-	 * The method reads *size* bytes (or to EOF if *size* is zero) from *input*
-	 * start at the current location. The output string is written to *output*
-	 * at the current location.
+	 */
+	static int decode(
+			const var::String & input,
+			var::Data & output,
+			enum alphabets alphabet = alphabet_standard
+			);
+
+	/*! \details Reads base64 encoded data from *input* and writes raw,
+	 * decoded data to *output*.
 	 *
+	 * @param input The file to read (a socket or any other fs::File)
+	 * @param output The file to write
+	 * @param size The number of bytes to read or zero to read to the end of the file
+	 * @param alphabet The alphabet to decode
+	 * @param buffer_size The number of bytes read at a time
+	 * @return Number of bytes read from *input* or less than zero if the input
+	 * isn't valid or a write failed
 	 *
 	 */
 	static int decode(
 			SourceFile input,
 			DestinationFile output,
-			Size size = Size(0)
+			Size size = Size(0),
+			enum alphabets alphabet = alphabet_standard,
+			BufferSize buffer_size = BufferSize(4096)
 			);
 
+	/*! \details Returns the number of characters needed to encode \a size bytes. */
+	static u32 calculate_encoded_size(
+			u32 size,
+			enum alphabets alphabet = alphabet_standard
+			);
+
+	/*! \details Returns the maximum number of bytes \a size characters decode to. */
+	static u32 calculate_decoded_size(u32 size){
+		return (size / 4) * 3 + ((size % 4) * 3) / 4;
+	}
 
 private:
-	static int encode(char * dest, const void * src, int nbyte);
-	static int decode(void * dest, const char * src, int nbyte);
-	static int calc_decoded_size(int nbyte);
-	static int calc_encoded_size(int nbyte);
-	static char encode_six(u8 six_bit_value);
-	static char decode_eigth(u8 eight_bit_value);
+	static u32 encode(
+			char * destination,
+			const void * source,
+			u32 size,
+			enum alphabets alphabet
+			);
 
+	static int decode(
+			void * destination,
+			const char * source,
+			u32 size,
+			enum alphabets alphabet
+			);
+
+	static int write_all(
+			const fs::File & file,
+			const void * buffer,
+			u32 size
+			);
 
 };
 
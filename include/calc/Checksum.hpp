@@ -12,6 +12,8 @@ namespace  calc {
 /*! \brief Checksum Class
  * \details The Checksum class is purely static and provides methods
  * for calculating and verifying checksums on data structures.
+ *
+ * For integrity checks on larger data, see Crc32, Crc16 and Adler32.
  */
 class Checksum {
 public:
@@ -63,21 +65,22 @@ public:
 			);
 
 	template<typename T> static T calculate_zero_sum(const var::Reference & data){
-		u32 i;
+		int i;
 		T sum = 0;
-		int count = data.size()/sizeof(T) - 1;
+		//signed so that data smaller than T doesn't wrap around
+		int count = static_cast<int>(data.size()/sizeof(T)) - 1;
 		for(i=0; i < count; i++){
 			sum += data.to<const T>()[i];
 		}
 		return (0 - sum);
 	}
 
-	template<typename T> static T verify_zero_sum(
+	template<typename T> static bool verify_zero_sum(
 			const var::Reference & data
 			){
 		int i;
 		T sum = 0;
-		int count = data.size()/sizeof(T);
+		int count = static_cast<int>(data.size()/sizeof(T));
 		for(i=0; i < count; i++){
 			sum += data.to<const T>()[i];
 		}
@@ -159,6 +162,12 @@ public:
 			);
 
 
+	/*! \details Calculates a 32-bit zero sum over \a data.
+	  *
+	  * The size of \a data is in bytes (as with calc_zero_sum(const u32 *, int)).
+	  * The last 32-bit word is the checksum position.
+	  *
+	  */
 	static u32 calc_zero_sum32(const var::Data & data);
 	static bool verify_zero_sum32(const var::Data & data);
 	static u32 calc_zero_sum8(const var::Data & data);
@@ -167,6 +176,200 @@ public:
 
 };
 
+/*! \brief CRC-32 Class
+ * \details The Crc32 class calculates 32-bit cyclic
+ * redundancy checks using either the IEEE 802.3 polynomial
+ * (as used by zip, png and ethernet) or the Castagnoli
+ * polynomial (CRC-32C as used by iSCSI and ext4).
+ *
+ * Data can be added incrementally using update(). The
+ * value is available from finish() once all the data
+ * has been added.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/calc.hpp>
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Crc32 crc;
+ * crc.update(String("1234"));
+ * crc.update(String("56789"));
+ * u32 value = crc.finish(); //0xCBF43926
+ *
+ * //or all at once
+ * value = Crc32::calculate(String("123456789"));
+ * ```
+ *
+ * Tables are processed 8 bytes at a time (slicing-by-8) on
+ * the host. Device builds use a single 256 entry table
+ * unless SAPI_CHECKSUM_SLICE_COUNT is defined as 8. On x86
+ * hosts with SSE4.2 the Castagnoli polynomial uses the crc32
+ * instruction, and on ARMv8 hosts with the CRC extension both
+ * polynomials use the crc32 instructions.
+ *
+ */
+class Crc32 {
+public:
+
+	enum polynomial {
+		polynomial_ieee /*! IEEE 802.3 polynomial (0x04C11DB7) */,
+		polynomial_castagnoli /*! Castagnoli polynomial (0x1EDC6F41) */
+	};
+
+	explicit Crc32(enum polynomial polynomial = polynomial_ieee) :
+		m_polynomial(polynomial){
+		reset();
+	}
+
+	/*! \details Restarts the calculation. */
+	Crc32 & reset(){
+		m_value = 0xffffffff;
+		return *this;
+	}
+
+	/*! \details Adds \a data to the calculation. */
+	Crc32 & update(const var::Reference & data);
+
+	/*! \details Returns the CRC of the data added since the
+	 * last reset and restarts the calculation.
+	 *
+	 */
+	u32 finish(){
+		u32 result = value();
+		reset();
+		return result;
+	}
+
+	/*! \details Returns the CRC of the data added so far. */
+	u32 value() const { return ~m_value; }
+
+	enum polynomial polynomial() const { return m_polynomial; }
+
+	/*! \details Calculates the CRC of \a data. */
+	static u32 calculate(
+			const var::Reference & data,
+			enum polynomial polynomial = polynomial_ieee
+			){
+		return Crc32(polynomial).update(data).finish();
+	}
+
+	/*! \details Returns true if \a polynomial is calculated
+	 * using CPU instructions rather than tables.
+	 *
+	 */
+	static bool is_accelerated(enum polynomial polynomial);
+
+private:
+	enum polynomial m_polynomial;
+	u32 m_value;
+};
+
+/*! \brief CRC-16 Class
+ * \details The Crc16 class calculates the 16-bit CRC-CCITT
+ * (polynomial 0x1021, not reflected).
+ *
+ * The default initial value (0xFFFF) gives CRC-16/CCITT-FALSE.
+ * Use an initial value of zero for CRC-16/XMODEM.
+ *
+ * ```
+ * //md2code:main
+ * Crc16 crc;
+ * crc.update(String("123456789"));
+ * u16 value = crc.finish(); //0x29B1
+ * ```
+ *
+ */
+class Crc16 {
+public:
+
+	explicit Crc16(u16 initial_value = 0xffff) :
+		m_initial_value(initial_value){
+		reset();
+	}
+
+	/*! \details Restarts the calculation. */
+	Crc16 & reset(){
+		m_value = m_initial_value;
+		return *this;
+	}
+
+	/*! \details Adds \a data to the calculation. */
+	Crc16 & update(const var::Reference & data);
+
+	/*! \details Returns the CRC and restarts the calculation. */
+	u16 finish(){
+		u16 result = value();
+		reset();
+		return result;
+	}
+
+	/*! \details Returns the CRC of the data added so far. */
+	u16 value() const { return m_value; }
+
+	/*! \details Calculates the CRC of \a data. */
+	static u16 calculate(
+			const var::Reference & data,
+			u16 initial_value = 0xffff
+			){
+		return Crc16(initial_value).update(data).finish();
+	}
+
+private:
+	u16 m_initial_value;
+	u16 m_value;
+};
+
+/*! \brief Adler-32 Class
+ * \details The Adler32 class calculates the Adler-32
+ * checksum (as used by zlib).
+ *
+ * Adler-32 is faster than a CRC but is weaker for
+ * short messages.
+ *
+ * ```
+ * //md2code:main
+ * u32 value = Adler32::calculate(String("Wikipedia")); //0x11E60398
+ * ```
+ *
+ */
+class Adler32 {
+public:
+
+	Adler32(){ reset(); }
+
+	/*! \details Restarts the calculation. */
+	Adler32 & reset(){
+		m_a = 1;
+		m_b = 0;
+		return *this;
+	}
+
+	/*! \details Adds \a data to the calculation. */
+	Adler32 & update(const var::Reference & data);
+
+	/*! \details Returns the checksum and restarts the calculation. */
+	u32 finish(){
+		u32 result = value();
+		reset();
+		return result;
+	}
+
+	/*! \details Returns the checksum of the data added so far. */
+	u32 value() const { return (m_b << 16) | m_a; }
+
+	/*! \details Calculates the checksum of \a data. */
+	static u32 calculate(const var::Reference & data){
+		return Adler32().update(data).finish();
+	}
+
+private:
+	u32 m_a;
+	u32 m_b;
+};
+
 }
 
 #endif // SAPI_CALC_CHECKSUM_HPP_
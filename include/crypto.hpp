@@ -10,6 +10,7 @@ namespace crypto {}
 #include "crypto/Sha256.hpp"
 #include "crypto/Random.hpp"
 #include "crypto/Aes.hpp"
+#include "crypto/AesGcm.hpp"
 
 using namespace crypto;
 
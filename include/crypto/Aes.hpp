@@ -2,10 +2,22 @@
 #ifndef SAPI_CRYPTO_AES_HPP_
 #define SAPI_CRYPTO_AES_HPP_
 
+#include <functional>
 #include "../api/CryptoObject.hpp"
 #include "../arg/Argument.hpp"
 #include "../var/Reference.hpp"
 #include "../var/Data.hpp"
+#include "../fs/File.hpp"
+
+#if defined __link
+#define CRYPTO_AES_DEFAULT_PAGE_SIZE 4096
+#else
+#define CRYPTO_AES_DEFAULT_PAGE_SIZE 256
+#endif
+
+namespace sys {
+class WorkerThread;
+}
 
 namespace crypto {
 
@@ -17,6 +29,43 @@ class AesOptions {
 	API_ACCESS_COMPOUND(AesOptions,var::Reference,cipher_data);
 };
 
+/*! \brief AES Class
+ * \details This class encrypts and decrypts data
+ * using AES (128, 192 or 256 bit keys).
+ *
+ * If the system implements the CRYPT_AES_API_REQUEST
+ * in kernel_request_api(), that API is used. Otherwise,
+ * the built-in software implementation is used. The software
+ * implementation is constant-time (it doesn't use tables
+ * indexed by secret data) and uses the AES instructions on x86 hosts
+ * that support them.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/crypto.hpp>
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Data key(16);
+ * key.fill<u8>(0x2b);
+ * Data iv(16);
+ * iv.fill<u8>(0);
+ *
+ * Aes aes;
+ * aes.initialize();
+ * aes.set_key(key).set_initialization_vector(iv);
+ *
+ * Data plain = Data::from_string("counter mode works with any size");
+ * Data cipher(plain.size());
+ * aes.encrypt_ctr(
+ *   Aes::SourcePlainData(plain),
+ *   Aes::DestinationCipherData(cipher)
+ *   );
+ * ```
+ *
+ */
 class Aes : public api::CryptoWorkObject {
 public:
 
@@ -26,8 +75,27 @@ public:
 	using SourcePlainData = arg::Argument<const var::Reference&, struct AesSourcePlainDataTag >;
 	using DestinationPlainData = arg::Argument<var::Reference&, struct AesDestinationPlainDataTag >;
 
+	using SourceFile = fs::File::Source;
+	using DestinationFile = fs::File::Destination;
+	using PageSize = fs::File::PageSize;
+	using IsOverlapped = arg::Argument<bool, struct AesIsOverlappedTag>;
+
+	enum backend {
+		backend_auto /*! Use the system API if it is available (otherwise use software) */,
+		backend_software /*! Always use the built-in implementation */
+	};
+
+	explicit Aes(enum backend backend = backend_auto);
 	~Aes();
 
+	/*! \details Returns true if this object uses the built-in implementation. */
+	bool is_software() const { return m_is_software; }
+
+	/*! \details Returns true if the built-in implementation
+	 * uses CPU instructions to encrypt and decrypt.
+	 *
+	 */
+	static bool is_accelerated();
 
 	int initialize();
 	int finalize();
@@ -40,6 +108,13 @@ public:
 			const var::Reference & key
 			);
 
+	/*! \details Sets the initialization vector for CBC mode
+	 * or the initial counter block for CTR mode.
+	 *
+	 * The value is updated by each operation so that
+	 * data can be encrypted in several parts.
+	 *
+	 */
 	Aes & set_initialization_vector(
 			const var::Reference & value
 			);
@@ -69,7 +144,16 @@ public:
 			DestinationPlainData destination_data
 			);
 
-
+	/*! \details Encrypts data in counter mode.
+	 *
+	 * The initialization vector is the initial counter block
+	 * (incremented as a 128-bit big-endian number). The data
+	 * can be any size. Calling encrypt_ctr() several times gives the same result
+	 * as calling it once with all the data.
+	 *
+	 * @return The number of bytes encrypted or less than zero for an error
+	 *
+	 */
 	int encrypt_ctr(
 			SourcePlainData source_data,
 			DestinationCipherData destination_data
@@ -80,9 +164,83 @@ public:
 			DestinationPlainData destination_data
 			);
 
+	/*! \details Encrypts \a source to \a destination in counter mode.
+	 *
+	 * @param source The file to read starting at the current location
+	 * @param destination The file to write
+	 * @param page_size The number of bytes read at a time
+	 * @param is_overlapped If true, a separate thread writes the previous page
+	 * and reads the next page while the current page is encrypted
+	 * @return The number of bytes encrypted or less than zero for an error
+	 *
+	 * One thread is started for the whole file. Use a large \a page_size
+	 * (64KB or more) with \a is_overlapped so the cost of handing
+	 * each page to the thread is small compared to the file access.
+	 *
+	 */
+	int encrypt_ctr(
+			SourceFile source,
+			DestinationFile destination,
+			PageSize page_size = PageSize(CRYPTO_AES_DEFAULT_PAGE_SIZE),
+			IsOverlapped is_overlapped = IsOverlapped(false)
+			);
+
+	int decrypt_ctr(
+			SourceFile source,
+			DestinationFile destination,
+			PageSize page_size = PageSize(CRYPTO_AES_DEFAULT_PAGE_SIZE),
+			IsOverlapped is_overlapped = IsOverlapped(false)
+			);
+
 private:
+	/*! \cond */
+	friend class AesGcm;
+
+	struct SoftwareContext {
+		union {
+			//bitsliced round keys
+			u32 sliced_key[15][8];
+			//encryption and decryption round keys for the AES instructions
+			u8 round_key[2][15][16];
+		};
+		u32 round_count;
+		bool is_accelerated;
+	};
+
 	void * m_context = nullptr;
 	InitializationVector m_initialization_vector;
+	var::Array<u8,16> m_stream_block;
+	u32 m_stream_offset;
+	bool m_is_software;
+	SoftwareContext m_software_context;
+
+	int encrypt_blocks(const u8 * input, u8 * output, u32 block_count);
+	int decrypt_blocks(const u8 * input, u8 * output, u32 block_count);
+	int encrypt_counter(
+			u8 counter[16],
+			u32 counter_size,
+			const u8 * input,
+			u8 * output,
+			u32 block_count
+			);
+	int transform_ctr(const u8 * input, u8 * output, u32 size);
+
+	using PageFunction = std::function<int(u8 * page, u32 size)>;
+	static int transform_file(
+			const fs::File & source,
+			const fs::File & destination,
+			u32 page_size,
+			bool is_overlapped,
+			const PageFunction & page_function
+			);
+	static int transform_pages(
+			const fs::File & source,
+			const fs::File & destination,
+			u32 page_size,
+			sys::WorkerThread * transfer,
+			const PageFunction & page_function
+			);
+	/*! \endcond */
 };
 
 }
@@ -0,0 +1,183 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_CRYPTO_AESGCM_HPP_
+#define SAPI_CRYPTO_AESGCM_HPP_
+
+#include "Aes.hpp"
+
+namespace crypto {
+
+/*! \brief AES-GCM Class
+ * \details This class encrypts and decrypts data using
+ * AES in Galois/Counter Mode (NIST SP 800-38D). GCM
+ * encrypts in counter mode and calculates a tag that is used
+ * to check that the data (and the additional data) hasn't been changed.
+ *
+ * The built-in implementation of crypto::Aes is always used. On
+ * x86 hosts that support them, the AES and carry-less multiply
+ * instructions are used.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/crypto.hpp>
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Data key(16);
+ * key.fill<u8>(0x2b);
+ * Data iv(12);
+ * iv.fill<u8>(0x01);
+ * String header("image header");
+ *
+ * AesGcm gcm;
+ * gcm.set_key(key);
+ *
+ * Data plain = Data::from_string("an image to send over the air");
+ * Data cipher(plain.size());
+ * gcm.start(AesGcm::mode_encrypt, iv, header);
+ * gcm.update(AesGcm::SourceData(plain), AesGcm::DestinationData(cipher));
+ * gcm.finish();
+ * //send cipher and gcm.tag()
+ *
+ * AesGcm receiver;
+ * receiver.set_key(key);
+ * receiver.start(AesGcm::mode_decrypt, iv, header);
+ * receiver.update(AesGcm::SourceData(cipher), AesGcm::DestinationData(plain));
+ * if( receiver.verify(gcm.tag()) < 0 ){
+ *   printf("the data has been changed\n");
+ * }
+ * ```
+ *
+ * When decrypting in several parts, the decrypted data
+ * must not be used until verify() succeeds.
+ *
+ */
+class AesGcm : public api::CryptoWorkObject {
+public:
+
+	using SourceData = arg::Argument<const var::Reference&, struct AesGcmSourceDataTag >;
+	using DestinationData = arg::Argument<var::Reference&, struct AesGcmDestinationDataTag >;
+
+	using SourceFile = Aes::SourceFile;
+	using DestinationFile = Aes::DestinationFile;
+	using PageSize = Aes::PageSize;
+	using IsOverlapped = Aes::IsOverlapped;
+
+	using Tag = var::Array<u8,16>;
+
+	enum modes {
+		mode_encrypt,
+		mode_decrypt
+	};
+
+	AesGcm();
+	~AesGcm();
+
+	/*! \details Returns true if CPU instructions are used
+	 * for both the cipher and the tag calculation.
+	 *
+	 */
+	static bool is_accelerated();
+
+	AesGcm & set_key(const var::Reference & key);
+
+	/*! \details Sets the number of tag bytes that are sent with
+	 * each message (default 16).
+	 *
+	 * The value must be 4, 8 or 12 to 16 (see NIST SP 800-38D).
+	 * Short tags are much easier to forge, so both sides must
+	 * agree on the size before any messages are exchanged.
+	 *
+	 */
+	AesGcm & set_tag_size(u32 value);
+
+	/*! \details Returns the number of tag bytes used by verify(). */
+	u32 tag_size() const { return m_tag_size; }
+
+	/*! \details Starts encrypting or decrypting a message.
+	 *
+	 * @param mode Whether update() encrypts or decrypts
+	 * @param initialization_vector The unique value for this message (12 bytes is recommended)
+	 * @param additional_data Data that is authenticated but not encrypted
+	 * @return Zero on success
+	 *
+	 */
+	int start(
+			enum modes mode,
+			const var::Reference & initialization_vector,
+			const var::Reference & additional_data = var::Reference()
+			);
+
+	/*! \details Encrypts or decrypts the next part of the message.
+	 *
+	 * The data can be any size. The source and destination can be the same.
+	 *
+	 * @return The number of bytes processed or less than zero for an error
+	 *
+	 */
+	int update(
+			SourceData source_data,
+			DestinationData destination_data
+			);
+
+	/*! \details Encrypts or decrypts \a source to \a destination.
+	 *
+	 * See Aes::encrypt_ctr() for details about \a page_size and \a is_overlapped.
+	 *
+	 */
+	int update(
+			SourceFile source,
+			DestinationFile destination,
+			PageSize page_size = PageSize(CRYPTO_AES_DEFAULT_PAGE_SIZE),
+			IsOverlapped is_overlapped = IsOverlapped(false)
+			);
+
+	/*! \details Finishes the message and calculates tag(). */
+	int finish();
+
+	/*! \details Finishes the message and compares the tag to \a expected_tag.
+	 *
+	 * @param expected_tag The tag from the sender (must be tag_size() bytes)
+	 * @return Zero if the tag matches or less than zero if it doesn't
+	 *
+	 * A tag of any other size is rejected so a shortened tag
+	 * can't be used to forge a message. The comparison takes the
+	 * same time no matter where the tags are different.
+	 *
+	 */
+	int verify(const var::Reference & expected_tag);
+
+	/*! \details Returns the tag (valid after finish()).
+	 *
+	 * The first tag_size() bytes are sent with the message.
+	 *
+	 */
+	const Tag & tag() const { return m_tag; }
+
+private:
+	/*! \cond */
+	Aes m_aes;
+	var::Array<u8,16> m_hash_key;
+	var::Array<u8,16> m_hash;
+	var::Array<u8,16> m_initial_counter;
+	var::Array<u8,16> m_counter;
+	var::Array<u8,16> m_stream_block;
+	//cipher bytes of the current block (not hashed yet)
+	var::Array<u8,16> m_partial_block;
+	u32 m_stream_offset;
+	u32 m_tag_size;
+	u64 m_additional_size;
+	u64 m_size;
+	enum modes m_mode;
+	bool m_is_key_set;
+	bool m_is_started;
+	Tag m_tag;
+
+	int transform(const u8 * input, u8 * output, u32 size);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_CRYPTO_AESGCM_HPP_
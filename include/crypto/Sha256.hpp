@@ -6,6 +6,7 @@
 #include "../api/CryptoObject.hpp"
 #include "../var/Array.hpp"
 #include "../var/Reference.hpp"
+#include "../var/Vector.hpp"
 #include "../fs/File.hpp"
 
 #if defined __link
@@ -23,8 +24,11 @@ namespace crypto {
  * routines that calculate SHA256
  * hash digest values.
  *
- * The system must implmenent the
- * CRYPT_SHA256_API_REQUEST in kernel_request_api().
+ * If the system implements the CRYPT_SHA256_API_REQUEST
+ * in kernel_request_api(), that API is used. Otherwise,
+ * the built-in software implementation is used. The software
+ * implementation uses the SHA instructions on x86 hosts
+ * that support them.
  *
  * ```
  * #include <sys/crypt.hpp>
@@ -49,10 +53,44 @@ public:
 	using Size = var::Reference::Size;
 	using SourceFile = fs::File::Source;
 	using PageSize = fs::File::PageSize;
+	using IsOverlapped = arg::Argument<bool, struct Sha256IsOverlappedTag>;
 
-	Sha256();
+	enum backend {
+		backend_auto /*! Use the system API if it is available (otherwise use software) */,
+		backend_software /*! Always use the built-in implementation */
+	};
+
+	explicit Sha256(enum backend backend = backend_auto);
 	~Sha256();
 
+	/*! \details Returns true if this object uses the built-in implementation. */
+	bool is_software() const { return m_is_software; }
+
+	/*! \details Returns true if the built-in implementation
+	 * uses CPU instructions to calculate the hash.
+	 *
+	 */
+	static bool is_accelerated();
+
+	enum instruction_set {
+		instruction_set_portable = 0 /*! Plain C++ (always available) */,
+		instruction_set_sha = 0x01 /*! The x86 SHA instructions */,
+		instruction_set_avx2 = 0x02 /*! AVX2 (hashes eight buffers at once in calculate()) */,
+		instruction_set_all = 0x03
+	};
+
+	/*! \details Limits the CPU instructions used by the built-in implementation.
+	 *
+	 * \a value is a combination of enum instruction_set values (default
+	 * instruction_set_all). It is used to compare the implementations:
+	 * set it before any hashes are calculated because it applies to all threads.
+	 *
+	 */
+	static void set_instruction_set(u32 value);
+
+	/*! \details Returns the instructions that are available and allowed by set_instruction_set(). */
+	static u32 instruction_set();
+
 	int initialize();
 	int finalize();
 
@@ -80,11 +118,48 @@ public:
 			PageSize page_size = PageSize(CRYPTO_SHA256_DEFAULT_PAGE_SIZE)
 			);
 
+	/*! \details Calculates the hash of \a file while reading ahead.
+	 *
+	 * If \a is_overlapped is true, the next page of the file
+	 * is read by a separate thread while the current page is being
+	 * hashed. Use a large \a page_size (64KB or more) so the
+	 * cost of starting the thread is small compared to reading
+	 * the page.
+	 *
+	 */
+	static var::String calculate(
+			const fs::File & file,
+			PageSize page_size,
+			IsOverlapped is_overlapped
+			);
+
 	static var::String calculate(
 			const var::String & file_path,
 			PageSize page_size = PageSize(CRYPTO_SHA256_DEFAULT_PAGE_SIZE)
 			);
 
+	/*! \details Calculates the digests of several independent buffers.
+	 *
+	 * @param input_list The buffers to hash
+	 * @return A list of digests in the same order as \a input_list
+	 *
+	 * On x86 hosts with AVX2 (and without the SHA instructions), eight
+	 * buffers are hashed at once, one per vector lane. Otherwise the
+	 * buffers are hashed one after the other.
+	 *
+	 * ```
+	 * //md2code:main
+	 * Vector<Reference> input_list;
+	 * input_list.push_back(Reference(String("first")));
+	 * input_list.push_back(Reference(String("second")));
+	 * Vector<Array<u8,32>> output_list = Sha256::calculate(input_list);
+	 * ```
+	 *
+	 */
+	static var::Vector<var::Array<u8, 32>> calculate(
+			const var::Vector<var::Reference> & input_list
+			);
+
 	Sha256 & operator << (const var::Reference & a);
 
 	const var::Array<u8, 32> & output();
@@ -94,9 +169,20 @@ public:
 	}
 
 private:
+	/*! \cond */
+	struct SoftwareContext {
+		u32 state[8];
+		u64 length;
+		u8 block[64];
+		u32 block_size;
+	};
+	/*! \endcond */
+
 	var::Array<u8,32> m_output;
 	void * m_context;
 	bool m_is_finished;
+	bool m_is_software;
+	SoftwareContext m_software_context;
 
 	bool is_initialized() const { return m_context != 0; }
 
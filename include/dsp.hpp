@@ -13,6 +13,7 @@
  */
 namespace dsp {}
 
+#include "dsp/SignalExpression.hpp"
 #include "dsp/SignalData.hpp"
 #include "dsp/Transform.hpp"
 #include "dsp/Filter.hpp"
@@ -4,6 +4,7 @@
 
 #include "../api/DspObject.hpp"
 #include "../var/Vector.hpp"
+#include "SignalExpression.hpp"
 
 namespace dsp {
 
@@ -25,8 +26,12 @@ class FirDecimateFilterQ31;
  * \details The Complex class is a template for holding
  * raw data types that comprise complex data.
  *
+ * The class has no virtual members so a vector of complex
+ * values has the {real, imaginary, ...} layout that the
+ * FFT functions use.
+ *
  */
-template <typename T> class Complex : public api::DspInfoObject {
+template <typename T> class Complex {
 public:
 
 	/*! \details Returns a reference to the real
@@ -51,41 +56,41 @@ public:
 	const T & imaginary() const { return m_value[1]; }
 
 	/*! \details Adds this to a and returns a new object. */
-	T operator + (const T & a) const {
-		T value;
+	Complex operator + (const Complex & a) const {
+		Complex value;
 		value.real() = real() + a.real();
 		value.imaginary() = imaginary() + a.imaginary();
 		return value;
 	}
 
 	/*! \details Adds \a a to this object. */
-	T & operator += (const T & a){
+	Complex & operator += (const Complex & a){
 		real() += a.real();
 		imaginary() += a.imaginary();
 		return *this;
 	}
 
 	/*! \details Subtracts this to a and returns a new object. */
-	T operator - (const T & a) const {
-		T value;
+	Complex operator - (const Complex & a) const {
+		Complex value;
 		value.real() = real() - a.real();
 		value.imaginary() = imaginary() - a.imaginary();
 		return value;
 	}
 
 	/*! \details Subtracts \a a from this object. */
-	T & operator -= (const T & a){
+	Complex & operator -= (const Complex & a){
 		real() -= a.real();
 		imaginary() -= a.imaginary();
 		return *this;
 	}
 
-	bool operator == (const T & a) const {
+	bool operator == (const Complex & a) const {
 		return (real() == a.real()) && (imaginary() == a.imaginary());
 	}
 
-	bool operator != (const T & a) const {
-		return (real() != a.real()) && (imaginary() != a.imaginary());
+	bool operator != (const Complex & a) const {
+		return (real() != a.real()) || (imaginary() != a.imaginary());
 	}
 
 private:
@@ -144,6 +149,10 @@ public:
  * All signals are dynamically allocated using the var::Vector
  * class.
  *
+ * The arithmetic operators return expressions (see SignalExpression)
+ * that are calculated in one pass when they are assigned to a signal, so
+ * combining operators doesn't allocate temporary signals.
+ *
  */
 template<class Derived, typename T, typename BigType> class SignalData : public var::Vector<T>, public api::DspWorkObject {
 public:
@@ -159,14 +168,47 @@ public:
 		return false;
 	}
 
+	/*! \details Returns an expression that refers to this signal.
+	  *
+	  * The expression's methods (such as SignalExpression::scale()
+	  * and SignalExpression::offset()) can then be combined with
+	  * other expressions without allocating memory.
+	  *
+	  * ```
+	  * c = a.expression().scale(gain, 1).offset(100) + b;
+	  * ```
+	  *
+	  */
+	SignalReference<T> expression() const { return SignalReference<T>(*this); }
+
+	/*! \details Calculates \a expression and stores the result in this signal.
+	  *
+	  * The signal is resized to SignalExpression::count() samples. This
+	  * signal can be an operand of \a expression.
+	  *
+	  */
+	template<class Expression> Derived & assign(const SignalExpression<Expression, T> & expression){
+		if( this->count() != expression.count() ){
+			this->resize(expression.count());
+		}
+		expression.evaluate(this->data());
+		return (Derived&)*this;
+	}
+
 	/*! \details Performs element-wise addition.
 	  *
 	  * Operators are not implemented on complex signals.
 	  *
-	  * \note This operator uses dynamic memory allocation
+	  * The operator returns an expression (see SignalExpression) that is
+	  * calculated when it is assigned to a signal.
 	  *
 	  */
-	Derived operator + (const Derived & a ) const { return add(a); }
+	SignalBinaryExpression<SignalReference<T>, SignalReference<T>, SignalAdd<T> > operator + (const Derived & a ) const { return expression() + a; }
+
+	/*! \details Performs element-wise addition with an expression. */
+	template<class Expression> SignalBinaryExpression<SignalReference<T>, Expression, SignalAdd<T> > operator + (const SignalExpression<Expression, T> & a ) const {
+		return expression() + a;
+	}
 
 	/*! \details Performs element-wise addition.
 	  *
@@ -174,13 +216,18 @@ public:
 	  */
 	Derived & operator += (const Derived & a ){ return add_assign(a); }
 
+	/*! \details Adds an expression to this signal element-wise. */
+	template<class Expression> Derived & operator += (const SignalExpression<Expression, T> & a ){
+		return assign(expression() + a);
+	}
+
 	/*! \details Adds a constant value to all elements.
 	  *
 	  * Operators are not implemented on complex signals.
 	  *
-	  * \note This operator uses dynamic memory allocation
+	  * The operator returns an expression (see SignalExpression).
 	  */
-	Derived operator + (const T & a ) const { return add(a); }
+	SignalUnaryExpression<SignalReference<T>, SignalOffset<T> > operator + (const T & a ) const { return expression() + a; }
 
 	/*! \details Adds a constant value to all elements in this signal. */
 	Derived & operator += (const T & a ){ return add_assign(a); }
@@ -189,9 +236,14 @@ public:
 	  *
 	  * Operators are not implemented on complex signals.
 	  *
-	  * \note This operator uses dynamic memory allocation
+	  * The operator returns an expression (see SignalExpression).
 	  */
-	Derived operator - (const Derived & a) const { return subtract(a); }
+	SignalBinaryExpression<SignalReference<T>, SignalReference<T>, SignalSubtract<T> > operator - (const Derived & a) const { return expression() - a; }
+
+	/*! \details Performs element-wise subtraction with an expression. */
+	template<class Expression> SignalBinaryExpression<SignalReference<T>, Expression, SignalSubtract<T> > operator - (const SignalExpression<Expression, T> & a ) const {
+		return expression() - a;
+	}
 
 	/*! \details Performs element-wise subtraction and saves the result in this signal.
 	  *
@@ -202,15 +254,19 @@ public:
 	  */
 	Derived & operator -= (const Derived & a){ return subtract_assign(a); }
 
+	/*! \details Subtracts an expression from this signal element-wise. */
+	template<class Expression> Derived & operator -= (const SignalExpression<Expression, T> & a ){
+		return assign(expression() - a);
+	}
+
 	/*! \details Subtracts a scalar value from each element.
 	  *
 	  *
 	  * Operators are not implemented on complex signals.
 	  *
-	  *
-	  * \note This operator uses dynamic memory allocation
+	  * The operator returns an expression (see SignalExpression).
 	  */
-	Derived operator - (const T & a) const { return add(-a); }
+	SignalUnaryExpression<SignalReference<T>, SignalOffset<T> > operator - (const T & a) const { return expression() - a; }
 
 	/*! \details Subtracts a scalar value from each element in this signal.
 	  *
@@ -219,33 +275,43 @@ public:
 	  */
 	Derived & operator -= (const T & a){ return add_assign(-a); }
 
+	/*! \details Returns an expression that negates each element. */
+	SignalUnaryExpression<SignalReference<T>, SignalNegate<T> > operator - () const { return -expression(); }
+
 	/*!
 	  * \details Calculates element-by-element multiplication.
 	  *
 	  * \param a The second operand of the multiply operation
-	  * \return A new signal containing the product of \a a and this signal.
-	  *
-	  * This operator requires the use of dynamic memory allocation. operator *=() does not.
+	  * \return An expression (see SignalExpression) for the product of \a a and this signal.
 	  *
 	  */
-	Derived operator * (const Derived & a ) const { return multiply(a); }
+	SignalBinaryExpression<SignalReference<T>, SignalReference<T>, SignalMultiply<T> > operator * (const Derived & a ) const { return expression() * a; }
+
+	/*! \details Performs element-wise multiplication with an expression. */
+	template<class Expression> SignalBinaryExpression<SignalReference<T>, Expression, SignalMultiply<T> > operator * (const SignalExpression<Expression, T> & a ) const {
+		return expression() * a;
+	}
 
 	/*! \details Multiples this with \a and stores the result in this signal.
 	  *
 	  * @param a The signal to multiply with.
 	  *
-	  * This is faster than operator *() because no dynamic memory allocation is used.
-	  *
 	  */
 	Derived & operator *= (const Derived & a ){ return multiply_assign(a); }
 
+	/*! \details Multiplies this signal by an expression element-wise. */
+	template<class Expression> Derived & operator *= (const SignalExpression<Expression, T> & a ){
+		return assign(expression() * a);
+	}
+
 	/*! \details Multiplies each element by a scaling value.
 	  *
 	  *
 	  * Operators are not implemented on complex signals.
 	  *
+	  * The operator returns an expression (see SignalExpression).
 	  */
-	Derived operator * (const T & value) const { return multiply(value); }
+	SignalUnaryExpression<SignalReference<T>, SignalScale<T> > operator * (const T & value) const { return expression() * value; }
 
 	/*! \details Multiplies each element of this signal by a scalar value.
 	  *
@@ -258,27 +324,23 @@ public:
 	/*! \details Shifts this signal.
 	  *
 	  * @param value Number of bits to left shift
-	  * @return A new signal with each element equal to this << value
-	  *
-	  * \note This operator uses dynamic memory allocation.
+	  * @return An expression (see SignalExpression) with each element equal to this << value
 	  *
 	  * Operators are not implemented on complex signals. Shift is not available for any floating-point types.
 	  *
 	  */
-	Derived operator << (s8 value) const { return shift(value); }
+	SignalUnaryExpression<SignalReference<T>, SignalShift<T> > operator << (s8 value) const { return expression() << value; }
 
 	/*! \details Shifts this signal.
 	  *
 	  * @param value Number of bits to left shift
-	  * @return A new signal with each element equal to this >> value
+	  * @return An expression (see SignalExpression) with each element equal to this >> value
 	  *
 	  * Operators are not implemented on complex signals. Shift is not available for any floating-point types.
 	  *
-	  * \note This operator uses dynamic memory allocation.
-	  *
 	  *
 	  */
-	Derived operator >> (s8 value) const { return shift(-1*value); }
+	SignalUnaryExpression<SignalReference<T>, SignalShift<T> > operator >> (s8 value) const { return expression() >> value; }
 
 	/*! \details Shifts this signal \a value bits to the left.
 	  *
@@ -494,6 +556,16 @@ public:
 	SignalQ15(size_t count) : SignalData(count){}
 	SignalQ15(){}
 
+	/*! \details Constructs a signal by calculating \a expression. */
+	template<class Expression> SignalQ15(const SignalExpression<Expression, q15_t> & expression) : SignalData(expression.count()){
+		expression.evaluate(data());
+	}
+
+	/*! \details Assigns the result of \a expression to this signal. */
+	template<class Expression> SignalQ15 & operator = (const SignalExpression<Expression, q15_t> & expression){
+		return assign(expression);
+	}
+
 	bool is_api_available() const {
 		return api_q15().is_valid();
 	}
@@ -605,6 +677,16 @@ public:
 	/*! \details Contructs an empty signal. */
 	SignalQ31(){}
 
+	/*! \details Constructs a signal by calculating \a expression. */
+	template<class Expression> SignalQ31(const SignalExpression<Expression, q31_t> & expression) : SignalData(expression.count()){
+		expression.evaluate(data());
+	}
+
+	/*! \details Assigns the result of \a expression to this signal. */
+	template<class Expression> SignalQ31 & operator = (const SignalExpression<Expression, q31_t> & expression){
+		return assign(expression);
+	}
+
 
 	q31_t mean() const;
 	q63_t power() const;
@@ -720,6 +802,16 @@ public:
 	SignalF32(size_t count) : SignalData(count){}
 	SignalF32(){}
 
+	/*! \details Constructs a signal by calculating \a expression. */
+	template<class Expression> SignalF32(const SignalExpression<Expression, float32_t> & expression) : SignalData(expression.count()){
+		expression.evaluate(data());
+	}
+
+	/*! \details Assigns the result of \a expression to this signal. */
+	template<class Expression> SignalF32 & operator = (const SignalExpression<Expression, float32_t> & expression){
+		return assign(expression);
+	}
+
 	bool is_api_available() const {
 		return api_f32().is_valid();
 	}
@@ -0,0 +1,437 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_DSP_SIGNAL_EXPRESSION_HPP_
+#define SAPI_DSP_SIGNAL_EXPRESSION_HPP_
+
+#include <cstring>
+#include "../api/DspObject.hpp"
+#include "../var/Vector.hpp"
+
+/*! \details Number of samples an expression evaluates at a time.
+ *
+ * Each intermediate value in an expression uses one block on the stack
+ * while the expression is evaluated.
+ *
+ */
+#if !defined SAPI_DSP_EXPRESSION_BLOCK_SIZE
+#if defined __link
+#define SAPI_DSP_EXPRESSION_BLOCK_SIZE 256
+#else
+#define SAPI_DSP_EXPRESSION_BLOCK_SIZE 32
+#endif
+#endif
+
+namespace dsp {
+
+/*! \cond */
+template<typename T> class SignalExpressionApi;
+
+template<> class SignalExpressionApi<q15_t> {
+public:
+	static void add(const q15_t * a, const q15_t * b, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->add((q15_t*)a, (q15_t*)b, result, count);
+	}
+	static void subtract(const q15_t * a, const q15_t * b, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->sub((q15_t*)a, (q15_t*)b, result, count);
+	}
+	static void multiply(const q15_t * a, const q15_t * b, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->mult((q15_t*)a, (q15_t*)b, result, count);
+	}
+	static void offset(const q15_t * a, q15_t value, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->offset((q15_t*)a, value, result, count);
+	}
+	static void scale(const q15_t * a, q15_t fraction, s8 shift, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->scale((q15_t*)a, fraction, shift, result, count);
+	}
+	static void shift(const q15_t * a, s8 value, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->shift((q15_t*)a, value, result, count);
+	}
+	static void negate(const q15_t * a, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->negate((q15_t*)a, result, count);
+	}
+	static void abs(const q15_t * a, q15_t * result, u32 count){
+		api::DspWorkObject::api_q15()->abs((q15_t*)a, result, count);
+	}
+};
+
+template<> class SignalExpressionApi<q31_t> {
+public:
+	static void add(const q31_t * a, const q31_t * b, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->add((q31_t*)a, (q31_t*)b, result, count);
+	}
+	static void subtract(const q31_t * a, const q31_t * b, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->sub((q31_t*)a, (q31_t*)b, result, count);
+	}
+	static void multiply(const q31_t * a, const q31_t * b, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->mult((q31_t*)a, (q31_t*)b, result, count);
+	}
+	static void offset(const q31_t * a, q31_t value, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->offset((q31_t*)a, value, result, count);
+	}
+	static void scale(const q31_t * a, q31_t fraction, s8 shift, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->scale((q31_t*)a, fraction, shift, result, count);
+	}
+	static void shift(const q31_t * a, s8 value, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->shift((q31_t*)a, value, result, count);
+	}
+	static void negate(const q31_t * a, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->negate((q31_t*)a, result, count);
+	}
+	static void abs(const q31_t * a, q31_t * result, u32 count){
+		api::DspWorkObject::api_q31()->abs((q31_t*)a, result, count);
+	}
+};
+
+//floating point signals do not have shift() and scale() ignores the shift value (like SignalF32::scale())
+template<> class SignalExpressionApi<float32_t> {
+public:
+	static void add(const float32_t * a, const float32_t * b, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->add((float32_t*)a, (float32_t*)b, result, count);
+	}
+	static void subtract(const float32_t * a, const float32_t * b, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->sub((float32_t*)a, (float32_t*)b, result, count);
+	}
+	static void multiply(const float32_t * a, const float32_t * b, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->mult((float32_t*)a, (float32_t*)b, result, count);
+	}
+	static void offset(const float32_t * a, float32_t value, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->offset((float32_t*)a, value, result, count);
+	}
+	static void scale(const float32_t * a, float32_t fraction, s8 shift, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->scale((float32_t*)a, fraction, result, count);
+	}
+	static void negate(const float32_t * a, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->negate((float32_t*)a, result, count);
+	}
+	static void abs(const float32_t * a, float32_t * result, u32 count){
+		api::DspWorkObject::api_f32()->abs((float32_t*)a, result, count);
+	}
+};
+
+template<typename T> class SignalAdd {
+public:
+	void operator()(const T * a, const T * b, T * result, u32 count) const {
+		SignalExpressionApi<T>::add(a, b, result, count);
+	}
+};
+
+template<typename T> class SignalSubtract {
+public:
+	void operator()(const T * a, const T * b, T * result, u32 count) const {
+		SignalExpressionApi<T>::subtract(a, b, result, count);
+	}
+};
+
+template<typename T> class SignalMultiply {
+public:
+	void operator()(const T * a, const T * b, T * result, u32 count) const {
+		SignalExpressionApi<T>::multiply(a, b, result, count);
+	}
+};
+
+template<typename T> class SignalOffset {
+public:
+	SignalOffset(T value) : m_value(value){}
+	void operator()(const T * a, T * result, u32 count) const {
+		SignalExpressionApi<T>::offset(a, m_value, result, count);
+	}
+private:
+	T m_value;
+};
+
+template<typename T> class SignalScale {
+public:
+	SignalScale(T fraction, s8 shift) : m_fraction(fraction), m_shift(shift){}
+	void operator()(const T * a, T * result, u32 count) const {
+		SignalExpressionApi<T>::scale(a, m_fraction, m_shift, result, count);
+	}
+private:
+	T m_fraction;
+	s8 m_shift;
+};
+
+template<typename T> class SignalShift {
+public:
+	SignalShift(s8 value) : m_value(value){}
+	void operator()(const T * a, T * result, u32 count) const {
+		SignalExpressionApi<T>::shift(a, m_value, result, count);
+	}
+private:
+	s8 m_value;
+};
+
+template<typename T> class SignalNegate {
+public:
+	void operator()(const T * a, T * result, u32 count) const {
+		SignalExpressionApi<T>::negate(a, result, count);
+	}
+};
+
+template<typename T> class SignalAbs {
+public:
+	void operator()(const T * a, T * result, u32 count) const {
+		SignalExpressionApi<T>::abs(a, result, count);
+	}
+};
+
+template<typename T> class SignalReference;
+template<class Left, class Right, class Operation> class SignalBinaryExpression;
+template<class Operand, class Operation> class SignalUnaryExpression;
+/*! \endcond */
+
+/*! \brief Signal Expression Template
+ * \details The SignalExpression class is the base
+ * of the values that the SignalQ15, SignalQ31 and SignalF32 operators
+ * return.
+ *
+ * An expression does not calculate anything when it is
+ * created. It is calculated when it is assigned to (or used to construct)
+ * a signal. The whole expression is calculated SAPI_DSP_EXPRESSION_BLOCK_SIZE
+ * samples at a time, so
+ *
+ * ```
+ * SignalQ15 c = (a * gain + b) >> 2;
+ * ```
+ *
+ * allocates only \a c and reads \a a and \a b once
+ * (the intermediate values stay in a small buffer on the stack).
+ * Each step uses the same DSP function as the method with the same
+ * name (for example, operator+() uses add()), so the
+ * Q15 and Q31 results saturate after each step exactly
+ * as if each step were calculated separately.
+ *
+ * The destination can be one of the operands (on either side
+ * of any operator):
+ *
+ * ```
+ * a = a * gain + b; //no memory is allocated
+ * a += b * gain; //same as above
+ * a = b * gain + a; //a is copied one block at a time before it is overwritten
+ * ```
+ *
+ * An expression refers to the signals it was created from. It should
+ * be assigned to a signal in the same statement rather than stored
+ * (for example, using `auto`).
+ *
+ */
+template<class Expression, typename T> class SignalExpression {
+public:
+
+	/*! \details Returns the number of samples the expression calculates
+	  * (the smallest number of samples of any signal in the expression).
+	  */
+	u32 count() const { return expression().count(); }
+
+	/*! \details Calculates the expression and stores count() samples in \a destination. */
+	void evaluate(T * destination) const {
+		const u32 total = count();
+		for(u32 offset = 0; offset < total; offset += SAPI_DSP_EXPRESSION_BLOCK_SIZE){
+			u32 block_count = total - offset;
+			if( block_count > SAPI_DSP_EXPRESSION_BLOCK_SIZE ){
+				block_count = SAPI_DSP_EXPRESSION_BLOCK_SIZE;
+			}
+			const T * result = expression().evaluate_block(offset, block_count, destination + offset);
+			if( result != destination + offset ){
+				::memcpy(destination + offset, result, block_count*sizeof(T));
+			}
+		}
+	}
+
+	/*! \details Adds an expression element-wise (see SignalData::add()). */
+	template<class Right> SignalBinaryExpression<Expression, Right, SignalAdd<T> > operator + (const SignalExpression<Right, T> & a) const {
+		return SignalBinaryExpression<Expression, Right, SignalAdd<T> >(expression(), a.expression());
+	}
+
+	/*! \details Adds a signal element-wise (see SignalData::add()). */
+	SignalBinaryExpression<Expression, SignalReference<T>, SignalAdd<T> > operator + (const var::Vector<T> & a) const {
+		return *this + SignalReference<T>(a);
+	}
+
+	/*! \details Adds \a a to each element (see SignalData::add()). */
+	SignalUnaryExpression<Expression, SignalOffset<T> > operator + (const T & a) const {
+		return offset(a);
+	}
+
+	/*! \details Subtracts an expression element-wise (see SignalData::subtract()). */
+	template<class Right> SignalBinaryExpression<Expression, Right, SignalSubtract<T> > operator - (const SignalExpression<Right, T> & a) const {
+		return SignalBinaryExpression<Expression, Right, SignalSubtract<T> >(expression(), a.expression());
+	}
+
+	/*! \details Subtracts a signal element-wise (see SignalData::subtract()). */
+	SignalBinaryExpression<Expression, SignalReference<T>, SignalSubtract<T> > operator - (const var::Vector<T> & a) const {
+		return *this - SignalReference<T>(a);
+	}
+
+	/*! \details Subtracts \a a from each element. */
+	SignalUnaryExpression<Expression, SignalOffset<T> > operator - (const T & a) const {
+		return offset(-a);
+	}
+
+	/*! \details Multiplies by an expression element-wise (see SignalData::multiply()). */
+	template<class Right> SignalBinaryExpression<Expression, Right, SignalMultiply<T> > operator * (const SignalExpression<Right, T> & a) const {
+		return SignalBinaryExpression<Expression, Right, SignalMultiply<T> >(expression(), a.expression());
+	}
+
+	/*! \details Multiplies by a signal element-wise (see SignalData::multiply()). */
+	SignalBinaryExpression<Expression, SignalReference<T>, SignalMultiply<T> > operator * (const var::Vector<T> & a) const {
+		return *this * SignalReference<T>(a);
+	}
+
+	/*! \details Multiplies each element by \a a (same as scale(a)). */
+	SignalUnaryExpression<Expression, SignalScale<T> > operator * (const T & a) const {
+		return scale(a);
+	}
+
+	/*! \details Shifts each element \a value bits to the left (not available for floating point). */
+	SignalUnaryExpression<Expression, SignalShift<T> > operator << (s8 value) const {
+		return SignalUnaryExpression<Expression, SignalShift<T> >(expression(), SignalShift<T>(value));
+	}
+
+	/*! \details Shifts each element \a value bits to the right (not available for floating point). */
+	SignalUnaryExpression<Expression, SignalShift<T> > operator >> (s8 value) const {
+		return SignalUnaryExpression<Expression, SignalShift<T> >(expression(), SignalShift<T>(-1*value));
+	}
+
+	/*! \details Negates each element (same as negate()). */
+	SignalUnaryExpression<Expression, SignalNegate<T> > operator - () const {
+		return negate();
+	}
+
+	/*! \details Adds \a value to each element. */
+	SignalUnaryExpression<Expression, SignalOffset<T> > offset(T value) const {
+		return SignalUnaryExpression<Expression, SignalOffset<T> >(expression(), SignalOffset<T>(value));
+	}
+
+	/*! \details Multiplies each element by \a scale_fraction and shifts the product \a shift bits
+	  * to the left (the shift is ignored for floating point).
+	  */
+	SignalUnaryExpression<Expression, SignalScale<T> > scale(T scale_fraction, s8 shift = 0) const {
+		return SignalUnaryExpression<Expression, SignalScale<T> >(expression(), SignalScale<T>(scale_fraction, shift));
+	}
+
+	/*! \details Negates each element. */
+	SignalUnaryExpression<Expression, SignalNegate<T> > negate() const {
+		return SignalUnaryExpression<Expression, SignalNegate<T> >(expression(), SignalNegate<T>());
+	}
+
+	/*! \details Calculates the absolute value of each element. */
+	SignalUnaryExpression<Expression, SignalAbs<T> > abs() const {
+		return SignalUnaryExpression<Expression, SignalAbs<T> >(expression(), SignalAbs<T>());
+	}
+
+	/*! \cond */
+	const Expression & expression() const { return static_cast<const Expression&>(*this); }
+	/*! \endcond */
+
+};
+
+/*! \brief Signal Reference Expression
+ * \details A SignalReference is the expression
+ * for a signal that is an operand in another expression.
+ *
+ */
+template<typename T> class SignalReference : public SignalExpression<SignalReference<T>, T> {
+public:
+	typedef T value_type;
+	enum {
+		is_reference = 1
+	};
+
+	SignalReference(const var::Vector<T> & signal) :
+		m_data(signal.data()),
+		m_count(signal.count()){}
+
+	u32 count() const { return m_count; }
+
+	/*! \cond */
+	const T * evaluate_block(u32 offset, u32 count, T * buffer) const {
+		return m_data + offset;
+	}
+	/*! \endcond */
+
+private:
+	const T * m_data;
+	u32 m_count;
+};
+
+/*! \brief Signal Binary Expression
+ * \details A SignalBinaryExpression is the expression for
+ * an element-wise operation on two expressions.
+ *
+ */
+template<class Left, class Right, class Operation> class SignalBinaryExpression :
+		public SignalExpression<SignalBinaryExpression<Left, Right, Operation>, typename Left::value_type> {
+public:
+	typedef typename Left::value_type value_type;
+	enum {
+		is_reference = 0
+	};
+
+	SignalBinaryExpression(const Left & left, const Right & right) :
+		m_left(left),
+		m_right(right){}
+
+	u32 count() const {
+		return m_left.count() < m_right.count() ? m_left.count() : m_right.count();
+	}
+
+	/*! \cond */
+	const value_type * evaluate_block(u32 offset, u32 count, value_type * buffer) const {
+		//the right side is calculated first so that when buffer is the destination,
+		//the left side doesn't overwrite an operand that the right side still needs
+		value_type right_buffer[(Right::is_reference && Left::is_reference) ? 1 : SAPI_DSP_EXPRESSION_BLOCK_SIZE];
+		const value_type * right = m_right.evaluate_block(offset, count, right_buffer);
+		if( (Right::is_reference && !Left::is_reference) &&
+				(right < buffer + count) && (buffer < right + count) ){
+			//the right side is the destination (a = b * gain + a): keep a copy
+			//because the left side is about to be calculated in buffer
+			::memcpy(right_buffer, right, count*sizeof(value_type));
+			right = right_buffer;
+		}
+		const value_type * left = m_left.evaluate_block(offset, count, buffer);
+		m_operation(left, right, buffer, count);
+		return buffer;
+	}
+	/*! \endcond */
+
+private:
+	Left m_left;
+	Right m_right;
+	Operation m_operation;
+};
+
+/*! \brief Signal Unary Expression
+ * \details A SignalUnaryExpression is the expression for
+ * an operation (such as offset, scale, shift or negate) on another
+ * expression.
+ *
+ */
+template<class Operand, class Operation> class SignalUnaryExpression :
+		public SignalExpression<SignalUnaryExpression<Operand, Operation>, typename Operand::value_type> {
+public:
+	typedef typename Operand::value_type value_type;
+	enum {
+		is_reference = 0
+	};
+
+	SignalUnaryExpression(const Operand & operand, const Operation & operation) :
+		m_operand(operand),
+		m_operation(operation){}
+
+	u32 count() const { return m_operand.count(); }
+
+	/*! \cond */
+	const value_type * evaluate_block(u32 offset, u32 count, value_type * buffer) const {
+		const value_type * operand = m_operand.evaluate_block(offset, count, buffer);
+		m_operation(operand, buffer, count);
+		return buffer;
+	}
+	/*! \endcond */
+
+private:
+	Operand m_operand;
+	Operation m_operation;
+};
+
+}
+
+#endif // SAPI_DSP_SIGNAL_EXPRESSION_HPP_
@@ -0,0 +1,299 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_DSP_DSP_HOST_API_H_
+#define SAPI_DSP_DSP_HOST_API_H_
+
+/*
+ * On Stratify OS, the dsp classes use the ARM CMSIS DSP library
+ * through the function tables in <arm_dsp_api.h> (provided by the kernel).
+ *
+ * Host (link) builds use the tables declared here instead. The
+ * tables have the same members, arguments and fixed-point
+ * semantics (saturation, accumulator widths and output formats)
+ * as the CMSIS functions they are named after so code behaves the
+ * same on the host and on the device.
+ *
+ * The element-wise, statistics, convolution and filter functions give the same
+ * fixed-point (q7/q15/q31) results as the CMSIS C code. The
+ * differences are:
+ *
+ * - sqrt() (and so rms() and std()) returns the exact square root rounded down
+ *   (the CMSIS Newton iteration can be one LSB different)
+ * - the fixed-point FFTs are calculated in double precision, scaled by 1/fftLen
+ *   (the same output format as CMSIS) and rounded to nearest (CMSIS truncates each stage)
+ * - floating point sums are added in a different order
+ * - f32 sin() and cos() use the C library (CMSIS interpolates a table)
+ *
+ * The vector kernels are selected when the program starts (AVX2 or SSE4.1 on x86,
+ * NEON on aarch64). Build with SAPI_DSP_HOST_SIMD defined as 0 to use
+ * only the scalar kernels. dsp_host_api_set_kernel() changes the kernels
+ * while the program is running (used for comparing the kernels).
+ *
+ */
+
+#include <stdint.h>
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+/*! \cond */
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+typedef float float32_t;
+typedef double float64_t;
+
+typedef enum {
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_LENGTH_ERROR = -2,
+	ARM_MATH_SIZE_MISMATCH = -3,
+	ARM_MATH_NANINF = -4,
+	ARM_MATH_SINGULAR = -5,
+	ARM_MATH_TEST_FAILURE = -6
+} arm_status;
+
+//the FFT lengths are powers of 2 from 16 to DSP_HOST_FFT_MAX_LENGTH
+#define DSP_HOST_FFT_MAX_LENGTH 8192
+
+typedef struct {
+	uint16_t fftLen;
+} arm_cfft_instance_q15;
+
+typedef struct {
+	uint16_t fftLen;
+} arm_cfft_instance_q31;
+
+typedef struct {
+	uint16_t fftLen;
+} arm_cfft_instance_f32;
+
+typedef struct {
+	uint32_t fftLenReal;
+	uint8_t ifftFlagR;
+	uint8_t bitReverseFlagR;
+	const arm_cfft_instance_q15 * pCfft;
+} arm_rfft_instance_q15;
+
+typedef struct {
+	uint32_t fftLenReal;
+	uint8_t ifftFlagR;
+	uint8_t bitReverseFlagR;
+	const arm_cfft_instance_q31 * pCfft;
+} arm_rfft_instance_q31;
+
+typedef struct {
+	arm_cfft_instance_f32 Sint;
+	uint16_t fftLenRFFT;
+} arm_rfft_fast_instance_f32;
+
+//the coefficients are stored in time reversed order
+//the state holds numTaps + blockSize - 1 samples
+typedef struct {
+	uint16_t numTaps;
+	q15_t * pState;
+	const q15_t * pCoeffs;
+	uint32_t blockSize;
+} arm_fir_instance_q15;
+
+typedef struct {
+	uint16_t numTaps;
+	q31_t * pState;
+	const q31_t * pCoeffs;
+	uint32_t blockSize;
+} arm_fir_instance_q31;
+
+typedef struct {
+	uint16_t numTaps;
+	float32_t * pState;
+	const float32_t * pCoeffs;
+	uint32_t blockSize;
+} arm_fir_instance_f32;
+
+typedef struct {
+	uint8_t M;
+	uint16_t numTaps;
+	const q31_t * pCoeffs;
+	q31_t * pState;
+	uint32_t blockSize;
+} arm_fir_decimate_instance_q31;
+
+//coefficients are {b0, 0, b1, b2, a1, a2} for each stage
+//the state is {x[n-1], x[n-2], y[n-1], y[n-2]} for each stage
+typedef struct {
+	int8_t numStages;
+	q15_t * pState;
+	const q15_t * pCoeffs;
+	int8_t postShift;
+} arm_biquad_casd_df1_inst_q15;
+
+//coefficients are {b0, b1, b2, a1, a2} for each stage
+typedef struct {
+	uint32_t numStages;
+	q31_t * pState;
+	const q31_t * pCoeffs;
+	uint8_t postShift;
+} arm_biquad_casd_df1_inst_q31;
+
+typedef struct {
+	uint32_t numStages;
+	float32_t * pState;
+	const float32_t * pCoeffs;
+} arm_biquad_casd_df1_inst_f32;
+
+typedef struct {
+	void (*abs)(const q7_t * pSrc, q7_t * pDst, uint32_t blockSize);
+	void (*add)(const q7_t * pSrcA, const q7_t * pSrcB, q7_t * pDst, uint32_t blockSize);
+	void (*dot_prod)(const q7_t * pSrcA, const q7_t * pSrcB, uint32_t blockSize, q31_t * result);
+	void (*mult)(const q7_t * pSrcA, const q7_t * pSrcB, q7_t * pDst, uint32_t blockSize);
+	void (*negate)(const q7_t * pSrc, q7_t * pDst, uint32_t blockSize);
+	void (*offset)(const q7_t * pSrc, q7_t offset, q7_t * pDst, uint32_t blockSize);
+	void (*scale)(const q7_t * pSrc, q7_t scaleFract, int8_t shift, q7_t * pDst, uint32_t blockSize);
+	void (*shift)(const q7_t * pSrc, int8_t shiftBits, q7_t * pDst, uint32_t blockSize);
+	void (*sub)(const q7_t * pSrcA, const q7_t * pSrcB, q7_t * pDst, uint32_t blockSize);
+	void (*mean)(const q7_t * pSrc, uint32_t blockSize, q7_t * pResult);
+	void (*power)(const q7_t * pSrc, uint32_t blockSize, q31_t * pResult);
+	void (*min)(const q7_t * pSrc, uint32_t blockSize, q7_t * pResult, uint32_t * pIndex);
+	void (*max)(const q7_t * pSrc, uint32_t blockSize, q7_t * pResult, uint32_t * pIndex);
+} arm_dsp_api_q7_t;
+
+typedef struct {
+	void (*abs)(const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*add)(const q15_t * pSrcA, const q15_t * pSrcB, q15_t * pDst, uint32_t blockSize);
+	void (*dot_prod)(const q15_t * pSrcA, const q15_t * pSrcB, uint32_t blockSize, q63_t * result);
+	void (*mult)(const q15_t * pSrcA, const q15_t * pSrcB, q15_t * pDst, uint32_t blockSize);
+	void (*negate)(const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*offset)(const q15_t * pSrc, q15_t offset, q15_t * pDst, uint32_t blockSize);
+	void (*scale)(const q15_t * pSrc, q15_t scaleFract, int8_t shift, q15_t * pDst, uint32_t blockSize);
+	void (*shift)(const q15_t * pSrc, int8_t shiftBits, q15_t * pDst, uint32_t blockSize);
+	void (*sub)(const q15_t * pSrcA, const q15_t * pSrcB, q15_t * pDst, uint32_t blockSize);
+	void (*conv)(const q15_t * pSrcA, uint32_t srcALen, const q15_t * pSrcB, uint32_t srcBLen, q15_t * pDst);
+	void (*conv_fast)(const q15_t * pSrcA, uint32_t srcALen, const q15_t * pSrcB, uint32_t srcBLen, q15_t * pDst);
+	void (*mean)(const q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+	void (*power)(const q15_t * pSrc, uint32_t blockSize, q63_t * pResult);
+	void (*var)(const q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+	void (*rms)(const q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+	void (*std)(const q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+	void (*min)(const q15_t * pSrc, uint32_t blockSize, q15_t * pResult, uint32_t * pIndex);
+	void (*max)(const q15_t * pSrc, uint32_t blockSize, q15_t * pResult, uint32_t * pIndex);
+	q15_t (*sin)(q15_t x);
+	q15_t (*cos)(q15_t x);
+	arm_status (*sqrt)(q15_t in, q15_t * pOut);
+	void (*fir)(const arm_fir_instance_q15 * S, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*fir_fast)(const arm_fir_instance_q15 * S, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	arm_status (*fir_init)(arm_fir_instance_q15 * S, uint16_t numTaps, const q15_t * pCoeffs, q15_t * pState, uint32_t blockSize);
+	void (*biquad_cascade_df1)(const arm_biquad_casd_df1_inst_q15 * S, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*biquad_cascade_df1_fast)(const arm_biquad_casd_df1_inst_q15 * S, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*biquad_cascade_df1_init)(arm_biquad_casd_df1_inst_q15 * S, uint8_t numStages, const q15_t * pCoeffs, q15_t * pState, int8_t postShift);
+	void (*cfft)(const arm_cfft_instance_q15 * S, q15_t * p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+	void (*rfft)(const arm_rfft_instance_q15 * S, q15_t * pSrc, q15_t * pDst);
+	arm_status (*rfft_init)(arm_rfft_instance_q15 * S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+} arm_dsp_api_q15_t;
+
+typedef struct {
+	void (*abs)(const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*add)(const q31_t * pSrcA, const q31_t * pSrcB, q31_t * pDst, uint32_t blockSize);
+	void (*dot_prod)(const q31_t * pSrcA, const q31_t * pSrcB, uint32_t blockSize, q63_t * result);
+	void (*mult)(const q31_t * pSrcA, const q31_t * pSrcB, q31_t * pDst, uint32_t blockSize);
+	void (*negate)(const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*offset)(const q31_t * pSrc, q31_t offset, q31_t * pDst, uint32_t blockSize);
+	void (*scale)(const q31_t * pSrc, q31_t scaleFract, int8_t shift, q31_t * pDst, uint32_t blockSize);
+	void (*shift)(const q31_t * pSrc, int8_t shiftBits, q31_t * pDst, uint32_t blockSize);
+	void (*sub)(const q31_t * pSrcA, const q31_t * pSrcB, q31_t * pDst, uint32_t blockSize);
+	void (*conv)(const q31_t * pSrcA, uint32_t srcALen, const q31_t * pSrcB, uint32_t srcBLen, q31_t * pDst);
+	void (*conv_fast)(const q31_t * pSrcA, uint32_t srcALen, const q31_t * pSrcB, uint32_t srcBLen, q31_t * pDst);
+	void (*mean)(const q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+	void (*power)(const q31_t * pSrc, uint32_t blockSize, q63_t * pResult);
+	void (*var)(const q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+	void (*rms)(const q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+	void (*std)(const q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+	void (*min)(const q31_t * pSrc, uint32_t blockSize, q31_t * pResult, uint32_t * pIndex);
+	void (*max)(const q31_t * pSrc, uint32_t blockSize, q31_t * pResult, uint32_t * pIndex);
+	q31_t (*sin)(q31_t x);
+	q31_t (*cos)(q31_t x);
+	arm_status (*sqrt)(q31_t in, q31_t * pOut);
+	void (*fir)(const arm_fir_instance_q31 * S, const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*fir_fast)(const arm_fir_instance_q31 * S, const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	arm_status (*fir_init)(arm_fir_instance_q31 * S, uint16_t numTaps, const q31_t * pCoeffs, q31_t * pState, uint32_t blockSize);
+	void (*fir_decimate)(const arm_fir_decimate_instance_q31 * S, const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*fir_decimate_fast)(const arm_fir_decimate_instance_q31 * S, const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	arm_status (*fir_decimate_init)(arm_fir_decimate_instance_q31 * S, uint16_t numTaps, uint8_t M, const q31_t * pCoeffs, q31_t * pState, uint32_t blockSize);
+	void (*biquad_cascade_df1)(const arm_biquad_casd_df1_inst_q31 * S, const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*biquad_cascade_df1_fast)(const arm_biquad_casd_df1_inst_q31 * S, const q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*biquad_cascade_df1_init)(arm_biquad_casd_df1_inst_q31 * S, uint8_t numStages, const q31_t * pCoeffs, q31_t * pState, int8_t postShift);
+	void (*cfft)(const arm_cfft_instance_q31 * S, q31_t * p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+	void (*rfft)(const arm_rfft_instance_q31 * S, q31_t * pSrc, q31_t * pDst);
+	arm_status (*rfft_init)(arm_rfft_instance_q31 * S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+} arm_dsp_api_q31_t;
+
+typedef struct {
+	void (*abs)(const float32_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	void (*add)(const float32_t * pSrcA, const float32_t * pSrcB, float32_t * pDst, uint32_t blockSize);
+	void (*dot_prod)(const float32_t * pSrcA, const float32_t * pSrcB, uint32_t blockSize, float32_t * result);
+	void (*mult)(const float32_t * pSrcA, const float32_t * pSrcB, float32_t * pDst, uint32_t blockSize);
+	void (*negate)(const float32_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	void (*offset)(const float32_t * pSrc, float32_t offset, float32_t * pDst, uint32_t blockSize);
+	void (*scale)(const float32_t * pSrc, float32_t scale, float32_t * pDst, uint32_t blockSize);
+	void (*sub)(const float32_t * pSrcA, const float32_t * pSrcB, float32_t * pDst, uint32_t blockSize);
+	void (*conv)(const float32_t * pSrcA, uint32_t srcALen, const float32_t * pSrcB, uint32_t srcBLen, float32_t * pDst);
+	void (*mean)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult);
+	void (*power)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult);
+	void (*var)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult);
+	void (*rms)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult);
+	void (*std)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult);
+	void (*min)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult, uint32_t * pIndex);
+	void (*max)(const float32_t * pSrc, uint32_t blockSize, float32_t * pResult, uint32_t * pIndex);
+	float32_t (*sin)(float32_t x);
+	float32_t (*cos)(float32_t x);
+	arm_status (*sqrt)(float32_t in, float32_t * pOut);
+	void (*fir)(const arm_fir_instance_f32 * S, const float32_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	arm_status (*fir_init)(arm_fir_instance_f32 * S, uint16_t numTaps, const float32_t * pCoeffs, float32_t * pState, uint32_t blockSize);
+	void (*biquad_cascade_df1)(const arm_biquad_casd_df1_inst_f32 * S, const float32_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	void (*biquad_cascade_df1_init)(arm_biquad_casd_df1_inst_f32 * S, uint8_t numStages, const float32_t * pCoeffs, float32_t * pState);
+	void (*cfft)(const arm_cfft_instance_f32 * S, float32_t * p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+	void (*rfft_fast)(const arm_rfft_fast_instance_f32 * S, float32_t * p, float32_t * pOut, uint8_t ifftFlag);
+	arm_status (*rfft_fast_init)(arm_rfft_fast_instance_f32 * S, uint16_t fftLen);
+} arm_dsp_api_f32_t;
+
+typedef struct {
+	void (*float_to_q7)(const float32_t * pSrc, q7_t * pDst, uint32_t blockSize);
+	void (*float_to_q15)(const float32_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*float_to_q31)(const float32_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*q7_to_float)(const q7_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	void (*q7_to_q15)(const q7_t * pSrc, q15_t * pDst, uint32_t blockSize);
+	void (*q7_to_q31)(const q7_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*q15_to_float)(const q15_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	void (*q15_to_q7)(const q15_t * pSrc, q7_t * pDst, uint32_t blockSize);
+	void (*q15_to_q31)(const q15_t * pSrc, q31_t * pDst, uint32_t blockSize);
+	void (*q31_to_float)(const q31_t * pSrc, float32_t * pDst, uint32_t blockSize);
+	void (*q31_to_q7)(const q31_t * pSrc, q7_t * pDst, uint32_t blockSize);
+	void (*q31_to_q15)(const q31_t * pSrc, q15_t * pDst, uint32_t blockSize);
+} arm_dsp_conversion_api_t;
+
+enum dsp_host_kernels {
+	DSP_HOST_KERNEL_AUTO /*! The fastest kernels the processor supports */,
+	DSP_HOST_KERNEL_SCALAR /*! Portable C++ kernels */,
+	DSP_HOST_KERNEL_SSE4_1 /*! x86 SSE4.1 kernels */,
+	DSP_HOST_KERNEL_AVX2 /*! x86 AVX2 kernels */,
+	DSP_HOST_KERNEL_NEON /*! aarch64 NEON kernels */
+};
+
+extern const arm_dsp_api_q7_t dsp_host_api_q7;
+extern const arm_dsp_api_q15_t dsp_host_api_q15;
+extern const arm_dsp_api_q31_t dsp_host_api_q31;
+extern const arm_dsp_api_f32_t dsp_host_api_f32;
+extern const arm_dsp_conversion_api_t dsp_host_api_conversion;
+
+//returns the kernels that are selected (never DSP_HOST_KERNEL_AUTO)
+int dsp_host_api_kernel();
+
+//returns 0 if the kernels are selected or -1 if the processor (or build) doesn't support them
+int dsp_host_api_set_kernel(int kernel);
+/*! \endcond */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // SAPI_DSP_DSP_HOST_API_H_
@@ -1,18 +1,119 @@
 #ifndef CSV_HPP
 #define CSV_HPP
 
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
 #include "../fs/File.hpp"
+#include "../fs/BufferedFile.hpp"
 #include "../var/Matrix.hpp"
 #include "../var/String.hpp"
 #include "../var/Tokenizer.hpp"
 
 namespace fmt {
 
+/*! \brief CSV Row Class
+ * \details The CsvRow class holds one row that has been
+ * parsed by fmt::Csv.
+ *
+ * The fields are views in to a buffer that is re-used
+ * from one row to the next. Each field is null-terminated
+ * in place with quotes removed and escaped quotes ("")
+ * collapsed, so no memory is allocated per field.
+ *
+ * ```
+ * //md2code:main
+ * File f;
+ * f.open(arg::FilePath("/home/data.csv"), OpenFlags::read_only());
+ * Csv csv(f, ",");
+ * CsvRow row;
+ * while( csv.read_row(row) >= 0 ){
+ *   printf("%s is %d\n", row.at(0), row.to_integer(1));
+ * }
+ * ```
+ *
+ * The values returned by at() are valid until the
+ * next row is read in to the object.
+ *
+ */
+class CsvRow {
+public:
+
+	/*! \details Returns the number of fields in the row. */
+	u32 count() const { return m_fields.count(); }
+
+	/*! \details Returns a pointer to the null-terminated field at \a column.
+	 *
+	 * If \a column is out of range, an empty string is returned.
+	 *
+	 */
+	const char * at(u32 column) const {
+		if( column < count() ){
+			return m_buffer.cstring() + m_fields.at(column).offset;
+		}
+		return "";
+	}
+
+	/*! \details Returns the length of the field at \a column. */
+	u32 length(u32 column) const {
+		if( column < count() ){
+			return m_fields.at(column).length;
+		}
+		return 0;
+	}
+
+	/*! \details Returns the field at \a column converted to an integer. */
+	int to_integer(u32 column) const;
+
+	/*! \details Returns the field at \a column converted to a float. */
+	float to_float(u32 column) const;
+
+	/*! \details Returns a copy of the field at \a column. */
+	var::String to_string(u32 column) const {
+		return var::String(at(column), var::String::Length(length(column)));
+	}
+
+	/*! \details Returns a copy of all the fields in the row. */
+	var::StringList to_list() const;
+
+private:
+	friend class Csv;
+
+	struct Field {
+		u32 offset;
+		u32 length;
+	};
+
+	var::String m_buffer;
+	var::Vector<Field> m_fields;
+};
+
+/*! \brief CSV Class
+ * \details The Csv class reads comma separated value
+ * files one row at a time.
+ *
+ * Rows are parsed according to RFC-4180: fields can be
+ * enclosed in double quotes in which case they may contain
+ * delimeters, line breaks and escaped ("") quotes.
+ *
+ * The file is read through an fs::BufferedFile so rows
+ * can be streamed from large files, devices and sockets
+ * without loading the entire file in to memory.
+ *
+ */
 class Csv : public api::WorkObject{
 public:
 
 	using Delimeters = var::Tokenizer::Delimeters;
 
+	/*! \details Defines the callback used with for_each_row().
+	 *
+	 * Returning true from the callback stops the operation.
+	 *
+	 */
+	using RowCallback = std::function<bool(const CsvRow & row)>;
+
 	Csv(fs::File & file, const var::String& delimeters);
 
 	static var::Matrix<var::String> load(
@@ -26,8 +127,92 @@ public:
 			Delimeters delimeters = Delimeters(",")
 			);
 
+	/*! \details Converts the fields in \a table to numbers.
+	 *
+	 * @param table A table returned by load()
+	 * @param is_header If true, the first row of \a table is skipped
+	 *
+	 * Fields that aren't numbers are converted to zero.
+	 *
+	 */
+	template<typename T> static var::Matrix<T> to_matrix(
+			const var::Matrix<var::String> & table,
+			bool is_header = true
+			){
+		const u32 first_row = (is_header && table.row_count()) ? 1 : 0;
+		var::Matrix<T> result(table.row_count() - first_row, table.column_count());
+		for(u32 i = first_row; i < table.row_count(); i++){
+			for(u32 j = 0; j < table.column_count(); j++){
+				result.at(i - first_row, j) =
+						static_cast<T>(::strtod(table.at(i, j).cstring(), nullptr));
+			}
+		}
+		return result;
+	}
+
+	/*! \details Reads the remaining rows in to a matrix of numbers.
+	 *
+	 * The matrix has one column for each field in header().
+	 * Missing fields and fields that aren't numbers are zero.
+	 * The rows are converted as they are read so the
+	 * text of the file isn't stored.
+	 *
+	 * ```
+	 * //md2code:main
+	 * File f;
+	 * f.open(arg::FilePath("/home/calibration.csv"), OpenFlags::read_only());
+	 * Csv csv(f, ",");
+	 * Matrix<float> samples = csv.read_matrix<float>();
+	 * Matrix<float> covariance = samples.transpose().multiply(samples);
+	 * ```
+	 *
+	 */
+	template<typename T> var::Matrix<T> read_matrix(){
+		var::Matrix<T> result;
+		const u32 column_count = header().count();
+		var::Vector<T> values(column_count);
+		for_each_row(
+					[&](const CsvRow & row) -> bool {
+			for(u32 i = 0; i < column_count; i++){
+				values.at(i) = static_cast<T>(::strtod(row.at(i), nullptr));
+			}
+			result.append(values);
+			return false;
+		});
+		return result;
+	}
+
 	var::StringList read_line(bool is_header = false);
 
+	/*! \details Reads the next row from the file in to \a row.
+	 *
+	 * @return The number of fields in the row (zero for
+	 * a blank line) or less than zero if the end of the file
+	 * has been reached
+	 *
+	 */
+	int read_row(CsvRow & row);
+
+	/*! \details Executes \a callback for each remaining row in the file.
+	 *
+	 * Blank lines are skipped.
+	 *
+	 * @return The number of rows that were passed to \a callback
+	 *
+	 */
+	int for_each_row(RowCallback callback);
+
+	/*! \details Sets whether bytes greater than 127 are dropped
+	 * while parsing (the default is true).
+	 *
+	 */
+	Csv & set_ascii_only(bool value = true){
+		m_is_ascii_only = value;
+		return *this;
+	}
+
+	bool is_ascii_only() const { return m_is_ascii_only; }
+
 	const var::StringList & header() const {
 		return m_header;
 	}
@@ -37,9 +222,111 @@ private:
 	const fs::File& file() const { return m_file; }
 	fs::File& file(){ return m_file; }
 
+	bool is_delimeter(char c) const {
+		return (c != 0) && (m_delimeters.find(c) != var::String::npos);
+	}
+
 	fs::File & m_file;
+	fs::BufferedFile m_buffered_file;
 	var::StringList	m_header;
 	var::String m_delimeters = ",";
+	var::String m_continuation;
+	CsvRow m_row;
+	bool m_is_ascii_only = true;
+
+};
+
+/*! \brief CSV Writer Class
+ * \details The CsvWriter class formats rows in to an
+ * internal buffer and writes the buffer to the file
+ * in blocks.
+ *
+ * Fields that contain the delimeter, a quote or a line
+ * break are quoted according to RFC-4180.
+ *
+ * To append to an existing file, open the file with
+ * fs::OpenFlags::append_write_only() before constructing
+ * the writer.
+ *
+ * ```
+ * //md2code:main
+ * File f;
+ * f.create("/home/log.csv", File::IsOverwrite(true));
+ * CsvWriter writer(f);
+ * writer.append_field("time").append_field("value").end_row();
+ * writer.append_field(100).append_field(1.5f).end_row();
+ * writer.flush();
+ * ```
+ *
+ * The buffer is flushed when the writer is destroyed.
+ *
+ */
+class CsvWriter : public api::WorkObject {
+public:
+
+	explicit CsvWriter(
+			const fs::File & file,
+			char delimeter = ',',
+			fs::File::PageSize page_size = fs::File::PageSize(SAPI_LINK_DEFAULT_PAGE_SIZE)
+			);
+
+	~CsvWriter(){
+		flush();
+	}
+
+	/*! \details Appends a field to the current row. */
+	CsvWriter & append_field(
+			const char * value,
+			u32 length
+			);
+
+	CsvWriter & append_field(const char * value){
+		return append_field(value, static_cast<u32>(strlen(value)));
+	}
+
+	CsvWriter & append_field(const var::String & value){
+		return append_field(value.cstring(), static_cast<u32>(value.length()));
+	}
+
+	/*! \details Appends an integer field to the current row. */
+	CsvWriter & append_field(int value);
+
+	/*! \details Appends a floating point field to the current row. */
+	CsvWriter & append_field(float value);
+
+	/*! \details Terminates the current row. */
+	CsvWriter & end_row();
+
+	/*! \details Appends all values in \a row and terminates the row. */
+	CsvWriter & append_row(const var::StringList & row);
+
+	/*! \details Writes any buffered data to the file.
+	 *
+	 * @return Zero on success or less than zero if the write failed
+	 *
+	 * Once a write fails, the writer discards any data
+	 * that is appended and flush() continues to return less than zero.
+	 *
+	 */
+	int flush();
+
+	/*! \details Returns the number of bytes written to the file. */
+	u32 bytes_written() const { return m_bytes_written; }
+
+private:
+	const fs::File & m_file;
+	var::Data m_buffer;
+	u32 m_size = 0;
+	u32 m_bytes_written = 0;
+	char m_delimeter;
+	bool m_is_first_field = true;
+	bool m_is_write_failed = false;
+
+	void write_bytes(const char * value, u32 length);
+	void write_byte(char value){
+		if( (m_size == m_buffer.size()) && (flush() < 0) ){ return; }
+		m_buffer.to_char()[m_size++] = value;
+	}
 
 };
 
@@ -16,7 +16,10 @@ namespace fs {}
 
 #include "fs/Stat.hpp"
 #include "fs/Dir.hpp"
+#include "fs/DirCopy.hpp"
+#include "fs/DirWalker.hpp"
 #include "fs/File.hpp"
+#include "fs/BufferedFile.hpp"
 
 using namespace fs;
 
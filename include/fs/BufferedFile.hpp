@@ -0,0 +1,183 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_FS_BUFFEREDFILE_HPP_
+#define SAPI_FS_BUFFEREDFILE_HPP_
+
+#include "File.hpp"
+
+namespace fs {
+
+/*! \brief Buffered File Class
+ * \details The BufferedFile class wraps an open fs::File
+ * and reads ahead from it in blocks. Line oriented
+ * operations like gets() and readline() are served from
+ * the internal buffer rather than issuing one read()
+ * per character. This makes a big difference for files
+ * that are accessed over the link protocol and for
+ * sockets.
+ *
+ * Bytes that have been read ahead but not yet consumed
+ * are handed back by subsequent calls to read() so gets()
+ * and read() can be freely mixed (for example, reading
+ * an HTTP header line by line and then reading the body).
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fs.hpp>
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * File f;
+ * f.open(
+ *   arg::FilePath("/home/data.csv"),
+ *   OpenFlags::read_only()
+ *   );
+ *
+ * BufferedFile buffered_file(f, File::PageSize(1024));
+ * String line;
+ * while( buffered_file.gets(line) != nullptr ){
+ *   printf("%s", line.cstring());
+ * }
+ * ```
+ *
+ * The wrapped file must remain valid for the lifetime
+ * of the BufferedFile. The BufferedFile does not close the
+ * wrapped file.
+ *
+ */
+class BufferedFile : public File {
+public:
+
+	/*! \details Constructs a buffered file that reads ahead
+	 * from \a file in blocks of \a page_size bytes.
+	 *
+	 */
+	explicit BufferedFile(
+			const File & file,
+			PageSize page_size = PageSize(SAPI_LINK_DEFAULT_PAGE_SIZE)
+			);
+
+	virtual ~BufferedFile(){
+		m_fd = -1;
+	}
+
+	/*! \details Opening is not supported. The file
+	 * must be opened before it is wrapped.
+	 *
+	 */
+	int open(
+			const var::String & path,
+			const OpenFlags & flags
+			) override {
+		MCU_UNUSED_ARGUMENT(path);
+		MCU_UNUSED_ARGUMENT(flags);
+		return set_error_number_if_error(
+					api::error_code_fs_unsupported_operation
+					);
+	}
+
+	/*! \details Discards any buffered data.
+	 *
+	 * The wrapped file is not closed.
+	 *
+	 */
+	int close() override {
+		discard();
+		return 0;
+	}
+
+	/*! \details Reads from the buffer and then from the
+	 * wrapped file.
+	 *
+	 * Requests that are larger than the block size
+	 * bypass the buffer once it has been drained.
+	 *
+	 */
+	int read(
+			void * buf,
+			Size size
+			) const override;
+
+	/*! \details Writes to the wrapped file.
+	 *
+	 * If the wrapped file is seekable, any read-ahead
+	 * data is discarded and the wrapped file's location
+	 * is restored before writing.
+	 *
+	 */
+	int write(
+			const void * buf,
+			Size size
+			) const override;
+
+	/*! \details Seeks the wrapped file accounting
+	 * for data that has been read ahead.
+	 *
+	 */
+	int seek(
+			int location,
+			enum whence whence = whence_set
+			) const override;
+
+	int ioctl(
+			IoRequest request,
+			IoArgument argument
+			) const override {
+		return m_file.ioctl(request, argument);
+	}
+
+	u32 size() const override { return m_file.size(); }
+
+	const char * gets(
+			var::String & s,
+			char term = '\n'
+			) const override;
+
+	int readline(
+			char * buf,
+			int nbyte,
+			int timeout_msec,
+			char terminator = '\n'
+			) const override;
+
+	using File::read;
+	using File::write;
+	using File::seek;
+	using File::gets;
+
+	/*! \details Returns the number of bytes that have
+	 * been read ahead from the wrapped file but not yet consumed.
+	 *
+	 */
+	u32 bytes_available() const { return m_end - m_offset; }
+
+	/*! \details Returns the size of the read-ahead block. */
+	u32 page_size() const { return m_buffer.size(); }
+
+	/*! \details Discards any data that has been
+	 * read ahead but not consumed.
+	 *
+	 */
+	void discard() const {
+		m_offset = 0;
+		m_end = 0;
+	}
+
+	/*! \details Accesses the wrapped file. */
+	const File & file() const { return m_file; }
+
+private:
+	const File & m_file;
+	mutable var::Data m_buffer;
+	mutable u32 m_offset;
+	mutable u32 m_end;
+
+	int fill() const;
+
+};
+
+}
+
+#endif /* SAPI_FS_BUFFEREDFILE_HPP_ */
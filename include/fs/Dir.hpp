@@ -53,6 +53,13 @@ public:
 	using IsOverwrite = File::IsOverwrite;
 	using Location = File::Location;
 
+	/*! \details Entry types reported by entry_type(). */
+	enum entry_types {
+		entry_type_unknown /*! The type is not provided by the directory (use File::get_info()) */,
+		entry_type_directory /*! The entry is a directory */,
+		entry_type_other /*! The entry is a file or device (not a directory) */
+	};
+
 #if defined __link
 	using LinkDriver = File::LinkDriver;
 	using SourceLinkDriver = File::SourceLinkDriver;
@@ -101,6 +108,14 @@ public:
 			SAPI_LINK_DRIVER_NULLPTR_LAST
 			);
 
+	/*! \details Copies the contents of a directory tree.
+	 *
+	 * This uses fs::DirCopy with its default settings. The progress
+	 * callback is updated with the progress (in bytes) of the whole
+	 * tree. Use fs::DirCopy directly to change the number of threads,
+	 * skip identical files or make a dry-run plan.
+	 *
+	 */
 	static int copy(
 			SourcePath source_path,
 			DestinationPath destination_path,
@@ -202,6 +217,24 @@ public:
 		return m_entry.d_name;
 	}
 
+	/*! \details Returns the type of the most recently read entry.
+	 *
+	 * The type comes from the directory entry itself (d_type) when
+	 * the underlying system provides it, which saves a call to
+	 * File::get_info() for each entry. Symbolic links and entries
+	 * read over the link protocol are reported as entry_type_unknown.
+	 *
+	 */
+	enum entry_types entry_type() const;
+
+	/*! \details Returns true if the most recently read entry is a directory.
+	 *
+	 * @param entry_path The full path to the entry (used only if
+	 * entry_type() is entry_type_unknown)
+	 *
+	 */
+	bool is_directory_entry(const var::String & entry_path);
+
 	/*! \details Returns the serial number of the most recently read entry. */
 	int ino(){
 		return m_entry.d_ino;
@@ -0,0 +1,240 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_FS_DIRCOPY_HPP_
+#define SAPI_FS_DIRCOPY_HPP_
+
+#include "Dir.hpp"
+#include "../sys/Mutex.hpp"
+#include "../sys/WorkerThread.hpp"
+#include "../sys/ProgressCallback.hpp"
+
+namespace fs {
+
+/*! \brief Directory Copy Class
+ * \details The DirCopy class copies a directory tree.
+ *
+ * The source tree is walked first to build a plan (the list
+ * of files and the total number of bytes). The files are then
+ * copied by a pool of threads and the progress callback
+ * is updated with the progress of the whole tree rather
+ * than each file.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fs.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Printer p;
+ * DirCopy dir_copy;
+ * dir_copy.set_thread_count(8)
+ *   .set_skip_mode(DirCopy::skip_size_and_time)
+ *   .set_progress_callback(p.progress_callback());
+ *
+ * dir_copy.copy(
+ *   DirCopy::SourcePath("/home/assets"),
+ *   DirCopy::DestinationPath("/home/staging/assets")
+ *   );
+ *
+ * p.key("files", "%ld", dir_copy.file_count());
+ * p.key("skipped", "%ld", dir_copy.skipped_count());
+ * ```
+ *
+ * When a link driver is used for the source or the destination,
+ * one file is copied at a time (the link protocol handles one request
+ * at a time). The next page of the file is read while the current page
+ * is written, so a local read overlaps a write to the device.
+ *
+ */
+class DirCopy : public api::WorkObject {
+public:
+
+	using SourcePath = File::SourcePath;
+	using DestinationPath = File::DestinationPath;
+
+#if defined __link
+	using SourceLinkDriver = File::SourceLinkDriver;
+	using DestinationLinkDriver = File::DestinationLinkDriver;
+#endif
+
+	/*! \details Defines how files that already exist at the destination are handled. */
+	enum skip_modes {
+		skip_none /*! Copy every file (default) */,
+		skip_size_and_time /*! Skip files with the same size that were modified after the source */,
+		skip_contents /*! Skip files that have the same contents as the source */
+	};
+
+	DirCopy(
+		#if defined __link
+			SourceLinkDriver source_driver = SourceLinkDriver(nullptr),
+			DestinationLinkDriver destination_driver = DestinationLinkDriver(nullptr)
+		#endif
+			);
+
+	/*! \details Sets the number of files that are copied at the same time.
+	 *
+	 * This is only used on host builds when neither the
+	 * source nor the destination uses a link driver.
+	 *
+	 */
+	DirCopy & set_thread_count(u32 value){
+		m_thread_count = value;
+		return *this;
+	}
+
+	u32 thread_count() const { return m_thread_count; }
+
+	/*! \details Sets how files that already exist at the destination are handled. */
+	DirCopy & set_skip_mode(enum skip_modes value){
+		m_skip_mode = value;
+		return *this;
+	}
+
+	enum skip_modes skip_mode() const { return m_skip_mode; }
+
+	/*! \details Sets dry-run mode.
+	 *
+	 * In dry-run mode, nothing is created or written. copy_list()
+	 * holds the files that would be copied.
+	 *
+	 */
+	DirCopy & set_dry_run(bool value = true){
+		m_is_dry_run = value;
+		return *this;
+	}
+
+	bool is_dry_run() const { return m_is_dry_run; }
+
+	/*! \details Sets the size of the pages used to read and write files. */
+	DirCopy & set_page_size(u32 value){
+		m_page_size = value;
+		return *this;
+	}
+
+	u32 page_size() const { return m_page_size; }
+
+	/*! \details Sets the callback that is updated with the progress of the whole tree.
+	 *
+	 * The progress is in bytes. If the callback returns true,
+	 * the copy is aborted.
+	 *
+	 */
+	DirCopy & set_progress_callback(const sys::ProgressCallback * value){
+		m_progress_callback = value;
+		return *this;
+	}
+
+	/*! \details Copies the contents of \a source_path to \a destination_path.
+	 *
+	 * @return Zero on success or less than zero for an error
+	 *
+	 * Directories are created at the destination as needed. Entries
+	 * that are not regular files or directories (such as devices)
+	 * are skipped.
+	 *
+	 */
+	int copy(
+			SourcePath source_path,
+			DestinationPath destination_path
+			);
+
+	/*! \details Returns the relative paths of the files that were
+	 * copied (or would be copied in dry-run mode).
+	 *
+	 * The order of the list is not defined when more
+	 * than one thread is used.
+	 *
+	 */
+	const var::Vector<var::String> & copy_list() const { return m_copy_list; }
+
+	/*! \details Returns the number of files that were copied. */
+	u32 file_count() const { return m_copy_list.count(); }
+
+	/*! \details Returns the number of files that were skipped (see set_skip_mode()). */
+	u32 skipped_count() const { return m_skipped_count; }
+
+	/*! \details Returns the number of bytes that were copied. */
+	u32 bytes() const { return m_bytes; }
+
+	/*! \details Returns the duration of the last copy in microseconds. */
+	u32 microseconds() const { return m_microseconds; }
+
+protected:
+
+	/*! \details Returns true if files are copied one at a time.
+	 *
+	 * This is true when a link driver is used for the source or
+	 * the destination. With one file at a time, the next page is
+	 * read while the current page is written.
+	 *
+	 */
+	virtual bool is_one_file_at_a_time() const;
+
+	/*! \details These create and write the files at the destination.
+	 *
+	 * A subclass can replace them (along with is_one_file_at_a_time())
+	 * to simulate a device without a link driver (see test::DirCopyBenchmark).
+	 * write_destination() returns the number of bytes written.
+	 *
+	 */
+	virtual int create_destination(
+			File & destination,
+			const var::String & path,
+			const Permissions & permissions
+			);
+	virtual int write_destination(
+			const File & destination,
+			const void * buffer,
+			u32 size
+			);
+
+private:
+
+	/*! \cond */
+	struct Job {
+		var::String path;
+		u32 size;
+	};
+
+#if defined __link
+	link_transport_mdriver_t * m_source_driver;
+	link_transport_mdriver_t * m_destination_driver;
+#endif
+	const sys::ProgressCallback * m_progress_callback;
+	u32 m_thread_count;
+	u32 m_page_size;
+	enum skip_modes m_skip_mode;
+	bool m_is_dry_run;
+
+	var::String m_source_path;
+	var::String m_destination_path;
+	var::Vector<Job> m_job_list;
+	var::Vector<var::String> m_copy_list;
+	sys::Mutex m_mutex;
+	u32 m_next_job;
+	u32 m_total;
+	u32 m_progress;
+	u32 m_bytes;
+	u32 m_skipped_count;
+	u32 m_microseconds;
+	int m_result;
+	//reads the next page while the current one is written (nullptr if not overlapped)
+	sys::WorkerThread * m_reader;
+	//guarded by m_mutex
+	bool m_is_aborted;
+
+	int plan();
+	static void * worker(void * args);
+	void work();
+	int copy_job(const Job & job);
+	bool is_skipped(const Job & job);
+	bool update_progress(u32 size, bool is_copied);
+	/*! \endcond */
+
+};
+
+}
+
+#endif // SAPI_FS_DIRCOPY_HPP_
@@ -0,0 +1,200 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_FS_DIRWALKER_HPP_
+#define SAPI_FS_DIRWALKER_HPP_
+
+#include <atomic>
+#include <functional>
+
+#include "Dir.hpp"
+#include "../sys/Mutex.hpp"
+#include "../sys/Cond.hpp"
+
+namespace fs {
+
+/*! \brief Directory Walker Entry Class
+ * \details The DirWalkerEntry class describes an entry
+ * that is passed to the fs::DirWalker callback.
+ *
+ */
+class DirWalkerEntry {
+public:
+
+	/*! \details Returns the path of the entry relative to the walk root. */
+	const var::String & path() const { return m_path; }
+
+	/*! \details Returns the full path of the entry (including the walk root). */
+	const var::String & full_path() const { return m_full_path; }
+
+	/*! \details Returns the name of the entry (the last part of path()). */
+	const char * name() const { return m_full_path.cstring() + m_name_offset; }
+
+	/*! \details Returns true if the entry is a directory. */
+	bool is_directory() const { return m_is_directory; }
+
+	/*! \details Returns the depth of the entry (entries in the root have a depth of zero). */
+	u32 depth() const { return m_depth; }
+
+private:
+	friend class DirWalker;
+	var::String m_path;
+	var::String m_full_path;
+	u32 m_name_offset;
+	u32 m_depth;
+	bool m_is_directory;
+};
+
+/*! \brief Directory Walker Class
+ * \details The DirWalker class visits all the entries
+ * below a directory and passes each one to a callback
+ * as it is read (no list of entries is built).
+ *
+ * The callback decides how the walk continues: returning
+ * visit_prune for a directory skips its contents and returning
+ * visit_stop ends the walk.
+ *
+ * Directory types come from the directory entries themselves
+ * when possible (see Dir::entry_type()) so File::get_info() is
+ * only needed when the system doesn't provide the type.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fs.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * u32 size = 0;
+ * DirWalker walker;
+ * walker.walk(
+ *   "/home",
+ *   [&](const DirWalkerEntry & entry){
+ *     if( entry.is_directory() && (entry.name()[0] == '.') ){
+ *       return DirWalker::visit_prune; //skip hidden directories
+ *     }
+ *     if( entry.is_directory() == false ){
+ *       size += File::get_info(entry.full_path()).size();
+ *     }
+ *     return DirWalker::visit_continue;
+ *   },
+ *   DirWalker::ThreadCount(4)
+ *   );
+ * ```
+ *
+ * On host builds (local file systems), more than one thread can
+ * be used to read directories in parallel. The callback is never
+ * called by more than one thread at a time, but entries from different
+ * directories are interleaved and the order is not defined.
+ *
+ */
+class DirWalker : public api::WorkObject {
+public:
+
+	/*! \details Values returned by the walk callback. */
+	enum visit_result {
+		visit_continue /*! Continue the walk (including the contents of a directory) */,
+		visit_prune /*! Don't walk the contents of this directory */,
+		visit_stop /*! Stop the walk */
+	};
+
+	using Callback = std::function<enum visit_result(const DirWalkerEntry & entry)>;
+	using ThreadCount = arg::Argument<u32, struct DirWalkerThreadCountTag>;
+
+#if defined __link
+	using LinkDriver = File::LinkDriver;
+#endif
+
+	/*! \details Constructs a directory walker. */
+	DirWalker(
+			SAPI_LINK_DRIVER_NULLPTR
+			);
+
+	/*! \details Sets the maximum depth of the walk.
+	 *
+	 * A value of zero only visits the entries in the root
+	 * directory. The default is unlimited.
+	 *
+	 */
+	DirWalker & set_maximum_depth(u32 value){
+		m_maximum_depth = value;
+		return *this;
+	}
+
+	u32 maximum_depth() const { return m_maximum_depth; }
+
+	/*! \details Skips entries that start with '.' (default is false). */
+	DirWalker & set_hidden_skipped(bool value = true){
+		m_is_hidden_skipped = value;
+		return *this;
+	}
+
+	bool is_hidden_skipped() const { return m_is_hidden_skipped; }
+
+	/*! \details Walks all the entries below \a path.
+	 *
+	 * @param path The root directory of the walk
+	 * @param callback Called for each entry
+	 * @param thread_count The number of threads used to read directories
+	 * (only used for local file systems on host builds)
+	 * @return Zero if the walk completed, one if the callback stopped
+	 * the walk or less than zero if \a path could not be opened
+	 *
+	 */
+	int walk(
+			const var::String & path,
+			const Callback & callback,
+			ThreadCount thread_count = ThreadCount(1)
+			);
+
+	/*! \details Returns the number of entries passed to the callback by the last walk. */
+	u32 entry_count() const { return m_entry_count; }
+
+private:
+
+	/*! \cond */
+	struct Pending {
+		var::String path;
+		u32 depth;
+	};
+
+	var::String m_root_path;
+	const Callback * m_callback;
+	u32 m_maximum_depth;
+	u32 m_entry_count;
+	bool m_is_hidden_skipped;
+	std::atomic<bool> m_is_stopped;
+#if defined __link
+	link_transport_mdriver_t * m_driver;
+#endif
+
+	//used by multi-threaded walks
+	sys::Mutex m_mutex;
+	sys::Cond m_pending_cond;
+	sys::Mutex m_callback_mutex;
+	var::Vector<Pending> m_pending_list;
+	std::atomic<u32> m_busy_count;
+
+	int walk_directory(
+			const var::String & path,
+			u32 depth,
+			bool is_threaded
+			);
+
+	enum visit_result visit(
+			Dir & directory,
+			const var::String & parent_path,
+			const char * name,
+			u32 depth,
+			bool is_threaded
+			);
+
+	static void * worker(void * args);
+	void work();
+	void stop(bool is_threaded);
+	/*! \endcond */
+
+};
+
+}
+
+#endif // SAPI_FS_DIRWALKER_HPP_
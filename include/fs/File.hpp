@@ -520,7 +520,7 @@ public:
 	 * @param terminator Terminating character of the line (default is newline)
 	 * @return Number of bytes received
 	 */
-	int readline(char * buf, int nbyte, int timeout_msec, char terminator = '\n') const;
+	virtual int readline(char * buf, int nbyte, int timeout_msec, char terminator = '\n') const;
 
 	const File& operator<<(const var::Reference & a) const {
 		write(a); return *this;
@@ -548,7 +548,16 @@ public:
 	/*! \details Reads a line in to the var::String until end-of-file or \a term is reached. */
 	var::String gets(char term = '\n') const;
 
-	const char * gets(var::String & s, char term = '\n') const;
+	/*! \details Reads a line in to \a s until \a term is reached.
+	 *
+	 * @return A pointer to the string or nullptr if end-of-file
+	 * was reached before \a term
+	 *
+	 * This method reads one byte at a time. Use fs::BufferedFile
+	 * to read lines in blocks.
+	 *
+	 */
+	virtual const char * gets(var::String & s, char term = '\n') const;
 
 
 	API_DEPRECATED("Use gets(var::String & s) instead")
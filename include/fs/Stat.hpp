@@ -260,6 +260,9 @@ public:
 	/*! \details Returns true if the file is executable. */
 	bool is_executable() const;
 
+	/*! \details Returns the time the file was last modified (seconds since the epoch). */
+	u32 modification_time() const;
+
 	/*! \details Returns the file mode value. */
 	Permissions permissions() const { return Permissions(m_stat.st_mode); }
 
@@ -14,6 +14,7 @@ namespace inet {}
 #include "inet/Socket.hpp"
 #include "inet/SecureSocket.hpp"
 #include "inet/Http.hpp"
+#include "inet/HttpServer.hpp"
 #include "inet/Url.hpp"
 #include "inet/Wifi.hpp"
 
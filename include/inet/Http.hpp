@@ -3,7 +3,10 @@
 #ifndef SAPI_INET_HTTP_HPP_
 #define SAPI_INET_HTTP_HPP_
 
+#include <functional>
+
 #include "Socket.hpp"
+#include "../fs/BufferedFile.hpp"
 #include "../api/InetObject.hpp"
 #include "../var/String.hpp"
 #include "../var/Array.hpp"
@@ -36,8 +39,25 @@ public:
 	HttpHeaderPair(){}
 	HttpHeaderPair(const var::String & key, const var::String & value) : var::Pair<var::String>(key, value){}
 
+	/*! \details Creates a pair from a header line (e.g. "Content-Length: 100").
+	 *
+	 * Whitespace after the colon and the line ending are not
+	 * included in the value.
+	 *
+	 */
 	static HttpHeaderPair from_string(const var::String & string);
 
+	/*! \details Returns true if \a key matches \a name without regard to case.
+	 *
+	 * No memory is allocated.
+	 *
+	 */
+	static bool is_key_match(
+			const char * key,
+			u32 key_length,
+			const char * name
+			);
+
 	var::String to_string() const {
 		return var::String() << key() << ": " << value();
 	}
@@ -71,6 +91,18 @@ public:
 class HttpClient : public Http {
 public:
 
+	/*! \details Defines the callback used to receive a response
+	 * body without writing it to a file.
+	 *
+	 * The callback is executed for each block of the body as it
+	 * arrives. \a data refers to the client's transfer buffer (which
+	 * is at most transfer_size() bytes) and is only valid during the
+	 * call. Returning a value less than zero aborts the transfer and
+	 * closes the connection.
+	 *
+	 */
+	using ResponseCallback = std::function<int(const var::Reference & data)>;
+
 	/*! \details Constructs a new HttpClient object.
 	 *
 	 * @param socket A reference to the socket to use
@@ -136,6 +168,32 @@ public:
 		return get(url.argument(), response, progress_callback);
 	}
 
+	/*! \details Executes an HTTP GET request and passes the
+	 * body to \a response as it is received.
+	 *
+	 * The body is streamed through one buffer of transfer_size()
+	 * bytes no matter how large the response (or its chunks) are.
+	 *
+	 * ```
+	 * //md2code:main
+	 * Socket socket;
+	 * HttpClient http_client(socket);
+	 * u32 total = 0;
+	 * http_client.get(
+	 *   HttpClient::UrlEncodedString("http://example.com/firmware.bin"),
+	 *   [&](const Reference & data) -> int {
+	 *     total += data.size();
+	 *     return 0;
+	 *   });
+	 * ```
+	 *
+	 */
+	int get(
+			UrlEncodedString url,
+			const ResponseCallback & response,
+			const sys::ProgressCallback * progress_callback = nullptr
+			);
+
 	int post(
 			const var::String& url,
 			RequestString request,
@@ -304,6 +362,73 @@ public:
 	 */
 	int close_connection();
 
+	/*! \details Sends a request without waiting for the response.
+	 *
+	 * @param method The request method (e.g. "GET" or "POST")
+	 * @param url The target URL
+	 * @return Zero on success
+	 *
+	 * Several requests can be sent on a keep-alive connection
+	 * before reading the responses (HTTP pipelining). Each
+	 * request must be matched by a call to receive_response(). The
+	 * responses arrive in the same order that the requests were sent.
+	 *
+	 * ```
+	 * //md2code:main
+	 * Socket socket;
+	 * HttpClient http_client(socket);
+	 * http_client.set_keep_alive();
+	 * DataFile first, second;
+	 * http_client.send_request("GET", HttpClient::UrlEncodedString("http://example.com/a"));
+	 * http_client.send_request("GET", HttpClient::UrlEncodedString("http://example.com/b"));
+	 * http_client.receive_response(HttpClient::ResponseFile(first));
+	 * http_client.receive_response(HttpClient::ResponseFile(second));
+	 * ```
+	 *
+	 */
+	int send_request(
+			const var::String & method,
+			UrlEncodedString url
+			){
+		return send_request(method, url.argument(), nullptr, nullptr);
+	}
+
+	int send_request(
+			const var::String & method,
+			UrlEncodedString url,
+			RequestFile request
+			){
+		return send_request(method, url.argument(), &request.argument(), nullptr);
+	}
+
+	/*! \details Receives the response to the oldest request
+	 * sent with send_request().
+	 *
+	 * @return Zero on success
+	 *
+	 */
+	int receive_response(
+			ResponseFile response,
+			const sys::ProgressCallback * progress_callback = nullptr
+			);
+
+	int receive_response(
+			const ResponseCallback & response,
+			const sys::ProgressCallback * progress_callback = nullptr
+			);
+
+	/*! \details Returns the number of body bytes received
+	 * with the most recent response.
+	 *
+	 */
+	u32 bytes_received() const { return m_bytes_received; }
+
+	/*! \details Returns the number of requests that have been
+	 * sent but whose responses have not been received.
+	 *
+	 */
+	u32 pending_response_count() const { return m_pending_response_count; }
+
 	var::Vector<HttpHeaderPair> & header_request_pairs(){ return m_header_request_pairs; }
 	const var::Vector<HttpHeaderPair> & header_request_pairs() const { return m_header_request_pairs; }
 
@@ -334,18 +459,40 @@ private:
 	bool m_is_chunked_transfer_encoding;
 	u32 m_transfer_size;
 	var::String m_traffic;
+	fs::BufferedFile m_input;
+	var::String m_line;
+	var::Data m_transfer_buffer;
+	u32 m_bytes_received = 0;
+	u16 m_alive_port = 0;
+	u32 m_pending_response_count = 0;
+	bool m_is_connection_reused = false;
+	bool m_is_close_requested = false;
+
+	struct AddressCacheEntry {
+		var::String domain_name;
+		SocketAddress address;
+	};
+	var::Vector<AddressCacheEntry> m_address_cache;
 
 	int connect_to_server(
 			const var::String & domain_name,
 			u16 port
 			);
 
+	int send_request(
+			const var::String & method,
+			const var::String & url,
+			const fs::File * request,
+			const sys::ProgressCallback * progress_callback
+			);
+
 	int query(
 			const var::String & command,
 			const var::String & url,
 			SendFile send_file,
 			GetFile get_file,
-			const sys::ProgressCallback * progress_callback
+			const sys::ProgressCallback * progress_callback,
+			const ResponseCallback * response_callback = nullptr
 			);
 
 
@@ -369,27 +516,85 @@ private:
 			const fs::File & data,
 			const sys::ProgressCallback * progress_callback
 			);
+	int listen_for_data(
+			const ResponseCallback & response,
+			const sys::ProgressCallback * progress_callback
+			);
+	int receive_data(
+			const ResponseCallback & response,
+			u32 size,
+			int progress_total,
+			const sys::ProgressCallback * progress_callback
+			);
 	/*! \endcond */
 
 };
 
-/*! \cond */
-class HttpServer : public Http {
+/*!
+ * \brief HTTP Connection Pool Class
+ * \details The HttpConnectionPool class keeps a small
+ * number of keep-alive HttpClient objects, one per host.
+ * Requests to a host that was used recently go out on the
+ * existing connection without a new DNS lookup or connect().
+ *
+ * ```
+ * #include <sapi/inet.hpp>
+ *
+ * HttpConnectionPool pool;
+ * DataFile response;
+ * const String url = "http://example.com/telemetry";
+ * for(u32 i=0; i < 100; i++){
+ *   pool.client(url).post(url, HttpClient::RequestString("{}"), HttpClient::ResponseFile(response));
+ * }
+ * ```
+ *
+ * When the pool is full, the least recently used connection is closed.
+ *
+ */
+class HttpConnectionPool {
 public:
-	HttpServer();
 
+	explicit HttpConnectionPool(u32 maximum_count = 4) :
+		m_maximum_count(maximum_count ? maximum_count : 1){}
 
-private:
+	~HttpConnectionPool(){
+		close_all();
+	}
 
-	//path to filesystem
-	//callback for dynamic content
+	HttpConnectionPool(const HttpConnectionPool &) = delete;
+	HttpConnectionPool & operator=(const HttpConnectionPool &) = delete;
 
-	//design to be easily used in a thread
+	/*! \details Returns the client for the host in \a url.
+	 *
+	 * https URLs use a SecureSocket.
+	 *
+	 */
+	HttpClient & client(const var::String & url);
 
+	/*! \details Returns the number of hosts in the pool. */
+	u32 count() const { return m_entries.count(); }
 
-};
-/*! \endcond */
+	/*! \details Closes and removes all connections. */
+	void close_all();
 
+private:
+	/*! \cond */
+	struct Entry {
+		var::String domain_name;
+		u16 port;
+		u8 protocol;
+		u32 sequence;
+		Socket * socket;
+		HttpClient * client;
+	};
+
+	var::Vector<Entry> m_entries;
+	u32 m_maximum_count;
+	u32 m_sequence = 0;
+
+	static void destroy(Entry & entry);
+	/*! \endcond */
+};
 
 }
 
@@ -0,0 +1,378 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_INET_HTTPSERVER_HPP_
+#define SAPI_INET_HTTPSERVER_HPP_
+
+#include <atomic>
+#include <functional>
+
+#include "Http.hpp"
+#include "../fs/BufferedFile.hpp"
+#include "../sys/Thread.hpp"
+
+namespace inet {
+
+/*! \brief HTTP Server Request Class
+ * \details The HttpServerRequest class holds a request
+ * that has been received by inet::HttpServer.
+ *
+ */
+class HttpServerRequest {
+public:
+
+	/*! \details Returns the request method (e.g. GET or POST). */
+	const var::String & method() const { return m_method; }
+
+	/*! \details Returns the path portion of the request target. */
+	const var::String & path() const { return m_path; }
+
+	/*! \details Returns the query string (without the leading '?'). */
+	const var::String & query() const { return m_query; }
+
+	/*! \details Returns the HTTP version (e.g. HTTP/1.1). */
+	const var::String & version() const { return m_version; }
+
+	const var::Vector<HttpHeaderPair> & header_pairs() const {
+		return m_header_pairs;
+	}
+
+	/*! \details Returns the value of the header called \a key.
+	 *
+	 * The key is matched without regard to case. An empty
+	 * string is returned if the header is not present.
+	 *
+	 */
+	const var::String & get_header_value(const var::String & key) const;
+
+	/*! \details Returns the request body. */
+	const var::Data & body() const { return m_body; }
+
+	u32 content_length() const { return m_content_length; }
+
+	/*! \details Returns true if the connection stays open after the response. */
+	bool is_keep_alive() const { return m_is_keep_alive; }
+
+private:
+	friend class HttpServer;
+	var::String m_method;
+	var::String m_path;
+	var::String m_query;
+	var::String m_version;
+	var::Vector<HttpHeaderPair> m_header_pairs;
+	var::Data m_body;
+	u32 m_content_length = 0;
+	bool m_is_keep_alive = false;
+};
+
+/*! \brief HTTP Server Response Class
+ * \details The HttpServerResponse class is passed
+ * to HttpServer route handlers and is used to send
+ * the response to the client.
+ *
+ * A response can be sent all at once using send(),
+ * streamed from a file using send_file() or sent in
+ * pieces using chunked transfer encoding.
+ *
+ * ```
+ * //md2code:main
+ * HttpServerResponse & response = ...;
+ * response.start_chunked("application/json");
+ * response.send_chunk(String("["));
+ * response.send_chunk(String("1,2,3"));
+ * response.send_chunk(String("]"));
+ * response.finish_chunked();
+ * ```
+ *
+ */
+class HttpServerResponse {
+public:
+
+	HttpServerResponse(
+			const Socket & socket,
+			bool is_keep_alive,
+			u32 transfer_size
+			) :
+		m_socket(socket),
+		m_transfer_size(transfer_size),
+		m_is_keep_alive(is_keep_alive){}
+
+	/*! \details Sets the status code (the default is 200). */
+	HttpServerResponse & set_status_code(int value){
+		m_status_code = value;
+		return *this;
+	}
+
+	int status_code() const { return m_status_code; }
+
+	/*! \details Adds a header to the response.
+	 *
+	 * This must be called before the response is sent.
+	 *
+	 */
+	HttpServerResponse & add_header_pair(
+			const var::String & key,
+			const var::String & value
+			){
+		m_header_pairs.push_back(HttpHeaderPair(key, value));
+		return *this;
+	}
+
+	/*! \details Closes the connection after this response is sent. */
+	HttpServerResponse & set_close_connection(){
+		m_is_keep_alive = false;
+		return *this;
+	}
+
+	bool is_keep_alive() const { return m_is_keep_alive; }
+
+	/*! \details Returns true if the response has been sent. */
+	bool is_sent() const { return m_is_header_sent; }
+
+	/*! \details Sends a complete response with \a body.
+	 *
+	 * @return Zero on success or less than zero if the
+	 * socket could not be written
+	 *
+	 */
+	int send(
+			const var::Reference & body,
+			const var::String & content_type = "application/json"
+			);
+
+	/*! \details Sends the contents of \a file as the response body.
+	 *
+	 * The file is read from its current location and written to
+	 * the socket in blocks of HttpServer::transfer_size() bytes.
+	 *
+	 */
+	int send_file(
+			const fs::File & file,
+			const var::String & content_type
+			);
+
+	/*! \details Sends the header for a chunked response. */
+	int start_chunked(const var::String & content_type);
+
+	/*! \details Sends one chunk of a chunked response.
+	 *
+	 * Empty chunks are ignored (finish_chunked() sends the
+	 * terminating chunk).
+	 *
+	 */
+	int send_chunk(const var::Reference & data);
+
+	/*! \details Sends the terminating chunk. */
+	int finish_chunked();
+
+private:
+	const Socket & m_socket;
+	var::Vector<HttpHeaderPair> m_header_pairs;
+	u32 m_transfer_size;
+	int m_status_code = 200;
+	bool m_is_keep_alive;
+	bool m_is_header_sent = false;
+
+	int send_header(
+			const var::String & content_type,
+			u32 content_length,
+			bool is_chunked
+			);
+	int write(const void * buffer, u32 size);
+};
+
+/*!
+ * \brief HTTP Server Class
+ * \details The HttpServer class implements an HTTP/1.1
+ * server. Connections are accepted and served by a fixed
+ * pool of sys::Thread workers that each call accept() on the
+ * listening socket.
+ *
+ * Requests are dispatched to route handlers. Requests that
+ * don't match a route are served from the file system below
+ * root_path() (if set).
+ *
+ * ```
+ * #include <sapi/inet.hpp>
+ *
+ * Socket socket;
+ * HttpServer server(socket);
+ *
+ * server.set_root_path("/home/www")
+ *   .add_route("GET", "/api/status", [](
+ *     const HttpServerRequest & request,
+ *     HttpServerResponse & response
+ *     ) -> int {
+ *     return response.send(String("{\"status\":\"ok\"}"));
+ *   });
+ *
+ * server.start(
+ *   SocketAddress(SocketAddressIpv4(0, 80)),
+ *   HttpServer::ThreadCount(4)
+ *   );
+ * ```
+ *
+ * A connection is kept open between requests unless the client
+ * asks to close it or keep_alive_timeout() expires while waiting
+ * for the next request.
+ *
+ */
+class HttpServer : public Http {
+public:
+
+	/*! \details Defines the route handler function.
+	 *
+	 * The handler should send a response using \a response. If
+	 * it returns without sending one, an empty 500 response is sent.
+	 *
+	 */
+	using Handler = std::function<int(
+		const HttpServerRequest & request,
+		HttpServerResponse & response
+		)>;
+
+	using ThreadCount = arg::Argument<u32, struct HttpServerThreadCountTag>;
+
+	/*! \details Constructs a server that uses \a socket to listen. */
+	explicit HttpServer(Socket & socket);
+	~HttpServer();
+
+	/*! \details Adds a route.
+	 *
+	 * @param method The method to match (use "*" to match any method)
+	 * @param path The path to match; if the path ends with '*', any
+	 * path that starts with the characters before '*' is matched
+	 * @param handler The function that creates the response
+	 *
+	 * Routes are matched in the order they are added.
+	 *
+	 */
+	HttpServer & add_route(
+			const var::String & method,
+			const var::String & path,
+			Handler handler
+			);
+
+	/*! \details Sets the directory from which static files are served. */
+	HttpServer & set_root_path(const var::String & path){
+		m_root_path = path;
+		return *this;
+	}
+
+	const var::String & root_path() const { return m_root_path; }
+
+	/*! \details Sets the block size used to read requests and send files. */
+	HttpServer & set_transfer_size(u32 value){
+		m_transfer_size = value;
+		return *this;
+	}
+
+	u32 transfer_size() const { return m_transfer_size; }
+
+	/*! \details Sets the largest request body that will be accepted.
+	 *
+	 * Larger requests receive a 413 response.
+	 *
+	 */
+	HttpServer & set_maximum_body_size(u32 value){
+		m_maximum_body_size = value;
+		return *this;
+	}
+
+	u32 maximum_body_size() const { return m_maximum_body_size; }
+
+	/*! \details Sets how long an idle connection is kept open (in seconds). */
+	HttpServer & set_keep_alive_timeout(u32 value){
+		m_keep_alive_timeout = value;
+		return *this;
+	}
+
+	u32 keep_alive_timeout() const { return m_keep_alive_timeout; }
+
+	/*! \details Sets the stack size of each worker thread.
+	 *
+	 * Values smaller than SAPI_WORKER_THREAD_STACK_SIZE are increased
+	 * to SAPI_WORKER_THREAD_STACK_SIZE.
+	 *
+	 */
+	HttpServer & set_thread_stack_size(u32 value){
+		m_thread_stack_size = value;
+		return *this;
+	}
+
+	/*! \details Binds to \a address and starts the worker threads.
+	 *
+	 * @return Zero on success
+	 *
+	 * This method returns once the workers have been created.
+	 *
+	 */
+	int start(
+			const SocketAddress & address,
+			ThreadCount thread_count = ThreadCount(4)
+			);
+
+	/*! \details Binds to \a address and serves requests in the
+	 * calling thread until stop() is called.
+	 *
+	 */
+	int run(const SocketAddress & address);
+
+	/*! \details Stops accepting connections and waits for the
+	 * worker threads to finish.
+	 *
+	 */
+	int stop();
+
+	bool is_running() const { return m_is_running; }
+
+	/*! \details Returns the number of requests that have been served. */
+	u32 request_count() const { return m_request_count; }
+
+	/*! \details Returns the standard reason phrase for \a status_code. */
+	static const char * get_reason_phrase(int status_code);
+
+	/*! \details Returns the content type to use for files with \a suffix. */
+	static const char * get_content_type(const var::String & suffix);
+
+private:
+
+	/*! \cond */
+	struct Route {
+		var::String method;
+		var::String path;
+		Handler handler;
+	};
+
+	var::Vector<Route> m_routes;
+	var::Vector<sys::Thread> m_threads;
+	var::String m_root_path;
+	u32 m_transfer_size = 1024;
+	u32 m_maximum_body_size = 8192;
+	u32 m_keep_alive_timeout = 5;
+	u32 m_thread_stack_size = 8192;
+	std::atomic<u32> m_request_count{0};
+	std::atomic<bool> m_is_running{false};
+
+	int listen(const SocketAddress & address);
+	static void * worker(void * args);
+	void serve();
+	void handle_connection(const Socket & connection);
+	int read_request(
+			const fs::BufferedFile & input,
+			HttpServerRequest & request
+			);
+	void execute(
+			const HttpServerRequest & request,
+			HttpServerResponse & response
+			);
+	int send_static_file(
+			const HttpServerRequest & request,
+			HttpServerResponse & response
+			);
+	/*! \endcond */
+
+};
+
+}
+
+#endif // SAPI_INET_HTTPSERVER_HPP_
@@ -16,6 +16,9 @@ typedef uint32_t in_addr_t;
 #include <netdb.h>
 #include <unistd.h>
 #include <arpa/inet.h>
+#if defined __link
+#include <netinet/tcp.h>
+#endif
 #endif
 
 #include <mcu/types.h>
@@ -369,8 +372,8 @@ public:
 		IP_TIME_TO_LIVE = IP_TTL,
 		IP_PACKET_INFO = IP_PKTINFO,
 
-#if !defined __link
 		TCP_NO_DELAY = TCP_NODELAY,
+#if !defined __link
 		TCP_KEEP_ALIVE = TCP_KEEPALIVE,
 		TCP_KEEP_IDLE = TCP_KEEPIDLE,
 		TCP_KEEP_INTERVAL = TCP_KEEPINTVL,
@@ -438,6 +441,14 @@ public:
 		return set_timeout(SOCKET_RECEIVE_TIMEOUT, timeout);
 	}
 
+	/*! \details Sends small writes right away instead of
+	 * waiting for the data that was sent before to be acknowledged.
+	 */
+	SocketOption & tcp_no_delay(bool value = true){
+		m_level = level_tcp;
+		return set_integer_value(TCP_NO_DELAY, value);
+	}
+
 	SocketOption & ip_type_of_service(int service){
 		m_level = level_ip;
 		return set_integer_value(IP_TYPE_OF_SERVICE, service);
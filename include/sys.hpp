@@ -27,10 +27,14 @@ namespace sys {}
 
 #include "sys/Auth.hpp"
 #include "sys/Mutex.hpp"
+#include "sys/Cond.hpp"
+#include "sys/TraceRecorder.hpp"
 #include "sys/Thread.hpp"
+#include "sys/WorkerThread.hpp"
 #include "sys/TaskManager.hpp"
 #include "sys/Cli.hpp"
 #include "sys/Printer.hpp"
+#include "sys/PrinterSink.hpp"
 #include "sys/JsonPrinter.hpp"
 #include "sys/YamlPrinter.hpp"
 #include "sys/MarkdownPrinter.hpp"
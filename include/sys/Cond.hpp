@@ -0,0 +1,81 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_SYS_COND_HPP_
+#define SAPI_SYS_COND_HPP_
+
+#include <pthread.h>
+#include "Mutex.hpp"
+#include "../chrono/ClockTime.hpp"
+
+namespace sys {
+
+/*! \brief Condition Variable Class
+ * \details The Cond class is a condition variable. A thread
+ * holding a sys::Mutex can wait() until another thread
+ * calls signal() or broadcast().
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Mutex mutex;
+ * Cond cond;
+ * bool is_ready = false;
+ *
+ * //waiting thread
+ * mutex.lock();
+ * while( is_ready == false ){
+ *   cond.wait(mutex);
+ * }
+ * mutex.unlock();
+ *
+ * //signaling thread
+ * mutex.lock();
+ * is_ready = true;
+ * cond.signal();
+ * mutex.unlock();
+ * ```
+ *
+ * Like all condition variables, wait() can return
+ * without a signal so the condition must be checked again.
+ *
+ */
+class Cond : public api::WorkObject {
+public:
+	/*! \details Constructs a new condition variable. */
+	Cond();
+	~Cond();
+
+	/*! \details Unlocks \a mutex and waits for a signal.
+	 *
+	 * \a mutex must be locked by the caller. It is locked
+	 * again before wait() returns.
+	 *
+	 */
+	int wait(Mutex & mutex);
+
+	/*! \details Unlocks \a mutex and waits for a signal or until
+	 * \a clock_time has elapsed.
+	 *
+	 * @return Zero if signaled or less than zero on a timeout (error number is ETIMEDOUT)
+	 *
+	 */
+	int wait_timed(Mutex & mutex, const chrono::ClockTime & clock_time);
+
+	/*! \details Wakes one waiting thread. */
+	int signal();
+
+	/*! \details Wakes all waiting threads. */
+	int broadcast();
+
+private:
+	pthread_cond_t m_item;
+	int set_error_number_if_nonzero(int result) const;
+};
+
+}
+
+#endif /* SAPI_SYS_COND_HPP_ */
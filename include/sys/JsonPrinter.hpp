@@ -3,15 +3,86 @@
 #define SAPI_SYS_JSONPRINTER_HPP
 
 
+#include <type_traits>
+
 #include "Printer.hpp"
 
 namespace sys {
 
+/*! \brief JSON Printer Class
+ * \details The JsonPrinter class prints
+ * JSON formatted output as it is generated
+ * (without building a var::JsonValue first).
+ *
+ * Keys and string values are escaped and
+ * written straight to the output buffer. The
+ * verbose level of each container is resolved
+ * when the container is opened so a child of a
+ * filtered container is also filtered.
+ *
+ * Combined with a sys::PrinterSink, large listings
+ * can be streamed directly to a file or socket.
+ *
+ * ```
+ * //md2code:main
+ * Socket & connection = ...;
+ * FilePrinterSink sink(connection);
+ * JsonPrinter p;
+ * p.set_sink(sink).set_flush_mode(Printer::flush_size);
+ * p.open_array("tasks");
+ * for(u32 i=0; i < 100; i++){
+ *   p.open_object("task");
+ *   p.number("id", i);
+ *   p.key("name", "task");
+ *   p.close_object();
+ * }
+ * p.close_array();
+ * p.flush();
+ * ```
+ *
+ */
 class JsonPrinter : public Printer {
 public:
 	JsonPrinter();
 
-
+	/*! \details Prints \a value as a JSON number (without quotes).
+	 *
+	 * @param key The key (ignored inside arrays; use an empty string for none)
+	 * @param value The integer or floating point value to print
+	 * @param level The verbose level needed to print the value
+	 *
+	 * Integers are formatted without using printf(). Floating
+	 * point values that JSON can't represent (inf and nan)
+	 * are printed as null.
+	 *
+	 */
+	template<typename T> JsonPrinter & number(
+			const var::String & key,
+			T value,
+			enum levels level = level_info
+			){
+		static_assert(
+					std::is_arithmetic<T>::value,
+					"JsonPrinter::number() requires an arithmetic type"
+					);
+		if( is_filtered(level) ){
+			return *this;
+		}
+		insert_comma();
+		print_key(key.is_empty() ? nullptr : key.cstring());
+		if( std::is_floating_point<T>::value ){
+			//9 digits are enough to read a float back exactly
+			print_real(static_cast<double>(value), std::is_same<T, float>::value ? 9 : 17);
+		} else if( std::is_signed<T>::value && (value < 0) ){
+			print_integer(
+						static_cast<u64>(0) - static_cast<u64>(value),
+						true
+						);
+		} else {
+			print_integer(static_cast<u64>(value), false);
+		}
+		return *this;
+	}
 
 private:
 
@@ -48,7 +119,22 @@ private:
 		return m_container_list.back();
 	}
 
+	bool is_filtered(enum levels level) const {
+		//container levels include the level of all parent containers
+		return (level > verbose_level()) ||
+				(container().verbose_level() > verbose_level());
+	}
+
+	void open_container(
+			enum levels level,
+			const char * key,
+			enum container_type type
+			);
 	void insert_comma();
+	void print_key(const char * key);
+	void print_string(const char * value);
+	void print_integer(u64 magnitude, bool is_negative);
+	void print_real(double value, int precision);
 
 };
 
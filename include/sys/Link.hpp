@@ -281,6 +281,74 @@ public:
 	using BootloaderRetryCount = arg::Argument<u32, struct LinkBootloaderRetryCountTag>;
 	using IsVerify = arg::Argument<bool, struct LinkIsVerifyTag>;
 	using HardwareId = arg::Argument<u32, struct LinkHardwareIdTag>;
+	using IsSkipIfIdentical = arg::Argument<bool, struct LinkIsSkipIfIdenticalTag>;
+
+	/*! \brief Transfer Statistics Class
+	 * \details The TransferStatistics class holds the
+	 * throughput of the most recent copy(), copy_directory()
+	 * or install_app() operation.
+	 *
+	 */
+	class TransferStatistics {
+	public:
+		/*! \details Returns the number of bytes that were transferred. */
+		u32 bytes() const { return m_bytes; }
+
+		/*! \details Returns the number of files that were transferred. */
+		u32 file_count() const { return m_file_count; }
+
+		/*! \details Returns the time spent transferring data in microseconds. */
+		u32 microseconds() const { return m_microseconds; }
+
+		/*! \details Returns the page size that the transfer settled on. */
+		u32 page_size() const { return m_page_size; }
+
+		/*! \details Returns the throughput in megabytes (10^6 bytes) per second. */
+		float mb_per_second() const {
+			if( m_microseconds == 0 ){ return 0.0f; }
+			return static_cast<float>(m_bytes) / static_cast<float>(m_microseconds);
+		}
+
+	private:
+		friend class Link;
+		u32 m_bytes = 0;
+		u32 m_file_count = 0;
+		u32 m_microseconds = 0;
+		u32 m_page_size = 0;
+	};
+
+	/*! \brief Update Statistics Class
+	 * \details The UpdateStatistics class holds the number
+	 * of bytes handled by the most recent call to update_os().
+	 *
+	 */
+	class UpdateStatistics {
+	public:
+		/*! \details Returns the number of bytes written to flash. */
+		u32 bytes_written() const { return m_bytes_written; }
+
+		/*! \details Returns the number of image bytes that didn't need to be written. */
+		u32 bytes_skipped() const { return m_bytes_skipped; }
+
+		/*! \details Returns the number of bytes read back to compare with the image. */
+		u32 bytes_compared() const { return m_bytes_compared; }
+
+		/*! \details Returns the total number of bytes transferred over the link. */
+		u32 bytes_transferred() const {
+			return m_bytes_written + m_bytes_compared + m_bytes_verified;
+		}
+
+		/*! \details Returns true if the device already had the image installed. */
+		bool is_up_to_date() const { return m_is_up_to_date; }
+
+	private:
+		friend class Link;
+		u32 m_bytes_written = 0;
+		u32 m_bytes_skipped = 0;
+		u32 m_bytes_compared = 0;
+		u32 m_bytes_verified = 0;
+		bool m_is_up_to_date = false;
+	};
 
 	Link();
 	~Link();
@@ -446,6 +514,63 @@ public:
 			const ProgressCallback * progress_callback = nullptr
 			);
 
+	/*! \details Copies the contents of \a source to \a destination.
+		*
+		* Both files must already be open. Either one can be a file on
+		* the device (opened with fs::File::LinkDriver(driver())). The
+		* data is moved with the same adaptive page size as copy() and
+		* transfer_statistics() is reset before the copy starts.
+		*
+		* \return Zero on success
+		*/
+	int copy(
+			SourceFile source,
+			DestinationFile destination,
+			const ProgressCallback * progress_callback = nullptr
+			);
+
+
+	/*! \details Copies a directory tree between the host and the device.
+		*
+		* \param src The directory to copy
+		* \param dest The directory to create (intermediate directories are created as needed)
+		* \param permissions The permissions used when creating files on the destination
+		* \param to_device When true, the copy is from the host to the device
+		* \param progress_callback Updated with the bytes copied across all files
+		* \return Zero on success
+		*
+		* Files are copied one after the other using the same
+		* adaptive page size as copy(). The page size learned on
+		* one file is used as the starting point for the next so
+		* trees of small files don't pay the ramp up cost each time.
+		*
+		*/
+	int copy_directory(
+			SourcePath src,
+			DestinationPath dest,
+			const fs::Permissions & permissions,
+			IsCopyToDevice to_device = IsCopyToDevice(true),
+			const ProgressCallback * progress_callback = nullptr
+			);
+
+	/*! \details Sets the range of page sizes used for file transfers.
+		*
+		* Each link transaction has a fixed round trip cost, so copy()
+		* starts with \a minimum bytes per request and doubles the page
+		* size while the measured throughput keeps improving. If the
+		* throughput drops sharply, the page size is halved.
+		*
+		*/
+	Link & set_transfer_page_size_range(u32 minimum, u32 maximum){
+		m_transfer_page_size_minimum = minimum;
+		m_transfer_page_size_maximum = maximum > minimum ? maximum : minimum;
+		return *this;
+	}
+
+	/*! \details Returns the statistics of the most recent file transfer. */
+	const TransferStatistics & transfer_statistics() const {
+		return m_transfer_statistics;
+	}
 
 	/*!
 		* \details Copies a file to the target device.
@@ -770,12 +895,45 @@ public:
 			BootloaderRetryCount bootloader_retry_total = BootloaderRetryCount(20)
 			);
 
+	/*! \details Updates the operating system.
+		*
+		* \param image The new binary image on the host
+		* \param is_verify true to read back the installation
+		* \param progress_printer Printer used to show the progress
+		* \param bootloader_retry_total Number of times to ping the bootloader after erasing
+		* \param is_skip_if_identical true to skip the update if the device already has the image
+		* \return Zero on success
+		*
+		* When \a is_skip_if_identical is true, the flash is read back
+		* page by page and compared with the image (the first 256 bytes
+		* are compared with the block that the installer would write). If
+		* every page matches, the device is left untouched.
+		*
+		* Otherwise, the comparison stops at the first page that differs and the
+		* whole OS is erased and written again: the bootloader can only erase
+		* the entire OS, so pages that haven't changed can't be skipped. Only
+		* pages that are all 0xFF (which already match the erased flash) aren't written.
+		* An update that isn't skipped costs the comparison on top of a normal update.
+		*
+		* The bytes that were written, skipped and compared are available from
+		* update_statistics() when the method returns.
+		*
+		*/
 	int update_os(const fs::File & image,
 								IsVerify is_verify,
 								Printer & progress_printer,
-								BootloaderRetryCount bootloader_retry_total = BootloaderRetryCount(20)
+								BootloaderRetryCount bootloader_retry_total = BootloaderRetryCount(20),
+								IsSkipIfIdentical is_skip_if_identical = IsSkipIfIdentical(false)
 			);
 
+	/*! \details Returns the statistics of the most recent
+		* update_os() call that used a sys::Printer.
+		*
+		*/
+	const UpdateStatistics & update_statistics() const {
+		return m_update_statistics;
+	}
+
 	/*! \details Returns the driver needed by other API objects.
 		*
 		* Other objects need the link driver in order to operate correctly.
@@ -885,6 +1043,37 @@ public:
 
 	const LinkInfo & info() const { return m_link_info; }
 
+protected:
+
+	/*! \details These access the bootloader for update_os().
+	 *
+	 * They call the link driver. A subclass can replace them
+	 * to simulate a bootloader without a device (see test::LinkBootloaderSimulator).
+	 *
+	 * read_bootloader_flash() and write_bootloader_flash() return the number of bytes read or written.
+	 * wait_for_bootloader() is called after erase_bootloader_flash() and returns once
+	 * the bootloader responds again.
+	 *
+	 */
+	virtual int read_bootloader_flash(u32 address, void * buffer, u32 size);
+	virtual int write_bootloader_flash(u32 address, const void * buffer, u32 size);
+	virtual int erase_bootloader_flash();
+	virtual int wait_for_bootloader(
+			BootloaderRetryCount bootloader_retry_total,
+			const ProgressCallback * progress_callback
+			);
+	virtual int read_bootloader_attributes(bootloader_attr_t & attributes);
+
+	/*! \details Marks the link as connected to a bootloader with \a attributes.
+	 *
+	 * connect() does this when it finds a bootloader. It is
+	 * available for simulated bootloaders that don't connect.
+	 *
+	 */
+	void set_bootloader_attributes(const bootloader_attr_t & attributes){
+		m_is_bootloader = true;
+		m_bootloader_attributes = attributes;
+	}
 
 private:
 	var::String m_notify_path;
@@ -899,6 +1088,10 @@ private:
 
 	LinkInfo m_link_info;
 	bootloader_attr_t m_bootloader_attributes;
+	UpdateStatistics m_update_statistics;
+	TransferStatistics m_transfer_statistics;
+	u32 m_transfer_page_size_minimum = 1024;
+	u32 m_transfer_page_size_maximum = 64*1024;
 
 	link_transport_mdriver_t m_driver_instance;
 
@@ -914,10 +1107,31 @@ private:
 
 	int install_os(const fs::File & image,
 								 IsVerify is_verify,
+								 HardwareId image_id,
+								 Printer & progress_printer,
+								 IsSkipIfIdentical is_skip_if_identical = IsSkipIfIdentical(false)
+								 );
+
+	int compare_os(const fs::File & image,
 								 HardwareId image_id,
 								 Printer & progress_printer
 								 );
 
+	int copy_file_contents(
+			SourcePath src,
+			DestinationPath dest,
+			const fs::Permissions & permissions,
+			IsCopyToDevice is_to_device,
+			const ProgressCallback * progress_callback
+			);
+
+	int transfer(
+			const fs::File & destination,
+			const fs::File & source,
+			u32 size,
+			const ProgressCallback * progress_callback
+			);
+
 	int check_error(int err);
 	void reset_progress();
 
@@ -170,6 +170,7 @@ public:
 	int unlock();
 
 private:
+	friend class Cond;
 	pthread_mutex_t m_item;
 };
 
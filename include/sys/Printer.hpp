@@ -6,6 +6,7 @@
 #include "../chrono/Timer.hpp"
 #include "../sys/ProgressCallback.hpp"
 #include "../var/String.hpp"
+#include "PrinterSink.hpp"
 
 #if defined __win32
 #undef ERROR
@@ -86,6 +87,13 @@ struct PrinterFlags {
 		level_trace /*! Prints line-by-line tracing (useful only for development). */,
 	};
 
+	/*! \details Defines when buffered output is passed to the sink. */
+	enum flush_modes {
+		flush_newline /*! Flush when a newline is printed or the buffer is full (default) */,
+		flush_size /*! Flush only when the buffer is full */,
+		flush_explicit /*! Flush only when flush() is called (the buffer grows as needed) */
+	};
+
 };
 
 
@@ -124,6 +132,22 @@ private:
  * p.open_object("System Information") << SysInfo::get() << p.close();
  * ```
  *
+ * Output is collected in a buffer and passed to a sys::PrinterSink
+ * in blocks rather than being written (and flushed) one fragment
+ * at a time. By default, the sink is the standard output and the
+ * buffer is flushed at the end of each line. Use set_sink() to send
+ * the output to a file, socket or string.
+ *
+ * ```
+ * //md2code:main
+ * String output;
+ * StringPrinterSink sink(output);
+ * JsonPrinter json;
+ * json.set_sink(sink).set_flush_mode(Printer::flush_size);
+ * json.open_object("System Information") << SysInfo::get() << json.close();
+ * json.flush();
+ * ```
+ *
  */
 class Printer : public api::WorkObject, public PrinterFlags {
 public:
@@ -167,6 +191,50 @@ public:
 	/*! \details Returns the current verbose level. */
 	enum levels verbose_level() const { return m_verbose_level; }
 
+	/*! \details Sets the destination for printed output.
+	 *
+	 * Any buffered output is flushed to the current sink
+	 * before the sink is changed. The sink must remain
+	 * valid for as long as the printer uses it.
+	 *
+	 */
+	Printer & set_sink(PrinterSink & sink);
+
+	/*! \details Sets the destination to the standard output (the default). */
+	Printer & set_standard_output_sink();
+
+	/*! \details Returns a reference to the current sink. */
+	PrinterSink & sink() const { return *m_sink; }
+
+	/*! \details Sets when buffered output is passed to the sink. */
+	Printer & set_flush_mode(enum flush_modes value){
+		m_flush_mode = value;
+		return *this;
+	}
+
+	enum flush_modes flush_mode() const { return m_flush_mode; }
+
+	/*! \details Sets the number of bytes that are buffered
+	 * before output is passed to the sink.
+	 *
+	 * This has no effect when flush_mode() is flush_explicit.
+	 *
+	 */
+	Printer & set_buffer_size(u32 value){
+		m_buffer_size = value;
+		return *this;
+	}
+
+	u32 buffer_size() const { return m_buffer_size; }
+
+	/*! \details Passes any buffered output to the sink and flushes the sink.
+	 *
+	 * @return Zero on success or less than zero if the sink
+	 * could not be written
+	 *
+	 */
+	int flush();
+
 	/*! \cond */
 	virtual Printer & debug(const char * fmt, ...);
 	virtual Printer & message(const char * fmt, ...);
@@ -325,6 +393,9 @@ protected:
 	void print_final_color(enum color_codes code, const char * snippet);
 	virtual void print_final(const char * fmt, ...);
 
+	/*! \details Adds \a size bytes from \a buffer to the output buffer. */
+	void print_final_buffer(const char * buffer, u32 size);
+
 private:
 
 #if defined __win32
@@ -342,10 +413,18 @@ private:
 
 	enum levels m_verbose_level;
 
+	PrinterSink * m_sink;
+	var::String m_output;
+	u32 m_buffer_size;
+	enum flush_modes m_flush_mode;
+
 #if defined __link
 	bool m_is_bash;
 #endif
 
+	static StandardOutputPrinterSink m_standard_output_sink;
+	int write_output();
+
 };
 
 class NullPrinter : public Printer {
@@ -421,6 +500,14 @@ private:
 	Printer & m_printer;
 };
 
+/*! \brief Performance Printer Class
+ * \details Prints the time between construction and destruction.
+ *
+ * The messages are formatted and printed while the code is being
+ * measured. On host builds, SYS_TRACE_SCOPE() (see sys::TraceRecorder)
+ * measures spans with much less overhead.
+ *
+ */
 class PerformancePrinter {
 public:
 	PerformancePrinter(Printer & printer, const char * function, int line)
@@ -0,0 +1,96 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_SYS_PRINTERSINK_HPP_
+#define SAPI_SYS_PRINTERSINK_HPP_
+
+#include "../var/String.hpp"
+
+namespace fs {
+class File;
+}
+
+namespace sys {
+
+/*! \brief Printer Sink Class
+ * \details The PrinterSink class is the destination
+ * for the text that is generated by sys::Printer.
+ *
+ * The printer collects output in a buffer and passes
+ * it to the sink in blocks (see Printer::set_flush_mode()).
+ * Implement write() (and optionally flush()) to send
+ * printer output somewhere new.
+ *
+ */
+class PrinterSink {
+public:
+	virtual ~PrinterSink(){}
+
+	/*! \details Writes \a size bytes from \a buffer.
+	 *
+	 * @return The number of bytes written or less than zero on an error
+	 *
+	 */
+	virtual int write(const char * buffer, u32 size) = 0;
+
+	/*! \details Flushes data that the sink itself has buffered. */
+	virtual int flush(){ return 0; }
+};
+
+/*! \brief Standard Output Printer Sink Class
+ * \details Writes printer output to the standard output.
+ *
+ * This is the default sink for sys::Printer.
+ *
+ */
+class StandardOutputPrinterSink : public PrinterSink {
+public:
+	int write(const char * buffer, u32 size) override;
+	int flush() override;
+};
+
+/*! \brief File Printer Sink Class
+ * \details Writes printer output to a fs::File.
+ *
+ * Any object that inherits fs::File (such as
+ * inet::Socket) can be used as the destination.
+ *
+ * ```
+ * //md2code:main
+ * File f;
+ * f.create("/home/output.json", File::IsOverwrite(true));
+ * FilePrinterSink sink(f);
+ * JsonPrinter p;
+ * p.set_sink(sink);
+ * p.open_object("data") << "value" << p.close();
+ * p.flush();
+ * ```
+ *
+ */
+class FilePrinterSink : public PrinterSink {
+public:
+	explicit FilePrinterSink(const fs::File & file) : m_file(file){}
+	int write(const char * buffer, u32 size) override;
+private:
+	const fs::File & m_file;
+};
+
+/*! \brief String Printer Sink Class
+ * \details Appends printer output to a var::String.
+ *
+ */
+class StringPrinterSink : public PrinterSink {
+public:
+	explicit StringPrinterSink(var::String & string) : m_string(string){}
+	int write(const char * buffer, u32 size) override {
+		m_string.string().append(buffer, size);
+		return static_cast<int>(size);
+	}
+
+	const var::String & string() const { return m_string; }
+
+private:
+	var::String & m_string;
+};
+
+}
+
+#endif // SAPI_SYS_PRINTERSINK_HPP_
@@ -11,6 +11,20 @@
 #include "../chrono/Time.hpp"
 #include "../chrono/MicroTime.hpp"
 
+/*! \details Stack size for the worker threads that the library creates.
+ *
+ * Desktop pthreads reject stacks smaller than PTHREAD_STACK_MIN
+ * (16KB or more), so the 4096 byte default only works on Stratify OS.
+ *
+ */
+#if !defined SAPI_WORKER_THREAD_STACK_SIZE
+#if defined __link
+#define SAPI_WORKER_THREAD_STACK_SIZE (128*1024)
+#else
+#define SAPI_WORKER_THREAD_STACK_SIZE 4096
+#endif
+#endif
+
 namespace sys {
 
 /*! \brief Thread Class
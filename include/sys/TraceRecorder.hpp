@@ -0,0 +1,247 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_SYS_TRACERECORDER_HPP_
+#define SAPI_SYS_TRACERECORDER_HPP_
+
+#include "Trace.hpp"
+
+#if defined __link
+
+#include <atomic>
+#include "../var/Vector.hpp"
+#include "../chrono/Time.hpp"
+
+namespace sys {
+
+/*! \brief Trace Record
+ * \details A TraceRecord is one binary event recorded
+ * by the sys::TraceRecorder. It has a fixed size so
+ * recording an event is a copy into a ring buffer.
+ *
+ */
+struct TraceRecord {
+	/*! \details Record types */
+	enum types {
+		type_begin /*! The start of a span */,
+		type_end /*! The end of a span */,
+		type_instant /*! An event without a duration */,
+		type_counter /*! A value that changes over time (first argument) */
+	};
+
+	u64 timestamp /*! Nanoseconds on the monotonic clock */;
+	u32 thread_id /*! Thread number assigned by the recorder (starting at 1) */;
+	u16 event_id /*! Value returned by TraceRecorder::register_event() */;
+	u8 type /*! The type of record (see types) */;
+	u8 argument_count /*! Number of valid values in argument_list */;
+	s32 argument_list[4];
+};
+
+/*! \brief Trace Argument List Class
+ * \details Holds up to four integer arguments
+ * for a trace record. Any integer type can be passed
+ * (values are stored as s32).
+ *
+ */
+class TraceArgumentList {
+public:
+	template<typename... Arguments> TraceArgumentList(Arguments... arguments){
+		static_assert(sizeof...(Arguments) <= 4, "A trace record has up to 4 arguments");
+		const s32 list[] = { 0, static_cast<s32>(arguments)... };
+		m_count = sizeof...(Arguments);
+		for(u8 i=0; i < m_count; i++){
+			m_list[i] = list[i+1];
+		}
+	}
+
+	u8 count() const { return m_count; }
+	s32 at(u8 position) const { return m_list[position]; }
+
+private:
+	s32 m_list[4];
+	u8 m_count;
+};
+
+/*! \brief Trace Recorder Class
+ * \details The TraceRecorder records binary trace events on
+ * host builds with very little overhead.
+ *
+ * Each thread writes events to its own lock-free ring buffer
+ * (a var::SpscRing). A background thread drains the buffers
+ * into one list. Events are named when exported, not when they
+ * are recorded, so recording an event is a clock read and
+ * a 32-byte copy.
+ *
+ * The recorder is used with macros that do nothing on
+ * Stratify OS builds (which have their own trace system):
+ *
+ * - SYS_TRACE_SCOPE(name, ...) records a span that ends when the scope exits
+ * - SYS_TRACE_INSTANT(name, ...) records a single event
+ * - SYS_TRACE_COUNTER(name, value) records the value of a counter
+ *
+ * Up to four integer arguments can be passed after the name.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * TraceRecorder::start();
+ *
+ * {
+ *   SYS_TRACE_SCOPE("transfer", 1024);
+ *   //code to measure
+ * }
+ *
+ * TraceRecorder::stop();
+ * //open with chrome://tracing or https://ui.perfetto.dev
+ * TraceRecorder::save_chrome_trace("trace.json");
+ * ```
+ *
+ * If a thread records events faster than they are drained, the
+ * new events are dropped and counted (see dropped_count()).
+ *
+ */
+class TraceRecorder {
+public:
+
+	using BufferCount = arg::Argument<u32, struct TraceRecorderBufferCountTag>;
+	using DrainInterval = arg::Argument<const chrono::MicroTime &, struct TraceRecorderDrainIntervalTag>;
+
+	/*! \details Starts recording.
+	 *
+	 * @param buffer_count The number of records each thread can buffer
+	 * @param drain_interval How often the background thread drains the buffers
+	 * @return Zero on success or less than zero if the drain thread couldn't be created
+	 *
+	 * The records from the last recording are cleared. Other
+	 * threads can be recording while start() is called: each thread
+	 * keeps its buffer (it is emptied in place). A buffer is only
+	 * freed by the thread that owns it (if \a buffer_count changes)
+	 * or by start() after that thread has exited.
+	 *
+	 */
+	static int start(
+			BufferCount buffer_count = BufferCount(4096),
+			DrainInterval drain_interval = DrainInterval(chrono::Milliseconds(10))
+			);
+
+	/*! \details Stops recording and drains all the buffers. */
+	static void stop();
+
+	/*! \details Returns true if events are being recorded. */
+	static bool is_active(){
+		return m_is_active.load(std::memory_order_relaxed);
+	}
+
+	/*! \details Returns the id used to record events with \a name.
+	 *
+	 * The macros call this once for each place they are used.
+	 * The same name always gets the same id.
+	 *
+	 */
+	static u16 register_event(const char * name);
+
+	/*! \details Returns the name of the event with \a event_id. */
+	static var::String event_name(u16 event_id);
+
+	/*! \details Records an event for the calling thread.
+	 *
+	 * Nothing is recorded unless the recorder is active.
+	 *
+	 */
+	static void record(
+			enum TraceRecord::types type,
+			u16 event_id,
+			const TraceArgumentList & argument_list
+			){
+		if( is_active() ){
+			record_active(type, event_id, argument_list);
+		}
+	}
+
+	/*! \details Returns the records that have been drained (in order for each thread). */
+	static var::Vector<TraceRecord> record_list();
+
+	/*! \details Returns the number of records that were dropped because a buffer was full. */
+	static u32 dropped_count();
+
+	/*! \details Returns the records in Chrome trace-event JSON format. */
+	static var::String to_chrome_trace();
+
+	/*! \details Saves the records in Chrome trace-event JSON format to \a path. */
+	static int save_chrome_trace(const var::String & path);
+
+	/*! \details Returns the records as sys::TraceEvent objects.
+	 *
+	 * The message of each event is the event name. Spans
+	 * start with '>' and end with '<'. Counters are shown as
+	 * name=value.
+	 *
+	 */
+	static var::Vector<TraceEvent> to_trace_event_list();
+
+private:
+	/*! \cond */
+	static std::atomic<bool> m_is_active;
+	static void record_active(
+			enum TraceRecord::types type,
+			u16 event_id,
+			const TraceArgumentList & argument_list
+			);
+	/*! \endcond */
+};
+
+/*! \brief Trace Scope Class
+ * \details Records the beginning of a span when constructed
+ * and the end of the span when destructed. Use SYS_TRACE_SCOPE()
+ * rather than this class.
+ *
+ */
+class TraceScope {
+public:
+	TraceScope(u16 event_id, const TraceArgumentList & argument_list){
+		m_is_recorded = TraceRecorder::is_active();
+		m_event_id = event_id;
+		if( m_is_recorded ){
+			TraceRecorder::record(TraceRecord::type_begin, event_id, argument_list);
+		}
+	}
+
+	~TraceScope(){
+		if( m_is_recorded ){
+			TraceRecorder::record(TraceRecord::type_end, m_event_id, TraceArgumentList());
+		}
+	}
+
+	TraceScope(const TraceScope & a) = delete;
+	TraceScope & operator=(const TraceScope & a) = delete;
+
+private:
+	u16 m_event_id;
+	bool m_is_recorded;
+};
+
+}
+
+/*! \cond */
+#define SYS_TRACE_CONCAT_(a,b) a##b
+#define SYS_TRACE_CONCAT(a,b) SYS_TRACE_CONCAT_(a,b)
+//each use gets its own static id so the name is only looked up once
+#define SYS_TRACE_EVENT_ID(name) ([](){ static const u16 event_id = sys::TraceRecorder::register_event(name); return event_id; }())
+/*! \endcond */
+
+#define SYS_TRACE_SCOPE(name, ...) sys::TraceScope SYS_TRACE_CONCAT(sys_trace_scope_, __LINE__)(SYS_TRACE_EVENT_ID(name), sys::TraceArgumentList(__VA_ARGS__))
+#define SYS_TRACE_INSTANT(name, ...) sys::TraceRecorder::record(sys::TraceRecord::type_instant, SYS_TRACE_EVENT_ID(name), sys::TraceArgumentList(__VA_ARGS__))
+#define SYS_TRACE_COUNTER(name, value) sys::TraceRecorder::record(sys::TraceRecord::type_counter, SYS_TRACE_EVENT_ID(name), sys::TraceArgumentList(value))
+
+#else
+
+#define SYS_TRACE_SCOPE(name, ...)
+#define SYS_TRACE_INSTANT(name, ...) do {} while(0)
+#define SYS_TRACE_COUNTER(name, value) do {} while(0)
+
+#endif
+
+#endif /* SAPI_SYS_TRACERECORDER_HPP_ */
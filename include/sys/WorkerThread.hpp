@@ -0,0 +1,82 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_SYS_WORKER_THREAD_HPP_
+#define SAPI_SYS_WORKER_THREAD_HPP_
+
+#include "Thread.hpp"
+#include "Mutex.hpp"
+#include "Cond.hpp"
+
+namespace sys {
+
+/*! \brief Worker Thread Class
+ * \details The WorkerThread class owns one joinable thread
+ * that runs functions handed to it with execute(). It is
+ * used to overlap a transfer (such as reading the next page
+ * of a file) with processing without creating a new thread
+ * for each page.
+ *
+ * ```
+ * //md2code:main
+ * //void * read_page(void * args) reads a page in to args
+ * WorkerThread worker;
+ * worker.execute(
+ *   Thread::Function(read_page),
+ *   Thread::FunctionArgument(&next_page)
+ * );
+ * //process the current page while the next one is read
+ * worker.wait();
+ * ```
+ *
+ * If the thread can't be created, execute() calls the function
+ * before returning so the results are the same, just not overlapped.
+ *
+ */
+class WorkerThread : public api::WorkObject {
+public:
+
+	/*! \details Constructs the object and starts the thread. */
+	explicit WorkerThread(
+			Thread::StackSize stack_size = Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE)
+			);
+
+	/*! \details Waits for the current function to complete and joins the thread. */
+	~WorkerThread();
+
+	WorkerThread(const WorkerThread&) = delete;
+	WorkerThread & operator=(const WorkerThread&) = delete;
+
+	/*! \details Returns true if the thread was created. */
+	bool is_running() const { return m_is_running; }
+
+	/*! \details Runs \a function with \a argument in the thread.
+	 *
+	 * If the thread is still running a previous function,
+	 * this method waits for it to complete first.
+	 *
+	 */
+	int execute(
+			Thread::Function function,
+			Thread::FunctionArgument argument = Thread::FunctionArgument(nullptr)
+			);
+
+	/*! \details Waits until the function passed to execute() has returned. */
+	int wait();
+
+private:
+	static void * work(void * args);
+	void * work();
+
+	Mutex m_mutex;
+	Cond m_cond;
+	Thread m_thread;
+	void * (*m_function)(void*) = nullptr;
+	void * m_argument = nullptr;
+	bool m_is_busy = false;
+	bool m_is_stop_requested = false;
+	bool m_is_running = false;
+};
+
+}
+
+#endif /* SAPI_SYS_WORKER_THREAD_HPP_ */
@@ -8,12 +8,18 @@
  *
  * The tests are timed automatically and output
  * a report in various, easily-parsable formats (including JSON).
+ *
+ * The classes that benchmark other modules aren't included
+ * by this header because they depend on those modules. Include
+ * each one from `sapi/test/` when it is needed.
  */
 namespace test{}
 
 #include "test/Function.hpp"
 #include "test/Case.hpp"
 #include "test/Test.hpp"
+#include "test/Benchmark.hpp"
+#include "test/Engine.hpp"
 
 
 using namespace test;
@@ -0,0 +1,102 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_AES_BENCHMARK_HPP_
+#define SAPI_TEST_AES_BENCHMARK_HPP_
+
+#include "../crypto/Aes.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief AES Benchmark Class
+ * \details The AesBenchmark class measures how fast
+ * Aes and AesGcm encrypt and decrypt using test::Benchmark.
+ *
+ * The names start with the key size (for example, "aes128")
+ * followed by the mode: "ecb.encrypt", "ecb.decrypt",
+ * "cbc.encrypt", "cbc.decrypt", "ctr", "gcm.encrypt"
+ * and "gcm.decrypt" (which includes AesGcm::verify()).
+ *
+ * If the system implements the AES API, the modes
+ * are measured again with the built-in implementation
+ * (for example, "aes128.software.ctr") so the two can be
+ * compared. AesGcm always uses the built-in implementation.
+ * On x86 hosts, Aes::is_accelerated() tells if the built-in
+ * results use the AES instructions.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/crypto.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/AesBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * AesBenchmark().set_key_size(32).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class AesBenchmark : public api::WorkObject {
+public:
+
+	AesBenchmark();
+
+	/*! \details Sets the number of bytes encrypted or decrypted
+	 * in each iteration (rounded up to a multiple of 16, default 64KB).
+	 *
+	 */
+	AesBenchmark & set_size(u32 value){
+		m_size = value ? (value + 15) & ~15UL : 16;
+		return *this;
+	}
+
+	/*! \details Sets the key size in bytes (16, 24 or 32; default 16). */
+	AesBenchmark & set_key_size(u32 value){
+		m_key_size = value;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	AesBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 size() const { return m_size; }
+	u32 key_size() const { return m_key_size; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks. */
+	AesBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_size;
+	u32 m_key_size;
+	var::String m_prefix;
+
+	int run_aes(
+			Benchmark & benchmark,
+			enum crypto::Aes::backend backend,
+			const var::String & name,
+			const var::Data & key,
+			const var::Data & plain
+			);
+	int run_gcm(
+			Benchmark & benchmark,
+			const var::String & name,
+			const var::Data & key,
+			const var::Data & plain
+			);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_AES_BENCHMARK_HPP_
@@ -0,0 +1,71 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_BASE64_BENCHMARK_HPP_
+#define SAPI_TEST_BASE64_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Base64 Benchmark Class
+ * \details The Base64Benchmark class measures how fast
+ * Base64 encodes and decodes using test::Benchmark.
+ *
+ * The names are "base64.encode", "base64.decode", "base64.encode.url",
+ * "base64.decode.url", "base64.encode.file" and "base64.decode.file"
+ * (the file variants stream between fs::DataFile objects).
+ * bytes_per_second() is based on the size of the raw (decoded)
+ * data in every case.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/calc.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/Base64Benchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * Base64Benchmark().set_size(64*1024).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class Base64Benchmark : public api::WorkObject {
+public:
+
+	Base64Benchmark();
+
+	/*! \details Sets the number of raw bytes encoded and decoded in each iteration (default 1MB). */
+	Base64Benchmark & set_size(u32 value){
+		m_size = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	Base64Benchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 size() const { return m_size; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks. */
+	Base64Benchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_size;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_BASE64_BENCHMARK_HPP_
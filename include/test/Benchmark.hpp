@@ -0,0 +1,226 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_BENCHMARK_HPP_
+#define SAPI_TEST_BENCHMARK_HPP_
+
+#include <functional>
+#include "../api/WorkObject.hpp"
+#include "../chrono/MicroTime.hpp"
+#include "../var/Json.hpp"
+#include "../var/String.hpp"
+#include "../var/Vector.hpp"
+
+namespace sys {
+class JsonPrinter;
+}
+
+namespace test {
+
+/*! \details Prevents the compiler from optimizing away \a value.
+ *
+ * Use this on the result of the code being measured so
+ * the compiler can't remove the code.
+ *
+ */
+template<typename T> inline void do_not_optimize(const T & value){
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*! \details Prevents the compiler from optimizing away \a value
+ * and from assuming it hasn't changed.
+ */
+template<typename T> inline void do_not_optimize(T & value){
+	asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+/*! \details Forces the compiler to assume all memory
+ * has been read and written (writes can't be removed).
+ */
+inline void clobber_memory(){
+	asm volatile("" : : : "memory");
+}
+
+/*! \brief Benchmark Result Class
+ * \details Holds the statistics of one benchmark. All
+ * times are nanoseconds per iteration.
+ *
+ */
+class BenchmarkResult {
+public:
+
+	const var::String & name() const { return m_name; }
+	/*! \details Returns the number of iterations in each sample. */
+	u32 iteration_count() const { return m_iteration_count; }
+	/*! \details Returns the number of samples. */
+	u32 sample_count() const { return m_sample_count; }
+
+	float minimum() const { return m_minimum; }
+	float median() const { return m_median; }
+	float p99() const { return m_p99; }
+	float mean() const { return m_mean; }
+	float standard_deviation() const { return m_standard_deviation; }
+
+	/*! \details Returns the bytes per second (based on the median) or zero. */
+	float bytes_per_second() const { return m_bytes_per_second; }
+	/*! \details Returns the items per second (based on the median) or zero. */
+	float items_per_second() const { return m_items_per_second; }
+
+	/*! \details Returns the change in heap usage per iteration.
+	 *
+	 * This is only available on Stratify OS (where the heap
+	 * usage is known). It is zero on host builds.
+	 *
+	 */
+	float heap_bytes_per_iteration() const { return m_heap_bytes_per_iteration; }
+
+	/*! \details Returns the median of the baseline (set by Benchmark::compare()) or zero. */
+	float baseline_median() const { return m_baseline_median; }
+	/*! \details Returns true if Benchmark::compare() found the median to be slower than the baseline. */
+	bool is_regression() const { return m_is_regression; }
+
+private:
+	friend class Benchmark;
+	var::String m_name;
+	u32 m_iteration_count = 0;
+	u32 m_sample_count = 0;
+	float m_minimum = 0.0f;
+	float m_median = 0.0f;
+	float m_p99 = 0.0f;
+	float m_mean = 0.0f;
+	float m_standard_deviation = 0.0f;
+	float m_bytes_per_second = 0.0f;
+	float m_items_per_second = 0.0f;
+	float m_heap_bytes_per_iteration = 0.0f;
+	float m_baseline_median = 0.0f;
+	bool m_is_regression = false;
+};
+
+/*! \brief Benchmark Class
+ * \details The Benchmark class measures how long code takes
+ * to run.
+ *
+ * The function being measured is passed the number of iterations to run.
+ * The benchmark first runs the function for the warmup duration
+ * and finds the number of iterations needed for each sample to last
+ * the sample duration. It then takes the samples and calculates
+ * the statistics.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/test.hpp>
+ * #include <sapi/sys.hpp>
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * String source(Data(1024));
+ *
+ * benchmark.run(
+ *   "String::find",
+ *   [&](u32 iterations){
+ *     for(u32 i=0; i < iterations; i++){
+ *       do_not_optimize(source.find("not found"));
+ *     }
+ *   },
+ *   Benchmark::BytesPerIteration(1024)
+ *   );
+ *
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ *
+ * //compare with results that were saved before
+ * JsonObject baseline = JsonDocument().load(
+ *   JsonDocument::FilePath("/home/baseline.json")
+ *   ).to_object();
+ * if( benchmark.compare(baseline) > 0 ){
+ *   printf("regression\n");
+ * }
+ * ```
+ *
+ */
+class Benchmark : public api::WorkObject {
+public:
+
+	using Function = std::function<void(u32 iterations)>;
+	using BytesPerIteration = arg::Argument<u32, struct BenchmarkBytesPerIterationTag>;
+	using ItemsPerIteration = arg::Argument<u64, struct BenchmarkItemsPerIterationTag>;
+	using Threshold = arg::Argument<float, struct BenchmarkThresholdTag>;
+
+	Benchmark();
+
+	/*! \details Sets how long the function runs before samples are taken (default 50ms). */
+	Benchmark & set_warmup_duration(const chrono::MicroTime & value){
+		m_warmup_duration = value.microseconds();
+		return *this;
+	}
+
+	/*! \details Sets the minimum duration of each sample (default 10ms). */
+	Benchmark & set_sample_duration(const chrono::MicroTime & value){
+		m_sample_duration = value.microseconds();
+		return *this;
+	}
+
+	/*! \details Sets the number of samples (default 20). */
+	Benchmark & set_sample_count(u32 value){
+		m_sample_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Measures \a function.
+	 *
+	 * @param name The name of the benchmark (used as the key in the JSON output)
+	 * @param function The code to measure
+	 * @param bytes_per_iteration The number of bytes processed by each iteration (for bytes_per_second())
+	 * @param items_per_iteration The number of items processed by each iteration (for items_per_second())
+	 * @return The result (it is also added to result_list())
+	 *
+	 */
+	const BenchmarkResult & run(
+			const var::String & name,
+			const Function & function,
+			BytesPerIteration bytes_per_iteration = BytesPerIteration(0),
+			ItemsPerIteration items_per_iteration = ItemsPerIteration(0)
+			);
+
+	/*! \details Returns the results of all the benchmarks that have run. */
+	const var::Vector<BenchmarkResult> & result_list() const { return m_result_list; }
+
+	/*! \details Compares the results with a baseline.
+	 *
+	 * @param baseline An object that was saved using print()
+	 * @param threshold How much slower the median can be before it is a regression (0.1 is 10%)
+	 * @return The number of regressions
+	 *
+	 * Benchmarks that are not in the baseline are ignored.
+	 *
+	 */
+	u32 compare(
+			const var::JsonObject & baseline,
+			Threshold threshold = Threshold(0.1f)
+			);
+
+	/*! \details Prints the results as one JSON object with a member
+	 * (keyed by name) for each benchmark.
+	 *
+	 * Inside another object, the results are printed under the
+	 * "benchmarks" key. The output can be saved and loaded later
+	 * as the baseline for compare().
+	 *
+	 */
+	void print(sys::JsonPrinter & printer) const;
+
+private:
+	/*! \cond */
+	u32 m_warmup_duration;
+	u32 m_sample_duration;
+	u32 m_sample_count;
+	var::Vector<BenchmarkResult> m_result_list;
+
+	static u32 measure(const Function & function, u32 iterations);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_BENCHMARK_HPP_
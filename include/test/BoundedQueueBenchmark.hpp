@@ -0,0 +1,89 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_BOUNDED_QUEUE_BENCHMARK_HPP_
+#define SAPI_TEST_BOUNDED_QUEUE_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Bounded Queue Benchmark Class
+ * \details The BoundedQueueBenchmark class measures var::BoundedQueue
+ * under contention using test::Benchmark. For comparison, the same
+ * work is done with a var::Queue that is protected by a sys::Mutex.
+ *
+ * "bounded_queue.threads.1" pushes and pops each item in the calling
+ * thread. For 2, 4, 8 and 16 threads (up to maximum_thread_count()),
+ * half the threads push items and half pop them
+ * ("bounded_queue.threads.N" and "mutex_queue.threads.N").
+ * items_per_second() is the number of items passed through
+ * the queue per second.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/BoundedQueueBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * BoundedQueueBenchmark().set_maximum_thread_count(8).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class BoundedQueueBenchmark : public api::WorkObject {
+public:
+
+	BoundedQueueBenchmark();
+
+	/*! \details Sets the number of items passed through the queue in each iteration (default 65536). */
+	BoundedQueueBenchmark & set_item_count(u32 value){
+		m_item_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the capacity of the bounded queue (default 1024). */
+	BoundedQueueBenchmark & set_capacity(u32 value){
+		m_capacity = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the largest number of threads used (default 16). */
+	BoundedQueueBenchmark & set_maximum_thread_count(u32 value){
+		m_maximum_thread_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	BoundedQueueBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 item_count() const { return m_item_count; }
+	u32 capacity() const { return m_capacity; }
+	u32 maximum_thread_count() const { return m_maximum_thread_count; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks. */
+	BoundedQueueBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_item_count;
+	u32 m_capacity;
+	u32 m_maximum_thread_count;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_BOUNDED_QUEUE_BENCHMARK_HPP_
@@ -0,0 +1,112 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_BUFFERED_FILE_BENCHMARK_HPP_
+#define SAPI_TEST_BUFFERED_FILE_BENCHMARK_HPP_
+
+#include "../fs/File.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Buffered File Benchmark Class
+ * \details The BufferedFileBenchmark class measures how
+ * fast lines are read using File::gets() compared with
+ * BufferedFile::gets() using test::Benchmark.
+ *
+ * Each iteration reads all the lines (CSV style rows
+ * about 30 characters long) so items_per_second() is
+ * lines per second. Each name is the file type, then "gets"
+ * or "buffered.gets", for example "data_file.buffered.gets".
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fs.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/BufferedFileBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * BufferedFileBenchmark file_benchmark;
+ * file_benchmark.run(benchmark);
+ * file_benchmark.run(benchmark, "/home/lines.csv");
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class BufferedFileBenchmark : public api::WorkObject {
+public:
+
+	BufferedFileBenchmark();
+
+	/*! \details Sets the number of lines read by each iteration (default 1000). */
+	BufferedFileBenchmark & set_line_count(u32 value){
+		m_line_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the BufferedFile page size (default SAPI_LINK_DEFAULT_PAGE_SIZE). */
+	BufferedFileBenchmark & set_page_size(u32 value){
+		m_page_size = value ? value : SAPI_LINK_DEFAULT_PAGE_SIZE;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name (for example, "link."). */
+	BufferedFileBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 line_count() const { return m_line_count; }
+	u32 page_size() const { return m_page_size; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks on a DataFile ("data_file.gets"). */
+	BufferedFileBenchmark & run(Benchmark & benchmark);
+
+	/*! \details Runs the benchmarks on a file at \a path ("file.gets").
+	 *
+	 * The file is created (overwriting any existing file),
+	 * read and then removed. On link builds, the file is
+	 * accessed using \a link_driver (so a path on a device
+	 * measures the link protocol).
+	 *
+	 */
+	BufferedFileBenchmark & run(
+			Benchmark & benchmark,
+			const var::String & path
+			SAPI_LINK_DRIVER_NULLPTR_LAST
+			);
+
+	/*! \details Runs the benchmarks on \a file which must
+	 * be open and seekable. The file is read from the beginning
+	 * in each iteration.
+	 *
+	 * @param benchmark The benchmark to add the results to
+	 * @param file The file to read
+	 * @param name The name of the file type used in the benchmark names
+	 *
+	 */
+	BufferedFileBenchmark & run(
+			Benchmark & benchmark,
+			const fs::File & file,
+			const var::String & name
+			);
+
+	/*! \details Returns the lines that are read by the benchmarks. */
+	var::String create_lines() const;
+
+private:
+	/*! \cond */
+	u32 m_line_count;
+	u32 m_page_size;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_BUFFERED_FILE_BENCHMARK_HPP_
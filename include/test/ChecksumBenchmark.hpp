@@ -0,0 +1,70 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_CHECKSUM_BENCHMARK_HPP_
+#define SAPI_TEST_CHECKSUM_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Checksum Benchmark Class
+ * \details The ChecksumBenchmark class measures the throughput
+ * of Crc32, Crc16, Adler32 and the Checksum zero sums
+ * using test::Benchmark.
+ *
+ * The names are "crc32.ieee", "crc32.castagnoli", "crc16.ccitt",
+ * "adler32", "zero_sum.u8" and "zero_sum.u32". bytes_per_second()
+ * is the throughput of each one.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/calc.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/ChecksumBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * ChecksumBenchmark().set_size(4096).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class ChecksumBenchmark : public api::WorkObject {
+public:
+
+	ChecksumBenchmark();
+
+	/*! \details Sets the number of bytes in each calculation (default 64KB). */
+	ChecksumBenchmark & set_size(u32 value){
+		m_size = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	ChecksumBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 size() const { return m_size; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks. */
+	ChecksumBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_size;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_CHECKSUM_BENCHMARK_HPP_
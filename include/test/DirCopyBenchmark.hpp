@@ -0,0 +1,132 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_DIR_COPY_BENCHMARK_HPP_
+#define SAPI_TEST_DIR_COPY_BENCHMARK_HPP_
+
+#include "../chrono/MicroTime.hpp"
+#include "../fs/File.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Directory Copy Benchmark Class
+ * \details The DirCopyBenchmark class measures how fast
+ * fs::DirCopy copies a tree using test::Benchmark.
+ *
+ * The tree below "source" is copied to "host" (and to
+ * "host.threads.N" if thread_count() is more than one) and to "link".
+ * The "link" copy simulates a device: files are copied one at a
+ * time and each file that is created and each page that is
+ * written waits for latency() plus the time to move the page at
+ * bytes_per_second().
+ *
+ * The names are "dir_copy.host", "dir_copy.host.threads.N" and
+ * "dir_copy.link". items_per_second() is files per second and
+ * bytes_per_second() is based on the size of the tree. If
+ * fs::DirCopy::file_count() or fs::DirCopy::bytes() don't match
+ * the tree, the error number is set to EIO.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fs.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/DirCopyBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * DirCopyBenchmark dir_copy_benchmark;
+ * dir_copy_benchmark.set_file_count(100).set_file_size(16*1024);
+ * dir_copy_benchmark.create_tree("/home/copy");
+ *
+ * Benchmark benchmark;
+ * dir_copy_benchmark.run(benchmark, "/home/copy");
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class DirCopyBenchmark : public api::WorkObject {
+public:
+
+	DirCopyBenchmark();
+
+	/*! \details Sets the number of files created by create_tree() (default 100). */
+	DirCopyBenchmark & set_file_count(u32 value){
+		m_file_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the size of each file created by create_tree() (default 16KB). */
+	DirCopyBenchmark & set_file_size(u32 value){
+		m_file_size = value;
+		return *this;
+	}
+
+	/*! \details Sets the number of threads used by the threaded host copy (default 4). */
+	DirCopyBenchmark & set_thread_count(u32 value){
+		m_thread_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the round trip time of each simulated link request (default 1ms). */
+	DirCopyBenchmark & set_latency(const chrono::MicroTime & value){
+		m_latency = value;
+		return *this;
+	}
+
+	/*! \details Sets the throughput of the simulated link (default 1000000 bytes per second). */
+	DirCopyBenchmark & set_bytes_per_second(u32 value){
+		m_bytes_per_second = value;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	DirCopyBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 file_count() const { return m_file_count; }
+	u32 file_size() const { return m_file_size; }
+	u32 thread_count() const { return m_thread_count; }
+	const chrono::MicroTime & latency() const { return m_latency; }
+	u32 bytes_per_second() const { return m_bytes_per_second; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Creates the tree that is copied below \a path.
+	 *
+	 * The files are in "source" below \a path
+	 * in directories of up to 10 files.
+	 *
+	 * @return Zero on success
+	 *
+	 */
+	int create_tree(const var::String & path);
+
+	/*! \details Runs the benchmarks on the tree below \a path.
+	 *
+	 * create_tree() must be called first. The copies are left
+	 * below \a path.
+	 *
+	 */
+	DirCopyBenchmark & run(
+			Benchmark & benchmark,
+			const var::String & path
+			);
+
+private:
+	/*! \cond */
+	u32 m_file_count;
+	u32 m_file_size;
+	u32 m_thread_count;
+	chrono::MicroTime m_latency;
+	u32 m_bytes_per_second;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_DIR_COPY_BENCHMARK_HPP_
@@ -0,0 +1,104 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_DIR_WALKER_BENCHMARK_HPP_
+#define SAPI_TEST_DIR_WALKER_BENCHMARK_HPP_
+
+#include "../fs/File.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Directory Walker Benchmark Class
+ * \details The DirWalkerBenchmark class measures how long
+ * fs::DirWalker takes to visit every entry in a tree compared
+ * with the recursive Dir::read_list() using test::Benchmark.
+ *
+ * The names are "dir.read_list", "dir_walker" and (if thread_count()
+ * is more than one) "dir_walker.threads.N". items_per_second()
+ * is entries per second.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fs.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/DirWalkerBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * DirWalkerBenchmark walker_benchmark;
+ * //100 directories with 1000 files each
+ * walker_benchmark.create_tree("/home/tree", 100000);
+ *
+ * Benchmark benchmark;
+ * benchmark.set_sample_count(5);
+ * walker_benchmark.set_thread_count(4).run(benchmark, "/home/tree");
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class DirWalkerBenchmark : public api::WorkObject {
+public:
+
+	DirWalkerBenchmark();
+
+	/*! \details Sets the number of threads used by the threaded walk (default 4). */
+	DirWalkerBenchmark & set_thread_count(u32 value){
+		m_thread_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the number of files in each directory created by create_tree() (default 1000). */
+	DirWalkerBenchmark & set_files_per_directory(u32 value){
+		m_files_per_directory = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	DirWalkerBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 thread_count() const { return m_thread_count; }
+	u32 files_per_directory() const { return m_files_per_directory; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Creates a tree of \a file_count empty files below \a path.
+	 *
+	 * The files are in directories of files_per_directory()
+	 * files which are grouped ten to a parent directory.
+	 *
+	 * @return Zero on success
+	 *
+	 */
+	int create_tree(
+			const var::String & path,
+			u32 file_count
+			SAPI_LINK_DRIVER_NULLPTR_LAST
+			);
+
+	/*! \details Runs the benchmarks on the tree below \a path.
+	 *
+	 * The tree isn't changed.
+	 *
+	 */
+	DirWalkerBenchmark & run(
+			Benchmark & benchmark,
+			const var::String & path
+			SAPI_LINK_DRIVER_NULLPTR_LAST
+			);
+
+private:
+	/*! \cond */
+	u32 m_thread_count;
+	u32 m_files_per_directory;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_DIR_WALKER_BENCHMARK_HPP_
@@ -0,0 +1,91 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_DSP_KERNEL_BENCHMARK_HPP_
+#define SAPI_TEST_DSP_KERNEL_BENCHMARK_HPP_
+
+#include "../api/DspObject.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief DSP Kernel Benchmark Class
+ * \details The DspKernelBenchmark class measures the DSP
+ * functions (element-wise operations, statistics, convolution, filters and FFTs)
+ * using test::Benchmark.
+ *
+ * The benchmarks are built with the host backend (link builds).
+ * The dsp module, and this class, aren't part of the Stratify OS
+ * library build, so device results are only available if an
+ * application builds the dsp sources with the CMSIS DSP library.
+ * Each name is the type followed by the function, for example
+ * "q15.add", "q31.fir.32" or "f32.rfft.1024".
+ *
+ * "q15.expression" calculates `(a * gain + b) >> 2` using the
+ * signal operators (see dsp::SignalExpression) and "q15.expression.eager"
+ * calculates the same value using multiply(), add() and shift()
+ * (which allocate a new signal for each step).
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/dsp.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/DspKernelBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * DspKernelBenchmark().set_sample_count(1024).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class DspKernelBenchmark : public api::DspWorkObject {
+public:
+
+	DspKernelBenchmark();
+
+	/*! \details Sets the number of samples each function processes (default 1024).
+	 *
+	 * The FFTs always use 1024 samples.
+	 *
+	 */
+	DspKernelBenchmark & set_sample_count(u32 value){
+		m_sample_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name (for example, "avx2."). */
+	DspKernelBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 sample_count() const { return m_sample_count; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the q15, q31 and f32 benchmarks. */
+	DspKernelBenchmark & run(Benchmark & benchmark);
+
+	/*! \details Runs the q15 benchmarks. */
+	DspKernelBenchmark & run_q15(Benchmark & benchmark);
+	/*! \details Runs the q31 benchmarks. */
+	DspKernelBenchmark & run_q31(Benchmark & benchmark);
+	/*! \details Runs the f32 benchmarks. */
+	DspKernelBenchmark & run_f32(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_sample_count;
+	var::String m_prefix;
+
+	var::String name(const char * value) const;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_DSP_KERNEL_BENCHMARK_HPP_
@@ -2,24 +2,185 @@
 #ifndef SAPI_TEST_ENGINE_HPP_
 #define SAPI_TEST_ENGINE_HPP_
 
-/*! \cond */
-
+#include <functional>
 #include "Test.hpp"
-#include "../var/Queue.hpp"
+#include "../var/Vector.hpp"
 
 namespace test {
 
-class Engine : public var::Queue<Test*> {
+/*! \brief Engine Case Result Class
+ * \details Holds the result and duration of one
+ * case executed by the test::Engine.
+ *
+ */
+class EngineCaseResult {
+public:
+
+	/*! \details Returns the name of the test that has the case. */
+	const var::String & test_name() const { return m_test_name; }
+	/*! \details Returns the name of the case. */
+	const var::String & name() const { return m_name; }
+	/*! \details Returns the wall-clock duration of the case. */
+	u32 microseconds() const { return m_microseconds; }
+	bool result() const { return m_result; }
+	/*! \details Returns true if the case was stopped because it took too long. */
+	bool is_timed_out() const { return m_is_timed_out; }
+
+private:
+	friend class Engine;
+	var::String m_test_name;
+	var::String m_name;
+	u32 m_microseconds = 0;
+	bool m_result = false;
+	bool m_is_timed_out = false;
+};
+
+/*! \brief Engine Class
+ * \details The Engine class executes a list of tests and
+ * merges the results into a single report.
+ *
+ * On host builds (except windows), each test runs in its own worker
+ * process and up to worker_count() tests run at the same time.
+ * A test that crashes only fails itself, and a case that runs
+ * longer than the case timeout is stopped (and fails). The
+ * report of each test is printed in the order the tests
+ * were added no matter which one finishes first.
+ *
+ * On Stratify OS, the tests run one at a time in the calling thread
+ * and the case timeout is not enforced.
+ *
+ * Tests are added as functions that create the test (rather than as
+ * test objects) because a test starts printing its report
+ * when it is constructed.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/test.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Test::initialize(Test::Name("unit"), Test::Version("1.0"));
+ *
+ * Engine engine;
+ * engine.set_case_timeout(Seconds(30))
+ *   .add("StringTest", [](){ return new StringTest(); })
+ *   .add("DataTest", [](){ return new DataTest(); });
+ *
+ * engine.execute(Test::execute_api | Test::execute_stress);
+ *
+ * //slowest cases first
+ * for(const EngineCaseResult & result: engine.case_result_list()){
+ *   printf("%s.%s: %ld\n", result.test_name().cstring(), result.name().cstring(), result.microseconds());
+ * }
+ *
+ * Test::finalize();
+ * ```
+ *
+ */
+class Engine : public api::WorkObject {
 public:
+
+	/*! \details Creates a test (the engine deletes it when it is done). */
+	using Factory = std::function<Test*()>;
+
 	Engine();
 
+	/*! \details Adds a test to execute.
+	 *
+	 * @param name The name of the test (used in the report if the test crashes)
+	 * @param factory Function that creates the test
+	 *
+	 */
+	Engine & add(const var::String & name, Factory factory);
 
+	/*! \details Sets the number of tests that run at the same time
+	 * (default is the number of processors).
+	 *
+	 * When performance cases are executed (Test::execute_performance),
+	 * one test runs at a time so the measurements aren't
+	 * skewed by other workers.
+	 *
+	 */
+	Engine & set_worker_count(u32 value){
+		m_worker_count = value ? value : 1;
+		return *this;
+	}
 
-};
+	/*! \details Sets the maximum duration of each case (default is no timeout). */
+	Engine & set_case_timeout(const chrono::MicroTime & value){
+		m_case_timeout = value.microseconds();
+		return *this;
+	}
 
-}
+	u32 worker_count() const { return m_worker_count; }
+	u32 case_timeout() const { return m_case_timeout; }
+
+	/*! \details Executes the tests.
+	 *
+	 * @param o_flags Which cases to execute (see Test::test_flags)
+	 * @return The number of tests that failed
+	 *
+	 */
+	u32 execute(u32 o_flags = Test::execute_all);
 
-/*! \endcond */
+	/*! \details Executes the tests using the options from \a cli.
+	 *
+	 * The execution flags are parsed using Test::parse_execution_flags().
+	 * The `workers` option sets the worker count and the `timeout`
+	 * option sets the case timeout in milliseconds.
+	 *
+	 */
+	u32 execute(const sys::Cli & cli);
 
+	/*! \details Returns the results of the cases that have
+	 * executed sorted with the slowest case first.
+	 */
+	const var::Vector<EngineCaseResult> & case_result_list() const {
+		return m_case_result_list;
+	}
+
+private:
+	/*! \cond */
+	friend class Test;
+
+	struct Entry {
+		var::String name;
+		Factory factory;
+	};
+
+	struct Worker;
+
+	var::Vector<Entry> m_entry_list;
+	var::Vector<EngineCaseResult> m_case_result_list;
+	u32 m_worker_count;
+	u32 m_case_timeout;
+	int m_status_fd;
+	const Entry * m_entry;
+
+	static Engine * m_active;
+
+	void case_opened(const Test & test, const var::String & case_name);
+	void case_closed(
+			const Test & test,
+			const var::String & case_name,
+			bool result,
+			u32 microseconds
+			);
+	void send_message(u8 type, bool result, u32 microseconds, const var::String & name);
+
+	bool execute_entry(const Entry & entry, u32 o_flags, u32 & microseconds);
+	u32 execute_serially(u32 o_flags);
+	u32 execute_workers(u32 o_flags);
+	int start_worker(Worker & worker, u32 o_flags);
+	int read_worker(Worker & worker, int fd);
+	void receive_message(Worker & worker);
+	bool finish_worker(Worker & worker);
+	void print_case_durations();
+	/*! \endcond */
+};
+
+}
 
 #endif // SAPI_TEST_ENGINE_HPP_
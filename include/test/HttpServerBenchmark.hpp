@@ -0,0 +1,128 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_HTTP_SERVER_BENCHMARK_HPP_
+#define SAPI_TEST_HTTP_SERVER_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+#include "../var/Vector.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief HTTP Server Latency Class
+ * \details Holds the request latency (in microseconds) that
+ * test::HttpServerBenchmark measured at one concurrency level.
+ *
+ */
+class HttpServerLatency {
+public:
+
+	/*! \details Returns the number of clients that sent requests at the same time. */
+	u32 concurrency() const { return m_concurrency; }
+	/*! \details Returns the number of requests that were measured. */
+	u32 request_count() const { return m_request_count; }
+
+	u32 minimum() const { return m_minimum; }
+	u32 median() const { return m_median; }
+	u32 p99() const { return m_p99; }
+	u32 maximum() const { return m_maximum; }
+
+private:
+	friend class HttpServerBenchmark;
+	u32 m_concurrency = 0;
+	u32 m_request_count = 0;
+	u32 m_minimum = 0;
+	u32 m_median = 0;
+	u32 m_p99 = 0;
+	u32 m_maximum = 0;
+};
+
+/*! \brief HTTP Server Benchmark Class
+ * \details The HttpServerBenchmark class measures inet::HttpServer
+ * over the loopback interface using test::Benchmark.
+ *
+ * The server is started on 127.0.0.1 with one worker for each
+ * client (each worker serves one connection at a time). For 1, 2, 4, 8
+ * and 16 clients (up to maximum_concurrency()), each client opens a
+ * keep-alive connection and sends GET requests one after another
+ * ("http_server.concurrency.N"). An iteration is one request from each
+ * client so items_per_second() is the number of requests per second.
+ *
+ * The time of every request (from writing the request to reading the
+ * last byte of the response) is kept. The latency at each concurrency
+ * level, including the p99, is available from latency_list().
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/HttpServerBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * HttpServerBenchmark http_server_benchmark;
+ * http_server_benchmark.set_maximum_concurrency(8).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * for(const auto & latency: http_server_benchmark.latency_list()){
+ *   printf("%ld clients: p99 %ldus\n", latency.concurrency(), latency.p99());
+ * }
+ * ```
+ *
+ */
+class HttpServerBenchmark : public api::WorkObject {
+public:
+
+	HttpServerBenchmark();
+
+	/*! \details Sets the port the server listens on (default 8090). */
+	HttpServerBenchmark & set_port(u16 value){
+		m_port = value;
+		return *this;
+	}
+
+	/*! \details Sets the size of each response body (default 128 bytes). */
+	HttpServerBenchmark & set_response_size(u32 value){
+		m_response_size = value;
+		return *this;
+	}
+
+	/*! \details Sets the largest number of clients (default 16). */
+	HttpServerBenchmark & set_maximum_concurrency(u32 value){
+		m_maximum_concurrency = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	HttpServerBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u16 port() const { return m_port; }
+	u32 response_size() const { return m_response_size; }
+	u32 maximum_concurrency() const { return m_maximum_concurrency; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Returns the latency at each concurrency level from the last run. */
+	const var::Vector<HttpServerLatency> & latency_list() const { return m_latency_list; }
+
+	/*! \details Runs the benchmarks. */
+	HttpServerBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u16 m_port;
+	u32 m_response_size;
+	u32 m_maximum_concurrency;
+	var::String m_prefix;
+	var::Vector<HttpServerLatency> m_latency_list;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_HTTP_SERVER_BENCHMARK_HPP_
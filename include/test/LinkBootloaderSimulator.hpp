@@ -0,0 +1,141 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_LINK_BOOTLOADER_SIMULATOR_HPP_
+#define SAPI_TEST_LINK_BOOTLOADER_SIMULATOR_HPP_
+
+#if defined __link
+
+#include "../chrono/MicroTime.hpp"
+#include "../sys/Link.hpp"
+#include "../var/Data.hpp"
+
+namespace test {
+
+/*! \brief Link Bootloader Simulator Class
+ * \details The LinkBootloaderSimulator class is a sys::Link
+ * that is connected to a simulated bootloader instead of a device. It
+ * is used to measure sys::Link::update_os() without hardware.
+ *
+ * The flash is kept in memory and starts at address zero. Writes can only
+ * clear bits (like flash) so a page that wasn't erased can't be written.
+ * Each request (read, write, erase or reading the attributes) waits for
+ * latency() plus the time to move its data at bytes_per_second().
+ *
+ * The simulator counts the requests and the bytes that
+ * crossed the simulated link. Like sys::Link, this class is
+ * only available on link builds.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/sys.hpp>
+ * #include <sapi/fs.hpp>
+ * #include <sapi/test/LinkBootloaderSimulator.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * LinkBootloaderSimulator link(
+ *   LinkBootloaderSimulator::FlashSize(256*1024),
+ *   LinkBootloaderSimulator::HardwareId(0x00000001)
+ *   );
+ * link.set_latency(Microseconds(1000));
+ * File image;
+ * image.open("/home/os.bin", OpenFlags::read_only());
+ * Printer printer;
+ * link.update_os(
+ *   image,
+ *   Link::IsVerify(false),
+ *   printer,
+ *   Link::BootloaderRetryCount(1),
+ *   Link::IsSkipIfIdentical(true)
+ *   );
+ * printf("%ld bytes transferred\n", link.bytes_transferred());
+ * ```
+ *
+ */
+class LinkBootloaderSimulator : public sys::Link {
+public:
+
+	using FlashSize = arg::Argument<u32, struct LinkBootloaderSimulatorFlashSizeTag>;
+
+	LinkBootloaderSimulator(
+			FlashSize flash_size,
+			HardwareId hardware_id
+			);
+
+	/*! \details Sets the round trip time of each request (default 0). */
+	LinkBootloaderSimulator & set_latency(const chrono::MicroTime & value){
+		m_latency = value;
+		return *this;
+	}
+
+	/*! \details Sets the throughput of the link (default 1000000 bytes per second).
+	 *
+	 * Zero means the data takes no time to move.
+	 *
+	 */
+	LinkBootloaderSimulator & set_bytes_per_second(u32 value){
+		m_bytes_per_second = value;
+		return *this;
+	}
+
+	const chrono::MicroTime & latency() const { return m_latency; }
+	u32 bytes_per_second() const { return m_bytes_per_second; }
+
+	/*! \details Returns the simulated flash.
+	 *
+	 * The flash can be changed directly (for example, to install an
+	 * older image) without counting as link traffic.
+	 *
+	 */
+	var::Data & flash(){ return m_flash; }
+	const var::Data & flash() const { return m_flash; }
+
+	/*! \details Returns the number of requests since the last reset_statistics(). */
+	u32 request_count() const { return m_request_count; }
+	/*! \details Returns the number of flash bytes read over the link. */
+	u32 bytes_read() const { return m_bytes_read; }
+	/*! \details Returns the number of flash bytes written over the link. */
+	u32 bytes_written() const { return m_bytes_written; }
+	/*! \details Returns the number of times the flash was erased. */
+	u32 erase_count() const { return m_erase_count; }
+	u32 bytes_transferred() const { return m_bytes_read + m_bytes_written; }
+
+	/*! \details Clears the request and byte counts. */
+	void reset_statistics(){
+		m_request_count = 0;
+		m_bytes_read = 0;
+		m_bytes_written = 0;
+		m_erase_count = 0;
+	}
+
+protected:
+	int read_bootloader_flash(u32 address, void * buffer, u32 size) override;
+	int write_bootloader_flash(u32 address, const void * buffer, u32 size) override;
+	int erase_bootloader_flash() override;
+	int wait_for_bootloader(
+			BootloaderRetryCount bootloader_retry_total,
+			const sys::ProgressCallback * progress_callback
+			) override;
+	int read_bootloader_attributes(bootloader_attr_t & attributes) override;
+
+private:
+	/*! \cond */
+	var::Data m_flash;
+	bootloader_attr_t m_attributes;
+	chrono::MicroTime m_latency;
+	u32 m_bytes_per_second = 1000000;
+	u32 m_request_count = 0;
+	u32 m_bytes_read = 0;
+	u32 m_bytes_written = 0;
+	u32 m_erase_count = 0;
+
+	void wait_for_request(u32 size);
+	bool is_in_flash(u32 address, u32 size) const;
+	/*! \endcond */
+};
+
+}
+
+#endif
+
+#endif // SAPI_TEST_LINK_BOOTLOADER_SIMULATOR_HPP_
@@ -0,0 +1,113 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_LINK_FILE_SIMULATOR_HPP_
+#define SAPI_TEST_LINK_FILE_SIMULATOR_HPP_
+
+#if defined __link
+
+#include "../chrono/MicroTime.hpp"
+#include "../fs/File.hpp"
+
+namespace test {
+
+/*! \brief Link File Simulator Class
+ * \details The LinkFileSimulator class is a fs::DataFile
+ * that acts like a file on a device that is connected
+ * with sys::Link. It is used to measure sys::Link::copy() without hardware.
+ *
+ * Each read() or write() is one link request. It waits for
+ * latency() plus the time to move its data at bytes_per_second()
+ * so larger pages pay the round trip cost less often.
+ *
+ * Like sys::Link, this class is only available on link builds.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/sys.hpp>
+ * #include <sapi/fs.hpp>
+ * #include <sapi/test/LinkFileSimulator.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * LinkFileSimulator device_file;
+ * device_file.set_latency(Microseconds(1000));
+ * DataFile host_file;
+ * host_file.data().resize(256*1024);
+ * Link link;
+ * link.copy(
+ *   Link::SourceFile(host_file),
+ *   Link::DestinationFile(device_file)
+ *   );
+ * printf("%ld requests at %0.2f MB/s\n",
+ *   device_file.request_count(),
+ *   link.transfer_statistics().mb_per_second()
+ *   );
+ * ```
+ *
+ */
+class LinkFileSimulator : public fs::DataFile {
+public:
+
+	LinkFileSimulator(
+			const fs::OpenFlags & flags = fs::OpenFlags::read_write()
+			);
+
+	/*! \details Sets the round trip time of each request (default 0). */
+	LinkFileSimulator & set_latency(const chrono::MicroTime & value){
+		m_latency = value;
+		return *this;
+	}
+
+	/*! \details Sets the throughput of the link (default 1000000 bytes per second).
+	 *
+	 * Zero means the data takes no time to move.
+	 *
+	 */
+	LinkFileSimulator & set_bytes_per_second(u32 value){
+		m_bytes_per_second = value;
+		return *this;
+	}
+
+	const chrono::MicroTime & latency() const { return m_latency; }
+	u32 bytes_per_second() const { return m_bytes_per_second; }
+
+	/*! \details Returns the number of requests since the last reset_statistics(). */
+	u32 request_count() const { return m_request_count; }
+	/*! \details Returns the number of bytes that crossed the simulated link. */
+	u32 bytes_transferred() const { return m_bytes_transferred; }
+
+	/*! \details Clears the request and byte counts. */
+	void reset_statistics(){
+		m_request_count = 0;
+		m_bytes_transferred = 0;
+	}
+
+	int read(
+			void * buf,
+			Size nbyte
+			) const override;
+
+	int write(
+			const void * buf,
+			Size nbyte
+			) const override;
+
+	using File::read;
+	using File::write;
+
+private:
+	/*! \cond */
+	chrono::MicroTime m_latency;
+	u32 m_bytes_per_second = 1000000;
+	mutable u32 m_request_count = 0;
+	mutable u32 m_bytes_transferred = 0;
+
+	void wait_for_request(u32 size) const;
+	/*! \endcond */
+};
+
+}
+
+#endif
+
+#endif // SAPI_TEST_LINK_FILE_SIMULATOR_HPP_
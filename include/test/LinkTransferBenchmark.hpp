@@ -0,0 +1,118 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_LINK_TRANSFER_BENCHMARK_HPP_
+#define SAPI_TEST_LINK_TRANSFER_BENCHMARK_HPP_
+
+#if defined __link
+
+#include "../api/WorkObject.hpp"
+#include "../chrono/MicroTime.hpp"
+#include "../sys/Link.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Link Transfer Benchmark Class
+ * \details The LinkTransferBenchmark class measures
+ * sys::Link::copy() between a host file and a test::LinkFileSimulator
+ * using test::Benchmark.
+ *
+ * Each direction is measured twice:
+ *
+ * - "fixed" uses one page size (the minimum of the range)
+ * - "adaptive" uses the page size range of sys::Link::set_transfer_page_size_range()
+ *
+ * The names are "link_transfer.to_device.fixed", "link_transfer.to_device.adaptive",
+ * "link_transfer.from_device.fixed" and "link_transfer.from_device.adaptive".
+ * bytes_per_second() is based on the size of the file. The
+ * sys::Link::TransferStatistics of the last adaptive copy in each
+ * direction show the page size that was reached.
+ *
+ * Like sys::Link, this class is only available on link builds.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/LinkTransferBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * LinkTransferBenchmark link_transfer_benchmark;
+ * link_transfer_benchmark.set_latency(Microseconds(500)).run(benchmark);
+ * printf("page size is %ld\n",
+ *   link_transfer_benchmark.to_device_statistics().page_size()
+ *   );
+ * ```
+ *
+ */
+class LinkTransferBenchmark : public api::WorkObject {
+public:
+
+	LinkTransferBenchmark();
+
+	/*! \details Sets the size of the file (default 256KB). */
+	LinkTransferBenchmark & set_file_size(u32 value){
+		m_file_size = value;
+		return *this;
+	}
+
+	/*! \details Sets the round trip time of each simulated request (default 1ms). */
+	LinkTransferBenchmark & set_latency(const chrono::MicroTime & value){
+		m_latency = value;
+		return *this;
+	}
+
+	/*! \details Sets the throughput of the simulated link (default 1000000 bytes per second). */
+	LinkTransferBenchmark & set_bytes_per_second(u32 value){
+		m_bytes_per_second = value;
+		return *this;
+	}
+
+	/*! \details Sets the range of page sizes (default 1KB to 64KB). */
+	LinkTransferBenchmark & set_page_size_range(u32 minimum, u32 maximum){
+		m_page_size_minimum = minimum;
+		m_page_size_maximum = maximum > minimum ? maximum : minimum;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	LinkTransferBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 file_size() const { return m_file_size; }
+	const chrono::MicroTime & latency() const { return m_latency; }
+	u32 bytes_per_second() const { return m_bytes_per_second; }
+	u32 page_size_minimum() const { return m_page_size_minimum; }
+	u32 page_size_maximum() const { return m_page_size_maximum; }
+	const var::String & prefix() const { return m_prefix; }
+
+	const sys::Link::TransferStatistics & to_device_statistics() const { return m_to_device_statistics; }
+	const sys::Link::TransferStatistics & from_device_statistics() const { return m_from_device_statistics; }
+
+	/*! \details Runs the benchmarks. */
+	LinkTransferBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_file_size;
+	chrono::MicroTime m_latency;
+	u32 m_bytes_per_second;
+	u32 m_page_size_minimum;
+	u32 m_page_size_maximum;
+	var::String m_prefix;
+	sys::Link::TransferStatistics m_to_device_statistics;
+	sys::Link::TransferStatistics m_from_device_statistics;
+	/*! \endcond */
+};
+
+}
+
+#endif
+
+#endif // SAPI_TEST_LINK_TRANSFER_BENCHMARK_HPP_
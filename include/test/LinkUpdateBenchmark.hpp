@@ -0,0 +1,118 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_LINK_UPDATE_BENCHMARK_HPP_
+#define SAPI_TEST_LINK_UPDATE_BENCHMARK_HPP_
+
+#if defined __link
+
+#include "../api/WorkObject.hpp"
+#include "../chrono/MicroTime.hpp"
+#include "../sys/Link.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Link Update Benchmark Class
+ * \details The LinkUpdateBenchmark class measures
+ * sys::Link::update_os() against a test::LinkBootloaderSimulator
+ * using test::Benchmark.
+ *
+ * The image has data in the first three quarters and is
+ * erased (0xFF) in the last quarter.
+ *
+ * - "link_update.full" installs the image without comparing
+ * - "link_update.skip_if_identical.same" finds the image is already installed
+ * - "link_update.skip_if_identical.changed" finds that the last page with data
+ * changed (so the comparison reads almost all of the image and then the OS is installed)
+ *
+ * bytes_per_second() is based on the size of the image. The
+ * sys::Link::UpdateStatistics of the last update in each benchmark show
+ * the bytes that were transferred and skipped.
+ *
+ * Like sys::Link, this class is only available on link builds.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/LinkUpdateBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * LinkUpdateBenchmark link_update_benchmark;
+ * link_update_benchmark.set_latency(Microseconds(500)).run(benchmark);
+ * printf("%ld bytes skipped\n",
+ *   link_update_benchmark.same_statistics().bytes_skipped()
+ *   );
+ * ```
+ *
+ */
+class LinkUpdateBenchmark : public api::WorkObject {
+public:
+
+	LinkUpdateBenchmark();
+
+	/*! \details Sets the size of the image (default 64KB). */
+	LinkUpdateBenchmark & set_image_size(u32 value){
+		m_image_size = value;
+		return *this;
+	}
+
+	/*! \details Sets the round trip time of each simulated request (default 1ms). */
+	LinkUpdateBenchmark & set_latency(const chrono::MicroTime & value){
+		m_latency = value;
+		return *this;
+	}
+
+	/*! \details Sets the throughput of the simulated link (default 1000000 bytes per second). */
+	LinkUpdateBenchmark & set_bytes_per_second(u32 value){
+		m_bytes_per_second = value;
+		return *this;
+	}
+
+	/*! \details Reads the image back after it is installed (default false). */
+	LinkUpdateBenchmark & set_verify(bool value = true){
+		m_is_verify = value;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	LinkUpdateBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 image_size() const { return m_image_size; }
+	const chrono::MicroTime & latency() const { return m_latency; }
+	u32 bytes_per_second() const { return m_bytes_per_second; }
+	bool is_verify() const { return m_is_verify; }
+	const var::String & prefix() const { return m_prefix; }
+
+	const sys::Link::UpdateStatistics & full_statistics() const { return m_full_statistics; }
+	const sys::Link::UpdateStatistics & same_statistics() const { return m_same_statistics; }
+	const sys::Link::UpdateStatistics & changed_statistics() const { return m_changed_statistics; }
+
+	/*! \details Runs the benchmarks. */
+	LinkUpdateBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_image_size;
+	chrono::MicroTime m_latency;
+	u32 m_bytes_per_second;
+	bool m_is_verify;
+	var::String m_prefix;
+	sys::Link::UpdateStatistics m_full_statistics;
+	sys::Link::UpdateStatistics m_same_statistics;
+	sys::Link::UpdateStatistics m_changed_statistics;
+	/*! \endcond */
+};
+
+}
+
+#endif
+
+#endif // SAPI_TEST_LINK_UPDATE_BENCHMARK_HPP_
@@ -0,0 +1,92 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_MATRIX_BENCHMARK_HPP_
+#define SAPI_TEST_MATRIX_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+
+#if defined __link
+#define SAPI_MATRIX_BENCHMARK_MAXIMUM_SIZE 2048
+#else
+#define SAPI_MATRIX_BENCHMARK_MAXIMUM_SIZE 64
+#endif
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Matrix Benchmark Class
+ * \details The MatrixBenchmark class measures Matrix::multiply()
+ * and Matrix::transpose() on square float and double
+ * matrices using test::Benchmark.
+ *
+ * The size starts at minimum_size() and doubles up to
+ * maximum_size(). The names are the type, the operation and
+ * the size, for example "matrix.float.multiply.256" and
+ * "matrix.double.transpose.256".
+ *
+ * For multiply, items_per_second() is floating point operations
+ * per second (2 * n^3 for each product). For transpose, bytes_per_second()
+ * counts both the bytes read and the bytes written.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/MatrixBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * MatrixBenchmark().set_maximum_size(512).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class MatrixBenchmark : public api::WorkObject {
+public:
+
+	MatrixBenchmark();
+
+	/*! \details Sets the smallest number of rows and columns (default 64). */
+	MatrixBenchmark & set_minimum_size(u32 value){
+		m_minimum_size = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the largest number of rows and columns
+	 * (default 2048 on link builds and 64 on Stratify OS).
+	 *
+	 */
+	MatrixBenchmark & set_maximum_size(u32 value){
+		m_maximum_size = value;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	MatrixBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 minimum_size() const { return m_minimum_size; }
+	u32 maximum_size() const { return m_maximum_size; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks (three matrices of each size are allocated). */
+	MatrixBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_minimum_size;
+	u32 m_maximum_size;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_MATRIX_BENCHMARK_HPP_
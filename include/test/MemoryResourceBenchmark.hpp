@@ -0,0 +1,85 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_MEMORY_RESOURCE_BENCHMARK_HPP_
+#define SAPI_TEST_MEMORY_RESOURCE_BENCHMARK_HPP_
+
+#include "../var/MemoryResource.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Memory Resource Benchmark Class
+ * \details The MemoryResourceBenchmark class measures a
+ * parsing workload using the heap, an ArenaResource and a
+ * PoolResource with test::Benchmark.
+ *
+ * Each iteration builds a CSV row with String, splits it, parses
+ * it with Tokenizer, tokenizes some HTTP header lines and appends the
+ * fields to a Data object. This creates many small objects
+ * that are all discarded together. With the arena, release()
+ * is called after each row.
+ *
+ * The names are "memory_resource.heap", "memory_resource.arena"
+ * and "memory_resource.pool". The arena and the pool are installed
+ * using var::MemoryResourceScope so they are only measured on link
+ * builds (Stratify OS doesn't support scopes). The statistics of the arena
+ * and the pool from the last run are available from arena_info() and pool_info().
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/MemoryResourceBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * MemoryResourceBenchmark memory_benchmark;
+ * memory_benchmark.run(benchmark);
+ * printf("arena allocations %ld\n", memory_benchmark.arena_info().allocation_count());
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class MemoryResourceBenchmark : public api::WorkObject {
+public:
+
+	/*! \details Sets a prefix for each benchmark name. */
+	MemoryResourceBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Returns the arena statistics from the last run. */
+	const var::MemoryResourceInfo & arena_info() const { return m_arena_info; }
+	/*! \details Returns the pool statistics from the last run. */
+	const var::MemoryResourceInfo & pool_info() const { return m_pool_info; }
+
+	/*! \details Runs the benchmarks. */
+	MemoryResourceBenchmark & run(Benchmark & benchmark);
+
+	/*! \details Runs the workload once and returns a value that depends on all the work.
+	 *
+	 * The workload uses the resource that is installed
+	 * for the calling thread (see MemoryResourceScope).
+	 *
+	 */
+	static u32 parse_row(u32 row);
+
+private:
+	/*! \cond */
+	var::String m_prefix;
+	var::MemoryResourceInfo m_arena_info;
+	var::MemoryResourceInfo m_pool_info;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_MEMORY_RESOURCE_BENCHMARK_HPP_
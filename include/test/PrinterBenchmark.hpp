@@ -0,0 +1,119 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_PRINTER_BENCHMARK_HPP_
+#define SAPI_TEST_PRINTER_BENCHMARK_HPP_
+
+#include "../sys/Printer.hpp"
+
+namespace var {
+class JsonValue;
+}
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Printer Benchmark Class
+ * \details The PrinterBenchmark class measures how long each
+ * printer (Printer, JsonPrinter, YamlPrinter and MarkdownPrinter)
+ * takes to print a large var::JsonValue using test::Benchmark.
+ *
+ * The value is an array of entry_count() objects that each
+ * have four members so items_per_second() is entries per
+ * second. Each name is the printer followed by the sink,
+ * for example "json_printer.string" or "yaml_printer.file".
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/sys.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/PrinterBenchmark.hpp>
+ * #include <sapi/fs.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * PrinterBenchmark printer_benchmark;
+ * printer_benchmark.run(benchmark);
+ *
+ * File f;
+ * f.create("/home/output.txt", File::IsOverwrite(true));
+ * FilePrinterSink sink(f);
+ * printer_benchmark.run(benchmark, sink, "file");
+ *
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class PrinterBenchmark : public api::WorkObject {
+public:
+
+	PrinterBenchmark();
+
+	/*! \details Sets the number of entries in the printed value (default 10000). */
+	PrinterBenchmark & set_entry_count(u32 value){
+		m_entry_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the flush mode of each printer (default Printer::flush_size). */
+	PrinterBenchmark & set_flush_mode(enum sys::Printer::flush_modes value){
+		m_flush_mode = value;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	PrinterBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 entry_count() const { return m_entry_count; }
+	enum sys::Printer::flush_modes flush_mode() const { return m_flush_mode; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks printing to a var::String
+	 * (the names end with ".string").
+	 *
+	 * The string is cleared before each iteration.
+	 *
+	 */
+	PrinterBenchmark & run(Benchmark & benchmark);
+
+	/*! \details Runs the benchmarks printing to \a sink.
+	 *
+	 * @param benchmark The benchmark to add the results to
+	 * @param sink Where the printers send their output (every iteration is sent)
+	 * @param name The name of the sink used in the benchmark names
+	 *
+	 */
+	PrinterBenchmark & run(
+			Benchmark & benchmark,
+			sys::PrinterSink & sink,
+			const var::String & name
+			);
+
+	/*! \details Returns the value that is printed. */
+	var::JsonValue create_value() const;
+
+private:
+	/*! \cond */
+	u32 m_entry_count;
+	enum sys::Printer::flush_modes m_flush_mode;
+	var::String m_prefix;
+
+	template<class T> void run_printer(
+			Benchmark & benchmark,
+			const char * printer_name,
+			sys::PrinterSink & sink,
+			const var::String & sink_name,
+			const var::JsonValue & value,
+			var::String * output
+			);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_PRINTER_BENCHMARK_HPP_
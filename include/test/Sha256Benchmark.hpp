@@ -0,0 +1,87 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_SHA256_BENCHMARK_HPP_
+#define SAPI_TEST_SHA256_BENCHMARK_HPP_
+
+#include "../crypto/Sha256.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief SHA256 Benchmark Class
+ * \details The Sha256Benchmark class measures how many
+ * hashes crypto::Sha256::calculate() produces per second
+ * using test::Benchmark.
+ *
+ * The same list of buffers is hashed with each implementation that the
+ * CPU supports:
+ *
+ * - "sha256.portable" uses plain C++
+ * - "sha256.sha" uses the x86 SHA instructions
+ * - "sha256.multi_buffer" hashes eight buffers at once with AVX2
+ *
+ * Each iteration hashes count() buffers so items_per_second()
+ * is the number of hashes per second. If an implementation
+ * produces a different digest than the portable one, the error
+ * number is set to EIO. Sha256::set_instruction_set() is
+ * restored to Sha256::instruction_set_all afterwards.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/crypto.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/Sha256Benchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * Sha256Benchmark().set_size(64).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class Sha256Benchmark : public api::WorkObject {
+public:
+
+	Sha256Benchmark();
+
+	/*! \details Sets the number of bytes in each buffer (default 1KB). */
+	Sha256Benchmark & set_size(u32 value){
+		m_size = value;
+		return *this;
+	}
+
+	/*! \details Sets the number of buffers hashed in each iteration (default 64). */
+	Sha256Benchmark & set_count(u32 value){
+		m_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	Sha256Benchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 size() const { return m_size; }
+	u32 count() const { return m_count; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks. */
+	Sha256Benchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_size;
+	u32 m_count;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_SHA256_BENCHMARK_HPP_
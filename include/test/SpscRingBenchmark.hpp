@@ -0,0 +1,92 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_SPSC_RING_BENCHMARK_HPP_
+#define SAPI_TEST_SPSC_RING_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief SPSC Ring Benchmark Class
+ * \details The SpscRingBenchmark class measures var::SpscRing
+ * with a producer and a consumer thread using test::Benchmark.
+ *
+ * - "spsc_ring.threads.1" pushes and pops each item in the calling thread
+ * - "spsc_ring.throughput" has one sys::Thread push batches of items
+ * while another uses them in place with peek_span() and consume()
+ * - "spsc_ring.round_trip" has one sys::Thread push an item and wait
+ * for another sys::Thread to send it back on a second ring
+ *
+ * items_per_second() is the number of items (or round trips) per
+ * second so the round trip latency is 1/items_per_second(). If the
+ * consumer doesn't receive every item in order, the error
+ * number is set to EIO.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/SpscRingBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * SpscRingBenchmark().set_capacity(1024).run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class SpscRingBenchmark : public api::WorkObject {
+public:
+
+	SpscRingBenchmark();
+
+	/*! \details Sets the number of items passed through the ring in each iteration (default 1048576). */
+	SpscRingBenchmark & set_item_count(u32 value){
+		m_item_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the number of round trips in each iteration (default 16384). */
+	SpscRingBenchmark & set_round_trip_count(u32 value){
+		m_round_trip_count = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets the capacity of the ring (default 4096). */
+	SpscRingBenchmark & set_capacity(u32 value){
+		m_capacity = value ? value : 1;
+		return *this;
+	}
+
+	/*! \details Sets a prefix for each benchmark name. */
+	SpscRingBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	u32 item_count() const { return m_item_count; }
+	u32 round_trip_count() const { return m_round_trip_count; }
+	u32 capacity() const { return m_capacity; }
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the benchmarks. */
+	SpscRingBenchmark & run(Benchmark & benchmark);
+
+private:
+	/*! \cond */
+	u32 m_item_count;
+	u32 m_round_trip_count;
+	u32 m_capacity;
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_SPSC_RING_BENCHMARK_HPP_
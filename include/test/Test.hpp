@@ -16,6 +16,9 @@
 
 namespace test {
 
+class BenchmarkResult;
+class Engine;
+
 #define TEST_EXPECT(a, T, b, c) a.expect<T>(__PRETTY_FUNCTION__, __LINE__, b, c)
 #define TEST_EXPECT_NOT(a, T, b, c) a.expect_not<T>(__PRETTY_FUNCTION__, __LINE__, b, c)
 #define TEST_ASSERT(a, T, b, c) do { if( a.expect<T>(__PRETTY_FUNCTION__, __LINE__, b, c) == false ){ return case_result(); } } while(0)
@@ -418,6 +421,21 @@ protected:
 
 	void print_case_score();
 
+	/*! \details Prints the statistics of a benchmark to the test report.
+	  *
+	  * \code
+	  * bool MyClassTest::execute_class_performance_case(){
+	  *   Benchmark benchmark;
+	  *   print_case_benchmark(
+	  *     benchmark.run("push", [&](u32 iterations){ ... })
+	  *   );
+	  *   return true;
+	  * }
+	  * \endcode
+	  *
+	  */
+	void print_case_benchmark(const BenchmarkResult & result);
+
 	void print_case_failed(const char * fmt, ...);
 	void print_case_failed(const api::Result & result, int line = 0){
 		if( line ){
@@ -454,6 +472,7 @@ private:
 	u32 m_case_message_number;
 	u32 m_indent_count;
 	var::String m_name;
+	var::String m_case_name;
 	Test * m_parent;
 	static bool m_is_initialized;
 	static bool m_all_test_result;
@@ -480,6 +499,7 @@ private:
 	}
 
 	friend class Case;
+	friend class Engine;
 	void open_case(const var::String & case_name);
 	void close_case(bool result);
 };
@@ -0,0 +1,78 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_TEST_TOKENIZER_BENCHMARK_HPP_
+#define SAPI_TEST_TOKENIZER_BENCHMARK_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/String.hpp"
+
+namespace test {
+
+class Benchmark;
+
+/*! \brief Tokenizer Benchmark Class
+ * \details The TokenizerBenchmark class measures var::Tokenizer
+ * (which creates a String for each token) and var::TokenScanner
+ * (which creates views) on HTTP header lines and CSV rows
+ * using test::Benchmark.
+ *
+ * Each iteration splits every line once so items_per_second()
+ * is lines per second. The names are "tokenizer.header",
+ * "token_scanner.header", "tokenizer.csv" and "token_scanner.csv".
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/test.hpp>
+ * #include <sapi/test/TokenizerBenchmark.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Benchmark benchmark;
+ * TokenizerBenchmark().run(benchmark);
+ * JsonPrinter printer;
+ * benchmark.print(printer);
+ * ```
+ *
+ */
+class TokenizerBenchmark : public api::WorkObject {
+public:
+
+	/*! \details Sets a prefix for each benchmark name. */
+	TokenizerBenchmark & set_prefix(const var::String & value){
+		m_prefix = value;
+		return *this;
+	}
+
+	const var::String & prefix() const { return m_prefix; }
+
+	/*! \details Runs the header and CSV benchmarks. */
+	TokenizerBenchmark & run(Benchmark & benchmark);
+
+	/*! \details Runs the benchmarks on \a line_list.
+	 *
+	 * @param benchmark The benchmark to add the results to
+	 * @param name The name used after "tokenizer." and "token_scanner."
+	 * @param line_list The lines to split
+	 * @param delimeters The delimeters passed to the tokenizer
+	 * @param ignore_between The ignore between characters passed to the tokenizer
+	 *
+	 */
+	TokenizerBenchmark & run(
+			Benchmark & benchmark,
+			const var::String & name,
+			const var::StringList & line_list,
+			const var::String & delimeters,
+			const var::String & ignore_between = var::String()
+			);
+
+private:
+	/*! \cond */
+	var::String m_prefix;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_TEST_TOKENIZER_BENCHMARK_HPP_
@@ -12,11 +12,14 @@
 namespace var {}
 
 #include "var/Data.hpp"
+#include "var/MemoryResource.hpp"
 #include "var/Flags.hpp"
 #include "var/Item.hpp"
 #include "var/Ring.hpp"
+#include "var/SpscRing.hpp"
 #include "var/LinkedList.hpp"
 #include "var/Queue.hpp"
+#include "var/BoundedQueue.hpp"
 #include "var/Json.hpp"
 #include "var/ConstString.hpp"
 #include "var/VersionString.hpp"
@@ -24,6 +27,7 @@ namespace var {}
 #include "var/Tokenizer.hpp"
 #include "var/Vector.hpp"
 #include "var/Array.hpp"
+#include "var/Matrix.hpp"
 #include "var/Datum.hpp"
 
 using namespace var;
@@ -0,0 +1,279 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_VAR_BOUNDEDQUEUE_HPP_
+#define SAPI_VAR_BOUNDEDQUEUE_HPP_
+
+#include <atomic>
+#include <new>
+#include <utility>
+#include <errno.h>
+#include "../api/WorkObject.hpp"
+#include "../chrono/Timer.hpp"
+#include "../sys/Cond.hpp"
+
+namespace var {
+
+/*! \brief Bounded Queue Class
+ * \details The BoundedQueue class is a first in/first out
+ * queue that any number of threads can push to and pop from
+ * at the same time.
+ *
+ * All the slots are allocated when the queue is constructed
+ * (nothing is allocated by push()). Each slot has a sequence number
+ * that tells pushing and popping threads whether the slot is
+ * ready for them, so try_push() and try_pop() never lock a mutex.
+ *
+ * A mutex and condition variable are only used when a thread
+ * blocks in pop() waiting for an item.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * BoundedQueue<u32> queue(256);
+ *
+ * //any producer thread
+ * if( queue.try_push(10) < 0 ){
+ *   //queue is full
+ * }
+ *
+ * //any consumer thread
+ * u32 value;
+ * if( queue.pop(value, Milliseconds(100)) == 0 ){
+ *   printf("popped %ld\n", value);
+ * }
+ * ```
+ *
+ * Unlike var::Queue, the number of items is fixed. The count passed
+ * to the constructor is rounded up to a power of two.
+ *
+ */
+template<typename T> class BoundedQueue : public api::WorkObject {
+public:
+
+	/*! \details Constructs a new queue that holds up to \a count items. */
+	explicit BoundedQueue(u32 count){
+		u32 slot_count = 2;
+		while( slot_count < count ){ slot_count <<= 1; }
+		m_mask = slot_count - 1;
+		m_slots = new Slot[slot_count];
+		for(u32 i=0; i < slot_count; i++){
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		m_push_position.store(0, std::memory_order_relaxed);
+		m_pop_position.store(0, std::memory_order_relaxed);
+		m_waiting_count.store(0, std::memory_order_relaxed);
+	}
+
+	~BoundedQueue(){
+		//destruct the items that were never popped
+		const u32 push_position = m_push_position.load(std::memory_order_relaxed);
+		for(u32 position = m_pop_position.load(std::memory_order_relaxed);
+				position != push_position;
+				position++){
+			m_slots[position & m_mask].item()->~T();
+		}
+		delete [] m_slots;
+	}
+
+	BoundedQueue(const BoundedQueue & a) = delete;
+	BoundedQueue & operator=(const BoundedQueue & a) = delete;
+
+	/*! \details Returns the maximum number of items in the queue. */
+	u32 capacity() const { return m_mask + 1; }
+
+	/*! \details Returns the number of items in the queue.
+	 *
+	 * The value may be out of date by the time it is used
+	 * if other threads are pushing or popping.
+	 *
+	 */
+	u32 count() const {
+		return m_push_position.load(std::memory_order_acquire) -
+				m_pop_position.load(std::memory_order_acquire);
+	}
+
+	bool is_empty() const { return count() == 0; }
+
+	/*! \details Pushes an item on the back of the queue.
+	 *
+	 * @return Zero on success or -1 if the queue is full
+	 *
+	 */
+	int try_push(const T & value){ return push_value(value); }
+	int try_push(T && value){ return push_value(std::move(value)); }
+
+	/*! \details Pops an item from the front of the queue without blocking.
+	 *
+	 * @param value Assigned the item that was popped
+	 * @return Zero on success or -1 if the queue is empty
+	 *
+	 */
+	int try_pop(T & value){
+		u32 position = m_pop_position.load(std::memory_order_relaxed);
+		Slot * slot;
+		while( 1 ){
+			slot = m_slots + (position & m_mask);
+			const u32 sequence = slot->sequence.load(std::memory_order_acquire);
+			const s32 difference = static_cast<s32>(sequence - (position + 1));
+			if( difference == 0 ){
+				if( m_pop_position.compare_exchange_weak(
+							position,
+							position + 1,
+							std::memory_order_relaxed) ){
+					break;
+				}
+			} else if( difference < 0 ){
+				//the item in this slot hasn't been pushed yet
+				return -1;
+			} else {
+				//another thread popped this slot first
+				position = m_pop_position.load(std::memory_order_relaxed);
+			}
+		}
+
+		T * item = slot->item();
+		value = std::move(*item);
+		item->~T();
+		//the slot is ready to be pushed on the next lap
+		slot->sequence.store(position + m_mask + 1, std::memory_order_release);
+		return 0;
+	}
+
+	/*! \details Pops an item from the front of the queue, waiting
+	 * for up to \a timeout if the queue is empty.
+	 *
+	 * @return Zero on success or -1 if no item was popped before
+	 * the timeout (error number is ETIMEDOUT)
+	 *
+	 */
+	int pop(T & value, const chrono::MicroTime & timeout){
+		return pop_value(value, &timeout);
+	}
+
+	/*! \details Pops an item from the front of the queue, waiting
+	 * as long as needed if the queue is empty.
+	 *
+	 */
+	int pop(T & value){
+		return pop_value(value, nullptr);
+	}
+
+	/*! \details Pops up to \a count items without blocking.
+	 *
+	 * @param values A pointer to at least \a count items
+	 * @param count The maximum number of items to pop
+	 * @return The number of items that were popped
+	 *
+	 */
+	u32 pop_batch(T * values, u32 count){
+		u32 result = 0;
+		while( (result < count) && (try_pop(values[result]) == 0) ){
+			result++;
+		}
+		return result;
+	}
+
+private:
+	/*! \cond */
+	enum {
+		cache_line_size = 64
+	};
+
+	struct Slot {
+		std::atomic<u32> sequence;
+		alignas(T) u8 storage[sizeof(T)];
+		T * item(){ return reinterpret_cast<T*>(storage); }
+	};
+
+	template<typename Value> int push_value(Value && value){
+		u32 position = m_push_position.load(std::memory_order_relaxed);
+		Slot * slot;
+		while( 1 ){
+			slot = m_slots + (position & m_mask);
+			const u32 sequence = slot->sequence.load(std::memory_order_acquire);
+			const s32 difference = static_cast<s32>(sequence - position);
+			if( difference == 0 ){
+				if( m_push_position.compare_exchange_weak(
+							position,
+							position + 1,
+							std::memory_order_relaxed) ){
+					break;
+				}
+			} else if( difference < 0 ){
+				//the item in this slot hasn't been popped yet
+				return -1;
+			} else {
+				//another thread pushed to this slot first
+				position = m_push_position.load(std::memory_order_relaxed);
+			}
+		}
+
+		new(static_cast<void*>(slot->storage)) T(std::forward<Value>(value));
+		slot->sequence.store(position + 1, std::memory_order_release);
+
+		//pairs with the fence in pop_value() so a waiting thread is never missed
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if( m_waiting_count.load(std::memory_order_relaxed) ){
+			m_mutex.lock();
+			m_cond.signal();
+			m_mutex.unlock();
+		}
+		return 0;
+	}
+
+	int pop_value(T & value, const chrono::MicroTime * timeout){
+		if( try_pop(value) == 0 ){
+			return 0;
+		}
+
+		chrono::Timer timer;
+		timer.start();
+
+		int result;
+		m_mutex.lock();
+		m_waiting_count.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while( (result = try_pop(value)) < 0 ){
+			if( timeout == nullptr ){
+				m_cond.wait(m_mutex);
+			} else {
+				const u32 elapsed = timer.microseconds();
+				if( elapsed >= timeout->microseconds() ){
+					set_error_number(ETIMEDOUT);
+					break;
+				}
+				m_cond.wait_timed(
+							m_mutex,
+							chrono::ClockTime(
+								chrono::MicroTime(timeout->microseconds() - elapsed)
+								)
+							);
+			}
+		}
+		m_waiting_count.fetch_sub(1, std::memory_order_relaxed);
+		m_mutex.unlock();
+		return result;
+	}
+
+	Slot * m_slots;
+	u32 m_mask;
+
+	std::atomic<u32> m_push_position;
+	u8 m_push_padding[cache_line_size];
+	std::atomic<u32> m_pop_position;
+	u8 m_pop_padding[cache_line_size];
+
+	std::atomic<u32> m_waiting_count;
+	sys::Mutex m_mutex;
+	sys::Cond m_cond;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_VAR_BOUNDEDQUEUE_HPP_
@@ -10,6 +10,7 @@
 #include "../api/VarObject.hpp"
 #include "../arg/Argument.hpp"
 #include "Reference.hpp"
+#include "MemoryResource.hpp"
 
 
 #if !defined __link
@@ -27,19 +28,31 @@ public:
 #if !defined __link
 	void refresh(){
 		m_info = mallinfo();
+		refresh_resource_info();
 	}
 	u32 arena() const { return m_info.arena; }
 	u32 free_block_count() const { return m_info.ordblks; }
 	u32 free_size() const { return m_info.fordblks; }
 	u32 used_size() const { return m_info.uordblks; }
 #else
-	void refresh(){}
+	void refresh(){
+		refresh_resource_info();
+	}
 	u32 arena() const { return 0; }
 	u32 free_block_count() const { return 0; }
 	u32 free_size() const { return 0; }
 	u32 used_size() const { return 0; }
 #endif
 
+	/*! \details Returns the statistics of the memory resource that
+	 * was installed for the calling thread (see var::MemoryResourceScope)
+	 * when the info was refreshed.
+	 *
+	 * The statistics are empty if no resource was installed.
+	 *
+	 */
+	const MemoryResourceInfo & resource_info() const { return m_resource_info; }
+
 	bool operator == (const DataInfo & a){
 		return used_size() == a.used_size();
 	}
@@ -48,6 +61,12 @@ private:
 #if !defined __link
 	struct mallinfo m_info;
 #endif
+	MemoryResourceInfo m_resource_info;
+
+	void refresh_resource_info(){
+		MemoryResource * resource = MemoryResource::current();
+		m_resource_info = resource ? resource->info() : MemoryResourceInfo();
+	}
 };
 
 
@@ -144,12 +163,18 @@ public:
 		update_reference();
 	}
 
-	Data(Data && a){
-		m_data = std::move(a.m_data);
+	Data(Data && a) : m_data(std::move(a.m_data)){
 		a.update_reference();
 		update_reference();
 	}
 
+	/*! \details Constructs an empty data object that gets memory from \a resource.
+	 *
+	 * See var::MemoryResource for more details.
+	 *
+	 */
+	explicit Data(MemoryResource & resource) : m_data(Allocator<u8>(&resource)){}
+
 
 	Data(std::initializer_list<u8> il) : m_data(il){
 		update_reference();
@@ -453,7 +478,7 @@ private:
 
 	void update_reference();
 
-	std::vector<u8> m_data;
+	std::vector<u8, Allocator<u8>> m_data;
 
 };
 
@@ -1,80 +1,734 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 #ifndef SAPI_VAR_MATRIX_HPP_
 #define SAPI_VAR_MATRIX_HPP_
 
+#include <type_traits>
+#include <utility>
+
 #include "../sys/Printer.hpp"
 #include "Vector.hpp"
 
 namespace var {
 
-template <typename T> class Matrix : public var::Vector<var::Vector<T>> {
+template<typename T> class Matrix;
+template<typename T> class MatrixView;
+
+/*! \cond */
+namespace matrix_kernel {
+
+//blocked transpose (destination is column_count x row_count)
+template<typename T> void transpose(
+		const T * source,
+		u32 source_stride,
+		T * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count
+		){
+	//the destination is written in rows so each tile only reads a few source cache lines
+	const u32 tile = 32;
+	for(u32 row = 0; row < row_count; row += tile){
+		const u32 row_end = row + tile < row_count ? row + tile : row_count;
+		for(u32 column = 0; column < column_count; column += tile){
+			const u32 column_end = column + tile < column_count ? column + tile : column_count;
+			for(u32 j = column; j < column_end; j++){
+				T * destination_row = destination + j*destination_stride;
+				for(u32 i = row; i < row_end; i++){
+					destination_row[i] = source[i*source_stride + j];
+				}
+			}
+		}
+	}
+}
+
+//destination = a * b for any arithmetic type (float and double use the packed kernels in Matrix.cpp)
+template<typename T> void multiply(
+		const T * a,
+		u32 a_stride,
+		const T * b,
+		u32 b_stride,
+		T * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count,
+		u32 inner_count
+		){
+	const u32 row_block = 64;
+	const u32 inner_block = 256;
+	for(u32 i = 0; i < row_count; i++){
+		T * destination_row = destination + i*destination_stride;
+		for(u32 j = 0; j < column_count; j++){
+			destination_row[j] = T();
+		}
+	}
+	for(u32 row = 0; row < row_count; row += row_block){
+		const u32 row_end = row + row_block < row_count ? row + row_block : row_count;
+		for(u32 inner = 0; inner < inner_count; inner += inner_block){
+			const u32 inner_end = inner + inner_block < inner_count ? inner + inner_block : inner_count;
+			for(u32 i = row; i < row_end; i++){
+				T * destination_row = destination + i*destination_stride;
+				for(u32 k = inner; k < inner_end; k++){
+					const T value = a[i*a_stride + k];
+					const T * b_row = b + k*b_stride;
+					for(u32 j = 0; j < column_count; j++){
+						destination_row[j] += value * b_row[j];
+					}
+				}
+			}
+		}
+	}
+}
+
+void multiply(
+		const float * a,
+		u32 a_stride,
+		const float * b,
+		u32 b_stride,
+		float * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count,
+		u32 inner_count
+		);
+
+void multiply(
+		const double * a,
+		u32 a_stride,
+		const double * b,
+		u32 b_stride,
+		double * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count,
+		u32 inner_count
+		);
+
+}
+
+template<typename E> class MatrixExpression {
+public:
+	const E & derived() const { return static_cast<const E&>(*this); }
+};
+
+//leaves are held as read-only views, other expressions are held by value
+template<typename E> struct MatrixOperand {
+	using type = E;
+};
+
+template<typename T> struct MatrixOperand< Matrix<T> > {
+	using type = MatrixView<const T>;
+};
+
+template<typename L, typename R, typename Operation>
+class MatrixBinaryExpression :
+		public MatrixExpression< MatrixBinaryExpression<L, R, Operation> > {
+public:
+	using value_type = typename L::value_type;
+
+	MatrixBinaryExpression(const L & left, const R & right, Operation operation) :
+		m_left(left), m_right(right), m_operation(operation){}
+
+	u32 row_count() const {
+		return m_left.row_count() < m_right.row_count() ? m_left.row_count() : m_right.row_count();
+	}
+
+	u32 column_count() const {
+		return m_left.column_count() < m_right.column_count() ? m_left.column_count() : m_right.column_count();
+	}
+
+	value_type at(u32 row, u32 column) const {
+		return m_operation(m_left.at(row, column), m_right.at(row, column));
+	}
+
+private:
+	typename MatrixOperand<L>::type m_left;
+	typename MatrixOperand<R>::type m_right;
+	Operation m_operation;
+};
+
+template<typename E, typename Operation>
+class MatrixUnaryExpression :
+		public MatrixExpression< MatrixUnaryExpression<E, Operation> > {
+public:
+	using value_type = typename E::value_type;
+
+	MatrixUnaryExpression(const E & operand, Operation operation) :
+		m_operand(operand), m_operation(operation){}
+
+	u32 row_count() const { return m_operand.row_count(); }
+	u32 column_count() const { return m_operand.column_count(); }
+
+	value_type at(u32 row, u32 column) const {
+		return m_operation(m_operand.at(row, column));
+	}
+
+private:
+	typename MatrixOperand<E>::type m_operand;
+	Operation m_operation;
+};
+
+struct MatrixScalarOperation {
+	enum operations {
+		add,
+		subtract,
+		subtract_from,
+		multiply,
+		divide
+	};
+};
+
+template<typename T, int operation> struct MatrixScalar {
+	T value;
+	T operator()(const T & a) const {
+		switch(operation){
+			case MatrixScalarOperation::add: return a + value;
+			case MatrixScalarOperation::subtract: return a - value;
+			case MatrixScalarOperation::subtract_from: return value - a;
+			case MatrixScalarOperation::multiply: return a * value;
+			case MatrixScalarOperation::divide: return a / value;
+		}
+		return a;
+	}
+};
+
+template<typename T> struct MatrixNegate {
+	T operator()(const T & a) const { return -a; }
+};
+/*! \endcond */
+
+/*! \brief Matrix Row Class
+ * \details A MatrixRow refers to the items in one
+ * row of a var::Matrix or var::MatrixView.
+ *
+ */
+template<typename T> class MatrixRow {
+public:
+	MatrixRow(T * data, u32 count) : m_data(data), m_count(count){}
+
+	T * begin() const { return m_data; }
+	T * end() const { return m_data + m_count; }
+
+	u32 count() const { return m_count; }
+	T * data() const { return m_data; }
+
+	T & at(u32 column) const { return m_data[column]; }
+	T & operator[](u32 column) const { return m_data[column]; }
+
+private:
+	T * m_data;
+	u32 m_count;
+};
+
+/*! \cond */
+template<typename T> class MatrixRowIterator {
+public:
+	MatrixRowIterator(T * data, u32 column_count, u32 stride) :
+		m_data(data), m_column_count(column_count), m_stride(stride){}
+
+	MatrixRow<T> operator*() const {
+		return MatrixRow<T>(m_data, m_column_count);
+	}
+
+	MatrixRowIterator & operator++(){
+		m_data += m_stride;
+		return *this;
+	}
+
+	bool operator!=(const MatrixRowIterator & a) const {
+		return m_data != a.m_data;
+	}
+
+	bool operator==(const MatrixRowIterator & a) const {
+		return m_data == a.m_data;
+	}
+
+private:
+	T * m_data;
+	u32 m_column_count;
+	u32 m_stride;
+};
+/*! \endcond */
+
+/*! \brief Matrix View Class
+ * \details A MatrixView refers to a rectangular part
+ * of a var::Matrix (or any row-major memory) without copying it.
+ *
+ * Consecutive rows are stride() items apart so a view
+ * can select a block of a larger matrix.
+ *
+ * ```
+ * //md2code:main
+ * Matrix<float> m(8, 8);
+ * //the upper right 4x4 block
+ * MatrixView<float> block = m.view(0, 4, 4, 4);
+ * block.fill(1.0f);
+ * ```
+ *
+ * A MatrixView<const T> is read-only.
+ *
+ */
+template<typename T> class MatrixView :
+		public MatrixExpression< MatrixView<T> > {
 public:
+	using value_type = typename std::remove_const<T>::type;
+	using iterator = MatrixRowIterator<T>;
+
+	MatrixView(){}
+
+	MatrixView(
+			T * data,
+			u32 row_count,
+			u32 column_count,
+			u32 stride
+			) :
+		m_data(data),
+		m_row_count(row_count),
+		m_column_count(column_count),
+		m_stride(stride){}
+
+	/*! \details Converts a writable view to a read-only view. */
+	template<typename U, typename = typename std::enable_if<
+						 std::is_same<const U, T>::value && !std::is_same<U, T>::value
+						 >::type>
+	MatrixView(const MatrixView<U> & view) :
+		MatrixView(view.data(), view.row_count(), view.column_count(), view.stride()){}
+
+	u32 row_count() const { return m_row_count; }
+	u32 column_count() const { return m_column_count; }
+
+	/*! \details Returns the number of items from the start of one row to the next. */
+	u32 stride() const { return m_stride; }
+
+	T * data() const { return m_data; }
+
+	/*! \details Returns true if the rows are next to each other in memory. */
+	bool is_contiguous() const {
+		return (m_stride == m_column_count) || (m_row_count <= 1);
+	}
+
+	T & at(u32 row, u32 column) const {
+		return m_data[row*m_stride + column];
+	}
+
+	MatrixRow<T> row(u32 row) const {
+		return MatrixRow<T>(m_data + row*m_stride, m_column_count);
+	}
+
+	iterator begin() const { return iterator(m_data, m_column_count, m_stride); }
+	iterator end() const { return iterator(m_data + m_row_count*m_stride, m_column_count, m_stride); }
+
+	/*! \details Returns a view of part of this view.
+	 *
+	 * The view is limited to the bounds of this view.
+	 *
+	 */
+	MatrixView view(
+			u32 row,
+			u32 column,
+			u32 row_count,
+			u32 column_count
+			) const {
+		if( row > m_row_count ){ row = m_row_count; }
+		if( column > m_column_count ){ column = m_column_count; }
+		if( row_count > m_row_count - row ){ row_count = m_row_count - row; }
+		if( column_count > m_column_count - column ){ column_count = m_column_count - column; }
+		return MatrixView(m_data + row*m_stride + column, row_count, column_count, m_stride);
+	}
+
+	const MatrixView & fill(const value_type & value) const {
+		for(u32 i = 0; i < m_row_count; i++){
+			T * row_data = m_data + i*m_stride;
+			for(u32 j = 0; j < m_column_count; j++){
+				row_data[j] = value;
+			}
+		}
+		return *this;
+	}
+
+	/*! \details Evaluates \a expression in to this view.
+	 *
+	 * Each item is calculated once so the expression
+	 * can refer to this view (for example, `a.assign(a * 2.0f + b)`).
+	 * The number of rows and columns assigned is the smaller
+	 * of the view and the expression.
+	 *
+	 */
+	template<typename E> const MatrixView & assign(const MatrixExpression<E> & expression) const {
+		const E & e = expression.derived();
+		const u32 rows = e.row_count() < m_row_count ? e.row_count() : m_row_count;
+		const u32 columns = e.column_count() < m_column_count ? e.column_count() : m_column_count;
+		for(u32 i = 0; i < rows; i++){
+			T * row_data = m_data + i*m_stride;
+			for(u32 j = 0; j < columns; j++){
+				row_data[j] = e.at(i, j);
+			}
+		}
+		return *this;
+	}
+
+private:
+	T * m_data = nullptr;
+	u32 m_row_count = 0;
+	u32 m_column_count = 0;
+	u32 m_stride = 0;
+};
+
+/*! \brief Matrix Class
+ * \details The Matrix class stores a two dimensional
+ * array of items in one row-major block of memory.
+ *
+ * Matrices of float and double are multiplied using
+ * cache-blocked kernels that use SIMD instructions when
+ * they are available. Element-wise operations build an
+ * expression that is evaluated in one pass when it is
+ * assigned, so no temporary matrices are created.
+ *
+ * ```
+ * //md2code:main
+ * Matrix<float> a(3, 3);
+ * Matrix<float> b(3, 3);
+ * a.fill(1.0f);
+ * b.fill(2.0f);
+ *
+ * //one pass, no temporary matrices
+ * Matrix<float> c = a * 0.5f + b - 1.0f;
+ *
+ * Matrix<float> product = a.multiply(b);
+ * Matrix<float> a_transpose = a.transpose();
+ * ```
+ *
+ */
+template <typename T> class Matrix :
+		public api::WorkObject,
+		public MatrixExpression< Matrix<T> > {
+public:
+
+	using value_type = T;
+	using iterator = MatrixRowIterator<T>;
+	using const_iterator = MatrixRowIterator<const T>;
 
 	Matrix(){}
 
+	/*! \details Constructs an empty matrix that gets memory from \a resource. */
+	explicit Matrix(MemoryResource & resource) : m_data(resource){}
+
 	Matrix(u32 row_count, u32 column_count){
 		resize(row_count, column_count);
 	}
 
-	Matrix transform() const {
+	/*! \details Constructs a matrix by evaluating \a expression. */
+	template<typename E> Matrix(const MatrixExpression<E> & expression){
+		assign(expression);
+	}
+
+	template<typename E> Matrix & operator=(const MatrixExpression<E> & expression){
+		return assign(expression);
+	}
+
+	/*! \details Evaluates \a expression in to this matrix.
+	 *
+	 * If the matrix isn't the same size as \a expression,
+	 * it is resized (and any existing values are lost).
+	 *
+	 */
+	template<typename E> Matrix & assign(const MatrixExpression<E> & expression){
+		const E & e = expression.derived();
+		if( (e.row_count() != row_count()) || (e.column_count() != column_count()) ){
+			//evaluate first in case the expression refers to this matrix
+			Matrix result(e.row_count(), e.column_count());
+			result.view().assign(expression);
+			return *this = std::move(result);
+		}
+		view().assign(expression);
+		return *this;
+	}
+
+	/*! \details Returns the transpose of the matrix.
+	 *
+	 * The copy is made in square tiles so that both the
+	 * source and the destination are accessed in cache-sized blocks.
+	 *
+	 */
+	Matrix transpose() const {
 		Matrix result(column_count(), row_count());
-		for(u32 row_offset = 0; row_offset++; row_offset < row_count()){
-			for(u32 column_offset = 0; column_offset++; column_offset < column_count()){
-				result.at(column_offset, row_offset) = at(row_offset, column_offset);
-			}
+		transpose(result.view(), view());
+		return result;
+	}
+
+	/*! \details Same as transpose(). */
+	Matrix transform() const {
+		return transpose();
+	}
+
+	/*! \details Copies the transpose of \a source to \a destination.
+	 *
+	 * @return Zero on success or less than zero if \a destination
+	 * doesn't have \a source.column_count() rows and \a source.row_count() columns
+	 *
+	 */
+	static int transpose(
+			const MatrixView<T> & destination,
+			const MatrixView<const T> & source
+			){
+		if( (destination.row_count() != source.column_count()) ||
+				(destination.column_count() != source.row_count()) ){
+			return -1;
 		}
+		matrix_kernel::transpose(
+					source.data(),
+					source.stride(),
+					destination.data(),
+					destination.stride(),
+					source.row_count(),
+					source.column_count()
+					);
+		return 0;
+	}
+
+	/*! \details Returns the matrix product of this matrix and \a a.
+	 *
+	 * If column_count() is not equal to \a a.row_count(),
+	 * an empty matrix is returned.
+	 *
+	 */
+	Matrix multiply(const Matrix & a) const {
+		if( column_count() != a.row_count() ){
+			return Matrix();
+		}
+		Matrix result(row_count(), a.column_count());
+		multiply(result.view(), view(), a.view());
 		return result;
 	}
 
+	/*! \details Calculates \a destination = \a a * \a b.
+	 *
+	 * @return Zero on success or less than zero if the sizes don't match
+	 *
+	 * \a destination must not overlap \a a or \a b.
+	 *
+	 */
+	static int multiply(
+			const MatrixView<T> & destination,
+			const MatrixView<const T> & a,
+			const MatrixView<const T> & b
+			){
+		if( (a.column_count() != b.row_count()) ||
+				(destination.row_count() != a.row_count()) ||
+				(destination.column_count() != b.column_count()) ){
+			return -1;
+		}
+		matrix_kernel::multiply(
+					a.data(),
+					a.stride(),
+					b.data(),
+					b.stride(),
+					destination.data(),
+					destination.stride(),
+					a.row_count(),
+					b.column_count(),
+					a.column_count()
+					);
+		return 0;
+	}
+
+	/*! \details Resizes the matrix.
+	 *
+	 * Items that are in both the old and new sizes keep their values.
+	 * New items are value-initialized.
+	 *
+	 */
 	Matrix& resize(u32 row_count, u32 column_count){
-		var::Vector<T>::resize(row_count);
-		for(auto & local_row: *this){
-			local_row.resize(column_count);
+		const u32 copy_row_count = row_count < m_row_count ? row_count : m_row_count;
+		if( column_count > m_column_count ){
+			m_data.resize(row_count * column_count);
+			//move rows from the end so nothing is overwritten before it is moved
+			for(u32 i = copy_row_count; i-- > 0;){
+				for(u32 j = m_column_count; j-- > 0;){
+					m_data[i*column_count + j] = std::move(m_data[i*m_column_count + j]);
+				}
+				for(u32 j = m_column_count; j < column_count; j++){
+					m_data[i*column_count + j] = T();
+				}
+			}
+		} else {
+			if( column_count < m_column_count ){
+				for(u32 i = 0; i < copy_row_count; i++){
+					for(u32 j = 0; j < column_count; j++){
+						m_data[i*column_count + j] = std::move(m_data[i*m_column_count + j]);
+					}
+				}
+			}
+			m_data.resize(row_count * column_count);
 		}
+
+		const u32 count = row_count * column_count;
+		for(u32 i = copy_row_count * column_count; i < count && i < m_row_count * m_column_count; i++){
+			m_data[i] = T();
+		}
+
+		m_row_count = row_count;
+		m_column_count = column_count;
 		return *this;
 	}
 
+	/*! \details Appends a row to the matrix.
+	 *
+	 * If the matrix has rows and \a value doesn't have
+	 * column_count() items, the row is not appended.
+	 *
+	 */
 	Matrix& append(const var::Vector<T> & value){
-		if( (column_count() == 0) || (column_count() == value.count()) ){
-			this->push_back(value);
+		if( (m_row_count == 0) || (m_column_count == 0) ){
+			m_data.clear();
+			m_row_count = 0;
+			m_column_count = value.count();
+		}
+		if( m_column_count == value.count() ){
+			for(const auto & item: value){
+				m_data.push_back(item);
+			}
+			m_row_count++;
 		}
 		return *this;
 	}
 
-	using var::Vector<var::Vector<T>>::at;
+	Matrix& fill(const T & value){
+		m_data.fill(value);
+		return *this;
+	}
 
-	var::Vector<T> & row(u32 row_offset){
-		return at(row_offset);
+	MatrixRow<T> row(u32 row_offset){
+		return MatrixRow<T>(m_data.data() + row_offset*m_column_count, m_column_count);
 	}
 
-	const var::Vector<T> & row(u32 row_offset) const {
-		return at(row_offset);
+	MatrixRow<const T> row(u32 row_offset) const {
+		return MatrixRow<const T>(m_data.data() + row_offset*m_column_count, m_column_count);
 	}
 
 	T & at(u32 row_offset, u32 column_offset){
-		return at(row_offset).at(column_offset);
+		return m_data[row_offset*m_column_count + column_offset];
 	}
 
 	const T & at(u32 row_offset, u32 column_offset) const {
-		return row(row_offset).at(column_offset);
+		return m_data[row_offset*m_column_count + column_offset];
 	}
 
+	u32 row_count() const { return m_row_count; }
+	u32 column_count() const { return m_column_count; }
+	u32 stride() const { return m_column_count; }
 
-	u32 row_count() const {
-		return this->count();
+	/*! \details Returns a pointer to the first item (the rows are stored one after another). */
+	T * data(){ return m_data.data(); }
+	const T * data() const { return m_data.data(); }
+
+	MatrixView<T> view(){
+		return MatrixView<T>(data(), m_row_count, m_column_count, m_column_count);
 	}
 
-	u32 column_count() const {
-		if( row_count() ){
-			return at(0).count();
-		}
-		return 0;
+	MatrixView<const T> view() const {
+		return MatrixView<const T>(data(), m_row_count, m_column_count, m_column_count);
 	}
 
-private:
+	/*! \details Returns a view of \a row_count x \a column_count items starting at \a row, \a column. */
+	MatrixView<T> view(u32 row, u32 column, u32 row_count, u32 column_count){
+		return view().view(row, column, row_count, column_count);
+	}
+
+	MatrixView<const T> view(u32 row, u32 column, u32 row_count, u32 column_count) const {
+		return view().view(row, column, row_count, column_count);
+	}
+
+	operator MatrixView<const T>() const { return view(); }
 
+	iterator begin(){ return view().begin(); }
+	iterator end(){ return view().end(); }
+	const_iterator begin() const { return view().begin(); }
+	const_iterator end() const { return view().end(); }
+
+private:
+	var::Vector<T> m_data;
+	u32 m_row_count = 0;
+	u32 m_column_count = 0;
 
 };
 
+/*! \details Returns an expression that adds \a a and \a b item by item. */
+template<typename L, typename R>
+MatrixBinaryExpression<L, R, std::plus<typename L::value_type>>
+operator + (const MatrixExpression<L> & a, const MatrixExpression<R> & b){
+	return MatrixBinaryExpression<L, R, std::plus<typename L::value_type>>(
+				a.derived(), b.derived(), std::plus<typename L::value_type>());
+}
+
+/*! \details Returns an expression that subtracts \a b from \a a item by item. */
+template<typename L, typename R>
+MatrixBinaryExpression<L, R, std::minus<typename L::value_type>>
+operator - (const MatrixExpression<L> & a, const MatrixExpression<R> & b){
+	return MatrixBinaryExpression<L, R, std::minus<typename L::value_type>>(
+				a.derived(), b.derived(), std::minus<typename L::value_type>());
+}
+
+/*! \details Returns an expression that multiplies \a a and \a b item by item.
+ *
+ * Use Matrix::multiply() for the matrix product.
+ *
+ */
+template<typename L, typename R>
+MatrixBinaryExpression<L, R, std::multiplies<typename L::value_type>>
+multiply_items(const MatrixExpression<L> & a, const MatrixExpression<R> & b){
+	return MatrixBinaryExpression<L, R, std::multiplies<typename L::value_type>>(
+				a.derived(), b.derived(), std::multiplies<typename L::value_type>());
+}
+
+/*! \details Returns an expression that divides \a a by \a b item by item. */
+template<typename L, typename R>
+MatrixBinaryExpression<L, R, std::divides<typename L::value_type>>
+divide_items(const MatrixExpression<L> & a, const MatrixExpression<R> & b){
+	return MatrixBinaryExpression<L, R, std::divides<typename L::value_type>>(
+				a.derived(), b.derived(), std::divides<typename L::value_type>());
+}
+
+/*! \details Returns an expression that applies \a function to each item of \a a. */
+template<typename E, typename F>
+MatrixUnaryExpression<E, F> apply_items(const MatrixExpression<E> & a, F function){
+	return MatrixUnaryExpression<E, F>(a.derived(), function);
+}
+
+/*! \cond */
+#define SAPI_VAR_MATRIX_SCALAR_OPERATOR(symbol, operation, reverse_operation) \
+	template<typename E> \
+	MatrixUnaryExpression<E, MatrixScalar<typename E::value_type, MatrixScalarOperation::operation>> \
+	operator symbol (const MatrixExpression<E> & a, const typename E::value_type & value){ \
+	return MatrixUnaryExpression<E, MatrixScalar<typename E::value_type, MatrixScalarOperation::operation>>( \
+	a.derived(), {value}); \
+	} \
+	template<typename E> \
+	MatrixUnaryExpression<E, MatrixScalar<typename E::value_type, MatrixScalarOperation::reverse_operation>> \
+	operator symbol (const typename E::value_type & value, const MatrixExpression<E> & a){ \
+	return MatrixUnaryExpression<E, MatrixScalar<typename E::value_type, MatrixScalarOperation::reverse_operation>>( \
+	a.derived(), {value}); \
+	}
+
+SAPI_VAR_MATRIX_SCALAR_OPERATOR(+, add, add)
+SAPI_VAR_MATRIX_SCALAR_OPERATOR(-, subtract, subtract_from)
+SAPI_VAR_MATRIX_SCALAR_OPERATOR(*, multiply, multiply)
+
+#undef SAPI_VAR_MATRIX_SCALAR_OPERATOR
+
+template<typename E>
+MatrixUnaryExpression<E, MatrixScalar<typename E::value_type, MatrixScalarOperation::divide>>
+operator / (const MatrixExpression<E> & a, const typename E::value_type & value){
+	return MatrixUnaryExpression<E, MatrixScalar<typename E::value_type, MatrixScalarOperation::divide>>(
+				a.derived(), {value});
+}
+/*! \endcond */
+
+template<typename E>
+MatrixUnaryExpression<E, MatrixNegate<typename E::value_type>>
+operator - (const MatrixExpression<E> & a){
+	return MatrixUnaryExpression<E, MatrixNegate<typename E::value_type>>(
+				a.derived(), MatrixNegate<typename E::value_type>());
+}
 
 template<typename T> sys::Printer& operator << (sys::Printer & printer, const Matrix<T> & matrix){
 	u32 i = 0;
@@ -93,6 +747,4 @@ template<typename T> sys::Printer& operator << (sys::Printer & printer, const Ma
 
 }
 
-
-
 #endif // SAPI_VAR_MATRIX_HPP_
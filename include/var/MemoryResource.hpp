@@ -0,0 +1,371 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_VAR_MEMORYRESOURCE_HPP_
+#define SAPI_VAR_MEMORYRESOURCE_HPP_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "../arg/Argument.hpp"
+
+namespace var {
+
+/*! \brief Memory Resource Info Class
+ * \details Holds the statistics of a var::MemoryResource.
+ *
+ */
+class MemoryResourceInfo {
+public:
+
+	/*! \details Returns the number of times memory was allocated. */
+	u32 allocation_count() const { return m_allocation_count; }
+	/*! \details Returns the number of times memory was freed. */
+	u32 free_count() const { return m_free_count; }
+	/*! \details Returns the number of bytes given out (and not freed). */
+	u32 used_size() const { return m_used_size; }
+	/*! \details Returns the largest value of used_size(). */
+	u32 peak_used_size() const { return m_peak_used_size; }
+	/*! \details Returns the number of bytes the resource holds (including bytes that aren't used). */
+	u32 capacity() const { return m_capacity; }
+	/*! \details Returns the number of blocks the resource got from the heap. */
+	u32 heap_block_count() const { return m_heap_block_count; }
+
+	/*! \cond */
+	void add_allocation(u32 size){
+		m_allocation_count++;
+		m_used_size += size;
+		if( m_used_size > m_peak_used_size ){
+			m_peak_used_size = m_used_size;
+		}
+	}
+
+	void add_free(u32 size){
+		m_free_count++;
+		m_used_size -= size;
+	}
+
+	void add_heap_block(u32 size){
+		m_heap_block_count++;
+		m_capacity += size;
+	}
+
+	void add_capacity(u32 size){
+		m_capacity += size;
+	}
+
+	void clear(){
+		*this = MemoryResourceInfo();
+	}
+	/*! \endcond */
+
+private:
+	u32 m_allocation_count = 0;
+	u32 m_free_count = 0;
+	u32 m_used_size = 0;
+	u32 m_peak_used_size = 0;
+	u32 m_capacity = 0;
+	u32 m_heap_block_count = 0;
+};
+
+/*! \brief Memory Resource Class
+ * \details A MemoryResource provides memory to var::Data,
+ * var::String and var::Vector objects in place of the heap.
+ *
+ * A resource is used by passing it to the constructor of an object
+ * (for example, `String string(arena)`) or, on link builds, by installing
+ * it with a var::MemoryResourceScope. Objects that are constructed while
+ * the scope is installed (in the same thread) get memory from the
+ * resource. Copies get memory from the resource installed where the
+ * copy is made except for items in a container: those get memory from the
+ * container's resource (see var::Allocator).
+ *
+ * See var::ArenaResource and var::PoolResource.
+ *
+ */
+class MemoryResource : public api::WorkObject {
+public:
+
+	virtual ~MemoryResource(){}
+
+	/*! \details Allocates \a size bytes aligned to \a alignment. */
+	virtual void * allocate(u32 size, u32 alignment) = 0;
+
+	/*! \details Frees memory returned by allocate(). */
+	virtual void deallocate(void * pointer, u32 size, u32 alignment) = 0;
+
+	/*! \details Returns the statistics of the resource. */
+	const MemoryResourceInfo & info() const { return m_info; }
+
+	/*! \details Returns the resource installed for the calling thread
+	 * or null if objects use the heap.
+	 */
+	static MemoryResource * current();
+
+protected:
+	/*! \cond */
+	MemoryResourceInfo m_info;
+	/*! \endcond */
+
+private:
+	/*! \cond */
+	friend class MemoryResourceScope;
+	static void set_current(MemoryResource * resource);
+	/*! \endcond */
+};
+
+/*! \brief Memory Resource Scope Class
+ * \details Installs a var::MemoryResource for the calling thread
+ * until the scope is destructed.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * ArenaResource arena;
+ * {
+ *   MemoryResourceScope scope(&arena);
+ *   //all these strings use the arena
+ *   StringList list = String("a,b,c,d").split(",");
+ * }
+ * //all the memory is given back at once
+ * arena.release();
+ * ```
+ *
+ * Scopes can be nested. Installing null makes objects use
+ * the heap.
+ *
+ * Every object that is constructed or copied in the scope uses the
+ * resource, including objects that are kept after the scope ends (such as
+ * a member, a cache or an item added to a container declared outside the scope).
+ * Don't install a scope around code that builds long-lived state, or install
+ * null around that part. ArenaResource::release() fails while any of
+ * those objects still exist rather than leaving them with freed memory.
+ *
+ * Scopes are only supported on link builds. Stratify OS doesn't have
+ * per-thread storage, so a scope does nothing and objects use the heap
+ * unless a resource is passed to their constructor.
+ *
+ */
+class MemoryResourceScope {
+public:
+	explicit MemoryResourceScope(MemoryResource * resource){
+		m_previous = MemoryResource::current();
+		MemoryResource::set_current(resource);
+	}
+
+	~MemoryResourceScope(){
+		MemoryResource::set_current(m_previous);
+	}
+
+	MemoryResourceScope(const MemoryResourceScope & a) = delete;
+	MemoryResourceScope & operator=(const MemoryResourceScope & a) = delete;
+
+private:
+	MemoryResource * m_previous;
+};
+
+/*! \brief Arena Resource Class
+ * \details The ArenaResource gives out memory by moving a pointer
+ * through large blocks (a monotonic arena).
+ *
+ * Freeing memory does nothing (except for the most recent allocation
+ * which is taken back so growing objects don't waste space).
+ * All the memory is given back at once by release() or
+ * when the arena is destructed. This is much faster than the heap
+ * and doesn't fragment it when work creates many small
+ * objects that are all discarded together (like parsing a
+ * message).
+ *
+ * release() only gives the memory back when every object that
+ * uses the arena has been destroyed.
+ *
+ */
+class ArenaResource : public MemoryResource {
+public:
+
+	using BlockSize = arg::Argument<u32, struct ArenaResourceBlockSizeTag>;
+
+	/*! \details Constructs an arena that gets \a block_size bytes at a time from the heap. */
+	explicit ArenaResource(BlockSize block_size = BlockSize(1024));
+
+	/*! \details Constructs an arena that uses \a buffer before getting memory from the heap.
+	 *
+	 * @param buffer The first block (such as a buffer on the stack)
+	 * @param size The number of bytes in \a buffer
+	 * @param block_size The size of blocks taken from the heap when \a buffer is full
+	 *
+	 */
+	ArenaResource(void * buffer, u32 size, BlockSize block_size = BlockSize(1024));
+
+	~ArenaResource();
+
+	ArenaResource(const ArenaResource & a) = delete;
+	ArenaResource & operator=(const ArenaResource & a) = delete;
+
+	void * allocate(u32 size, u32 alignment) override;
+	void deallocate(void * pointer, u32 size, u32 alignment) override;
+
+	/*! \details Gives back all the memory.
+	 *
+	 * @return Zero on success or less than zero (with error_number() set to EBUSY)
+	 * if objects are still using memory from the arena
+	 *
+	 * If any memory is still in use (info().used_size() isn't zero),
+	 * nothing is given back so those objects stay valid. This usually
+	 * means an object that outlives the work was created in a
+	 * var::MemoryResourceScope.
+	 *
+	 * The newest heap block is kept (and used again) so an arena
+	 * that is released after each request doesn't use the heap
+	 * once it is big enough. All the blocks are freed
+	 * when the arena is destructed (unless memory is still in use).
+	 *
+	 */
+	int release();
+
+private:
+	/*! \cond */
+	struct Block {
+		Block * next;
+		u32 size;
+	};
+
+	Block * m_block;
+	u8 * m_position;
+	u8 * m_end;
+	u8 * m_buffer;
+	u32 m_buffer_size;
+	u32 m_block_size;
+
+	void free_blocks();
+	/*! \endcond */
+};
+
+/*! \brief Pool Resource Class
+ * \details The PoolResource gives out fixed size blocks
+ * from memory allocated once when the pool is constructed.
+ *
+ * Allocating and freeing a block is constant time and
+ * never fragments the heap. Requests that are larger than
+ * the block size (or made when all the blocks are used) are
+ * passed to the heap.
+ *
+ */
+class PoolResource : public MemoryResource {
+public:
+
+	using BlockSize = arg::Argument<u32, struct PoolResourceBlockSizeTag>;
+	using BlockCount = arg::Argument<u32, struct PoolResourceBlockCountTag>;
+
+	PoolResource(BlockSize block_size, BlockCount block_count);
+	~PoolResource();
+
+	PoolResource(const PoolResource & a) = delete;
+	PoolResource & operator=(const PoolResource & a) = delete;
+
+	void * allocate(u32 size, u32 alignment) override;
+	void deallocate(void * pointer, u32 size, u32 alignment) override;
+
+	u32 block_size() const { return m_block_size; }
+	u32 block_count() const { return m_block_count; }
+
+	/*! \details Returns the number of allocations that were passed to the heap. */
+	u32 overflow_count() const { return m_overflow_count; }
+
+private:
+	/*! \cond */
+	struct FreeBlock {
+		FreeBlock * next;
+	};
+
+	u8 * m_pool;
+	FreeBlock * m_free_list;
+	u32 m_block_size;
+	u32 m_block_count;
+	u32 m_overflow_count;
+	/*! \endcond */
+};
+
+/*! \brief Allocator Class
+ * \details The Allocator is a standard library allocator
+ * that gets memory from a var::MemoryResource (or the heap if
+ * the resource is null).
+ *
+ * A default constructed Allocator uses the resource that is installed
+ * for the calling thread (see var::MemoryResourceScope) or the heap if
+ * there isn't one. Like
+ * `std::pmr::polymorphic_allocator`, the allocator isn't changed
+ * by assignment so assigning an object that uses a resource
+ * to an object that uses the heap copies the contents
+ * to the heap.
+ *
+ * Items are constructed with the allocator's resource installed
+ * so a var::String that is copied in to a var::Vector on the heap
+ * also uses the heap (even if an arena is installed where the copy
+ * is made). An item that is moved in to a container keeps the memory
+ * of the item it was moved from.
+ *
+ */
+template<typename T> class Allocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::false_type;
+
+	Allocator() noexcept : m_resource(MemoryResource::current()){}
+	Allocator(MemoryResource * resource) noexcept : m_resource(resource){}
+	template<typename U> Allocator(const Allocator<U> & a) noexcept : m_resource(a.resource()){}
+
+	T * allocate(size_t count){
+		if( m_resource == nullptr ){
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+		return static_cast<T*>(m_resource->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T * pointer, size_t count){
+		if( m_resource == nullptr ){
+			::operator delete(pointer);
+			return;
+		}
+		m_resource->deallocate(pointer, count * sizeof(T), alignof(T));
+	}
+
+	//copies use the resource installed where the copy is made
+	Allocator select_on_container_copy_construction() const {
+		return Allocator();
+	}
+
+	//items use the container's resource (trivially copyable items can't hold memory)
+	template<typename U, typename... Arguments>
+	typename std::enable_if<!std::is_trivially_copyable<U>::value>::type construct(
+			U * pointer,
+			Arguments&&... arguments
+			){
+		MemoryResourceScope scope(m_resource);
+		::new(static_cast<void*>(pointer)) U(std::forward<Arguments>(arguments)...);
+	}
+
+	MemoryResource * resource() const { return m_resource; }
+
+private:
+	MemoryResource * m_resource;
+};
+
+template<typename T, typename U> bool operator == (const Allocator<T> & a, const Allocator<U> & b){
+	return a.resource() == b.resource();
+}
+
+template<typename T, typename U> bool operator != (const Allocator<T> & a, const Allocator<U> & b){
+	return a.resource() != b.resource();
+}
+
+}
+
+#endif // SAPI_VAR_MEMORYRESOURCE_HPP_
@@ -15,6 +15,9 @@ namespace var {
  * and popped from the front. It is similar to the
  * std::queue container class.
  *
+ * Queue is not thread safe. var::BoundedQueue can be
+ * shared by several threads.
+ *
  */
 template<typename T> class Queue : public api::WorkObject {
 public:
@@ -33,9 +36,20 @@ public:
 		copy_object(a);
 	}
 
-	Queue & operator=(const Queue & a){ copy_object(a); }
-	Queue(Queue && a){ move_object(a); }
-	Queue & operator=(Queue && a){ move_object(a); }
+	Queue & operator=(const Queue & a){
+		copy_object(a);
+		return *this;
+	}
+
+	Queue(Queue && a) : m_linked_list(sizeof(T)*jump_size()){
+		set_initial_values();
+		move_object(a);
+	}
+
+	Queue & operator=(Queue && a){
+		move_object(a);
+		return *this;
+	}
 
 	/*! \details Returns a reference to the back item.
 	  *
@@ -208,11 +222,14 @@ private:
 
 	void move_object(Queue<T> & a){
 		if( this != &a ){
+			//a gets this queue's items so they are freed with a
 			m_linked_list.swap(a.m_linked_list);
+			u16 front_idx = m_front_idx;
+			u16 back_idx = m_back_idx;
 			m_front_idx = a.m_front_idx;
 			m_back_idx = a.m_back_idx;
-			a.m_front_idx = 0;
-			a.m_back_idx = 0;
+			a.m_front_idx = front_idx;
+			a.m_back_idx = back_idx;
 		}
 	}
 
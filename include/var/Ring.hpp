@@ -27,6 +27,9 @@ namespace var {
  *
  * The Ring can handle items of any type.
  *
+ * Ring is not thread safe. To pass items from one thread
+ * to another without a mutex, use var::SpscRing.
+ *
  * \code
  *
  * Ring<u32> ring(32); //32 32-bit word ring buffer
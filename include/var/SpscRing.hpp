@@ -0,0 +1,282 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_VAR_SPSCRING_HPP_
+#define SAPI_VAR_SPSCRING_HPP_
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include "Data.hpp"
+
+namespace var {
+
+/*! \brief Single Producer Single Consumer Ring Buffer
+ * \details SpscRing is the lock-free version of var::Ring for
+ * passing items from one thread to another.
+ *
+ * Exactly one thread (the producer) may call push() and push_batch()
+ * and exactly one other thread (the consumer) may call pop(),
+ * pop_batch(), peek_span() and consume(). No mutex is needed.
+ *
+ * The number of items is always a power of two so wrapping the
+ * positions is a mask rather than a division. Items are copied with
+ * memcpy() so \a T must be trivially copyable (such as samples
+ * from an ADC or I2S driver). A batch is copied with at most
+ * two memcpy() calls (one before the end of the buffer and one after).
+ *
+ * The producer and consumer positions are kept in different cache lines
+ * so the two threads don't share a line every time one of them moves.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/sys.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * SpscRing<s16> ring(4096);
+ *
+ * //reader thread
+ * s16 samples[256];
+ * //... read samples from the device
+ * ring.push_batch(samples, 256);
+ *
+ * //processing thread (in-place, nothing is copied)
+ * SpscRing<s16>::Span span = ring.peek_span();
+ * s32 sum = 0;
+ * for(u32 i=0; i < span.count(); i++){
+ *   sum += span.at(i);
+ * }
+ * ring.consume(span.count());
+ * ```
+ *
+ */
+template<typename T> class SpscRing {
+	static_assert(
+			std::is_trivially_copyable<T>::value,
+			"SpscRing items are copied with memcpy()"
+			);
+public:
+
+	/*! \details Contiguous items that are ready to be consumed (see peek_span()). */
+	class Span {
+	public:
+		Span(T * pointer, u32 count){
+			m_pointer = pointer;
+			m_count = count;
+		}
+
+		/*! \details Returns a pointer to the first item. */
+		T * pointer() const { return m_pointer; }
+		/*! \details Returns the number of items in the span. */
+		u32 count() const { return m_count; }
+		/*! \details Returns true if no items are in the span. */
+		bool is_empty() const { return m_count == 0; }
+		/*! \details Accesses the item at \a position. */
+		T & at(u32 position) const { return m_pointer[position]; }
+
+	private:
+		T * m_pointer;
+		u32 m_count;
+	};
+
+	/*! \details Constructs a new ring buffer.
+	 *
+	 * @param count The number of items (rounded up to a power of two)
+	 *
+	 * If \a count is more than 0x80000000 or the memory can't be
+	 * allocated, count() is zero and nothing can be pushed.
+	 *
+	 */
+	explicit SpscRing(u32 count) : m_buffer(round_up(count) * sizeof(T)){
+		initialize(round_down(m_buffer.size() / sizeof(T)));
+	}
+
+	/*! \details Constructs a new ring buffer using existing memory.
+	 *
+	 * @param reference The memory to use (must be writable)
+	 *
+	 * The number of items is the largest power of two that fits
+	 * in \a reference.
+	 *
+	 */
+	explicit SpscRing(Reference & reference){
+		m_buffer.refer_to(reference);
+		initialize(round_down(reference.size() / sizeof(T)));
+	}
+
+	/*! \details Returns the number of items the ring can hold. */
+	u32 count() const { return m_count; }
+
+	/*! \details Returns the number of items that are ready to be popped.
+	 *
+	 * The value is exact when called by the consumer. Other
+	 * threads see a value that may be out of date.
+	 *
+	 */
+	u32 count_ready() const {
+		return m_head.load(std::memory_order_acquire) -
+				m_tail.load(std::memory_order_acquire);
+	}
+
+	/*! \details Returns the number of items that can be pushed.
+	 *
+	 * The value is exact when called by the producer.
+	 *
+	 */
+	u32 count_free() const { return m_count - count_ready(); }
+
+	bool is_empty() const { return count_ready() == 0; }
+	bool is_full() const { return count_ready() == m_count; }
+
+	/*! \details Pushes a value (producer only).
+	 *
+	 * @return Zero on success or -1 if the ring is full
+	 *
+	 */
+	int push(const T & value){
+		return push_batch(&value, 1) == 1 ? 0 : -1;
+	}
+
+	/*! \details Pops a value (consumer only).
+	 *
+	 * @param value Assigned the oldest value in the ring
+	 * @return Zero on success or -1 if the ring is empty
+	 *
+	 */
+	int pop(T & value){
+		return pop_batch(&value, 1) == 1 ? 0 : -1;
+	}
+
+	/*! \details Pushes up to \a count values (producer only).
+	 *
+	 * @return The number of values that were pushed (less than
+	 * \a count if the ring fills up)
+	 *
+	 */
+	u32 push_batch(const T * values, u32 count){
+		const u32 head = m_head.load(std::memory_order_relaxed);
+		u32 available = m_count - (head - m_tail_cache);
+		if( available < count ){
+			//only look at the consumer's position when the cached value isn't enough
+			m_tail_cache = m_tail.load(std::memory_order_acquire);
+			available = m_count - (head - m_tail_cache);
+			if( count > available ){ count = available; }
+		}
+
+		if( count ){
+			const u32 offset = head & m_mask;
+			const u32 first = (count < m_count - offset) ? count : m_count - offset;
+			::memcpy(to_items() + offset, values, first * sizeof(T));
+			::memcpy(to_items(), values + first, (count - first) * sizeof(T));
+			m_head.store(head + count, std::memory_order_release);
+		}
+		return count;
+	}
+
+	/*! \details Pops up to \a count values (consumer only).
+	 *
+	 * @return The number of values that were copied to \a values
+	 *
+	 */
+	u32 pop_batch(T * values, u32 count){
+		const u32 tail = m_tail.load(std::memory_order_relaxed);
+		u32 ready = m_head_cache - tail;
+		if( ready < count ){
+			m_head_cache = m_head.load(std::memory_order_acquire);
+			ready = m_head_cache - tail;
+			if( count > ready ){ count = ready; }
+		}
+
+		if( count ){
+			const u32 offset = tail & m_mask;
+			const u32 first = (count < m_count - offset) ? count : m_count - offset;
+			::memcpy(values, to_items() + offset, first * sizeof(T));
+			::memcpy(values + first, to_items(), (count - first) * sizeof(T));
+			m_tail.store(tail + count, std::memory_order_release);
+		}
+		return count;
+	}
+
+	/*! \details Returns the oldest items in the ring without copying them (consumer only).
+	 *
+	 * The span stops at the end of the buffer so it can be
+	 * shorter than count_ready(). Once the items are used, call consume()
+	 * so the producer can reuse the space.
+	 *
+	 */
+	Span peek_span(){
+		const u32 tail = m_tail.load(std::memory_order_relaxed);
+		m_head_cache = m_head.load(std::memory_order_acquire);
+		const u32 offset = tail & m_mask;
+		const u32 ready = m_head_cache - tail;
+		return Span(
+					to_items() + offset,
+					(ready < m_count - offset) ? ready : m_count - offset
+					);
+	}
+
+	/*! \details Removes \a count items that were used in place (consumer only).
+	 *
+	 * \a count must not be more than the count of the last peek_span().
+	 *
+	 */
+	void consume(u32 count){
+		m_tail.store(
+					m_tail.load(std::memory_order_relaxed) + count,
+					std::memory_order_release
+					);
+	}
+
+private:
+	/*! \cond */
+	enum {
+		cache_line_size = 64
+	};
+
+	static u32 round_up(u32 count){
+		//larger counts can't be rounded up in a u32
+		if( count > 0x80000000 ){ return 0; }
+		u32 result = 1;
+		while( result < count ){ result <<= 1; }
+		return result;
+	}
+
+	static u32 round_down(u32 count){
+		if( count == 0 ){ return 0; }
+		u32 result = 1;
+		while( (result << 1) <= count && (result << 1) != 0 ){ result <<= 1; }
+		return result;
+	}
+
+	void initialize(u32 count){
+		m_count = count;
+		m_mask = count ? count - 1 : 0;
+		m_head = 0;
+		m_tail = 0;
+		m_head_cache = 0;
+		m_tail_cache = 0;
+	}
+
+	T * to_items() const { return m_buffer.to<T>(); }
+
+	Data m_buffer;
+	u32 m_count;
+	u32 m_mask;
+
+	//written by the producer
+	std::atomic<u32> m_head;
+	u32 m_tail_cache;
+	u8 m_producer_padding[cache_line_size];
+
+	//written by the consumer
+	std::atomic<u32> m_tail;
+	u32 m_head_cache;
+	u8 m_consumer_padding[cache_line_size];
+	/*! \endcond */
+};
+
+} /* namespace var */
+
+#endif /* SAPI_VAR_SPSCRING_HPP_ */
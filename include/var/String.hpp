@@ -12,6 +12,7 @@
 #include <string>
 #include "../arg/Argument.hpp"
 #include "Vector.hpp"
+#include "MemoryResource.hpp"
 
 namespace var {
 
@@ -89,10 +90,11 @@ public:
 		base_16 = 16,
 	};
 
-	using iterator = typename std::string::iterator;
-	using const_iterator = typename std::string::const_iterator;
-	using reverse_iterator = typename std::string::reverse_iterator;
-	using const_reverse_iterator = typename std::string::const_reverse_iterator;
+	using StdString = std::basic_string<char, std::char_traits<char>, Allocator<char>>;
+	using iterator = typename StdString::iterator;
+	using const_iterator = typename StdString::const_iterator;
+	using reverse_iterator = typename StdString::reverse_iterator;
+	using const_reverse_iterator = typename StdString::const_reverse_iterator;
 
 
 	const_iterator begin() const noexcept { return m_string.begin(); }
@@ -145,7 +147,7 @@ public:
 	String (std::initializer_list<char> il) : m_string(il){}
 	String& operator=(const char * s){
 		if( s == nullptr ){
-			m_string = std::string();
+			m_string.clear();
 		} else {
 			m_string = s;
 		}
@@ -154,7 +156,12 @@ public:
 	String& operator=(const String & s){ m_string = s.string(); return *this; }
 	String& operator=(char c){ m_string = c; return *this; }
 
-	explicit String(const std::string & a) : m_string(a){}
+	explicit String(const std::string & a) : m_string(a.data(), a.size()){}
+	explicit String(const StdString & a) : m_string(a){}
+	explicit String(StdString && a) : m_string(std::move(a)){}
+
+	/*! \details Constructs an empty string that gets memory from \a resource. */
+	explicit String(MemoryResource & resource) : m_string(Allocator<char>(&resource)){}
 	explicit String(const Reference & reference);
 
 	/*! \details Appends a character to this string. */
@@ -559,6 +566,20 @@ public:
 		return *this;
 	}
 
+	/*! \details Appends a maximum of \a length characters of \a cstring_to_append to this String. */
+	String & append(
+			const char * cstring_to_append,
+			Length length
+			){
+		if( cstring_to_append != nullptr ){
+			m_string.append(
+						cstring_to_append,
+						length.argument()
+						);
+		}
+		return *this;
+	}
+
 	/*! \details Appends \a c to this String.  */
 	String & append(char c){
 		m_string.append(1, c);
@@ -873,8 +894,8 @@ public:
 		return ::strtoul(cstring(), nullptr, base);
 	}
 
-	std::string & string(){ return m_string; }
-	const std::string & string() const { return m_string; }
+	StdString & string(){ return m_string; }
+	const StdString & string() const { return m_string; }
 
 
 	u32 capacity() const { return m_string.capacity(); }
@@ -888,7 +909,7 @@ public:
 
 private:
 
-	std::string m_string;
+	StdString m_string;
 	static String m_empty_string;
 };
 
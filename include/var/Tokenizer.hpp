@@ -3,6 +3,8 @@
 #ifndef SAPI_VAR_TOKENIZER_HPP_
 #define SAPI_VAR_TOKENIZER_HPP_
 
+#include <cstring>
+
 #include "../arg/Argument.hpp"
 #include "String.hpp"
 #include "Vector.hpp"
@@ -123,6 +125,202 @@ private:
 
 typedef Tokenizer Token;
 
+/*! \brief Token View Class
+ * \details The TokenView class refers to a token
+ * within a string that has been scanned by
+ * var::TokenScanner. It stores a pointer and a length
+ * rather than a copy of the token.
+ *
+ * The view is only valid as long as the scanned
+ * string is valid.
+ *
+ */
+class TokenView {
+public:
+	TokenView() : m_data(nullptr), m_length(0){}
+	TokenView(const char * data, u32 length) :
+		m_data(data), m_length(length){}
+
+	/*! \details Returns a pointer to the start of the token.
+	 *
+	 * The token is not null-terminated.
+	 *
+	 */
+	const char * data() const { return m_data; }
+
+	/*! \details Returns the number of characters in the token. */
+	u32 length() const { return m_length; }
+
+	bool is_empty() const { return m_length == 0; }
+
+	char at(u32 position) const {
+		return position < m_length ? m_data[position] : 0;
+	}
+
+	/*! \details Returns a copy of the token. */
+	var::String to_string() const {
+		return var::String(m_data ? m_data : "", String::Length(m_length));
+	}
+
+	bool operator == (const char * value) const {
+		return (::strlen(value) == m_length) &&
+				(::strncmp(m_data, value, m_length) == 0);
+	}
+
+	bool operator != (const char * value) const {
+		return !(*this == value);
+	}
+
+	bool operator == (const TokenView & a) const {
+		return (a.length() == m_length) &&
+				(::strncmp(m_data, a.data(), m_length) == 0);
+	}
+
+private:
+	const char * m_data;
+	u32 m_length;
+};
+
+/*! \brief Token Scanner Class
+ * \details The TokenScanner class splits a string
+ * in to tokens the same way as var::Tokenizer but
+ * without allocating any memory. Tokens are produced
+ * on demand as var::TokenView objects that point in to
+ * the source string.
+ *
+ * Delimeters are looked up in a 256-bit table. On hosts
+ * with SSE2 (and on AArch64 with NEON) the input is
+ * scanned 16 bytes at a time for the next delimeter.
+ *
+ * ```
+ * //md2code:main
+ * String line = "Content-Type: text/html; charset=utf-8";
+ * for(const TokenView & token: TokenScanner(line, TokenScanner::Delimeters(";"))){
+ *   printf("%s\n", token.to_string().cstring());
+ * }
+ * ```
+ *
+ * The source string must remain valid while the scanner
+ * and any views it has produced are in use.
+ *
+ */
+class TokenScanner {
+public:
+
+	using Delimeters = Tokenizer::Delimeters;
+	using IgnoreBetween = Tokenizer::IgnoreBetween;
+	using MaximumCount = Tokenizer::MaximumCount;
+
+	TokenScanner(
+			const char * input,
+			u32 length,
+			Delimeters delimeters,
+			IgnoreBetween ignore = IgnoreBetween(""),
+			MaximumCount maximum_count = MaximumCount(0)
+			);
+
+	TokenScanner(
+			const var::String & input,
+			Delimeters delimeters,
+			IgnoreBetween ignore = IgnoreBetween(""),
+			MaximumCount maximum_count = MaximumCount(0)
+			) : TokenScanner(
+					input.cstring(),
+					static_cast<u32>(input.length()),
+					delimeters,
+					ignore,
+					maximum_count){}
+
+	/*! \details Assigns the next token to \a token.
+	 *
+	 * @return true if a token was assigned or false if
+	 * there are no more tokens
+	 *
+	 */
+	bool next(TokenView & token);
+
+	/*! \details Restarts scanning at the beginning of the input. */
+	TokenScanner & reset(){
+		m_cursor = 0;
+		m_count = 0;
+		m_is_complete = false;
+		return *this;
+	}
+
+	/*! \details Counts the tokens in the input.
+	 *
+	 * This scans the entire input and resets the scanner.
+	 *
+	 */
+	u32 count();
+
+	/*! \details Returns the token at \a offset (scanning from the start). */
+	TokenView at(u32 offset);
+
+	class Iterator {
+	public:
+		Iterator() : m_scanner(nullptr){}
+		explicit Iterator(TokenScanner * scanner) : m_scanner(scanner){
+			advance();
+		}
+
+		const TokenView & operator*() const { return m_token; }
+		const TokenView * operator->() const { return &m_token; }
+
+		Iterator & operator++(){
+			advance();
+			return *this;
+		}
+
+		bool operator != (const Iterator & a) const {
+			return m_scanner != a.m_scanner;
+		}
+
+	private:
+		TokenScanner * m_scanner;
+		TokenView m_token;
+
+		void advance(){
+			if( m_scanner && (m_scanner->next(m_token) == false) ){
+				m_scanner = nullptr;
+			}
+		}
+	};
+
+	Iterator begin(){
+		reset();
+		return Iterator(this);
+	}
+
+	Iterator end(){ return Iterator(); }
+
+	/*! \details Returns true if \a c is one of the delimeters. */
+	bool is_delimeter(char c) const {
+		return is_in_table(m_delimeter_table, c);
+	}
+
+private:
+	const char * m_input;
+	u32 m_length;
+	u32 m_cursor = 0;
+	u32 m_count = 0;
+	u32 m_maximum_count;
+	bool m_is_complete = false;
+	u32 m_delimeter_table[8];
+	u32 m_ignore_table[8];
+	//delimeters and ignore characters together (used for vector scans)
+	char m_special_list[8];
+	u32 m_special_count = 0;
+
+	static bool is_in_table(const u32 * table, char c){
+		const u8 value = static_cast<u8>(c);
+		return (table[value >> 5] & (1UL << (value & 0x1f))) != 0;
+	}
+
+	static void add_to_table(u32 * table, const var::String & characters);
+	u32 find_special(u32 cursor) const;
+};
+
 }
 
 namespace sys {
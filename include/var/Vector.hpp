@@ -8,6 +8,7 @@
 #include <functional>
 
 #include "../arg/Argument.hpp"
+#include "MemoryResource.hpp"
 
 namespace var {
 
@@ -29,6 +30,9 @@ public:
 		*/
 	Vector(){}
 
+	/*! \details Constructs an empty vector that gets memory from \a resource. */
+	explicit Vector(MemoryResource & resource) : m_vector(Allocator<T>(&resource)){}
+
 	/*! \details Constructs a vector with \a count uninitialized items. */
 	explicit Vector(size_t count){
 		m_vector.resize(count);
@@ -47,10 +51,11 @@ public:
 		return push_back(a);
 	}
 
-	using iterator = typename std::vector<T>::iterator;
-	using const_iterator = typename std::vector<T>::const_iterator;
-	using reverse_iterator = typename std::vector<T>::reverse_iterator;
-	using const_reverse_iterator = typename std::vector<T>::const_reverse_iterator;
+	using StdVector = std::vector<T, Allocator<T>>;
+	using iterator = typename StdVector::iterator;
+	using const_iterator = typename StdVector::const_iterator;
+	using reverse_iterator = typename StdVector::reverse_iterator;
+	using const_reverse_iterator = typename StdVector::const_reverse_iterator;
 
 	const_iterator begin() const noexcept { return m_vector.begin(); }
 	iterator begin() noexcept { return m_vector.begin(); }
@@ -203,7 +208,7 @@ public:
 		return reinterpret_cast<T*>(
 					bsearch(
 						&a,
-						std::vector<T>::data(),
+						m_vector.data(),
 						count(),
 						sizeof(T),
 						ascending
@@ -218,7 +223,7 @@ public:
 		return reinterpret_cast<T*>(
 					bsearch(
 						&a,
-						std::vector<T>::data(),
+						m_vector.data(),
 						count(),
 						sizeof(T),
 						compare
@@ -346,8 +351,8 @@ public:
 	bool is_empty() const { return m_vector.empty(); }
 
 
-	std::vector<T> & vector(){ return m_vector; }
-	const std::vector<T> & vector() const { return m_vector; }
+	StdVector & vector(){ return m_vector; }
+	const StdVector & vector() const { return m_vector; }
 
 	const T * data() const { return m_vector.data(); }
 	T * data(){ return m_vector.data(); }
@@ -415,7 +420,7 @@ protected:
 
 private:
 
-	std::vector<T> m_vector;
+	StdVector m_vector;
 
 };
 
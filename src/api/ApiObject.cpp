@@ -120,6 +120,8 @@ const char * api::get_error_code_description(s32 ec){
 		ERROR_CODE_CASE(error_code_crypto_missing_api);
 		ERROR_CODE_CASE(error_code_crypto_unsupported_operation);
 		ERROR_CODE_CASE(error_code_crypto_bad_iv_size);
+		ERROR_CODE_CASE(error_code_crypto_bad_key_size);
+		ERROR_CODE_CASE(error_code_crypto_authentication_failed);
 
 
 		ERROR_CODE_CASE(error_code_fs_failed_to_open);
@@ -138,6 +140,7 @@ const char * api::get_error_code_description(s32 ec){
 		ERROR_CODE_CASE(error_code_fs_failed_to_close);
 		ERROR_CODE_CASE(error_code_fs_failed_to_unlink);
 		ERROR_CODE_CASE(error_code_fs_failed_to_rmdir);
+		ERROR_CODE_CASE(error_code_fs_cancelled);
 
 		ERROR_CODE_CASE(error_code_inet_failed_to_create_socket);
 		ERROR_CODE_CASE(error_code_inet_failed_to_connect_to_socket);
@@ -149,6 +152,9 @@ const char * api::get_error_code_description(s32 ec){
 		ERROR_CODE_CASE(error_code_inet_failed_to_get_header);
 		ERROR_CODE_CASE(error_code_inet_failed_wrong_domain);
 		ERROR_CODE_CASE(error_code_inet_wifi_api_missing);
+		ERROR_CODE_CASE(error_code_inet_failed_to_listen);
+		ERROR_CODE_CASE(error_code_inet_failed_to_receive_data);
+		ERROR_CODE_CASE(error_code_inet_failed_to_parse_chunk);
 
 		ERROR_CODE_CASE(error_code_var_json_unknown);
 		ERROR_CODE_CASE(error_code_var_json_out_of_memory);
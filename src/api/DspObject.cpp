@@ -5,12 +5,10 @@
 
 using namespace api;
 
-#if !defined __link
 DspQ7Api DspWorkObject::m_api_q7;
 DspQ15Api DspWorkObject::m_api_q15;
 DspQ31Api DspWorkObject::m_api_q31;
 DspF32Api DspWorkObject::m_api_f32;
 DspConversionApi DspWorkObject::m_api_conversion;
-#endif
 
 u32 sapi_dsp_object_unused;
@@ -6,237 +6,663 @@
 #include <cstring>
 #include "calc/Base64.hpp"
 
+#if defined __link && defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+#define BASE64_USE_X86 1
+#include <immintrin.h>
+#else
+#define BASE64_USE_X86 0
+#endif
+
+#if defined __link && defined __aarch64__ && defined __ARM_NEON
+#define BASE64_USE_NEON 1
+#include <arm_neon.h>
+#else
+#define BASE64_USE_NEON 0
+#endif
+
 using namespace calc;
 
-int Base64::encode(
-		SourceFile source,
-		DestinationFile destination,
-		Size size
-		){
-	u32 chunk_size = 96;
-	const u32 output_buffer_size = calc_encoded_size(chunk_size);
-	char input_buffer[chunk_size];
-	char output_buffer[output_buffer_size];
-	u32 size_processed = 0;
-	int result;
-	do {
-		if( size.argument() - size_processed < chunk_size ){
-			chunk_size = size.argument() - size_processed;
-		}
-		result = source.argument().read(
-					input_buffer,
-					fs::File::Size(chunk_size)
-					);
-		if( result > 0 ){
-			size_processed += result;
-			int len = encode(output_buffer, input_buffer, result);
-			if( destination.argument().write(
-						output_buffer,
-						fs::File::Size(len)
-						) != len ){
-				result = 0;
-			}
-		}
-	} while( (result > 0) && (size.argument() > size_processed) );
-	return size_processed;
-}
+namespace {
 
-int Base64::decode(
-		SourceFile input,
-		DestinationFile output,
-		Size size
-		){
-	u32 chunk_size = 96;
-	const u32 output_buffer_size = calc_decoded_size(chunk_size);
-	char input_buffer[chunk_size];
-	char output_buffer[output_buffer_size];
-	u32 size_processed = 0;
-	int result;
+const char standard_alphabet[65] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-	do {
-		if( size.argument() - size_processed < chunk_size ){
-			chunk_size = size.argument() - size_processed;
-		}
-		result = input.argument().read(
-					input_buffer,
-					fs::File::Size(chunk_size)
-					);
-		if( result > 0 ){
-			size_processed += result;
-			int len = calc_decoded_size(result);
-			len -= decode(output_buffer, input_buffer, result);
-			if( output.argument().write(
-						output_buffer,
-						fs::File::Size(len)
-						) != len ){
-				result = 0;
-			}
+const char url_alphabet[65] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
+enum {
+	invalid_value = 0xff
+};
+
+//maps each character to its six-bit value (or invalid_value)
+class DecodeTable {
+public:
+	DecodeTable(const char * alphabet){
+		memset(m_value, invalid_value, sizeof(m_value));
+		for(u8 i=0; i < 64; i++){
+			m_value[static_cast<u8>(alphabet[i])] = i;
 		}
-	} while( (result > 0) && (size.argument() > size_processed) );
+	}
 
-	return size_processed;
+	u8 at(char c) const { return m_value[static_cast<u8>(c)]; }
+	const u8 * value() const { return m_value; }
+
+private:
+	u8 m_value[256];
+};
+
+const DecodeTable standard_decode_table(standard_alphabet);
+const DecodeTable url_decode_table(url_alphabet);
+
+//block kernels encode/decode as many whole blocks as they can and return the input used
+typedef u32 (*encode_blocks_t)(char * destination, const u8 * source, u32 size, const char * alphabet);
+typedef u32 (*decode_blocks_t)(u8 * destination, const char * source, u32 size, const char * alphabet, const DecodeTable & table);
+
+u32 encode_blocks_scalar(char * destination, const u8 * source, u32 size, const char * alphabet){
+	u32 i;
+	for(i=0; i + 3 <= size; i += 3){
+		const u32 value =
+				(static_cast<u32>(source[i]) << 16) |
+				(static_cast<u32>(source[i+1]) << 8) |
+				source[i+2];
+		destination[0] = alphabet[value >> 18];
+		destination[1] = alphabet[(value >> 12) & 0x3f];
+		destination[2] = alphabet[(value >> 6) & 0x3f];
+		destination[3] = alphabet[value & 0x3f];
+		destination += 4;
+	}
+	return i;
 }
 
-var::String Base64::encode(const var::Reference& input
+u32 decode_blocks_scalar(
+		u8 * destination,
+		const char * source,
+		u32 size,
+		const char * alphabet,
+		const DecodeTable & table
 		){
-	var::String result;
+	MCU_UNUSED_ARGUMENT(alphabet);
+	u32 i;
+	for(i=0; i + 4 <= size; i += 4){
+		const u32 a = table.at(source[i]);
+		const u32 b = table.at(source[i+1]);
+		const u32 c = table.at(source[i+2]);
+		const u32 d = table.at(source[i+3]);
+		//any invalid value sets the top bit
+		if( (a | b | c | d) & 0x80 ){
+			break;
+		}
+		const u32 value = (a << 18) | (b << 12) | (c << 6) | d;
+		destination[0] = value >> 16;
+		destination[1] = value >> 8;
+		destination[2] = value;
+		destination += 3;
+	}
+	return i;
+}
 
-	result.resize(
-				calc_encoded_size(input.size())
+#if BASE64_USE_X86
+
+//splits 12 bytes (in each 128-bit lane) into 16 six-bit values (Mula's method)
+#define BASE64_SSE_SPLIT(input, and_epi, mulhi_epu16, mullo_epi16, or_epi, set1_epi32) \
+	do { \
+	const auto t0 = and_epi(input, set1_epi32(0x0fc0fc00)); \
+	const auto t1 = mulhi_epu16(t0, set1_epi32(0x04000040)); \
+	const auto t2 = and_epi(input, set1_epi32(0x003f03f0)); \
+	const auto t3 = mullo_epi16(t2, set1_epi32(0x01000010)); \
+	input = or_epi(t1, t3); \
+	} while(0)
+
+//offsets that are added to each range of six-bit values
+__attribute__((target("ssse3")))
+__m128i encode_shift_lut(const char * alphabet){
+	return _mm_setr_epi8(
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				static_cast<char>(alphabet[62] - 62),
+				static_cast<char>(alphabet[63] - 63),
+				'A', 0, 0
 				);
+}
 
-	encode(result.to_char(),
-				 input.to_const_void(),
-				 input.size());
-
-	return result;
+__attribute__((target("ssse3")))
+u32 encode_blocks_ssse3(char * destination, const u8 * source, u32 size, const char * alphabet){
+	const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m128i shift_lut = encode_shift_lut(alphabet);
+	u32 i;
+	//16 bytes are loaded but only 12 are used
+	for(i=0; i + 16 <= size; i += 12){
+		__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		input = _mm_shuffle_epi8(input, shuffle);
+		BASE64_SSE_SPLIT(input, _mm_and_si128, _mm_mulhi_epu16, _mm_mullo_epi16, _mm_or_si128, _mm_set1_epi32);
+
+		//map each six-bit value to its range and add the range offset
+		__m128i result = _mm_subs_epu8(input, _mm_set1_epi8(51));
+		const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), input);
+		result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+		result = _mm_shuffle_epi8(shift_lut, result);
+		_mm_storeu_si128(
+					reinterpret_cast<__m128i*>(destination),
+					_mm_add_epi8(result, input)
+					);
+		destination += 16;
+	}
+	return i + encode_blocks_scalar(destination, source + i, size - i, alphabet);
 }
 
-var::Data Base64::decode(
-		const var::String & input
+__attribute__((target("ssse3")))
+u32 decode_blocks_ssse3(
+		u8 * destination,
+		const char * source,
+		u32 size,
+		const char * alphabet,
+		const DecodeTable & table
 		){
-	var::Data result;
-	int len	= calc_decoded_size(input.length());
-	if( result.allocate(len) < 0 ){
-		return var::Data();
-	}
+	const __m128i character_62 = _mm_set1_epi8(alphabet[62]);
+	const __m128i character_63 = _mm_set1_epi8(alphabet[63]);
+	const __m128i pack_shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	u32 i;
+	//16 bytes are stored but only 12 are used
+	for(i=0; i + 24 <= size; i += 16){
+		const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		//signed compares: characters above 127 are in none of the ranges
+		const __m128i upper = _mm_and_si128(
+					_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+					_mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), c));
+		const __m128i lower = _mm_and_si128(
+					_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+					_mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), c));
+		const __m128i digit = _mm_and_si128(
+					_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+					_mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+		const __m128i is_62 = _mm_cmpeq_epi8(c, character_62);
+		const __m128i is_63 = _mm_cmpeq_epi8(c, character_63);
+
+		const __m128i valid = _mm_or_si128(
+					_mm_or_si128(upper, lower),
+					_mm_or_si128(digit, _mm_or_si128(is_62, is_63)));
+		if( _mm_movemask_epi8(valid) != 0xffff ){
+			break;
+		}
 
-	len -= decode(
-				result.to_void(),
-				input.cstring(),
-				input.length()
-				);
+		__m128i values = _mm_and_si128(upper, _mm_sub_epi8(c, _mm_set1_epi8('A')));
+		values = _mm_or_si128(values, _mm_and_si128(lower, _mm_sub_epi8(c, _mm_set1_epi8('a' - 26))));
+		values = _mm_or_si128(values, _mm_and_si128(digit, _mm_add_epi8(c, _mm_set1_epi8(52 - '0'))));
+		values = _mm_or_si128(values, _mm_and_si128(is_62, _mm_set1_epi8(62)));
+		values = _mm_or_si128(values, _mm_and_si128(is_63, _mm_set1_epi8(63)));
+
+		//combine four six-bit values into three bytes
+		__m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+		merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+		_mm_storeu_si128(
+					reinterpret_cast<__m128i*>(destination),
+					_mm_shuffle_epi8(merged, pack_shuffle)
+					);
+		destination += 12;
+	}
+	return i + decode_blocks_scalar(destination, source + i, size - i, alphabet, table);
+}
 
-	result.resize(len);
-	return result;
+__attribute__((target("avx2")))
+u32 encode_blocks_avx2(char * destination, const u8 * source, u32 size, const char * alphabet){
+	const __m256i shuffle = _mm256_set_epi8(
+				10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+				10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m256i shift = _mm256_broadcastsi128_si256(encode_shift_lut(alphabet));
+	u32 i;
+	//each lane loads 16 bytes and uses 12
+	for(i=0; i + 28 <= size; i += 24){
+		__m256i input = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))
+						),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 12)),
+					1);
+		input = _mm256_shuffle_epi8(input, shuffle);
+		BASE64_SSE_SPLIT(input, _mm256_and_si256, _mm256_mulhi_epu16, _mm256_mullo_epi16, _mm256_or_si256, _mm256_set1_epi32);
+
+		__m256i result = _mm256_subs_epu8(input, _mm256_set1_epi8(51));
+		const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), input);
+		result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+		result = _mm256_shuffle_epi8(shift, result);
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(destination),
+					_mm256_add_epi8(result, input)
+					);
+		destination += 32;
+	}
+	return i + encode_blocks_ssse3(destination, source + i, size - i, alphabet);
 }
 
-int Base64::encode(
-		char * dest,
-		const void * src,
-		int nbyte
+__attribute__((target("avx2")))
+u32 decode_blocks_avx2(
+		u8 * destination,
+		const char * source,
+		u32 size,
+		const char * alphabet,
+		const DecodeTable & table
 		){
+	const __m256i character_62 = _mm256_set1_epi8(alphabet[62]);
+	const __m256i character_63 = _mm256_set1_epi8(alphabet[63]);
+	const __m256i pack_shuffle = _mm256_setr_epi8(
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m256i pack_permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+	u32 i;
+	//32 bytes are stored but only 24 are used
+	for(i=0; i + 48 <= size; i += 32){
+		const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+		const __m256i upper = _mm256_and_si256(
+					_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+		const __m256i lower = _mm256_and_si256(
+					_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+		const __m256i digit = _mm256_and_si256(
+					_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+		const __m256i is_62 = _mm256_cmpeq_epi8(c, character_62);
+		const __m256i is_63 = _mm256_cmpeq_epi8(c, character_63);
+
+		const __m256i valid = _mm256_or_si256(
+					_mm256_or_si256(upper, lower),
+					_mm256_or_si256(digit, _mm256_or_si256(is_62, is_63)));
+		if( _mm256_movemask_epi8(valid) != -1 ){
+			break;
+		}
 
-	int i;
-	int j;
-	int k;
-	int len;
-	u8 six_bits[4];
-	len = nbyte;
-	const char * data;
-	data = (const char *)src;
+		__m256i values = _mm256_and_si256(upper, _mm256_sub_epi8(c, _mm256_set1_epi8('A')));
+		values = _mm256_or_si256(values, _mm256_and_si256(lower, _mm256_sub_epi8(c, _mm256_set1_epi8('a' - 26))));
+		values = _mm256_or_si256(values, _mm256_and_si256(digit, _mm256_add_epi8(c, _mm256_set1_epi8(52 - '0'))));
+		values = _mm256_or_si256(values, _mm256_and_si256(is_62, _mm256_set1_epi8(62)));
+		values = _mm256_or_si256(values, _mm256_and_si256(is_63, _mm256_set1_epi8(63)));
+
+		__m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+		merged = _mm256_shuffle_epi8(merged, pack_shuffle);
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(destination),
+					_mm256_permutevar8x32_epi32(merged, pack_permute)
+					);
+		destination += 24;
+	}
+	return i + decode_blocks_ssse3(destination, source + i, size - i, alphabet, table);
+}
 
-	k = 0;
-	//We need to encode three bytes at a time in to four encoded bytes
-	for(i=0; i < len; i+=3){
-		//First the thress bytes are broken down into six-bit sections
-		six_bits[0] = (data[i] >> 2) & 0x3F;
-		six_bits[1] = ((data[i] << 4) & 0x30) + ((data[i+1]>>4) & 0x0F);
-		six_bits[2] = ((data[i+1] << 2) & 0x3C) + ((data[i+2]>>6) & 0x03);
-		six_bits[3] = data[i+2] & 0x3F;
-		//now we use the helper function to convert from six-bits to base64
-		for(j=0; j < 4; j++){
-			dest[k+j] = encode_six(six_bits[j]);
+#endif
+
+#if BASE64_USE_NEON
+
+u32 encode_blocks_neon(char * destination, const u8 * source, u32 size, const char * alphabet){
+	const uint8x16x4_t lookup = vld1q_u8_x4(reinterpret_cast<const u8*>(alphabet));
+	const uint8x16_t mask = vdupq_n_u8(0x3f);
+	u32 i;
+	for(i=0; i + 48 <= size; i += 48){
+		const uint8x16x3_t input = vld3q_u8(source + i);
+		uint8x16x4_t output;
+		output.val[0] = vshrq_n_u8(input.val[0], 2);
+		output.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(input.val[0], 4), vshrq_n_u8(input.val[1], 4)), mask);
+		output.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(input.val[1], 2), vshrq_n_u8(input.val[2], 6)), mask);
+		output.val[3] = vandq_u8(input.val[2], mask);
+		for(u32 j=0; j < 4; j++){
+			output.val[j] = vqtbl4q_u8(lookup, output.val[j]);
 		}
-		k+=4;
+		vst4q_u8(reinterpret_cast<u8*>(destination), output);
+		destination += 64;
 	}
+	return i + encode_blocks_scalar(destination, source + i, size - i, alphabet);
+}
 
-	//at the end, we add = if the input is not divisible by 3
-	if( (len % 3) == 1 ){
-		//two equals at end
-		dest[k-2] = '=';
-		dest[k-1] = '=';
-	} else if ( (len % 3) == 2 ){
-		dest[k-1] = '=';
+u32 decode_blocks_neon(
+		u8 * destination,
+		const char * source,
+		u32 size,
+		const char * alphabet,
+		const DecodeTable & table
+		){
+	//characters 0 to 127 are looked up in two 64 byte tables
+	const uint8x16x4_t lookup_low = vld1q_u8_x4(table.value());
+	const uint8x16x4_t lookup_high = vld1q_u8_x4(table.value() + 64);
+	const uint8x16_t offset = vdupq_n_u8(64);
+	u32 i;
+	for(i=0; i + 64 <= size; i += 64){
+		uint8x16x4_t input = vld4q_u8(reinterpret_cast<const u8*>(source + i));
+		uint8x16_t invalid = vdupq_n_u8(0);
+		for(u32 j=0; j < 4; j++){
+			const uint8x16_t c = input.val[j];
+			//vqtbl4q gives zero past 63 and vqtbx4q keeps the value past 63
+			uint8x16_t value = vqtbl4q_u8(lookup_low, c);
+			value = vqtbx4q_u8(value, lookup_high, vsubq_u8(c, offset));
+			invalid = vorrq_u8(invalid, vorrq_u8(value, vandq_u8(c, vdupq_n_u8(0x80))));
+			input.val[j] = value;
+		}
+		//invalid_value and characters above 127 set the top bit
+		if( vmaxvq_u8(invalid) & 0x80 ){
+			break;
+		}
+		uint8x16x3_t output;
+		output.val[0] = vorrq_u8(vshlq_n_u8(input.val[0], 2), vshrq_n_u8(input.val[1], 4));
+		output.val[1] = vorrq_u8(vshlq_n_u8(input.val[1], 4), vshrq_n_u8(input.val[2], 2));
+		output.val[2] = vorrq_u8(vshlq_n_u8(input.val[2], 6), input.val[3]);
+		vst3q_u8(destination, output);
+		destination += 48;
 	}
+	return i + decode_blocks_scalar(destination, source + i, size - i, alphabet, table);
+}
 
-	//finally, zero terminate the output string
-	dest[k] = 0;
+#endif
+
+class Kernel {
+public:
+	Kernel(){
+		encode_blocks = encode_blocks_scalar;
+		decode_blocks = decode_blocks_scalar;
+#if BASE64_USE_X86
+		__builtin_cpu_init();
+		if( __builtin_cpu_supports("avx2") ){
+			encode_blocks = encode_blocks_avx2;
+			decode_blocks = decode_blocks_avx2;
+		} else if( __builtin_cpu_supports("ssse3") ){
+			encode_blocks = encode_blocks_ssse3;
+			decode_blocks = decode_blocks_ssse3;
+		}
+#elif BASE64_USE_NEON
+		encode_blocks = encode_blocks_neon;
+		decode_blocks = decode_blocks_neon;
+#endif
+	}
 
-	return strlen(dest);
+	encode_blocks_t encode_blocks;
+	decode_blocks_t decode_blocks;
+};
+
+//selected once for the processor that is running
+const Kernel kernel;
+
+}
+
+u32 Base64::calculate_encoded_size(
+		u32 size,
+		enum alphabets alphabet
+		){
+	if( alphabet == alphabet_url ){
+		return (size / 3) * 4 + ((size % 3) ? (size % 3) + 1 : 0);
+	}
+	return ((size + 2) / 3) * 4;
 }
 
-int Base64::calc_encoded_size(int nbyte){
-	return ((((nbyte*4+2)/3) + 3)/4)*4;
+u32 Base64::encode(
+		char * destination,
+		const void * source,
+		u32 size,
+		enum alphabets alphabet
+		){
+	const char * characters = alphabet == alphabet_url ? url_alphabet : standard_alphabet;
+	const u8 * data = static_cast<const u8*>(source);
+
+	const u32 block_size = kernel.encode_blocks(destination, data, size, characters);
+	char * output = destination + (block_size / 3) * 4;
+	data += block_size;
+
+	const u32 remaining = size - block_size;
+	if( remaining ){
+		const u32 value =
+				(static_cast<u32>(data[0]) << 16) |
+				(remaining == 2 ? static_cast<u32>(data[1]) << 8 : 0);
+		*output++ = characters[value >> 18];
+		*output++ = characters[(value >> 12) & 0x3f];
+		if( remaining == 2 ){
+			*output++ = characters[(value >> 6) & 0x3f];
+		}
+		if( alphabet == alphabet_standard ){
+			*output++ = '=';
+			if( remaining == 1 ){
+				*output++ = '=';
+			}
+		}
+	}
+
+	return output - destination;
 }
 
-int Base64::decode(void * dest, const char * src, int nbyte){
-	char * data = (char *)dest;
-	int i;
-	int j;
+int Base64::decode(
+		void * destination,
+		const char * source,
+		u32 size,
+		enum alphabets alphabet
+		){
+	const char * characters = alphabet == alphabet_url ? url_alphabet : standard_alphabet;
+	const DecodeTable & table = alphabet == alphabet_url ? url_decode_table : standard_decode_table;
+	u8 * output = static_cast<u8*>(destination);
+
+	//padding is required for the standard alphabet and optional for the URL alphabet
+	if( (size >= 2) && (size % 4 == 0) && (source[size-1] == '=') ){
+		size -= (source[size-2] == '=') ? 2 : 1;
+	} else if( (alphabet == alphabet_standard) && (size % 4) ){
+		return -1;
+	}
+
+	if( size % 4 == 1 ){
+		return -1;
+	}
 
-	u8 eight_bits[4] = {0};
+	const u32 block_size = kernel.decode_blocks(output, source, size, characters, table);
+	output += (block_size / 4) * 3;
 
-	for(i=0,j=0; j < nbyte; i+=3,j+=4){
-		eight_bits[0] = decode_eigth(src[j]);
-		eight_bits[1] = decode_eigth(src[j+1]);
-		eight_bits[2] = decode_eigth(src[j+2]);
-		eight_bits[3] = decode_eigth(src[j+3]);
-		data[i] = (eight_bits[0] << 2) | (eight_bits[1] >> 4);
-		data[i+1] = (eight_bits[1] << 4) | (eight_bits[2] >> 2);
-		data[i+2] = (eight_bits[2] << 6) | (eight_bits[3]);
+	const u32 remaining = size - block_size;
+	if( remaining >= 4 ){
+		//the kernel stopped at an invalid character
+		return -1;
 	}
 
-	int padding = 0;
-	if( j >= 4 ){
-		if( src[j-4+2] == '=' ){
-			padding = 2;
-		} else if( src[j-4+3] == '=' ){
-			padding = 1;
+	if( remaining ){
+		const u32 a = table.at(source[block_size]);
+		const u32 b = table.at(source[block_size+1]);
+		const u32 c = remaining == 3 ? table.at(source[block_size+2]) : 0;
+		if( (a | b | c) & 0x80 ){
+			return -1;
+		}
+		//the bits after the last byte must be zero
+		if( (remaining == 2 && (b & 0x0f)) || (remaining == 3 && (c & 0x03)) ){
+			return -1;
+		}
+		const u32 value = (a << 18) | (b << 12) | (c << 6);
+		*output++ = value >> 16;
+		if( remaining == 3 ){
+			*output++ = value >> 8;
 		}
 	}
 
-	return padding;
+	return output - static_cast<u8*>(destination);
 }
 
-int Base64::calc_decoded_size(int nbyte){
-	//doesn't account for padding
-	return (nbyte*3+3)/4;
+var::String Base64::encode(
+		const var::Reference & input,
+		enum alphabets alphabet
+		){
+	var::String result;
+	result.resize(
+				calculate_encoded_size(input.size(), alphabet)
+				);
+
+	encode(result.to_char(),
+			 input.to_const_void(),
+			 input.size(),
+			 alphabet);
+
+	return result;
 }
 
-//This is a helper function to convert a six-bit value to base64
-char Base64::encode_six(u8 six_bit_value){
-	u8 x;
-	char c = -1;
-	x = six_bit_value & ~0xC0; //remove top two bits (should be zero anyway)
-	if( x < 26 ){
-		c = 'A' + x;
-	} else if ( x < 52 ){
-		c = 'a' + (x - 26);
-	} else if( x < 62 ){
-		c = '0' + (x - 52);
-	} else if( x == 62 ){
-		c = '+';
-	} else if (x == 63 ){
-		c = '/';
+var::Data Base64::decode(
+		const var::String & input,
+		enum alphabets alphabet
+		){
+	var::Data result;
+	if( decode(input, result, alphabet) < 0 ){
+		return var::Data();
 	}
-	return c;
+	return result;
 }
 
-char Base64::decode_eigth(u8 eight_bit_value){
-	u8 x;
-	x = eight_bit_value;
-	if( (x >= 'A') && (x <= 'Z') ){
-		return x - 'A';
+int Base64::decode(
+		const var::String & input,
+		var::Data & output,
+		enum alphabets alphabet
+		){
+	if( output.allocate(calculate_decoded_size(input.length())) < 0 ){
+		return -1;
 	}
 
-	if( (x >= 'a') && (x <= 'z') ){
-		return x - 'a' + 26;
+	int result = decode(
+				output.to_void(),
+				input.cstring(),
+				input.length(),
+				alphabet
+				);
+
+	output.resize(result < 0 ? 0 : result);
+	return result;
+}
+
+int Base64::write_all(
+		const fs::File & file,
+		const void * buffer,
+		u32 size
+		){
+	const u8 * data = static_cast<const u8*>(buffer);
+	while( size ){
+		int result = file.write(data, fs::File::Size(size));
+		if( result <= 0 ){
+			return -1;
+		}
+		data += result;
+		size -= result;
 	}
+	return 0;
+}
 
-	if( (x >= '0') && (x <= '9') ){
-		return x - '0' + 52;
+int Base64::encode(
+		SourceFile source,
+		DestinationFile destination,
+		Size size,
+		enum alphabets alphabet,
+		BufferSize buffer_size
+		){
+	//whole groups of three bytes are encoded until the end
+	u32 input_size = (buffer_size.argument() / 3) * 3;
+	if( input_size < 3 ){
+		input_size = 3;
+	}
+	var::Data input_buffer(input_size);
+	var::Data output_buffer(calculate_encoded_size(input_size));
+	if( (input_buffer.size() < input_size) || (output_buffer.size() == 0) ){
+		return -1;
 	}
 
-	if( x == '+' ){
-		return 62;
+	u32 size_processed = 0;
+	u32 input_count = 0;
+	bool is_end = false;
+	while( is_end == false ){
+		u32 read_size = input_size - input_count;
+		if( size.argument() && (size.argument() - size_processed < read_size) ){
+			read_size = size.argument() - size_processed;
+		}
+
+		int result = read_size ?
+					source.argument().read(
+						input_buffer.to_u8() + input_count,
+						fs::File::Size(read_size)
+						) : 0;
+		if( result > 0 ){
+			size_processed += result;
+			input_count += result;
+		}
+		is_end = (result <= 0) ||
+				(size.argument() && (size_processed == size.argument()));
+
+		//partial groups are only encoded (with padding) at the end
+		const u32 encode_count = is_end ? input_count : (input_count / 3) * 3;
+		if( encode_count ){
+			u32 length = encode(
+						output_buffer.to_char(),
+						input_buffer.to_const_void(),
+						encode_count,
+						alphabet
+						);
+			if( write_all(destination.argument(), output_buffer.to_const_void(), length) < 0 ){
+				return -1;
+			}
+			input_count -= encode_count;
+			memmove(input_buffer.to_u8(), input_buffer.to_u8() + encode_count, input_count);
+		}
 	}
+	return size_processed;
+}
 
-	if( x == '/' ){
-		return 63;
+int Base64::decode(
+		SourceFile input,
+		DestinationFile output,
+		Size size,
+		enum alphabets alphabet,
+		BufferSize buffer_size
+		){
+	//whole groups of four characters are decoded until the end
+	u32 input_size = (buffer_size.argument() / 4) * 4;
+	if( input_size < 4 ){
+		input_size = 4;
+	}
+	var::Data input_buffer(input_size);
+	var::Data output_buffer(calculate_decoded_size(input_size));
+	if( (input_buffer.size() < input_size) || (output_buffer.size() == 0) ){
+		return -1;
 	}
 
-	return 0;
-}
+	u32 size_processed = 0;
+	u32 input_count = 0;
+	bool is_padded = false;
+	bool is_end = false;
+	while( is_end == false ){
+		u32 read_size = input_size - input_count;
+		if( size.argument() && (size.argument() - size_processed < read_size) ){
+			read_size = size.argument() - size_processed;
+		}
 
+		int result = read_size ?
+					input.argument().read(
+						input_buffer.to_u8() + input_count,
+						fs::File::Size(read_size)
+						) : 0;
+		if( result > 0 ){
+			size_processed += result;
+			input_count += result;
+		}
+		is_end = (result <= 0) ||
+				(size.argument() && (size_processed == size.argument()));
+
+		const u32 decode_count = is_end ? input_count : (input_count / 4) * 4;
+		if( decode_count ){
+			//padding can only be at the end of the input
+			if( is_padded ){
+				return -1;
+			}
+			is_padded = input_buffer.to_const_char()[decode_count-1] == '=';
+
+			int length = decode(
+						output_buffer.to_void(),
+						input_buffer.to_const_char(),
+						decode_count,
+						alphabet
+						);
+			if( length < 0 ){
+				return -1;
+			}
+			if( write_all(output.argument(), output_buffer.to_const_void(), length) < 0 ){
+				return -1;
+			}
+			input_count -= decode_count;
+			memmove(input_buffer.to_u8(), input_buffer.to_u8() + decode_count, input_count);
+		}
+	}
+
+	return size_processed;
+}
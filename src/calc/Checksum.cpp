@@ -1,5 +1,6 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 #include <cstdio>
+#include <cstring>
 #include "calc/Checksum.hpp"
 
 using namespace calc;
@@ -64,3 +65,294 @@ bool Checksum::verify_zero_sum(const u32 * data, int size){
 	return (sum == 0);
 }
 
+#if !defined SAPI_CHECKSUM_SLICE_COUNT
+#if defined __link
+#define SAPI_CHECKSUM_SLICE_COUNT 8
+#else
+//keeps the tables small on devices
+#define SAPI_CHECKSUM_SLICE_COUNT 1
+#endif
+#endif
+
+#if defined __link && defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+#define SAPI_CHECKSUM_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+#if defined __ARM_FEATURE_CRC32
+#define SAPI_CHECKSUM_ARM_CRC32 1
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+//tables[k][n] is the CRC of byte n followed by k zero bytes
+class Crc32Table {
+public:
+	explicit Crc32Table(u32 reflected_polynomial){
+		for(u32 n=0; n < 256; n++){
+			u32 crc = n;
+			for(u32 bit=0; bit < 8; bit++){
+				crc = (crc & 1) ? ((crc >> 1) ^ reflected_polynomial) : (crc >> 1);
+			}
+			table[0][n] = crc;
+		}
+
+		for(u32 k=1; k < SAPI_CHECKSUM_SLICE_COUNT; k++){
+			for(u32 n=0; n < 256; n++){
+				const u32 previous = table[k-1][n];
+				table[k][n] = (previous >> 8) ^ table[0][previous & 0xff];
+			}
+		}
+	}
+
+	u32 table[SAPI_CHECKSUM_SLICE_COUNT][256];
+};
+
+class Crc16Table {
+public:
+	Crc16Table(){
+		for(u32 n=0; n < 256; n++){
+			u16 crc = static_cast<u16>(n << 8);
+			for(u32 bit=0; bit < 8; bit++){
+				crc = (crc & 0x8000) ?
+							static_cast<u16>((crc << 1) ^ 0x1021) :
+							static_cast<u16>(crc << 1);
+			}
+			table[0][n] = crc;
+		}
+
+		for(u32 k=1; k < SAPI_CHECKSUM_SLICE_COUNT; k++){
+			for(u32 n=0; n < 256; n++){
+				const u16 previous = table[k-1][n];
+				table[k][n] = static_cast<u16>(
+							(previous << 8) ^ table[0][previous >> 8]
+						);
+			}
+		}
+	}
+
+	u16 table[SAPI_CHECKSUM_SLICE_COUNT][256];
+};
+
+//tables are built the first time they are used
+const Crc32Table & crc32_table(enum Crc32::polynomial polynomial){
+	if( polynomial == Crc32::polynomial_castagnoli ){
+		static const Crc32Table castagnoli_table(0x82f63b78);
+		return castagnoli_table;
+	}
+	static const Crc32Table ieee_table(0xedb88320);
+	return ieee_table;
+}
+
+const Crc16Table & crc16_table(){
+	static const Crc16Table table;
+	return table;
+}
+
+u32 crc32_tables(
+		u32 crc,
+		const u8 * data,
+		size_t size,
+		const u32 (*table)[256]
+		){
+
+#if SAPI_CHECKSUM_SLICE_COUNT == 8
+	while( size >= 8 ){
+		const u32 low = crc ^ (
+					static_cast<u32>(data[0]) |
+				(static_cast<u32>(data[1]) << 8) |
+				(static_cast<u32>(data[2]) << 16) |
+				(static_cast<u32>(data[3]) << 24)
+				);
+
+		crc = table[7][low & 0xff] ^
+				table[6][(low >> 8) & 0xff] ^
+				table[5][(low >> 16) & 0xff] ^
+				table[4][low >> 24] ^
+				table[3][data[4]] ^
+				table[2][data[5]] ^
+				table[1][data[6]] ^
+				table[0][data[7]];
+
+		data += 8;
+		size -= 8;
+	}
+#endif
+
+	while( size-- ){
+		crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
+	}
+	return crc;
+}
+
+#if defined SAPI_CHECKSUM_SSE42
+__attribute__((target("sse4.2")))
+u32 crc32c_sse42(u32 crc, const u8 * data, size_t size){
+#if defined __x86_64__
+	u64 crc64 = crc;
+	while( size >= 8 ){
+		u64 value;
+		::memcpy(&value, data, sizeof(value));
+		crc64 = _mm_crc32_u64(crc64, value);
+		data += 8;
+		size -= 8;
+	}
+	crc = static_cast<u32>(crc64);
+#endif
+	while( size-- ){
+		crc = _mm_crc32_u8(crc, *data++);
+	}
+	return crc;
+}
+
+bool is_sse42_available(){
+	static const bool is_available = __builtin_cpu_supports("sse4.2");
+	return is_available;
+}
+#endif
+
+#if defined SAPI_CHECKSUM_ARM_CRC32
+u32 crc32_arm(u32 crc, const u8 * data, size_t size, bool is_castagnoli){
+	while( size >= 8 ){
+		u64 value;
+		::memcpy(&value, data, sizeof(value));
+		crc = is_castagnoli ? __crc32cd(crc, value) : __crc32d(crc, value);
+		data += 8;
+		size -= 8;
+	}
+	while( size-- ){
+		crc = is_castagnoli ? __crc32cb(crc, *data) : __crc32b(crc, *data);
+		data++;
+	}
+	return crc;
+}
+#endif
+
+}
+
+bool Crc32::is_accelerated(enum polynomial polynomial){
+#if defined SAPI_CHECKSUM_ARM_CRC32
+	(void)polynomial;
+	return true;
+#elif defined SAPI_CHECKSUM_SSE42
+	return (polynomial == polynomial_castagnoli) && is_sse42_available();
+#else
+	(void)polynomial;
+	return false;
+#endif
+}
+
+Crc32 & Crc32::update(const var::Reference & data){
+	const u8 * buffer = data.to_const_u8();
+	const size_t size = data.size();
+	if( (buffer == nullptr) || (size == 0) ){
+		return *this;
+	}
+
+#if defined SAPI_CHECKSUM_ARM_CRC32
+	m_value = crc32_arm(
+				m_value,
+				buffer,
+				size,
+				m_polynomial == polynomial_castagnoli
+				);
+	return *this;
+#else
+
+#if defined SAPI_CHECKSUM_SSE42
+	if( (m_polynomial == polynomial_castagnoli) && is_sse42_available() ){
+		m_value = crc32c_sse42(m_value, buffer, size);
+		return *this;
+	}
+#endif
+
+	m_value = crc32_tables(
+				m_value,
+				buffer,
+				size,
+				crc32_table(m_polynomial).table
+				);
+	return *this;
+#endif
+}
+
+Crc16 & Crc16::update(const var::Reference & data){
+	const u8 * buffer = data.to_const_u8();
+	size_t size = data.size();
+	if( buffer == nullptr ){
+		return *this;
+	}
+
+	const u16 (*table)[256] = crc16_table().table;
+	u16 crc = m_value;
+
+#if SAPI_CHECKSUM_SLICE_COUNT == 8
+	while( size >= 8 ){
+		//the current CRC is the same as xor'ing it in to the first two bytes
+		crc = table[7][buffer[0] ^ (crc >> 8)] ^
+				table[6][buffer[1] ^ (crc & 0xff)] ^
+				table[5][buffer[2]] ^
+				table[4][buffer[3]] ^
+				table[3][buffer[4]] ^
+				table[2][buffer[5]] ^
+				table[1][buffer[6]] ^
+				table[0][buffer[7]];
+		buffer += 8;
+		size -= 8;
+	}
+#endif
+
+	while( size-- ){
+		crc = static_cast<u16>((crc << 8) ^ table[0][(crc >> 8) ^ *buffer++]);
+	}
+
+	m_value = crc;
+	return *this;
+}
+
+Adler32 & Adler32::update(const var::Reference & data){
+	//largest n such that 255n(n+1)/2 + (n+1)(65521-1) fits in 32 bits
+	const size_t maximum_run = 5552;
+	const u32 modulus = 65521;
+
+	const u8 * buffer = data.to_const_u8();
+	size_t size = data.size();
+	if( buffer == nullptr ){
+		return *this;
+	}
+
+	u32 a = m_a;
+	u32 b = m_b;
+
+	while( size > 0 ){
+		size_t run = size < maximum_run ? size : maximum_run;
+		size -= run;
+
+		//the modulo is only needed once per run
+		while( run >= 8 ){
+			a += buffer[0]; b += a;
+			a += buffer[1]; b += a;
+			a += buffer[2]; b += a;
+			a += buffer[3]; b += a;
+			a += buffer[4]; b += a;
+			a += buffer[5]; b += a;
+			a += buffer[6]; b += a;
+			a += buffer[7]; b += a;
+			buffer += 8;
+			run -= 8;
+		}
+
+		while( run-- ){
+			a += *buffer++;
+			b += a;
+		}
+
+		a %= modulus;
+		b %= modulus;
+	}
+
+	m_a = a;
+	m_b = b;
+	return *this;
+}
@@ -1,21 +1,664 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 
 #include <errno.h>
+#include <cstring>
 #include "crypto/Aes.hpp"
 #include "sys/Printer.hpp"
+#include "sys/WorkerThread.hpp"
+
+#if defined __link && defined __GNUC__ && defined __x86_64__
+#define SAPI_AES_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 using namespace crypto;
 
+namespace {
+
+inline u32 load_little_endian(const u8 * data){
+	return static_cast<u32>(data[0]) |
+			(static_cast<u32>(data[1]) << 8) |
+			(static_cast<u32>(data[2]) << 16) |
+			(static_cast<u32>(data[3]) << 24);
+}
+
+inline void store_little_endian(u8 * data, u32 value){
+	data[0] = static_cast<u8>(value);
+	data[1] = static_cast<u8>(value >> 8);
+	data[2] = static_cast<u8>(value >> 16);
+	data[3] = static_cast<u8>(value >> 24);
+}
+
+//clears secrets (the compiler can't remove volatile stores)
+void clear(void * data, u32 size){
+	volatile u8 * bytes = static_cast<volatile u8*>(data);
+	while( size-- ){
+		*bytes++ = 0;
+	}
+}
+
+void increment_counter(u8 counter[16], u32 counter_size){
+	for(u32 i=16; i > 16 - counter_size; i--){
+		if( ++counter[i-1] != 0 ){
+			return;
+		}
+	}
+}
+
+/*
+ * The software implementation is bitsliced: two blocks are
+ * held in eight words with each word holding one bit of each of
+ * the 32 bytes. The S-box is a boolean circuit so no memory
+ * is indexed by secret data.
+ */
+
+//moves between the normal and bitsliced representation (it is its own inverse)
+void ortho(u32 q[8]){
+#define SAPI_AES_SWAP(low_mask, high_mask, shift, x, y) \
+	do { \
+	const u32 a = (x); \
+	const u32 b = (y); \
+	(x) = (a & (low_mask)) | ((b & (low_mask)) << (shift)); \
+	(y) = ((a & (high_mask)) >> (shift)) | (b & (high_mask)); \
+	} while(0)
+
+	SAPI_AES_SWAP(0x55555555, 0xaaaaaaaa, 1, q[0], q[1]);
+	SAPI_AES_SWAP(0x55555555, 0xaaaaaaaa, 1, q[2], q[3]);
+	SAPI_AES_SWAP(0x55555555, 0xaaaaaaaa, 1, q[4], q[5]);
+	SAPI_AES_SWAP(0x55555555, 0xaaaaaaaa, 1, q[6], q[7]);
+
+	SAPI_AES_SWAP(0x33333333, 0xcccccccc, 2, q[0], q[2]);
+	SAPI_AES_SWAP(0x33333333, 0xcccccccc, 2, q[1], q[3]);
+	SAPI_AES_SWAP(0x33333333, 0xcccccccc, 2, q[4], q[6]);
+	SAPI_AES_SWAP(0x33333333, 0xcccccccc, 2, q[5], q[7]);
+
+	SAPI_AES_SWAP(0x0f0f0f0f, 0xf0f0f0f0, 4, q[0], q[4]);
+	SAPI_AES_SWAP(0x0f0f0f0f, 0xf0f0f0f0, 4, q[1], q[5]);
+	SAPI_AES_SWAP(0x0f0f0f0f, 0xf0f0f0f0, 4, q[2], q[6]);
+	SAPI_AES_SWAP(0x0f0f0f0f, 0xf0f0f0f0, 4, q[3], q[7]);
+
+#undef SAPI_AES_SWAP
+}
+
+//the S-box circuit from Boyar and Peralta (q[7] is the most significant bit)
+void substitute(u32 q[8]){
+	const u32 x0 = q[7];
+	const u32 x1 = q[6];
+	const u32 x2 = q[5];
+	const u32 x3 = q[4];
+	const u32 x4 = q[3];
+	const u32 x5 = q[2];
+	const u32 x6 = q[1];
+	const u32 x7 = q[0];
+
+	//top linear transformation
+	const u32 y14 = x3 ^ x5;
+	const u32 y13 = x0 ^ x6;
+	const u32 y9 = x0 ^ x3;
+	const u32 y8 = x0 ^ x5;
+	const u32 t0 = x1 ^ x2;
+	const u32 y1 = t0 ^ x7;
+	const u32 y4 = y1 ^ x3;
+	const u32 y12 = y13 ^ y14;
+	const u32 y2 = y1 ^ x0;
+	const u32 y5 = y1 ^ x6;
+	const u32 y3 = y5 ^ y8;
+	const u32 t1 = x4 ^ y12;
+	const u32 y15 = t1 ^ x5;
+	const u32 y20 = t1 ^ x1;
+	const u32 y6 = y15 ^ x7;
+	const u32 y10 = y15 ^ t0;
+	const u32 y11 = y20 ^ y9;
+	const u32 y7 = x7 ^ y11;
+	const u32 y17 = y10 ^ y11;
+	const u32 y19 = y10 ^ y8;
+	const u32 y16 = t0 ^ y11;
+	const u32 y21 = y13 ^ y16;
+	const u32 y18 = x0 ^ y16;
+
+	//non-linear section
+	const u32 t2 = y12 & y15;
+	const u32 t3 = y3 & y6;
+	const u32 t4 = t3 ^ t2;
+	const u32 t5 = y4 & x7;
+	const u32 t6 = t5 ^ t2;
+	const u32 t7 = y13 & y16;
+	const u32 t8 = y5 & y1;
+	const u32 t9 = t8 ^ t7;
+	const u32 t10 = y2 & y7;
+	const u32 t11 = t10 ^ t7;
+	const u32 t12 = y9 & y11;
+	const u32 t13 = y14 & y17;
+	const u32 t14 = t13 ^ t12;
+	const u32 t15 = y8 & y10;
+	const u32 t16 = t15 ^ t12;
+	const u32 t17 = t4 ^ t14;
+	const u32 t18 = t6 ^ t16;
+	const u32 t19 = t9 ^ t14;
+	const u32 t20 = t11 ^ t16;
+	const u32 t21 = t17 ^ y20;
+	const u32 t22 = t18 ^ y19;
+	const u32 t23 = t19 ^ y21;
+	const u32 t24 = t20 ^ y18;
+
+	const u32 t25 = t21 ^ t22;
+	const u32 t26 = t21 & t23;
+	const u32 t27 = t24 ^ t26;
+	const u32 t28 = t25 & t27;
+	const u32 t29 = t28 ^ t22;
+	const u32 t30 = t23 ^ t24;
+	const u32 t31 = t22 ^ t26;
+	const u32 t32 = t31 & t30;
+	const u32 t33 = t32 ^ t24;
+	const u32 t34 = t23 ^ t33;
+	const u32 t35 = t27 ^ t33;
+	const u32 t36 = t24 & t35;
+	const u32 t37 = t36 ^ t34;
+	const u32 t38 = t27 ^ t36;
+	const u32 t39 = t29 & t38;
+	const u32 t40 = t25 ^ t39;
+
+	const u32 t41 = t40 ^ t37;
+	const u32 t42 = t29 ^ t33;
+	const u32 t43 = t29 ^ t40;
+	const u32 t44 = t33 ^ t37;
+	const u32 t45 = t42 ^ t41;
+	const u32 z0 = t44 & y15;
+	const u32 z1 = t37 & y6;
+	const u32 z2 = t33 & x7;
+	const u32 z3 = t43 & y16;
+	const u32 z4 = t40 & y1;
+	const u32 z5 = t29 & y7;
+	const u32 z6 = t42 & y11;
+	const u32 z7 = t45 & y17;
+	const u32 z8 = t41 & y10;
+	const u32 z9 = t44 & y12;
+	const u32 z10 = t37 & y3;
+	const u32 z11 = t33 & y4;
+	const u32 z12 = t43 & y13;
+	const u32 z13 = t40 & y5;
+	const u32 z14 = t29 & y2;
+	const u32 z15 = t42 & y9;
+	const u32 z16 = t45 & y14;
+	const u32 z17 = t41 & y8;
+
+	//bottom linear transformation
+	const u32 t46 = z15 ^ z16;
+	const u32 t47 = z10 ^ z11;
+	const u32 t48 = z5 ^ z13;
+	const u32 t49 = z9 ^ z10;
+	const u32 t50 = z2 ^ z12;
+	const u32 t51 = z2 ^ z5;
+	const u32 t52 = z7 ^ z8;
+	const u32 t53 = z0 ^ z3;
+	const u32 t54 = z6 ^ z7;
+	const u32 t55 = z16 ^ z17;
+	const u32 t56 = z12 ^ t48;
+	const u32 t57 = t50 ^ t53;
+	const u32 t58 = z4 ^ t46;
+	const u32 t59 = z3 ^ t54;
+	const u32 t60 = t46 ^ t57;
+	const u32 t61 = z14 ^ t57;
+	const u32 t62 = t52 ^ t58;
+	const u32 t63 = t49 ^ t58;
+	const u32 t64 = z4 ^ t59;
+	const u32 t65 = t61 ^ t62;
+	const u32 t66 = z1 ^ t63;
+	const u32 s0 = t59 ^ t63;
+	const u32 s6 = t56 ^ ~t62;
+	const u32 s7 = t48 ^ ~t60;
+	const u32 t67 = t64 ^ t65;
+	const u32 s3 = t53 ^ t66;
+	const u32 s4 = t51 ^ t66;
+	const u32 s5 = t47 ^ t65;
+	const u32 s1 = t64 ^ ~s3;
+	const u32 s2 = t55 ^ ~t67;
+
+	q[7] = s0;
+	q[6] = s1;
+	q[5] = s2;
+	q[4] = s3;
+	q[3] = s4;
+	q[2] = s5;
+	q[1] = s6;
+	q[0] = s7;
+}
+
+//inverse of the affine transformation that follows the field inversion in the S-box
+void inverse_affine(u32 q[8]){
+	u32 x[8];
+	for(u32 i=0; i < 8; i++){
+		x[i] = q[(i+2) & 7] ^ q[(i+5) & 7] ^ q[(i+7) & 7];
+	}
+	//the constant is 0x05
+	x[0] = ~x[0];
+	x[2] = ~x[2];
+	memcpy(q, x, sizeof(x));
+}
+
+void inverse_substitute(u32 q[8]){
+	inverse_affine(q);
+	substitute(q);
+	inverse_affine(q);
+}
+
+//each byte of a word is one row (four columns of two blocks)
+void shift_rows(u32 q[8]){
+	for(u32 i=0; i < 8; i++){
+		const u32 x = q[i];
+		q[i] = (x & 0x000000ff) |
+				((x & 0x0000fc00) >> 2) | ((x & 0x00000300) << 6) |
+				((x & 0x00f00000) >> 4) | ((x & 0x000f0000) << 4) |
+				((x & 0xc0000000) >> 6) | ((x & 0x3f000000) << 2);
+	}
+}
+
+void inverse_shift_rows(u32 q[8]){
+	for(u32 i=0; i < 8; i++){
+		const u32 x = q[i];
+		q[i] = (x & 0x000000ff) |
+				((x & 0x00003f00) << 2) | ((x & 0x0000c000) >> 6) |
+				((x & 0x000f0000) << 4) | ((x & 0x00f00000) >> 4) |
+				((x & 0x03000000) << 6) | ((x & 0xfc000000) >> 2);
+	}
+}
+
+inline u32 rotate_right(u32 value, u32 count){
+	return (value >> count) | (value << (32 - count));
+}
+
+//2a + 3b + c + d for each column where a rotation by 8 bits moves to the next row
+void mix_columns(u32 q[8]){
+	u32 r[8];
+	for(u32 i=0; i < 8; i++){
+		r[i] = rotate_right(q[i], 8);
+	}
+	const u32 q0 = q[0]; const u32 q1 = q[1]; const u32 q2 = q[2]; const u32 q3 = q[3];
+	const u32 q4 = q[4]; const u32 q5 = q[5]; const u32 q6 = q[6]; const u32 q7 = q[7];
+
+	q[0] = q7 ^ r[7] ^ r[0] ^ rotate_right(q0 ^ r[0], 16);
+	q[1] = q0 ^ r[0] ^ q7 ^ r[7] ^ r[1] ^ rotate_right(q1 ^ r[1], 16);
+	q[2] = q1 ^ r[1] ^ r[2] ^ rotate_right(q2 ^ r[2], 16);
+	q[3] = q2 ^ r[2] ^ q7 ^ r[7] ^ r[3] ^ rotate_right(q3 ^ r[3], 16);
+	q[4] = q3 ^ r[3] ^ q7 ^ r[7] ^ r[4] ^ rotate_right(q4 ^ r[4], 16);
+	q[5] = q4 ^ r[4] ^ r[5] ^ rotate_right(q5 ^ r[5], 16);
+	q[6] = q5 ^ r[5] ^ r[6] ^ rotate_right(q6 ^ r[6], 16);
+	q[7] = q6 ^ r[6] ^ r[7] ^ rotate_right(q7 ^ r[7], 16);
+}
+
+//the inverse is the forward mix after adding 4(a + c) to a and c and 4(b + d) to b and d
+void inverse_mix_columns(u32 q[8]){
+	u32 t[8];
+	for(u32 i=0; i < 8; i++){
+		t[i] = q[i] ^ rotate_right(q[i], 16);
+	}
+	//multiply by 4 in GF(2^8) (x^8 = x^4 + x^3 + x + 1)
+	const u32 u[8] = {
+		t[6],
+		t[6] ^ t[7],
+		t[0] ^ t[7],
+		t[1] ^ t[6],
+		t[2] ^ t[6] ^ t[7],
+		t[3] ^ t[7],
+		t[4],
+		t[5]
+	};
+	for(u32 i=0; i < 8; i++){
+		q[i] ^= u[i];
+	}
+	mix_columns(q);
+}
+
+inline void add_round_key(u32 q[8], const u32 key[8]){
+	for(u32 i=0; i < 8; i++){
+		q[i] ^= key[i];
+	}
+}
+
+void encrypt_sliced(const u32 key[][8], u32 round_count, u32 q[8]){
+	add_round_key(q, key[0]);
+	for(u32 round=1; round < round_count; round++){
+		substitute(q);
+		shift_rows(q);
+		mix_columns(q);
+		add_round_key(q, key[round]);
+	}
+	substitute(q);
+	shift_rows(q);
+	add_round_key(q, key[round_count]);
+}
+
+void decrypt_sliced(const u32 key[][8], u32 round_count, u32 q[8]){
+	add_round_key(q, key[round_count]);
+	for(u32 round=round_count-1; round > 0; round--){
+		inverse_shift_rows(q);
+		inverse_substitute(q);
+		add_round_key(q, key[round]);
+		inverse_mix_columns(q);
+	}
+	inverse_shift_rows(q);
+	inverse_substitute(q);
+	add_round_key(q, key[0]);
+}
+
+//loads one or two blocks (second may be null)
+void load_blocks(u32 q[8], const u8 * first, const u8 * second){
+	for(u32 i=0; i < 4; i++){
+		q[2*i] = load_little_endian(first + 4*i);
+		q[2*i+1] = second ? load_little_endian(second + 4*i) : 0;
+	}
+	ortho(q);
+}
+
+void store_blocks(u8 * first, u8 * second, u32 q[8]){
+	ortho(q);
+	for(u32 i=0; i < 4; i++){
+		store_little_endian(first + 4*i, q[2*i]);
+		if( second ){
+			store_little_endian(second + 4*i, q[2*i+1]);
+		}
+	}
+}
+
+u32 substitute_word(u32 value){
+	u32 q[8] = {value, 0, 0, 0, 0, 0, 0, 0};
+	ortho(q);
+	substitute(q);
+	ortho(q);
+	return q[0];
+}
+
+//returns the number of rounds or zero if the key size is not valid
+u32 expand_key(u32 word[60], const u8 * key, u32 key_size){
+	if( (key_size != 16) && (key_size != 24) && (key_size != 32) ){
+		return 0;
+	}
+	const u32 key_word_count = key_size / 4;
+	const u32 round_count = key_word_count + 6;
+	const u32 word_count = (round_count + 1) * 4;
+
+	for(u32 i=0; i < key_word_count; i++){
+		word[i] = load_little_endian(key + 4*i);
+	}
+
+	u32 round_constant = 0x01;
+	for(u32 i=key_word_count; i < word_count; i++){
+		u32 value = word[i-1];
+		if( i % key_word_count == 0 ){
+			value = substitute_word(rotate_right(value, 8)) ^ round_constant;
+			//round constants don't depend on the key
+			round_constant = (round_constant << 1) ^ ((round_constant >> 7) * 0x11b);
+		} else if( (key_word_count > 6) && (i % key_word_count == 4) ){
+			value = substitute_word(value);
+		}
+		word[i] = word[i - key_word_count] ^ value;
+	}
+	return round_count;
+}
+
+#if defined SAPI_AES_X86
+
+bool is_aes_ni_available(){
+	static const bool is_available = []() -> bool {
+		//CPUID.1:ECX bit 25 indicates the AES instructions
+		unsigned int eax, ebx, ecx, edx;
+		if( __get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 ){
+			return false;
+		}
+		return (ecx & (1u << 25)) != 0;
+	}();
+	return is_available;
+}
+
+__attribute__((target("aes")))
+void expand_decrypt_key_ni(u8 decrypt_key[15][16], const u8 encrypt_key[15][16], u32 round_count){
+	memcpy(decrypt_key[0], encrypt_key[round_count], 16);
+	for(u32 round=1; round < round_count; round++){
+		_mm_storeu_si128(
+					reinterpret_cast<__m128i*>(decrypt_key[round]),
+					_mm_aesimc_si128(
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(encrypt_key[round_count - round]))
+						)
+					);
+	}
+	memcpy(decrypt_key[round_count], encrypt_key[0], 16);
+}
+
+//encrypts (or decrypts) eight blocks at a time so the instructions overlap
+#define SAPI_AES_NI_ROUNDS(block, count, key, round_count, round_function, last_function) \
+	do { \
+	for(u32 j=0; j < (count); j++){ (block)[j] = _mm_xor_si128((block)[j], (key)[0]); } \
+	for(u32 round=1; round < (round_count); round++){ \
+	for(u32 j=0; j < (count); j++){ (block)[j] = round_function((block)[j], (key)[round]); } \
+	} \
+	for(u32 j=0; j < (count); j++){ (block)[j] = last_function((block)[j], (key)[(round_count)]); } \
+	} while(0)
+
+__attribute__((target("aes")))
+void load_key_ni(__m128i key[15], const u8 round_key[15][16], u32 round_count){
+	for(u32 round=0; round <= round_count; round++){
+		key[round] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_key[round]));
+	}
+}
+
+__attribute__((target("aes")))
+void encrypt_blocks_ni(
+		const u8 round_key[15][16],
+		u32 round_count,
+		const u8 * input,
+		u8 * output,
+		u32 block_count
+		){
+	__m128i key[15];
+	load_key_ni(key, round_key, round_count);
+	while( block_count ){
+		const u32 count = block_count < 8 ? block_count : 8;
+		__m128i block[8];
+		for(u32 j=0; j < count; j++){
+			block[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16*j));
+		}
+		SAPI_AES_NI_ROUNDS(block, count, key, round_count, _mm_aesenc_si128, _mm_aesenclast_si128);
+		for(u32 j=0; j < count; j++){
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16*j), block[j]);
+		}
+		input += 16*count;
+		output += 16*count;
+		block_count -= count;
+	}
+}
+
+__attribute__((target("aes")))
+void decrypt_blocks_ni(
+		const u8 round_key[15][16],
+		u32 round_count,
+		const u8 * input,
+		u8 * output,
+		u32 block_count
+		){
+	__m128i key[15];
+	load_key_ni(key, round_key, round_count);
+	while( block_count ){
+		const u32 count = block_count < 8 ? block_count : 8;
+		__m128i block[8];
+		for(u32 j=0; j < count; j++){
+			block[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16*j));
+		}
+		SAPI_AES_NI_ROUNDS(block, count, key, round_count, _mm_aesdec_si128, _mm_aesdeclast_si128);
+		for(u32 j=0; j < count; j++){
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16*j), block[j]);
+		}
+		input += 16*count;
+		output += 16*count;
+		block_count -= count;
+	}
+}
+
+__attribute__((target("aes")))
+void encrypt_cbc_ni(
+		const u8 round_key[15][16],
+		u32 round_count,
+		u8 initialization_vector[16],
+		const u8 * input,
+		u8 * output,
+		u32 block_count
+		){
+	__m128i key[15];
+	load_key_ni(key, round_key, round_count);
+	__m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(initialization_vector));
+	for(u32 i=0; i < block_count; i++){
+		__m128i block[1] = {
+			_mm_xor_si128(chain, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16*i)))
+		};
+		SAPI_AES_NI_ROUNDS(block, 1, key, round_count, _mm_aesenc_si128, _mm_aesenclast_si128);
+		chain = block[0];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16*i), chain);
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(initialization_vector), chain);
+}
+
+__attribute__((target("aes")))
+void decrypt_cbc_ni(
+		const u8 round_key[15][16],
+		u32 round_count,
+		u8 initialization_vector[16],
+		const u8 * input,
+		u8 * output,
+		u32 block_count
+		){
+	__m128i key[15];
+	load_key_ni(key, round_key, round_count);
+	__m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(initialization_vector));
+	while( block_count ){
+		const u32 count = block_count < 8 ? block_count : 8;
+		__m128i cipher[8];
+		__m128i block[8];
+		for(u32 j=0; j < count; j++){
+			cipher[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16*j));
+			block[j] = cipher[j];
+		}
+		SAPI_AES_NI_ROUNDS(block, count, key, round_count, _mm_aesdec_si128, _mm_aesdeclast_si128);
+		for(u32 j=0; j < count; j++){
+			_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(output + 16*j),
+						_mm_xor_si128(block[j], j ? cipher[j-1] : chain)
+						);
+		}
+		chain = cipher[count-1];
+		input += 16*count;
+		output += 16*count;
+		block_count -= count;
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(initialization_vector), chain);
+}
+
+__attribute__((target("aes")))
+void encrypt_counter_ni(
+		const u8 round_key[15][16],
+		u32 round_count,
+		u8 counter[16],
+		u32 counter_size,
+		const u8 * input,
+		u8 * output,
+		u32 block_count
+		){
+	__m128i key[15];
+	load_key_ni(key, round_key, round_count);
+	while( block_count ){
+		const u32 count = block_count < 8 ? block_count : 8;
+		__m128i block[8];
+		for(u32 j=0; j < count; j++){
+			block[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counter));
+			increment_counter(counter, counter_size);
+		}
+		SAPI_AES_NI_ROUNDS(block, count, key, round_count, _mm_aesenc_si128, _mm_aesenclast_si128);
+		for(u32 j=0; j < count; j++){
+			_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(output + 16*j),
+						_mm_xor_si128(
+							block[j],
+							_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16*j))
+							)
+						);
+		}
+		input += 16*count;
+		output += 16*count;
+		block_count -= count;
+	}
+}
+
+#undef SAPI_AES_NI_ROUNDS
+
+#endif
+
+struct PageTransfer {
+	const fs::File * source;
+	const fs::File * destination;
+	var::Data * page;
+	u32 write_size;
+	int write_result;
+	int read_result;
+};
+
+int write_all(const fs::File & file, const u8 * data, u32 size){
+	while( size ){
+		const int result = file.write(data, fs::File::Size(size));
+		if( result <= 0 ){
+			return -1;
+		}
+		data += result;
+		size -= result;
+	}
+	return 0;
+}
+
+//writes the page (if it holds output) then reads the next input into it
+void * transfer_page(void * args){
+	PageTransfer * transfer = static_cast<PageTransfer*>(args);
+	transfer->write_result = 0;
+	if( transfer->write_size ){
+		transfer->write_result = write_all(
+					*transfer->destination,
+					transfer->page->to_const_u8(),
+					transfer->write_size
+					);
+	}
+	transfer->read_result = transfer->write_result < 0 ?
+				-1 :
+				transfer->source->read(*transfer->page);
+	return nullptr;
+}
+
+}
+
+Aes::Aes(enum backend backend){
+	m_is_software = (backend == backend_software) ||
+			(aes_api().is_valid() == false);
+	m_stream_offset = 16;
+	m_software_context.round_count = 0;
+	m_software_context.is_accelerated = false;
+}
+
 Aes::~Aes(){
 	m_initialization_vector.fill(0);
+	m_stream_block.fill(0);
 	finalize();
 }
 
+bool Aes::is_accelerated(){
+#if defined SAPI_AES_X86
+	return is_aes_ni_available();
+#else
+	return false;
+#endif
+}
+
 int Aes::initialize(){
-	if( aes_api().is_valid() == false ){
-		return set_error_number_if_error(api::error_code_crypto_missing_api);
-	}
 	finalize();
+	if( m_is_software ){
+		m_context = &m_software_context;
+		return 0;
+	}
 	int result = 0;
 	if( aes_api()->init(&m_context) < 0 ){
 		result = api::error_code_crypto_operation_failed;
@@ -25,7 +668,12 @@ int Aes::initialize(){
 
 int Aes::finalize(){
 	if( m_context != nullptr ){
-		aes_api()->deinit(&m_context);
+		if( m_is_software ){
+			clear(&m_software_context, sizeof(m_software_context));
+			m_context = nullptr;
+		} else {
+			aes_api()->deinit(&m_context);
+		}
 	}
 	return 0;
 }
@@ -44,12 +692,60 @@ Aes & Aes::set_initialization_vector(
 		m_initialization_vector.at(i) = value.to_const_u8()[i];
 	}
 
+	//the counter mode key stream starts over
+	m_stream_offset = 16;
+
 	return *this;
 }
 
 Aes & Aes::set_key(
 		const var::Reference & key
 		){
+	if( m_is_software ){
+		if( m_context == nullptr ){
+			initialize();
+		}
+
+		SoftwareContext & context = m_software_context;
+		u32 word[60];
+		context.round_count = expand_key(word, key.to_const_u8(), key.size());
+		if( context.round_count == 0 ){
+			set_error_number_if_error(api::error_code_crypto_bad_key_size);
+			return *this;
+		}
+
+		context.is_accelerated = is_accelerated();
+		for(u32 round=0; round <= context.round_count; round++){
+			const u32 * round_word = word + 4*round;
+			if( context.is_accelerated ){
+				for(u32 i=0; i < 4; i++){
+					store_little_endian(context.round_key[0][round] + 4*i, round_word[i]);
+				}
+			} else {
+				//both blocks use the same round key
+				u32 * sliced_key = context.sliced_key[round];
+				for(u32 i=0; i < 4; i++){
+					sliced_key[2*i] = round_word[i];
+					sliced_key[2*i+1] = round_word[i];
+				}
+				ortho(sliced_key);
+			}
+		}
+
+#if defined SAPI_AES_X86
+		if( context.is_accelerated ){
+			expand_decrypt_key_ni(
+						context.round_key[1],
+					context.round_key[0],
+					context.round_count
+					);
+		}
+#endif
+
+		clear(word, sizeof(word));
+		return *this;
+	}
+
 	set_error_number_if_error(
 				aes_api()->set_key(
 					m_context,
@@ -61,6 +757,258 @@ Aes & Aes::set_key(
 	return *this;
 }
 
+int Aes::encrypt_blocks(const u8 * input, u8 * output, u32 block_count){
+	if( m_is_software == false ){
+		for(u32 i=0; i < block_count; i++){
+			if( aes_api()->encrypt_ecb(
+						m_context,
+						input + 16*i,
+						output + 16*i
+						) < 0 ){
+				return -1;
+			}
+		}
+		return 0;
+	}
+
+	const SoftwareContext & context = m_software_context;
+#if defined SAPI_AES_X86
+	if( context.is_accelerated ){
+		encrypt_blocks_ni(
+					context.round_key[0],
+				context.round_count,
+				input,
+				output,
+				block_count
+				);
+		return 0;
+	}
+#endif
+
+	for(u32 i=0; i < block_count; i += 2){
+		const bool is_pair = i + 1 < block_count;
+		u32 q[8];
+		load_blocks(q, input + 16*i, is_pair ? input + 16*(i+1) : nullptr);
+		encrypt_sliced(context.sliced_key, context.round_count, q);
+		store_blocks(output + 16*i, is_pair ? output + 16*(i+1) : nullptr, q);
+	}
+	return 0;
+}
+
+int Aes::decrypt_blocks(const u8 * input, u8 * output, u32 block_count){
+	if( m_is_software == false ){
+		for(u32 i=0; i < block_count; i++){
+			if( aes_api()->decrypt_ecb(
+						m_context,
+						input + 16*i,
+						output + 16*i
+						) < 0 ){
+				return -1;
+			}
+		}
+		return 0;
+	}
+
+	const SoftwareContext & context = m_software_context;
+#if defined SAPI_AES_X86
+	if( context.is_accelerated ){
+		decrypt_blocks_ni(
+					context.round_key[1],
+				context.round_count,
+				input,
+				output,
+				block_count
+				);
+		return 0;
+	}
+#endif
+
+	for(u32 i=0; i < block_count; i += 2){
+		const bool is_pair = i + 1 < block_count;
+		u32 q[8];
+		load_blocks(q, input + 16*i, is_pair ? input + 16*(i+1) : nullptr);
+		decrypt_sliced(context.sliced_key, context.round_count, q);
+		store_blocks(output + 16*i, is_pair ? output + 16*(i+1) : nullptr, q);
+	}
+	return 0;
+}
+
+int Aes::encrypt_counter(
+		u8 counter[16],
+		u32 counter_size,
+		const u8 * input,
+		u8 * output,
+		u32 block_count
+		){
+
+#if defined SAPI_AES_X86
+	if( m_is_software && m_software_context.is_accelerated ){
+		encrypt_counter_ni(
+					m_software_context.round_key[0],
+				m_software_context.round_count,
+				counter,
+				counter_size,
+				input,
+				output,
+				block_count
+				);
+		return 0;
+	}
+#endif
+
+	//two blocks of key stream at a time (one pass of the bitsliced cipher)
+	while( block_count ){
+		const u32 count = block_count < 2 ? block_count : 2;
+		u8 key_stream[32];
+		memcpy(key_stream, counter, 16);
+		increment_counter(counter, counter_size);
+		if( count == 2 ){
+			memcpy(key_stream + 16, counter, 16);
+			increment_counter(counter, counter_size);
+		}
+		if( encrypt_blocks(key_stream, key_stream, count) < 0 ){
+			return -1;
+		}
+		for(u32 i=0; i < 16*count; i++){
+			output[i] = input[i] ^ key_stream[i];
+		}
+		input += 16*count;
+		output += 16*count;
+		block_count -= count;
+	}
+	return 0;
+}
+
+int Aes::transform_ctr(const u8 * input, u8 * output, u32 size){
+	u32 offset = 0;
+
+	//use the rest of the key stream block from the last call
+	while( (m_stream_offset < 16) && (offset < size) ){
+		output[offset] = input[offset] ^ m_stream_block.at(m_stream_offset++);
+		offset++;
+	}
+
+	const u32 block_count = (size - offset) / 16;
+	if( block_count ){
+		if( encrypt_counter(
+					m_initialization_vector.data(),
+					16,
+					input + offset,
+					output + offset,
+					block_count
+					) < 0 ){
+			return -1;
+		}
+		offset += block_count * 16;
+	}
+
+	if( offset < size ){
+		m_stream_block.fill(0);
+		if( encrypt_counter(
+					m_initialization_vector.data(),
+					16,
+					m_stream_block.data(),
+					m_stream_block.data(),
+					1
+					) < 0 ){
+			return -1;
+		}
+		m_stream_offset = 0;
+		while( offset < size ){
+			output[offset] = input[offset] ^ m_stream_block.at(m_stream_offset++);
+			offset++;
+		}
+	}
+
+	return size;
+}
+
+int Aes::transform_file(
+		const fs::File & source,
+		const fs::File & destination,
+		u32 page_size,
+		bool is_overlapped,
+		const PageFunction & page_function
+		){
+	if( is_overlapped ){
+		//one thread transfers every page of the file
+		sys::WorkerThread transfer;
+		return transform_pages(source, destination, page_size, &transfer, page_function);
+	}
+	return transform_pages(source, destination, page_size, nullptr, page_function);
+}
+
+int Aes::transform_pages(
+		const fs::File & source,
+		const fs::File & destination,
+		u32 page_size,
+		sys::WorkerThread * transfer,
+		const PageFunction & page_function
+		){
+	var::Data page_list[2] = {
+		var::Data(page_size),
+		var::Data(page_size)
+	};
+
+	if( (page_list[0].size() < page_size) || (page_list[1].size() < page_size) ){
+		return api::error_code_crypto_operation_failed;
+	}
+
+	u32 current = 0;
+	//size of the output in the other page that hasn't been written yet
+	u32 pending_size = 0;
+	int total = 0;
+	int result = source.read(page_list[current]);
+	while( result > 0 ){
+		PageTransfer next;
+		next.source = &source;
+		next.destination = &destination;
+		next.page = page_list + (current ^ 1);
+		next.write_size = pending_size;
+
+		if( transfer ){
+			transfer->execute(
+						sys::Thread::Function(transfer_page),
+						sys::Thread::FunctionArgument(&next)
+						);
+		}
+
+		if( page_function(page_list[current].to_u8(), result) < 0 ){
+			if( transfer ){
+				transfer->wait();
+			}
+			return api::error_code_crypto_operation_failed;
+		}
+		total += result;
+
+		if( transfer ){
+			transfer->wait();
+			pending_size = result;
+			current ^= 1;
+		} else {
+			next.page = page_list + current;
+			next.write_size = result;
+			transfer_page(&next);
+		}
+
+		if( next.write_result < 0 ){
+			return api::error_code_fs_failed_to_write;
+		}
+		result = next.read_result;
+	}
+
+	if( result < 0 ){
+		return api::error_code_fs_failed_to_read;
+	}
+
+	//the last page is transformed but not written
+	if( pending_size &&
+			(write_all(destination, page_list[current ^ 1].to_const_u8(), pending_size) < 0) ){
+		return api::error_code_fs_failed_to_write;
+	}
+
+	return total;
+}
 
 int Aes::encrypt_ecb(
 		SourcePlainData source_data,
@@ -75,18 +1023,12 @@ int Aes::encrypt_ecb(
 		return set_error_number_if_error(api::error_code_crypto_bad_block_size);
 	}
 
-	for(
-			u32 i=0;
-			i < source_data.argument().size();
-			i+=16
-			){
-		if( aes_api()->encrypt_ecb(
-					m_context,
-					source_data.argument().to_const_u8() + i,
-					destination_data.argument().to_u8() + i
-					) < 0 ){
-			return -1;
-		}
+	if( encrypt_blocks(
+				source_data.argument().to_const_u8(),
+				destination_data.argument().to_u8(),
+				source_data.argument().size() / 16
+				) < 0 ){
+		return -1;
 	}
 	return source_data.argument().size();
 
@@ -108,16 +1050,14 @@ int Aes::decrypt_ecb(
 					);
 	}
 
-	for(u32 i=0; i < source_data.argument().size(); i+=16){
-		if( aes_api()->decrypt_ecb(
-					m_context,
-					source_data.argument().to_const_u8() + i,
-					destination_data.argument().to_u8() + i
-					) < 0 ){
-			return set_error_number_if_error(
-						api::error_code_crypto_operation_failed
-						);
-		}
+	if( decrypt_blocks(
+				source_data.argument().to_const_u8(),
+				destination_data.argument().to_u8(),
+				source_data.argument().size() / 16
+				) < 0 ){
+		return set_error_number_if_error(
+					api::error_code_crypto_operation_failed
+					);
 	}
 
 	return set_error_number_if_error(
@@ -140,6 +1080,35 @@ int Aes::encrypt_cbc(
 		return set_error_number_if_error(api::error_code_crypto_bad_block_size);
 	}
 
+	if( m_is_software ){
+		const u8 * input = source_data.argument().to_const_u8();
+		u8 * output = destination_data.argument().to_u8();
+		const u32 block_count = source_data.argument().size() / 16;
+#if defined SAPI_AES_X86
+		if( m_software_context.is_accelerated ){
+			encrypt_cbc_ni(
+						m_software_context.round_key[0],
+					m_software_context.round_count,
+					m_initialization_vector.data(),
+					input,
+					output,
+					block_count
+					);
+			return source_data.argument().size();
+		}
+#endif
+		//each block depends on the one before so only one block is encrypted at a time
+		u8 * chain = m_initialization_vector.data();
+		for(u32 i=0; i < block_count; i++){
+			for(u32 j=0; j < 16; j++){
+				chain[j] ^= input[16*i + j];
+			}
+			encrypt_blocks(chain, chain, 1);
+			memcpy(output + 16*i, chain, 16);
+		}
+		return source_data.argument().size();
+	}
+
 	int result;
 	if( (result = aes_api()->encrypt_cbc(
 				 m_context,
@@ -169,6 +1138,42 @@ int Aes::decrypt_cbc(
 		return set_error_number_if_error(api::error_code_crypto_bad_block_size);
 	}
 
+	if( m_is_software ){
+		const u8 * input = source_data.argument().to_const_u8();
+		u8 * output = destination_data.argument().to_u8();
+		const u32 block_count = source_data.argument().size() / 16;
+#if defined SAPI_AES_X86
+		if( m_software_context.is_accelerated ){
+			decrypt_cbc_ni(
+						m_software_context.round_key[1],
+					m_software_context.round_count,
+					m_initialization_vector.data(),
+					input,
+					output,
+					block_count
+					);
+			return source_data.argument().size();
+		}
+#endif
+		//blocks are independent when decrypting so two are decrypted at a time
+		for(u32 i=0; i < block_count; i += 2){
+			const u32 count = (i + 1 < block_count) ? 2 : 1;
+			u8 cipher[32];
+			memcpy(cipher, input + 16*i, 16*count);
+			decrypt_blocks(cipher, output + 16*i, count);
+			for(u32 j=0; j < 16; j++){
+				output[16*i + j] ^= m_initialization_vector.at(j);
+			}
+			if( count == 2 ){
+				for(u32 j=0; j < 16; j++){
+					output[16*(i+1) + j] ^= cipher[j];
+				}
+			}
+			memcpy(m_initialization_vector.data(), cipher + 16*(count-1), 16);
+		}
+		return source_data.argument().size();
+	}
+
 	int result;
 	if( (result = aes_api()->decrypt_cbc(
 				 m_context,
@@ -187,17 +1192,59 @@ int Aes::encrypt_ctr(
 		SourcePlainData source_data,
 		DestinationCipherData destination_data
 		){
-	return set_error_number_if_error(
-				api::error_code_crypto_unsupported_operation
-				);
+	if( source_data.argument().size() >
+			destination_data.argument().size() ){
+		return set_error_number_if_error(api::error_code_crypto_size_mismatch);
+	}
+
+	if( transform_ctr(
+				source_data.argument().to_const_u8(),
+				destination_data.argument().to_u8(),
+				source_data.argument().size()
+				) < 0 ){
+		return set_error_number_if_error(
+					api::error_code_crypto_operation_failed
+					);
+	}
+
+	return source_data.argument().size();
 }
 
 int Aes::decrypt_ctr(
 		SourceCipherData source_data,
 		DestinationPlainData destination_data
 		){
-	return set_error_number_if_error(
-				api::error_code_crypto_unsupported_operation
+	//counter mode decryption is the same as encryption
+	return encrypt_ctr(
+				SourcePlainData(source_data.argument()),
+				DestinationCipherData(destination_data.argument())
 				);
 }
 
+int Aes::encrypt_ctr(
+		SourceFile source,
+		DestinationFile destination,
+		PageSize page_size,
+		IsOverlapped is_overlapped
+		){
+	return set_error_number_if_error(
+				transform_file(
+					source.argument(),
+					destination.argument(),
+					page_size.argument(),
+					is_overlapped.argument(),
+					[this](u8 * page, u32 size){
+						return transform_ctr(page, page, size);
+					}
+				)
+			);
+}
+
+int Aes::decrypt_ctr(
+		SourceFile source,
+		DestinationFile destination,
+		PageSize page_size,
+		IsOverlapped is_overlapped
+		){
+	return encrypt_ctr(source, destination, page_size, is_overlapped);
+}
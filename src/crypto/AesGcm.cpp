@@ -0,0 +1,509 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+#include "crypto/AesGcm.hpp"
+
+#if defined __link && defined __GNUC__ && defined __x86_64__
+#define SAPI_AES_GCM_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+using namespace crypto;
+
+namespace {
+
+inline u64 load_big_endian(const u8 * data){
+	u64 result = 0;
+	for(u32 i=0; i < 8; i++){
+		result = (result << 8) | data[i];
+	}
+	return result;
+}
+
+inline void store_big_endian(u8 * data, u64 value){
+	for(u32 i=0; i < 8; i++){
+		data[i] = static_cast<u8>(value >> (56 - 8*i));
+	}
+}
+
+/*
+ * Carry-less multiply of the low 64 bits using integer multiplies.
+ * Holes of three zero bits between the used bits absorb the carries
+ * so the time doesn't depend on the values.
+ */
+inline u64 multiply_carryless(u64 x, u64 y){
+	const u64 x0 = x & 0x1111111111111111ULL;
+	const u64 x1 = x & 0x2222222222222222ULL;
+	const u64 x2 = x & 0x4444444444444444ULL;
+	const u64 x3 = x & 0x8888888888888888ULL;
+	const u64 y0 = y & 0x1111111111111111ULL;
+	const u64 y1 = y & 0x2222222222222222ULL;
+	const u64 y2 = y & 0x4444444444444444ULL;
+	const u64 y3 = y & 0x8888888888888888ULL;
+	u64 z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+	u64 z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+	u64 z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+	u64 z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+	z0 &= 0x1111111111111111ULL;
+	z1 &= 0x2222222222222222ULL;
+	z2 &= 0x4444444444444444ULL;
+	z3 &= 0x8888888888888888ULL;
+	return z0 | z1 | z2 | z3;
+}
+
+inline u64 reverse_bits(u64 x){
+	x = ((x & 0x5555555555555555ULL) << 1) | ((x >> 1) & 0x5555555555555555ULL);
+	x = ((x & 0x3333333333333333ULL) << 2) | ((x >> 2) & 0x3333333333333333ULL);
+	x = ((x & 0x0f0f0f0f0f0f0f0fULL) << 4) | ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL);
+	x = ((x & 0x00ff00ff00ff00ffULL) << 8) | ((x >> 8) & 0x00ff00ff00ff00ffULL);
+	x = ((x & 0x0000ffff0000ffffULL) << 16) | ((x >> 16) & 0x0000ffff0000ffffULL);
+	return (x << 32) | (x >> 32);
+}
+
+//hash = (hash + block) * hash_key for each block (the last block is padded with zeros)
+void ghash_portable(u8 hash[16], const u8 hash_key[16], const u8 * data, u32 size){
+	u64 y1 = load_big_endian(hash);
+	u64 y0 = load_big_endian(hash + 8);
+	const u64 h1 = load_big_endian(hash_key);
+	const u64 h0 = load_big_endian(hash_key + 8);
+	const u64 h0r = reverse_bits(h0);
+	const u64 h1r = reverse_bits(h1);
+	const u64 h2 = h0 ^ h1;
+	const u64 h2r = h0r ^ h1r;
+
+	while( size ){
+		const u8 * block = data;
+		u8 padded_block[16];
+		if( size < 16 ){
+			memset(padded_block, 0, sizeof(padded_block));
+			memcpy(padded_block, data, size);
+			block = padded_block;
+			size = 16;
+		}
+		y1 ^= load_big_endian(block);
+		y0 ^= load_big_endian(block + 8);
+		data += 16;
+		size -= 16;
+
+		//Karatsuba: the high halves of the products come from the bit reversed values
+		const u64 y0r = reverse_bits(y0);
+		const u64 y1r = reverse_bits(y1);
+		const u64 y2 = y0 ^ y1;
+		const u64 y2r = y0r ^ y1r;
+
+		const u64 z0 = multiply_carryless(y0, h0);
+		const u64 z1 = multiply_carryless(y1, h1);
+		u64 z2 = multiply_carryless(y2, h2);
+		u64 z0h = multiply_carryless(y0r, h0r);
+		u64 z1h = multiply_carryless(y1r, h1r);
+		u64 z2h = multiply_carryless(y2r, h2r);
+		z2 ^= z0 ^ z1;
+		z2h ^= z0h ^ z1h;
+		z0h = reverse_bits(z0h) >> 1;
+		z1h = reverse_bits(z1h) >> 1;
+		z2h = reverse_bits(z2h) >> 1;
+
+		u64 v0 = z0;
+		u64 v1 = z0h ^ z2;
+		u64 v2 = z1 ^ z2h;
+		u64 v3 = z1h;
+
+		//GCM bit order is reflected so the 256-bit product is shifted by one
+		v3 = (v3 << 1) | (v2 >> 63);
+		v2 = (v2 << 1) | (v1 >> 63);
+		v1 = (v1 << 1) | (v0 >> 63);
+		v0 = (v0 << 1);
+
+		//reduce modulo x^128 + x^7 + x^2 + x + 1
+		v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+		v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+		v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+		v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+		y0 = v2;
+		y1 = v3;
+	}
+
+	store_big_endian(hash, y1);
+	store_big_endian(hash + 8, y0);
+}
+
+#if defined SAPI_AES_GCM_X86
+
+bool is_clmul_available(){
+	static const bool is_available = []() -> bool {
+		//CPUID.1:ECX bit 1 is PCLMULQDQ and bit 9 is SSSE3
+		unsigned int eax, ebx, ecx, edx;
+		if( __get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 ){
+			return false;
+		}
+		return (ecx & (1u << 1)) && (ecx & (1u << 9));
+	}();
+	return is_available;
+}
+
+//multiplies byte reversed values (Intel carry-less multiplication guide, algorithm 5)
+__attribute__((target("pclmul,ssse3")))
+inline __m128i multiply_clmul(__m128i a, __m128i b){
+	__m128i low = _mm_clmulepi64_si128(a, b, 0x00);
+	__m128i middle = _mm_xor_si128(
+				_mm_clmulepi64_si128(a, b, 0x10),
+				_mm_clmulepi64_si128(a, b, 0x01)
+				);
+	__m128i high = _mm_clmulepi64_si128(a, b, 0x11);
+	low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+	high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+
+	//shift the 256-bit product left by one
+	__m128i low_carry = _mm_srli_epi32(low, 31);
+	__m128i high_carry = _mm_srli_epi32(high, 31);
+	low = _mm_slli_epi32(low, 1);
+	high = _mm_slli_epi32(high, 1);
+	const __m128i cross_carry = _mm_srli_si128(low_carry, 12);
+	high_carry = _mm_slli_si128(high_carry, 4);
+	low_carry = _mm_slli_si128(low_carry, 4);
+	low = _mm_or_si128(low, low_carry);
+	high = _mm_or_si128(high, _mm_or_si128(high_carry, cross_carry));
+
+	//reduce modulo x^128 + x^7 + x^2 + x + 1
+	__m128i t = _mm_xor_si128(
+				_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)),
+				_mm_slli_epi32(low, 25)
+				);
+	const __m128i t_high = _mm_srli_si128(t, 4);
+	low = _mm_xor_si128(low, _mm_slli_si128(t, 12));
+	t = _mm_xor_si128(
+				_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)),
+				_mm_xor_si128(_mm_srli_epi32(low, 7), t_high)
+				);
+	return _mm_xor_si128(high, _mm_xor_si128(low, t));
+}
+
+__attribute__((target("pclmul,ssse3")))
+void ghash_clmul(u8 hash[16], const u8 hash_key[16], const u8 * data, u32 size){
+	const __m128i byte_reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i h = _mm_shuffle_epi8(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(hash_key)),
+				byte_reverse
+				);
+	__m128i y = _mm_shuffle_epi8(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(hash)),
+				byte_reverse
+				);
+
+	//four blocks at a time: y = (y + b0)h^4 + b1 h^3 + b2 h^2 + b3 h
+	if( size >= 64 ){
+		const __m128i h2 = multiply_clmul(h, h);
+		const __m128i h3 = multiply_clmul(h2, h);
+		const __m128i h4 = multiply_clmul(h2, h2);
+		while( size >= 64 ){
+			__m128i block[4];
+			for(u32 i=0; i < 4; i++){
+				block[i] = _mm_shuffle_epi8(
+							_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16*i)),
+							byte_reverse
+							);
+			}
+			y = _mm_xor_si128(
+						_mm_xor_si128(
+							multiply_clmul(_mm_xor_si128(y, block[0]), h4),
+						multiply_clmul(block[1], h3)
+						),
+					_mm_xor_si128(
+						multiply_clmul(block[2], h2),
+						multiply_clmul(block[3], h)
+						)
+					);
+			data += 64;
+			size -= 64;
+		}
+	}
+
+	while( size ){
+		__m128i block;
+		if( size < 16 ){
+			u8 padded_block[16] = {0};
+			memcpy(padded_block, data, size);
+			block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded_block));
+			size = 16;
+		} else {
+			block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		}
+		y = multiply_clmul(_mm_xor_si128(y, _mm_shuffle_epi8(block, byte_reverse)), h);
+		data += 16;
+		size -= 16;
+	}
+
+	_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(hash),
+				_mm_shuffle_epi8(y, byte_reverse)
+				);
+}
+
+#endif
+
+void ghash(u8 hash[16], const u8 hash_key[16], const u8 * data, u32 size){
+#if defined SAPI_AES_GCM_X86
+	if( is_clmul_available() ){
+		ghash_clmul(hash, hash_key, data, size);
+		return;
+	}
+#endif
+	ghash_portable(hash, hash_key, data, size);
+}
+
+//blocks processed per pass so the hash reads data that is still in the cache
+const u32 pass_block_count = 64;
+
+}
+
+AesGcm::AesGcm() : m_aes(Aes::backend_software){
+	m_stream_offset = 16;
+	m_tag_size = 16;
+	m_additional_size = 0;
+	m_size = 0;
+	m_mode = mode_encrypt;
+	m_is_key_set = false;
+	m_is_started = false;
+	m_tag.fill(0);
+}
+
+AesGcm::~AesGcm(){
+	m_hash_key.fill(0);
+	m_hash.fill(0);
+	m_stream_block.fill(0);
+	m_partial_block.fill(0);
+}
+
+bool AesGcm::is_accelerated(){
+#if defined SAPI_AES_GCM_X86
+	return Aes::is_accelerated() && is_clmul_available();
+#else
+	return false;
+#endif
+}
+
+AesGcm & AesGcm::set_key(const var::Reference & key){
+	m_is_key_set = false;
+	m_is_started = false;
+	m_aes.clear_result();
+	if( (m_aes.initialize() < 0) || (m_aes.set_key(key).return_value() < 0) ){
+		set_error_number_if_error(m_aes.return_value());
+		return *this;
+	}
+
+	//the hash key is the encrypted zero block
+	m_hash_key.fill(0);
+	m_aes.encrypt_blocks(m_hash_key.data(), m_hash_key.data(), 1);
+	m_is_key_set = true;
+	return *this;
+}
+
+AesGcm & AesGcm::set_tag_size(u32 value){
+	if( (value == 4) || (value == 8) || ((value >= 12) && (value <= 16)) ){
+		m_tag_size = value;
+	} else {
+		set_error_number_if_error(api::error_code_crypto_size_mismatch);
+	}
+	return *this;
+}
+
+int AesGcm::start(
+		enum modes mode,
+		const var::Reference & initialization_vector,
+		const var::Reference & additional_data
+		){
+	if( m_is_key_set == false ){
+		return set_error_number_if_error(api::error_code_crypto_bad_key_size);
+	}
+
+	if( initialization_vector.size() == 0 ){
+		return set_error_number_if_error(api::error_code_crypto_bad_iv_size);
+	}
+
+	if( initialization_vector.size() == 12 ){
+		memcpy(m_initial_counter.data(), initialization_vector.to_const_u8(), 12);
+		m_initial_counter.at(12) = 0;
+		m_initial_counter.at(13) = 0;
+		m_initial_counter.at(14) = 0;
+		m_initial_counter.at(15) = 1;
+	} else {
+		//other sizes are hashed
+		u8 length_block[16] = {0};
+		store_big_endian(length_block + 8, static_cast<u64>(initialization_vector.size()) * 8);
+		m_initial_counter.fill(0);
+		ghash(
+					m_initial_counter.data(),
+					m_hash_key.data(),
+					initialization_vector.to_const_u8(),
+					initialization_vector.size()
+					);
+		ghash(m_initial_counter.data(), m_hash_key.data(), length_block, 16);
+	}
+
+	m_counter = m_initial_counter;
+	//the first block of key stream is for the tag
+	for(u32 i=16; i > 12; i--){
+		if( ++m_counter.at(i-1) != 0 ){
+			break;
+		}
+	}
+
+	m_hash.fill(0);
+	ghash(
+				m_hash.data(),
+				m_hash_key.data(),
+				additional_data.to_const_u8(),
+				additional_data.size()
+				);
+
+	m_mode = mode;
+	m_additional_size = additional_data.size();
+	m_size = 0;
+	m_stream_offset = 16;
+	m_is_started = true;
+	return 0;
+}
+
+int AesGcm::transform(const u8 * input, u8 * output, u32 size){
+	const bool is_encrypt = m_mode == mode_encrypt;
+	u32 offset = 0;
+	m_size += size;
+
+	//finish the key stream block from the last call
+	while( (m_stream_offset < 16) && (offset < size) ){
+		const u8 value = input[offset];
+		output[offset] = value ^ m_stream_block.at(m_stream_offset);
+		m_partial_block.at(m_stream_offset++) = is_encrypt ? output[offset] : value;
+		offset++;
+		if( m_stream_offset == 16 ){
+			ghash(m_hash.data(), m_hash_key.data(), m_partial_block.data(), 16);
+		}
+	}
+
+	u32 block_count = (size - offset) / 16;
+	while( block_count ){
+		const u32 count = block_count < pass_block_count ? block_count : pass_block_count;
+		//the hash is always calculated on the cipher data
+		if( is_encrypt == false ){
+			ghash(m_hash.data(), m_hash_key.data(), input + offset, count * 16);
+		}
+		if( m_aes.encrypt_counter(m_counter.data(), 4, input + offset, output + offset, count) < 0 ){
+			return -1;
+		}
+		if( is_encrypt ){
+			ghash(m_hash.data(), m_hash_key.data(), output + offset, count * 16);
+		}
+		offset += count * 16;
+		block_count -= count;
+	}
+
+	if( offset < size ){
+		m_stream_block.fill(0);
+		if( m_aes.encrypt_counter(m_counter.data(), 4, m_stream_block.data(), m_stream_block.data(), 1) < 0 ){
+			return -1;
+		}
+		m_stream_offset = 0;
+		while( offset < size ){
+			const u8 value = input[offset];
+			output[offset] = value ^ m_stream_block.at(m_stream_offset);
+			m_partial_block.at(m_stream_offset++) = is_encrypt ? output[offset] : value;
+			offset++;
+		}
+	}
+
+	return size;
+}
+
+int AesGcm::update(
+		SourceData source_data,
+		DestinationData destination_data
+		){
+	if( m_is_started == false ){
+		return set_error_number_if_error(api::error_code_crypto_operation_failed);
+	}
+
+	if( source_data.argument().size() >
+			destination_data.argument().size() ){
+		return set_error_number_if_error(api::error_code_crypto_size_mismatch);
+	}
+
+	if( transform(
+				source_data.argument().to_const_u8(),
+				destination_data.argument().to_u8(),
+				source_data.argument().size()
+				) < 0 ){
+		return set_error_number_if_error(api::error_code_crypto_operation_failed);
+	}
+
+	return source_data.argument().size();
+}
+
+int AesGcm::update(
+		SourceFile source,
+		DestinationFile destination,
+		PageSize page_size,
+		IsOverlapped is_overlapped
+		){
+	if( m_is_started == false ){
+		return set_error_number_if_error(api::error_code_crypto_operation_failed);
+	}
+
+	return set_error_number_if_error(
+				Aes::transform_file(
+					source.argument(),
+					destination.argument(),
+					page_size.argument(),
+					is_overlapped.argument(),
+					[this](u8 * page, u32 size){
+						return transform(page, page, size);
+					}
+				)
+			);
+}
+
+int AesGcm::finish(){
+	if( m_is_started == false ){
+		return 0;
+	}
+	m_is_started = false;
+
+	if( m_stream_offset < 16 ){
+		ghash(m_hash.data(), m_hash_key.data(), m_partial_block.data(), m_stream_offset);
+		m_stream_offset = 16;
+	}
+
+	u8 length_block[16];
+	store_big_endian(length_block, m_additional_size * 8);
+	store_big_endian(length_block + 8, m_size * 8);
+	ghash(m_hash.data(), m_hash_key.data(), length_block, 16);
+
+	//the tag is the hash encrypted with the initial counter block
+	if( m_aes.encrypt_counter(m_initial_counter.data(), 4, m_hash.data(), m_tag.data(), 1) < 0 ){
+		return set_error_number_if_error(api::error_code_crypto_operation_failed);
+	}
+	return 0;
+}
+
+int AesGcm::verify(const var::Reference & expected_tag){
+	//the size is never taken from the tag that is received
+	if( expected_tag.size() != m_tag_size ){
+		finish();
+		return set_error_number_if_error(api::error_code_crypto_size_mismatch);
+	}
+
+	if( finish() < 0 ){
+		return -1;
+	}
+
+	u8 difference = 0;
+	for(u32 i=0; i < m_tag_size; i++){
+		difference |= m_tag.at(i) ^ expected_tag.to_const_u8()[i];
+	}
+
+	if( difference != 0 ){
+		return set_error_number_if_error(api::error_code_crypto_authentication_failed);
+	}
+	return 0;
+}
@@ -1,12 +1,308 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <cstring>
 #include "crypto/Sha256.hpp"
+#include "sys/WorkerThread.hpp"
+
+#if defined __link && defined __GNUC__ && defined __x86_64__
+#define SAPI_SHA256_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 using namespace crypto;
 
-Sha256::Sha256(){
-	if( sha256_api().is_valid() == false ){
-		exit_fatal("sha256_api api missing");
+namespace {
+
+const u32 sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const u32 sha256_initial_state[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+inline u32 rotate_right(u32 value, u32 count){
+	return (value >> count) | (value << (32 - count));
+}
+
+inline u32 load_big_endian(const u8 * data){
+	return (static_cast<u32>(data[0]) << 24) |
+			(static_cast<u32>(data[1]) << 16) |
+			(static_cast<u32>(data[2]) << 8) |
+			static_cast<u32>(data[3]);
+}
+
+inline void store_big_endian(u8 * data, u32 value){
+	data[0] = static_cast<u8>(value >> 24);
+	data[1] = static_cast<u8>(value >> 16);
+	data[2] = static_cast<u8>(value >> 8);
+	data[3] = static_cast<u8>(value);
+}
+
+void compress_portable(u32 state[8], const u8 * data, size_t block_count){
+	u32 w[16];
+	while( block_count-- ){
+		u32 a = state[0]; u32 b = state[1]; u32 c = state[2]; u32 d = state[3];
+		u32 e = state[4]; u32 f = state[5]; u32 g = state[6]; u32 h = state[7];
+
+		for(u32 t=0; t < 64; t++){
+			u32 word;
+			if( t < 16 ){
+				word = load_big_endian(data + 4*t);
+			} else {
+				const u32 w15 = w[(t-15) & 15];
+				const u32 w2 = w[(t-2) & 15];
+				word = w[t & 15] +
+						(rotate_right(w15, 7) ^ rotate_right(w15, 18) ^ (w15 >> 3)) +
+						w[(t-7) & 15] +
+						(rotate_right(w2, 17) ^ rotate_right(w2, 19) ^ (w2 >> 10));
+			}
+			w[t & 15] = word;
+
+			const u32 t1 = h +
+					(rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25)) +
+					((e & f) ^ (~e & g)) +
+					sha256_k[t] + word;
+			const u32 t2 =
+					(rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22)) +
+					((a & b) ^ (a & c) ^ (b & c));
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+		data += 64;
+	}
+}
+
+#if defined SAPI_SHA256_X86
+__attribute__((target("sha,sse4.1")))
+void compress_sha_ni(u32 state[8], const u8 * data, size_t block_count){
+	const __m128i byte_swap = _mm_set_epi64x(
+				0x0c0d0e0f08090a0bULL,
+				0x0405060700010203ULL
+				);
+
+	//the instructions use ABEF/CDGH ordering
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+	while( block_count-- ){
+		const __m128i abef = state0;
+		const __m128i cdgh = state1;
+		__m128i message[4];
+
+		for(u32 i=0; i < 16; i++){
+			__m128i & current = message[i & 3];
+			if( i < 4 ){
+				current = _mm_shuffle_epi8(
+							_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16*i)),
+							byte_swap
+							);
+			} else {
+				//W[t..t+3] from W[t-16..t-13], W[t-12..t-9], W[t-7..t-4] and W[t-4..t-1]
+				const __m128i & previous = message[(i-1) & 3];
+				tmp = _mm_sha256msg1_epu32(current, message[(i-3) & 3]);
+				tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(previous, message[(i-2) & 3], 4));
+				current = _mm_sha256msg2_epu32(tmp, previous);
+			}
+
+			__m128i rounds = _mm_add_epi32(
+						current,
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(sha256_k + 4*i))
+						);
+			state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+			rounds = _mm_shuffle_epi32(rounds, 0x0e);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, rounds);
+		}
+
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+		data += 64;
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+__attribute__((target("avx2")))
+inline __m256i rotate_right_x8(__m256i value, int count){
+	return _mm256_or_si256(
+				_mm256_srli_epi32(value, count),
+				_mm256_slli_epi32(value, 32 - count)
+				);
+}
+
+//state[word][lane]: hashes one block from each of eight independent messages
+__attribute__((target("avx2")))
+void compress_avx2_x8(u32 state[8][8], const u8 * const block_list[8]){
+	__m256i w[16];
+	__m256i v[8];
+	for(u32 i=0; i < 8; i++){
+		v[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[i]));
+	}
+
+	for(u32 t=0; t < 64; t++){
+		__m256i word;
+		if( t < 16 ){
+			word = _mm256_set_epi32(
+						static_cast<int>(load_big_endian(block_list[7] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[6] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[5] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[4] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[3] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[2] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[1] + 4*t)),
+					static_cast<int>(load_big_endian(block_list[0] + 4*t))
+					);
+		} else {
+			const __m256i w15 = w[(t-15) & 15];
+			const __m256i w2 = w[(t-2) & 15];
+			const __m256i sigma0 = _mm256_xor_si256(
+						_mm256_xor_si256(rotate_right_x8(w15, 7), rotate_right_x8(w15, 18)),
+						_mm256_srli_epi32(w15, 3)
+						);
+			const __m256i sigma1 = _mm256_xor_si256(
+						_mm256_xor_si256(rotate_right_x8(w2, 17), rotate_right_x8(w2, 19)),
+						_mm256_srli_epi32(w2, 10)
+						);
+			word = _mm256_add_epi32(
+						_mm256_add_epi32(w[t & 15], sigma0),
+						_mm256_add_epi32(w[(t-7) & 15], sigma1)
+						);
+		}
+		w[t & 15] = word;
+
+		const __m256i & a = v[0]; const __m256i & b = v[1];
+		const __m256i & c = v[2]; const __m256i & e = v[4];
+		const __m256i & f = v[5]; const __m256i & g = v[6];
+
+		const __m256i big_sigma1 = _mm256_xor_si256(
+					_mm256_xor_si256(rotate_right_x8(e, 6), rotate_right_x8(e, 11)),
+					rotate_right_x8(e, 25)
+					);
+		const __m256i choose = _mm256_xor_si256(
+					_mm256_and_si256(e, f),
+					_mm256_andnot_si256(e, g)
+					);
+		const __m256i t1 = _mm256_add_epi32(
+					_mm256_add_epi32(v[7], big_sigma1),
+					_mm256_add_epi32(
+						_mm256_add_epi32(choose, word),
+						_mm256_set1_epi32(static_cast<int>(sha256_k[t]))
+						)
+					);
+		const __m256i big_sigma0 = _mm256_xor_si256(
+					_mm256_xor_si256(rotate_right_x8(a, 2), rotate_right_x8(a, 13)),
+					rotate_right_x8(a, 22)
+					);
+		const __m256i majority = _mm256_or_si256(
+					_mm256_and_si256(a, b),
+					_mm256_and_si256(c, _mm256_or_si256(a, b))
+					);
+		const __m256i t2 = _mm256_add_epi32(big_sigma0, majority);
+
+		v[7] = v[6]; v[6] = v[5]; v[5] = v[4];
+		v[4] = _mm256_add_epi32(v[3], t1);
+		v[3] = v[2]; v[2] = v[1]; v[1] = v[0];
+		v[0] = _mm256_add_epi32(t1, t2);
+	}
+
+	for(u32 i=0; i < 8; i++){
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(state[i]),
+					_mm256_add_epi32(
+						v[i],
+						_mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[i]))
+					)
+				);
+	}
+}
+
+bool is_sha_ni_available(){
+	static const bool is_available = []() -> bool {
+		//CPUID.(EAX=7,ECX=0):EBX bit 29 indicates the SHA extensions
+		unsigned int eax, ebx, ecx, edx;
+		if( __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0 ){
+			return false;
+		}
+		return __builtin_cpu_supports("sse4.1") && (ebx & (1u << 29));
+	}();
+	return is_available;
+}
+
+bool is_avx2_available(){
+	static const bool is_available = __builtin_cpu_supports("avx2");
+	return is_available;
+}
+#endif
+
+u32 allowed_instruction_set = Sha256::instruction_set_all;
+
+bool is_sha_ni_enabled(){
+#if defined SAPI_SHA256_X86
+	return (allowed_instruction_set & Sha256::instruction_set_sha) && is_sha_ni_available();
+#else
+	return false;
+#endif
+}
+
+bool is_avx2_enabled(){
+#if defined SAPI_SHA256_X86
+	return (allowed_instruction_set & Sha256::instruction_set_avx2) && is_avx2_available();
+#else
+	return false;
+#endif
+}
+
+void compress(u32 state[8], const u8 * data, size_t block_count){
+#if defined SAPI_SHA256_X86
+	if( is_sha_ni_enabled() ){
+		compress_sha_ni(state, data, block_count);
+		return;
 	}
+#endif
+	compress_portable(state, data, block_count);
+}
+
+//builds the final one or two blocks of a message; returns the number of blocks
+u32 build_final_blocks(
+		u8 output[128],
+		const u8 * tail,
+		u32 tail_size,
+		u64 message_size
+		){
+	::memset(output, 0, 128);
+	::memcpy(output, tail, tail_size);
+	output[tail_size] = 0x80;
+	const u32 block_count = (tail_size < 56) ? 1 : 2;
+	const u64 bit_count = message_size * 8;
+	u8 * length = output + block_count*64 - 8;
+	store_big_endian(length, static_cast<u32>(bit_count >> 32));
+	store_big_endian(length + 4, static_cast<u32>(bit_count));
+	return block_count;
+}
+
+}
+
+Sha256::Sha256(enum backend backend){
+	m_is_software = (backend == backend_software) ||
+			(sha256_api().is_valid() == false);
 	m_context = 0;
 	m_is_finished = true;
 }
@@ -15,6 +311,25 @@ Sha256::~Sha256(){
 	finalize();
 }
 
+bool Sha256::is_accelerated(){
+	return is_sha_ni_enabled();
+}
+
+void Sha256::set_instruction_set(u32 value){
+	allowed_instruction_set = value;
+}
+
+u32 Sha256::instruction_set(){
+	u32 result = instruction_set_portable;
+	if( is_sha_ni_enabled() ){
+		result |= instruction_set_sha;
+	}
+	if( is_avx2_enabled() ){
+		result |= instruction_set_avx2;
+	}
+	return result;
+}
+
 Sha256 & Sha256::operator << (const var::Reference & a){
 	update(var::Reference::SourceBuffer(a.to_const_char()),
 				 var::Reference::Size(a.size())
@@ -24,6 +339,10 @@ Sha256 & Sha256::operator << (const var::Reference & a){
 
 int Sha256::initialize(){
 	finalize();
+	if( m_is_software ){
+		m_context = &m_software_context;
+		return 0;
+	}
 	return set_error_number_if_error(sha256_api()->init(&m_context));
 }
 
@@ -43,13 +362,26 @@ const var::Array<u8, 32> & Sha256::output(){
 
 int Sha256::finalize(){
 	if( m_context != 0 ){
-		sha256_api()->deinit(&m_context);
+		if( m_is_software == false ){
+			sha256_api()->deinit(&m_context);
+		}
+		m_context = 0;
 	}
 	return 0;
 }
 
 int Sha256::start(){
 	m_is_finished = false;
+	if( m_is_software ){
+		::memcpy(
+					m_software_context.state,
+					sha256_initial_state,
+					sizeof(sha256_initial_state)
+					);
+		m_software_context.length = 0;
+		m_software_context.block_size = 0;
+		return 0;
+	}
 	return set_error_number_if_error(sha256_api()->start(m_context));
 }
 
@@ -65,6 +397,41 @@ int Sha256::update(
 		start();
 	}
 
+	if( m_is_software ){
+		SoftwareContext & context = m_software_context;
+		const u8 * data = static_cast<const u8*>(input.argument());
+		size_t remaining = size.argument();
+		context.length += remaining;
+
+		if( context.block_size ){
+			u32 page_size = 64 - context.block_size;
+			if( page_size > remaining ){
+				page_size = static_cast<u32>(remaining);
+			}
+			::memcpy(context.block + context.block_size, data, page_size);
+			context.block_size += page_size;
+			data += page_size;
+			remaining -= page_size;
+			if( context.block_size < 64 ){
+				return 0;
+			}
+			compress(context.state, context.block, 1);
+			context.block_size = 0;
+		}
+
+		//whole blocks are hashed straight from the caller's buffer
+		const size_t block_count = remaining / 64;
+		if( block_count ){
+			compress(context.state, data, block_count);
+			data += block_count*64;
+			remaining -= block_count*64;
+		}
+
+		::memcpy(context.block, data, remaining);
+		context.block_size = static_cast<u32>(remaining);
+		return 0;
+	}
+
 	return set_error_number_if_error(sha256_api()->update(m_context, (const unsigned char*)input.argument(), size.argument()));
 }
 
@@ -74,7 +441,7 @@ var::String Sha256::calculate(
 		PageSize page_size
 		){
 	var::Data page(page_size.argument());
-	Sha256 hash;
+	Sha256 hash(is_accelerated() ? backend_software : backend_auto);
 
 	if( hash.initialize() < 0 ){
 		return var::String();
@@ -95,6 +462,69 @@ var::String Sha256::calculate(
 	return hash.to_string();
 }
 
+namespace {
+
+struct ReadAhead {
+	const fs::File * file;
+	var::Data * page;
+	int result;
+};
+
+void * read_ahead(void * args){
+	ReadAhead * read_ahead = static_cast<ReadAhead*>(args);
+	read_ahead->result = read_ahead->file->read(*read_ahead->page);
+	return nullptr;
+}
+
+}
+
+var::String Sha256::calculate(
+		const fs::File & file,
+		PageSize page_size,
+		IsOverlapped is_overlapped
+		){
+	if( is_overlapped.argument() == false ){
+		return calculate(file, page_size);
+	}
+
+	var::Data page_list[2] = {
+		var::Data(page_size.argument()),
+		var::Data(page_size.argument())
+	};
+	Sha256 hash(is_accelerated() ? backend_software : backend_auto);
+
+	if( (hash.initialize() < 0) || (hash.start() < 0) ){
+		return var::String();
+	}
+
+	//one reader thread is used for all the pages
+	sys::WorkerThread reader;
+	u32 current = 0;
+	int result = file.read(page_list[current]);
+	while( result > 0 ){
+		ReadAhead next;
+		next.file = &file;
+		next.page = page_list + (current ^ 1);
+		next.result = 0;
+
+		reader.execute(
+					sys::Thread::Function(read_ahead),
+					sys::Thread::FunctionArgument(&next)
+					);
+
+		hash.update(
+					var::Reference::SourceBuffer(page_list[current].to_const_char()),
+					var::Reference::Size(result)
+					);
+
+		reader.wait();
+		result = next.result;
+		current ^= 1;
+	}
+
+	return hash.to_string();
+}
+
 var::String Sha256::calculate(
 		const var::String & file_path,
 		PageSize page_size
@@ -108,12 +538,132 @@ var::String Sha256::calculate(
 		return var::String();
 	}
 
-	return calculate(f);
+	return calculate(f, page_size);
+}
+
+var::Vector<var::Array<u8, 32>> Sha256::calculate(
+		const var::Vector<var::Reference> & input_list
+		){
+	var::Vector<var::Array<u8, 32>> result(input_list.count());
+
+	u32 offset = 0;
+
+#if defined SAPI_SHA256_X86
+	//the SHA instructions are faster than eight lanes of AVX2
+	if( (is_sha_ni_enabled() == false) && is_avx2_enabled() ){
+		const u32 lane_count = 8;
+		for(; offset + lane_count <= input_list.count(); offset += lane_count){
+			u32 state[8][8];
+			u8 final_blocks[lane_count][128];
+			u32 full_block_count[lane_count];
+			u32 total_block_count[lane_count];
+			u32 maximum_block_count = 0;
+
+			for(u32 lane=0; lane < lane_count; lane++){
+				const var::Reference & input = input_list.at(offset + lane);
+				for(u32 i=0; i < 8; i++){
+					state[i][lane] = sha256_initial_state[i];
+				}
+				full_block_count[lane] = static_cast<u32>(input.size() / 64);
+				total_block_count[lane] = full_block_count[lane] +
+						build_final_blocks(
+							final_blocks[lane],
+							input.to_const_u8() + full_block_count[lane]*64,
+							static_cast<u32>(input.size() % 64),
+							input.size()
+							);
+				if( total_block_count[lane] > maximum_block_count ){
+					maximum_block_count = total_block_count[lane];
+				}
+			}
+
+			for(u32 block=0; block < maximum_block_count; block++){
+				const u8 * block_list[lane_count];
+				u32 previous_state[8][8];
+				::memcpy(previous_state, state, sizeof(state));
+
+				for(u32 lane=0; lane < lane_count; lane++){
+					const var::Reference & input = input_list.at(offset + lane);
+					if( block < full_block_count[lane] ){
+						block_list[lane] = input.to_const_u8() + block*64;
+					} else if( block < total_block_count[lane] ){
+						block_list[lane] = final_blocks[lane] + (block - full_block_count[lane])*64;
+					} else {
+						//this lane is finished: hash anything and restore the state below
+						block_list[lane] = final_blocks[lane];
+					}
+				}
+
+				compress_avx2_x8(state, block_list);
+
+				for(u32 lane=0; lane < lane_count; lane++){
+					if( block >= total_block_count[lane] ){
+						for(u32 i=0; i < 8; i++){
+							state[i][lane] = previous_state[i][lane];
+						}
+					}
+				}
+			}
+
+			for(u32 lane=0; lane < lane_count; lane++){
+				for(u32 i=0; i < 8; i++){
+					store_big_endian(result.at(offset + lane).data() + 4*i, state[i][lane]);
+				}
+			}
+		}
+	}
+#endif
+
+	for(; offset < input_list.count(); offset++){
+		const var::Reference & input = input_list.at(offset);
+		u32 state[8];
+		u8 final_blocks[128];
+		::memcpy(state, sha256_initial_state, sizeof(state));
+
+		const size_t full_block_count = input.size() / 64;
+		compress(state, input.to_const_u8(), full_block_count);
+		compress(
+					state,
+					final_blocks,
+					build_final_blocks(
+						final_blocks,
+						input.to_const_u8() + full_block_count*64,
+						static_cast<u32>(input.size() % 64),
+						input.size()
+						)
+					);
+
+		for(u32 i=0; i < 8; i++){
+			store_big_endian(result.at(offset).data() + 4*i, state[i]);
+		}
+	}
+
+	return result;
 }
 
 int Sha256::finish(){
 	if( m_is_finished == false){
 		m_is_finished = true;
+
+		if( m_is_software ){
+			SoftwareContext & context = m_software_context;
+			u8 final_blocks[128];
+			compress(
+						context.state,
+						final_blocks,
+						build_final_blocks(
+							final_blocks,
+							context.block,
+							context.block_size,
+							context.length
+							)
+						);
+			for(u32 i=0; i < 8; i++){
+				store_big_endian(m_output.data() + 4*i, context.state[i]);
+			}
+			return 0;
+		}
+
 		return set_error_number_if_error(
 					sha256_api()->finish(
 						m_context,
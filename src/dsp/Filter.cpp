@@ -39,7 +39,7 @@ BiquadFilterQ15::BiquadFilterQ15(const BiquadCoefficientsQ15 & coefficients, s8
 	if( api_q15().is_valid() && api_q15()->biquad_cascade_df1_init ){
 		api_q15()->biquad_cascade_df1_init(
 					instance(),
-					coefficients.count(),
+					coefficients.stages(),
 					(q15_t*)coefficients.to_const_void(),
 					m_state.data(),
 					post_shift);
@@ -53,7 +53,7 @@ BiquadFilterQ31::BiquadFilterQ31(const BiquadCoefficientsQ31 & coefficients, s8
 	if( api_q31().is_valid() && api_q31()->biquad_cascade_df1_init ){
 		api_q31()->biquad_cascade_df1_init(
 					instance(),
-					coefficients.count(),
+					coefficients.stages(),
 					(q31_t*)coefficients.to_const_void(),
 					m_state.data(),
 					post_shift);
@@ -67,7 +67,7 @@ BiquadFilterF32::BiquadFilterF32(const BiquadCoefficientsF32 & coefficients){
 	if( api_f32().is_valid() && api_f32()->biquad_cascade_df1_init ){
 		api_f32()->biquad_cascade_df1_init(
 					instance(),
-					coefficients.count(),
+					coefficients.stages(),
 					(float32_t*)coefficients.to_const_void(),
 					m_state.data()
 					);
@@ -0,0 +1,1947 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cmath>
+#include <cstring>
+#include "dsp/dsp_host_api.h"
+#include "var/Vector.hpp"
+#include "HostDspTransform.h"
+
+#if !defined SAPI_DSP_HOST_SIMD
+#define SAPI_DSP_HOST_SIMD 1
+#endif
+
+#if SAPI_DSP_HOST_SIMD && defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+#define DSP_HOST_USE_X86 1
+#include <immintrin.h>
+#else
+#define DSP_HOST_USE_X86 0
+#endif
+
+#if SAPI_DSP_HOST_SIMD && defined __aarch64__ && defined __ARM_NEON
+#define DSP_HOST_USE_NEON 1
+#include <arm_neon.h>
+#else
+#define DSP_HOST_USE_NEON 0
+#endif
+
+/*
+ * The functions in this file follow the CMSIS DSP C code
+ * (the code that is used on Cortex-M processors without the DSP
+ * instructions). The comments show where the results depend
+ * on the accumulator width or on a truncation.
+ *
+ * The operations that are used the most are "kernels" that
+ * work on arrays. Each kernel has a scalar version
+ * (which is also used for the last few items of the vector versions) and
+ * vector versions from HostDspKernels.h that give the same results.
+ *
+ */
+
+namespace {
+
+/*! \cond */
+inline q7_t ssat8(q31_t value){
+	return value > INT8_MAX ? INT8_MAX : (value < INT8_MIN ? INT8_MIN : static_cast<q7_t>(value));
+}
+
+inline q15_t ssat16(q31_t value){
+	return value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : static_cast<q15_t>(value));
+}
+
+inline q31_t clip_q63_to_q31(q63_t value){
+	return value > INT32_MAX ? INT32_MAX : (value < INT32_MIN ? INT32_MIN : static_cast<q31_t>(value));
+}
+
+//__SSAT(value, 16) takes an int32 (a wider accumulator is truncated first)
+inline q15_t ssat16_truncate(q63_t value){
+	return ssat16(static_cast<q31_t>(value));
+}
+
+inline q31_t wrap_add(q31_t a, q31_t b){
+	return static_cast<q31_t>(static_cast<u32>(a) + static_cast<u32>(b));
+}
+
+inline q63_t wrap_add(q63_t a, q63_t b){
+	return static_cast<q63_t>(static_cast<u64>(a) + static_cast<u64>(b));
+}
+
+//multAcc_32x32_keep32(_R): adds the upper 32 bits of x*y (+ round) to a
+inline q31_t multiply_accumulate_high(q31_t a, q31_t x, q31_t y, q63_t round){
+	const u64 sum = (static_cast<u64>(static_cast<u32>(a)) << 32)
+			+ static_cast<u64>(static_cast<q63_t>(x) * y)
+			+ static_cast<u64>(round);
+	return static_cast<q31_t>(static_cast<u32>(sum >> 32));
+}
+
+inline q31_t shift_left_saturate(q31_t value, u32 shift){
+	if( value == 0 ){ return 0; }
+	if( shift > 31 ){
+		return value < 0 ? INT32_MIN : INT32_MAX;
+	}
+	const q31_t result = static_cast<q31_t>(static_cast<u32>(value) << shift);
+	if( (result >> shift) != value ){
+		return INT32_MAX ^ (value >> 31);
+	}
+	return result;
+}
+
+inline q31_t shift_right(q31_t value, u32 shift){
+	return value >> (shift > 31 ? 31 : shift);
+}
+
+inline q15_t mult_q15(q15_t a, q15_t b){
+	return ssat16((static_cast<q31_t>(a) * b) >> 15);
+}
+
+inline q31_t mult_high_q31(q31_t a, q31_t b){
+	return static_cast<q31_t>((static_cast<q63_t>(a) * b) >> 32);
+}
+
+inline q31_t mult_q31(q31_t a, q31_t b){
+	q31_t result = mult_high_q31(a, b);
+	//__SSAT(result, 31)
+	if( result > 0x3fffffff ){ result = 0x3fffffff; }
+	return static_cast<q31_t>(static_cast<u32>(result) << 1);
+}
+
+inline q15_t scale_q15(q15_t value, q15_t scale_fraction, int shift){
+	const q31_t product = static_cast<q31_t>(value) * scale_fraction;
+	const int right_shift = 15 - shift;
+	if( right_shift >= 0 ){
+		return ssat16(product >> (right_shift > 31 ? 31 : right_shift));
+	}
+	return ssat16(clip_q63_to_q31(static_cast<q63_t>(product) << (-right_shift > 31 ? 31 : -right_shift)));
+}
+
+inline q31_t scale_q31(q31_t value, q31_t scale_fraction, int shift){
+	const q31_t high = mult_high_q31(value, scale_fraction);
+	const int left_shift = shift + 1;
+	if( left_shift >= 0 ){
+		return shift_left_saturate(high, left_shift);
+	}
+	return shift_right(high, -left_shift);
+}
+
+inline q15_t shift_q15(q15_t value, int shift){
+	if( shift >= 0 ){
+		return ssat16(static_cast<q31_t>(value) << (shift > 16 ? 16 : shift));
+	}
+	return static_cast<q15_t>(value >> (-shift > 15 ? 15 : -shift));
+}
+
+inline q31_t shift_q31(q31_t value, int shift){
+	if( shift >= 0 ){
+		return shift_left_saturate(value, shift);
+	}
+	return shift_right(value, -shift);
+}
+
+inline q15_t abs_q15(q15_t value){
+	return value > 0 ? value : (value == INT16_MIN ? INT16_MAX : static_cast<q15_t>(-value));
+}
+
+inline q31_t abs_q31(q31_t value){
+	return value > 0 ? value : (value == INT32_MIN ? INT32_MAX : -value);
+}
+
+inline q15_t negate_q15(q15_t value){
+	return value == INT16_MIN ? INT16_MAX : static_cast<q15_t>(-value);
+}
+
+inline q31_t negate_q31(q31_t value){
+	return value == INT32_MIN ? INT32_MAX : -value;
+}
+
+//scalar kernels
+void add_q15_scalar(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat16(static_cast<q31_t>(a[i]) + b[i]); }
+}
+
+void sub_q15_scalar(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat16(static_cast<q31_t>(a[i]) - b[i]); }
+}
+
+void mult_q15_scalar(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = mult_q15(a[i], b[i]); }
+}
+
+void offset_q15_scalar(const q15_t * source, q15_t offset, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat16(static_cast<q31_t>(source[i]) + offset); }
+}
+
+void scale_q15_scalar(const q15_t * source, q15_t scale_fraction, s8 shift, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = scale_q15(source[i], scale_fraction, shift); }
+}
+
+void shift_q15_scalar(const q15_t * source, s8 shift, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = shift_q15(source[i], shift); }
+}
+
+void abs_q15_scalar(const q15_t * source, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = abs_q15(source[i]); }
+}
+
+void negate_q15_scalar(const q15_t * source, q15_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = negate_q15(source[i]); }
+}
+
+//arm_mean_q15() adds in a q31_t
+q31_t sum_q15_scalar(const q15_t * source, u32 count){
+	q31_t result = 0;
+	for(u32 i=0; i < count; i++){ result = wrap_add(result, static_cast<q31_t>(source[i])); }
+	return result;
+}
+
+q63_t power_q15_scalar(const q15_t * source, u32 count){
+	q63_t result = 0;
+	for(u32 i=0; i < count; i++){ result += static_cast<q31_t>(source[i]) * source[i]; }
+	return result;
+}
+
+q63_t dot_prod_q15_scalar(const q15_t * a, const q15_t * b, u32 count){
+	q63_t result = 0;
+	for(u32 i=0; i < count; i++){ result += static_cast<q31_t>(a[i]) * b[i]; }
+	return result;
+}
+
+q15_t min_q15_scalar(const q15_t * source, u32 count){
+	q15_t result = source[0];
+	for(u32 i=1; i < count; i++){ if( source[i] < result ){ result = source[i]; } }
+	return result;
+}
+
+q15_t max_q15_scalar(const q15_t * source, u32 count){
+	q15_t result = source[0];
+	for(u32 i=1; i < count; i++){ if( source[i] > result ){ result = source[i]; } }
+	return result;
+}
+
+/*
+ * The FIR filters and the convolutions calculate
+ * destination[n] = sum(coefficients[k] * source[n+k]) for each output. The
+ * "fast" q15 versions add in a q31_t (overflow wraps) and the
+ * q31 versions add the upper 32 bits of each product.
+ *
+ */
+void correlate_fast_q15_scalar(const q15_t * source, const q15_t * coefficients, u32 tap_count, q15_t * destination, u32 count){
+	for(u32 n=0; n < count; n++){
+		q31_t sum = 0;
+		for(u32 k=0; k < tap_count; k++){
+			sum = wrap_add(sum, static_cast<q31_t>(coefficients[k]) * source[n+k]);
+		}
+		destination[n] = ssat16(sum >> 15);
+	}
+}
+
+void correlate_fast_q31_scalar(const q31_t * source, const q31_t * coefficients, u32 tap_count, q31_t * destination, u32 count, q63_t round){
+	for(u32 n=0; n < count; n++){
+		q31_t sum = 0;
+		for(u32 k=0; k < tap_count; k++){
+			sum = multiply_accumulate_high(sum, source[n+k], coefficients[k], round);
+		}
+		destination[n] = static_cast<q31_t>(static_cast<u32>(sum) << 1);
+	}
+}
+
+void add_q31_scalar(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = clip_q63_to_q31(static_cast<q63_t>(a[i]) + b[i]); }
+}
+
+void sub_q31_scalar(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = clip_q63_to_q31(static_cast<q63_t>(a[i]) - b[i]); }
+}
+
+void mult_q31_scalar(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = mult_q31(a[i], b[i]); }
+}
+
+void offset_q31_scalar(const q31_t * source, q31_t offset, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = clip_q63_to_q31(static_cast<q63_t>(source[i]) + offset); }
+}
+
+void scale_q31_scalar(const q31_t * source, q31_t scale_fraction, s8 shift, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = scale_q31(source[i], scale_fraction, shift); }
+}
+
+void shift_q31_scalar(const q31_t * source, s8 shift, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = shift_q31(source[i], shift); }
+}
+
+void abs_q31_scalar(const q31_t * source, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = abs_q31(source[i]); }
+}
+
+void negate_q31_scalar(const q31_t * source, q31_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = negate_q31(source[i]); }
+}
+
+q63_t sum_q31_scalar(const q31_t * source, u32 count){
+	q63_t result = 0;
+	for(u32 i=0; i < count; i++){ result += source[i]; }
+	return result;
+}
+
+//arm_power_q31() and arm_dot_prod_q31() add the products in 16.48 format
+q63_t power_q31_scalar(const q31_t * source, u32 count){
+	q63_t result = 0;
+	for(u32 i=0; i < count; i++){ result = wrap_add(result, (static_cast<q63_t>(source[i]) * source[i]) >> 14); }
+	return result;
+}
+
+q63_t dot_prod_q31_scalar(const q31_t * a, const q31_t * b, u32 count){
+	q63_t result = 0;
+	for(u32 i=0; i < count; i++){ result = wrap_add(result, (static_cast<q63_t>(a[i]) * b[i]) >> 14); }
+	return result;
+}
+
+q31_t min_q31_scalar(const q31_t * source, u32 count){
+	q31_t result = source[0];
+	for(u32 i=1; i < count; i++){ if( source[i] < result ){ result = source[i]; } }
+	return result;
+}
+
+q31_t max_q31_scalar(const q31_t * source, u32 count){
+	q31_t result = source[0];
+	for(u32 i=1; i < count; i++){ if( source[i] > result ){ result = source[i]; } }
+	return result;
+}
+
+void add_f32_scalar(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = a[i] + b[i]; }
+}
+
+void sub_f32_scalar(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = a[i] - b[i]; }
+}
+
+void mult_f32_scalar(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = a[i] * b[i]; }
+}
+
+void offset_f32_scalar(const float32_t * source, float32_t offset, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = source[i] + offset; }
+}
+
+void scale_f32_scalar(const float32_t * source, float32_t scale, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = source[i] * scale; }
+}
+
+void abs_f32_scalar(const float32_t * source, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = std::fabs(source[i]); }
+}
+
+void negate_f32_scalar(const float32_t * source, float32_t * destination, u32 count){
+	for(u32 i=0; i < count; i++){ destination[i] = -source[i]; }
+}
+
+float32_t sum_f32_scalar(const float32_t * source, u32 count){
+	float32_t result = 0.0f;
+	for(u32 i=0; i < count; i++){ result += source[i]; }
+	return result;
+}
+
+float32_t power_f32_scalar(const float32_t * source, u32 count){
+	float32_t result = 0.0f;
+	for(u32 i=0; i < count; i++){ result += source[i] * source[i]; }
+	return result;
+}
+
+float32_t dot_prod_f32_scalar(const float32_t * a, const float32_t * b, u32 count){
+	float32_t result = 0.0f;
+	for(u32 i=0; i < count; i++){ result += a[i] * b[i]; }
+	return result;
+}
+
+//sum of (source[i] - mean)^2 (arm_var_f32() uses two passes)
+float32_t deviation_f32_scalar(const float32_t * source, u32 count, float32_t mean){
+	float32_t result = 0.0f;
+	for(u32 i=0; i < count; i++){
+		const float32_t difference = source[i] - mean;
+		result += difference * difference;
+	}
+	return result;
+}
+
+float32_t min_f32_scalar(const float32_t * source, u32 count){
+	float32_t result = source[0];
+	for(u32 i=1; i < count; i++){ if( source[i] < result ){ result = source[i]; } }
+	return result;
+}
+
+float32_t max_f32_scalar(const float32_t * source, u32 count){
+	float32_t result = source[0];
+	for(u32 i=1; i < count; i++){ if( source[i] > result ){ result = source[i]; } }
+	return result;
+}
+
+void correlate_f32_scalar(const float32_t * source, const float32_t * coefficients, u32 tap_count, float32_t * destination, u32 count){
+	for(u32 n=0; n < count; n++){
+		float32_t sum = 0.0f;
+		for(u32 k=0; k < tap_count; k++){
+			sum += coefficients[k] * source[n+k];
+		}
+		destination[n] = sum;
+	}
+}
+
+struct Kernels {
+	void (*add_q15)(const q15_t * a, const q15_t * b, q15_t * destination, u32 count);
+	void (*sub_q15)(const q15_t * a, const q15_t * b, q15_t * destination, u32 count);
+	void (*mult_q15)(const q15_t * a, const q15_t * b, q15_t * destination, u32 count);
+	void (*offset_q15)(const q15_t * source, q15_t offset, q15_t * destination, u32 count);
+	void (*scale_q15)(const q15_t * source, q15_t scale_fraction, s8 shift, q15_t * destination, u32 count);
+	void (*shift_q15)(const q15_t * source, s8 shift, q15_t * destination, u32 count);
+	void (*abs_q15)(const q15_t * source, q15_t * destination, u32 count);
+	void (*negate_q15)(const q15_t * source, q15_t * destination, u32 count);
+	q31_t (*sum_q15)(const q15_t * source, u32 count);
+	q63_t (*power_q15)(const q15_t * source, u32 count);
+	q63_t (*dot_prod_q15)(const q15_t * a, const q15_t * b, u32 count);
+	q15_t (*min_q15)(const q15_t * source, u32 count);
+	q15_t (*max_q15)(const q15_t * source, u32 count);
+	void (*correlate_fast_q15)(const q15_t * source, const q15_t * coefficients, u32 tap_count, q15_t * destination, u32 count);
+
+	void (*add_q31)(const q31_t * a, const q31_t * b, q31_t * destination, u32 count);
+	void (*sub_q31)(const q31_t * a, const q31_t * b, q31_t * destination, u32 count);
+	void (*mult_q31)(const q31_t * a, const q31_t * b, q31_t * destination, u32 count);
+	void (*offset_q31)(const q31_t * source, q31_t offset, q31_t * destination, u32 count);
+	void (*scale_q31)(const q31_t * source, q31_t scale_fraction, s8 shift, q31_t * destination, u32 count);
+	void (*shift_q31)(const q31_t * source, s8 shift, q31_t * destination, u32 count);
+	void (*abs_q31)(const q31_t * source, q31_t * destination, u32 count);
+	void (*negate_q31)(const q31_t * source, q31_t * destination, u32 count);
+	q63_t (*sum_q31)(const q31_t * source, u32 count);
+	q63_t (*power_q31)(const q31_t * source, u32 count);
+	q63_t (*dot_prod_q31)(const q31_t * a, const q31_t * b, u32 count);
+	q31_t (*min_q31)(const q31_t * source, u32 count);
+	q31_t (*max_q31)(const q31_t * source, u32 count);
+	void (*correlate_fast_q31)(const q31_t * source, const q31_t * coefficients, u32 tap_count, q31_t * destination, u32 count, q63_t round);
+
+	void (*add_f32)(const float32_t * a, const float32_t * b, float32_t * destination, u32 count);
+	void (*sub_f32)(const float32_t * a, const float32_t * b, float32_t * destination, u32 count);
+	void (*mult_f32)(const float32_t * a, const float32_t * b, float32_t * destination, u32 count);
+	void (*offset_f32)(const float32_t * source, float32_t offset, float32_t * destination, u32 count);
+	void (*scale_f32)(const float32_t * source, float32_t scale, float32_t * destination, u32 count);
+	void (*abs_f32)(const float32_t * source, float32_t * destination, u32 count);
+	void (*negate_f32)(const float32_t * source, float32_t * destination, u32 count);
+	float32_t (*sum_f32)(const float32_t * source, u32 count);
+	float32_t (*power_f32)(const float32_t * source, u32 count);
+	float32_t (*dot_prod_f32)(const float32_t * a, const float32_t * b, u32 count);
+	float32_t (*deviation_f32)(const float32_t * source, u32 count, float32_t mean);
+	float32_t (*min_f32)(const float32_t * source, u32 count);
+	float32_t (*max_f32)(const float32_t * source, u32 count);
+	void (*correlate_f32)(const float32_t * source, const float32_t * coefficients, u32 tap_count, float32_t * destination, u32 count);
+};
+
+#define DSP_HOST_KERNEL_LIST(prefix, suffix) \
+	prefix add_q15##suffix, prefix sub_q15##suffix, prefix mult_q15##suffix, prefix offset_q15##suffix, \
+	prefix scale_q15##suffix, prefix shift_q15##suffix, prefix abs_q15##suffix, prefix negate_q15##suffix, \
+	prefix sum_q15##suffix, prefix power_q15##suffix, prefix dot_prod_q15##suffix, \
+	prefix min_q15##suffix, prefix max_q15##suffix, prefix correlate_fast_q15##suffix, \
+	prefix add_q31##suffix, prefix sub_q31##suffix, prefix mult_q31##suffix, prefix offset_q31##suffix, \
+	prefix scale_q31##suffix, prefix shift_q31##suffix, prefix abs_q31##suffix, prefix negate_q31##suffix, \
+	prefix sum_q31##suffix, prefix power_q31##suffix, prefix dot_prod_q31##suffix, \
+	prefix min_q31##suffix, prefix max_q31##suffix, prefix correlate_fast_q31##suffix, \
+	prefix add_f32##suffix, prefix sub_f32##suffix, prefix mult_f32##suffix, prefix offset_f32##suffix, \
+	prefix scale_f32##suffix, prefix abs_f32##suffix, prefix negate_f32##suffix, \
+	prefix sum_f32##suffix, prefix power_f32##suffix, prefix dot_prod_f32##suffix, prefix deviation_f32##suffix, \
+	prefix min_f32##suffix, prefix max_f32##suffix, prefix correlate_f32##suffix
+
+const Kernels scalar_kernels = { DSP_HOST_KERNEL_LIST(, _scalar) };
+
+#if DSP_HOST_USE_X86
+
+/*
+ * HostDspKernels.h has the vector kernels. It is
+ * included once for each instruction set with Vector
+ * defined as the operations on one register.
+ *
+ */
+namespace sse4_1 {
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+struct Vector {
+	typedef __m128i integer_t;
+	typedef __m128 float_t;
+	enum { size = 16 };
+
+	static integer_t load(const void * value){ return _mm_loadu_si128(static_cast<const __m128i*>(value)); }
+	static void store(void * destination, integer_t value){ _mm_storeu_si128(static_cast<__m128i*>(destination), value); }
+	static float_t load_float(const float32_t * value){ return _mm_loadu_ps(value); }
+	static void store_float(float32_t * destination, float_t value){ _mm_storeu_ps(destination, value); }
+
+	static integer_t zero(){ return _mm_setzero_si128(); }
+	static integer_t set_s16(s16 value){ return _mm_set1_epi16(value); }
+	static integer_t set_s32(s32 value){ return _mm_set1_epi32(value); }
+	static integer_t set_s64(s64 value){ return _mm_set1_epi64x(value); }
+	static float_t set_float(float32_t value){ return _mm_set1_ps(value); }
+	static float_t zero_float(){ return _mm_setzero_ps(); }
+
+	static integer_t bit_and(integer_t a, integer_t b){ return _mm_and_si128(a, b); }
+	static integer_t bit_and_not(integer_t a, integer_t b){ return _mm_andnot_si128(a, b); }
+	static integer_t bit_or(integer_t a, integer_t b){ return _mm_or_si128(a, b); }
+	static integer_t bit_xor(integer_t a, integer_t b){ return _mm_xor_si128(a, b); }
+	static integer_t select(integer_t a, integer_t b, integer_t mask){ return _mm_blendv_epi8(a, b, mask); }
+
+	static integer_t add_s16(integer_t a, integer_t b){ return _mm_add_epi16(a, b); }
+	static integer_t add_saturate_s16(integer_t a, integer_t b){ return _mm_adds_epi16(a, b); }
+	static integer_t subtract_saturate_s16(integer_t a, integer_t b){ return _mm_subs_epi16(a, b); }
+	static integer_t multiply_low_s16(integer_t a, integer_t b){ return _mm_mullo_epi16(a, b); }
+	static integer_t multiply_high_s16(integer_t a, integer_t b){ return _mm_mulhi_epi16(a, b); }
+	static integer_t multiply_add_s16(integer_t a, integer_t b){ return _mm_madd_epi16(a, b); }
+	static integer_t equal_s16(integer_t a, integer_t b){ return _mm_cmpeq_epi16(a, b); }
+	static integer_t shift_left_s16(integer_t a, int count){ return _mm_sll_epi16(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_s16(integer_t a, int count){ return _mm_sra_epi16(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_u16(integer_t a, int count){ return _mm_srl_epi16(a, _mm_cvtsi32_si128(count)); }
+	static integer_t abs_s16(integer_t a){ return _mm_abs_epi16(a); }
+	static integer_t min_u16(integer_t a, integer_t b){ return _mm_min_epu16(a, b); }
+	static integer_t min_s16(integer_t a, integer_t b){ return _mm_min_epi16(a, b); }
+	static integer_t max_s16(integer_t a, integer_t b){ return _mm_max_epi16(a, b); }
+	static integer_t unpack_low_s16(integer_t a, integer_t b){ return _mm_unpacklo_epi16(a, b); }
+	static integer_t unpack_high_s16(integer_t a, integer_t b){ return _mm_unpackhi_epi16(a, b); }
+	static integer_t pack_saturate_s32(integer_t a, integer_t b){ return _mm_packs_epi32(a, b); }
+
+	static integer_t add_s32(integer_t a, integer_t b){ return _mm_add_epi32(a, b); }
+	static integer_t subtract_s32(integer_t a, integer_t b){ return _mm_sub_epi32(a, b); }
+	static integer_t equal_s32(integer_t a, integer_t b){ return _mm_cmpeq_epi32(a, b); }
+	static integer_t greater_s32(integer_t a, integer_t b){ return _mm_cmpgt_epi32(a, b); }
+	static integer_t shift_left_s32(integer_t a, int count){ return _mm_sll_epi32(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_s32(integer_t a, int count){ return _mm_sra_epi32(a, _mm_cvtsi32_si128(count)); }
+	static integer_t abs_s32(integer_t a){ return _mm_abs_epi32(a); }
+	static integer_t min_u32(integer_t a, integer_t b){ return _mm_min_epu32(a, b); }
+	static integer_t min_s32(integer_t a, integer_t b){ return _mm_min_epi32(a, b); }
+	static integer_t max_s32(integer_t a, integer_t b){ return _mm_max_epi32(a, b); }
+	static integer_t unpack_low_s32(integer_t a, integer_t b){ return _mm_unpacklo_epi32(a, b); }
+	static integer_t unpack_high_s32(integer_t a, integer_t b){ return _mm_unpackhi_epi32(a, b); }
+	//even items from a and odd items from b
+	static integer_t blend_odd_s32(integer_t a, integer_t b){ return _mm_blend_epi16(a, b, 0xcc); }
+	//signed product of the even 32-bit items (64-bit results)
+	static integer_t multiply_even_s32(integer_t a, integer_t b){ return _mm_mul_epi32(a, b); }
+
+	static integer_t add_s64(integer_t a, integer_t b){ return _mm_add_epi64(a, b); }
+	static integer_t shift_left_s64(integer_t a, int count){ return _mm_sll_epi64(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_u64(integer_t a, int count){ return _mm_srl_epi64(a, _mm_cvtsi32_si128(count)); }
+	static integer_t sign_s64(integer_t a){ return _mm_shuffle_epi32(_mm_srai_epi32(a, 31), _MM_SHUFFLE(3,3,1,1)); }
+
+	static float_t add_float(float_t a, float_t b){ return _mm_add_ps(a, b); }
+	static float_t subtract_float(float_t a, float_t b){ return _mm_sub_ps(a, b); }
+	static float_t multiply_float(float_t a, float_t b){ return _mm_mul_ps(a, b); }
+	static float_t min_float(float_t a, float_t b){ return _mm_min_ps(a, b); }
+	static float_t max_float(float_t a, float_t b){ return _mm_max_ps(a, b); }
+	static float_t and_float(float_t a, float_t b){ return _mm_and_ps(a, b); }
+	static float_t xor_float(float_t a, float_t b){ return _mm_xor_ps(a, b); }
+	static float_t cast_float(integer_t a){ return _mm_castsi128_ps(a); }
+};
+
+#include "HostDspKernels.h"
+
+#pragma GCC pop_options
+
+}
+
+namespace avx2 {
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+struct Vector {
+	typedef __m256i integer_t;
+	typedef __m256 float_t;
+	enum { size = 32 };
+
+	static integer_t load(const void * value){ return _mm256_loadu_si256(static_cast<const __m256i*>(value)); }
+	static void store(void * destination, integer_t value){ _mm256_storeu_si256(static_cast<__m256i*>(destination), value); }
+	static float_t load_float(const float32_t * value){ return _mm256_loadu_ps(value); }
+	static void store_float(float32_t * destination, float_t value){ _mm256_storeu_ps(destination, value); }
+
+	static integer_t zero(){ return _mm256_setzero_si256(); }
+	static integer_t set_s16(s16 value){ return _mm256_set1_epi16(value); }
+	static integer_t set_s32(s32 value){ return _mm256_set1_epi32(value); }
+	static integer_t set_s64(s64 value){ return _mm256_set1_epi64x(value); }
+	static float_t set_float(float32_t value){ return _mm256_set1_ps(value); }
+	static float_t zero_float(){ return _mm256_setzero_ps(); }
+
+	static integer_t bit_and(integer_t a, integer_t b){ return _mm256_and_si256(a, b); }
+	static integer_t bit_and_not(integer_t a, integer_t b){ return _mm256_andnot_si256(a, b); }
+	static integer_t bit_or(integer_t a, integer_t b){ return _mm256_or_si256(a, b); }
+	static integer_t bit_xor(integer_t a, integer_t b){ return _mm256_xor_si256(a, b); }
+	static integer_t select(integer_t a, integer_t b, integer_t mask){ return _mm256_blendv_epi8(a, b, mask); }
+
+	static integer_t add_s16(integer_t a, integer_t b){ return _mm256_add_epi16(a, b); }
+	static integer_t add_saturate_s16(integer_t a, integer_t b){ return _mm256_adds_epi16(a, b); }
+	static integer_t subtract_saturate_s16(integer_t a, integer_t b){ return _mm256_subs_epi16(a, b); }
+	static integer_t multiply_low_s16(integer_t a, integer_t b){ return _mm256_mullo_epi16(a, b); }
+	static integer_t multiply_high_s16(integer_t a, integer_t b){ return _mm256_mulhi_epi16(a, b); }
+	static integer_t multiply_add_s16(integer_t a, integer_t b){ return _mm256_madd_epi16(a, b); }
+	static integer_t equal_s16(integer_t a, integer_t b){ return _mm256_cmpeq_epi16(a, b); }
+	static integer_t shift_left_s16(integer_t a, int count){ return _mm256_sll_epi16(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_s16(integer_t a, int count){ return _mm256_sra_epi16(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_u16(integer_t a, int count){ return _mm256_srl_epi16(a, _mm_cvtsi32_si128(count)); }
+	static integer_t abs_s16(integer_t a){ return _mm256_abs_epi16(a); }
+	static integer_t min_u16(integer_t a, integer_t b){ return _mm256_min_epu16(a, b); }
+	static integer_t min_s16(integer_t a, integer_t b){ return _mm256_min_epi16(a, b); }
+	static integer_t max_s16(integer_t a, integer_t b){ return _mm256_max_epi16(a, b); }
+	static integer_t unpack_low_s16(integer_t a, integer_t b){ return _mm256_unpacklo_epi16(a, b); }
+	static integer_t unpack_high_s16(integer_t a, integer_t b){ return _mm256_unpackhi_epi16(a, b); }
+	static integer_t pack_saturate_s32(integer_t a, integer_t b){ return _mm256_packs_epi32(a, b); }
+
+	static integer_t add_s32(integer_t a, integer_t b){ return _mm256_add_epi32(a, b); }
+	static integer_t subtract_s32(integer_t a, integer_t b){ return _mm256_sub_epi32(a, b); }
+	static integer_t equal_s32(integer_t a, integer_t b){ return _mm256_cmpeq_epi32(a, b); }
+	static integer_t greater_s32(integer_t a, integer_t b){ return _mm256_cmpgt_epi32(a, b); }
+	static integer_t shift_left_s32(integer_t a, int count){ return _mm256_sll_epi32(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_s32(integer_t a, int count){ return _mm256_sra_epi32(a, _mm_cvtsi32_si128(count)); }
+	static integer_t abs_s32(integer_t a){ return _mm256_abs_epi32(a); }
+	static integer_t min_u32(integer_t a, integer_t b){ return _mm256_min_epu32(a, b); }
+	static integer_t min_s32(integer_t a, integer_t b){ return _mm256_min_epi32(a, b); }
+	static integer_t max_s32(integer_t a, integer_t b){ return _mm256_max_epi32(a, b); }
+	static integer_t unpack_low_s32(integer_t a, integer_t b){ return _mm256_unpacklo_epi32(a, b); }
+	static integer_t unpack_high_s32(integer_t a, integer_t b){ return _mm256_unpackhi_epi32(a, b); }
+	static integer_t blend_odd_s32(integer_t a, integer_t b){ return _mm256_blend_epi32(a, b, 0xaa); }
+	static integer_t multiply_even_s32(integer_t a, integer_t b){ return _mm256_mul_epi32(a, b); }
+
+	static integer_t add_s64(integer_t a, integer_t b){ return _mm256_add_epi64(a, b); }
+	static integer_t shift_left_s64(integer_t a, int count){ return _mm256_sll_epi64(a, _mm_cvtsi32_si128(count)); }
+	static integer_t shift_right_u64(integer_t a, int count){ return _mm256_srl_epi64(a, _mm_cvtsi32_si128(count)); }
+	static integer_t sign_s64(integer_t a){ return _mm256_shuffle_epi32(_mm256_srai_epi32(a, 31), _MM_SHUFFLE(3,3,1,1)); }
+
+	static float_t add_float(float_t a, float_t b){ return _mm256_add_ps(a, b); }
+	static float_t subtract_float(float_t a, float_t b){ return _mm256_sub_ps(a, b); }
+	static float_t multiply_float(float_t a, float_t b){ return _mm256_mul_ps(a, b); }
+	static float_t min_float(float_t a, float_t b){ return _mm256_min_ps(a, b); }
+	static float_t max_float(float_t a, float_t b){ return _mm256_max_ps(a, b); }
+	static float_t and_float(float_t a, float_t b){ return _mm256_and_ps(a, b); }
+	static float_t xor_float(float_t a, float_t b){ return _mm256_xor_ps(a, b); }
+	static float_t cast_float(integer_t a){ return _mm256_castsi256_ps(a); }
+};
+
+#include "HostDspKernels.h"
+
+#pragma GCC pop_options
+
+}
+
+#endif
+
+#if DSP_HOST_USE_NEON
+
+/*
+ * The NEON saturating instructions are the same operations
+ * as the Cortex-M DSP instructions that CMSIS uses (QADD16, QDMULH, ...)
+ * so only the element-wise kernels and the reductions are here. The
+ * others use the scalar kernels.
+ *
+ */
+namespace neon {
+
+void add_q15(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ vst1q_s16(destination + i, vqaddq_s16(vld1q_s16(a + i), vld1q_s16(b + i))); }
+	add_q15_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void sub_q15(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ vst1q_s16(destination + i, vqsubq_s16(vld1q_s16(a + i), vld1q_s16(b + i))); }
+	sub_q15_scalar(a + i, b + i, destination + i, count - i);
+}
+
+//saturate((2*a*b) >> 16) is the same as saturate((a*b) >> 15)
+void mult_q15(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ vst1q_s16(destination + i, vqdmulhq_s16(vld1q_s16(a + i), vld1q_s16(b + i))); }
+	mult_q15_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void offset_q15(const q15_t * source, q15_t offset, q15_t * destination, u32 count){
+	const int16x8_t value = vdupq_n_s16(offset);
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ vst1q_s16(destination + i, vqaddq_s16(vld1q_s16(source + i), value)); }
+	offset_q15_scalar(source + i, offset, destination + i, count - i);
+}
+
+void abs_q15(const q15_t * source, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ vst1q_s16(destination + i, vqabsq_s16(vld1q_s16(source + i))); }
+	abs_q15_scalar(source + i, destination + i, count - i);
+}
+
+void negate_q15(const q15_t * source, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ vst1q_s16(destination + i, vqnegq_s16(vld1q_s16(source + i))); }
+	negate_q15_scalar(source + i, destination + i, count - i);
+}
+
+q31_t sum_q15(const q15_t * source, u32 count){
+	int32x4_t sum = vdupq_n_s32(0);
+	u32 i;
+	for(i=0; i + 8 <= count; i += 8){ sum = vpadalq_s16(sum, vld1q_s16(source + i)); }
+	return wrap_add(vaddvq_s32(sum), sum_q15_scalar(source + i, count - i));
+}
+
+q15_t min_q15(const q15_t * source, u32 count){
+	if( count < 8 ){ return min_q15_scalar(source, count); }
+	int16x8_t result = vld1q_s16(source);
+	u32 i;
+	for(i=8; i + 8 <= count; i += 8){ result = vminq_s16(result, vld1q_s16(source + i)); }
+	const q15_t value = vminvq_s16(result);
+	if( i == count ){ return value; }
+	const q15_t tail = min_q15_scalar(source + i, count - i);
+	return tail < value ? tail : value;
+}
+
+q15_t max_q15(const q15_t * source, u32 count){
+	if( count < 8 ){ return max_q15_scalar(source, count); }
+	int16x8_t result = vld1q_s16(source);
+	u32 i;
+	for(i=8; i + 8 <= count; i += 8){ result = vmaxq_s16(result, vld1q_s16(source + i)); }
+	const q15_t value = vmaxvq_s16(result);
+	if( i == count ){ return value; }
+	const q15_t tail = max_q15_scalar(source + i, count - i);
+	return tail > value ? tail : value;
+}
+
+void add_q31(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_s32(destination + i, vqaddq_s32(vld1q_s32(a + i), vld1q_s32(b + i))); }
+	add_q31_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void sub_q31(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_s32(destination + i, vqsubq_s32(vld1q_s32(a + i), vld1q_s32(b + i))); }
+	sub_q31_scalar(a + i, b + i, destination + i, count - i);
+}
+
+//arm_mult_q31() drops the lowest bit: saturate((2*a*b) >> 32) with bit 0 cleared
+void mult_q31(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	const int32x4_t one = vdupq_n_s32(1);
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){
+		vst1q_s32(destination + i, vbicq_s32(vqdmulhq_s32(vld1q_s32(a + i), vld1q_s32(b + i)), one));
+	}
+	mult_q31_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void offset_q31(const q31_t * source, q31_t offset, q31_t * destination, u32 count){
+	const int32x4_t value = vdupq_n_s32(offset);
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_s32(destination + i, vqaddq_s32(vld1q_s32(source + i), value)); }
+	offset_q31_scalar(source + i, offset, destination + i, count - i);
+}
+
+void abs_q31(const q31_t * source, q31_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_s32(destination + i, vqabsq_s32(vld1q_s32(source + i))); }
+	abs_q31_scalar(source + i, destination + i, count - i);
+}
+
+void negate_q31(const q31_t * source, q31_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_s32(destination + i, vqnegq_s32(vld1q_s32(source + i))); }
+	negate_q31_scalar(source + i, destination + i, count - i);
+}
+
+void add_f32(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vaddq_f32(vld1q_f32(a + i), vld1q_f32(b + i))); }
+	add_f32_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void sub_f32(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i))); }
+	sub_f32_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void mult_f32(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i))); }
+	mult_f32_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void offset_f32(const float32_t * source, float32_t offset, float32_t * destination, u32 count){
+	const float32x4_t value = vdupq_n_f32(offset);
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vaddq_f32(vld1q_f32(source + i), value)); }
+	offset_f32_scalar(source + i, offset, destination + i, count - i);
+}
+
+void scale_f32(const float32_t * source, float32_t scale, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vmulq_n_f32(vld1q_f32(source + i), scale)); }
+	scale_f32_scalar(source + i, scale, destination + i, count - i);
+}
+
+void abs_f32(const float32_t * source, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vabsq_f32(vld1q_f32(source + i))); }
+	abs_f32_scalar(source + i, destination + i, count - i);
+}
+
+void negate_f32(const float32_t * source, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ vst1q_f32(destination + i, vnegq_f32(vld1q_f32(source + i))); }
+	negate_f32_scalar(source + i, destination + i, count - i);
+}
+
+float32_t sum_f32(const float32_t * source, u32 count){
+	float32x4_t sum = vdupq_n_f32(0.0f);
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ sum = vaddq_f32(sum, vld1q_f32(source + i)); }
+	return vaddvq_f32(sum) + sum_f32_scalar(source + i, count - i);
+}
+
+float32_t power_f32(const float32_t * source, u32 count){
+	float32x4_t sum = vdupq_n_f32(0.0f);
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){
+		const float32x4_t value = vld1q_f32(source + i);
+		sum = vaddq_f32(sum, vmulq_f32(value, value));
+	}
+	return vaddvq_f32(sum) + power_f32_scalar(source + i, count - i);
+}
+
+float32_t dot_prod_f32(const float32_t * a, const float32_t * b, u32 count){
+	float32x4_t sum = vdupq_n_f32(0.0f);
+	u32 i;
+	for(i=0; i + 4 <= count; i += 4){ sum = vaddq_f32(sum, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i))); }
+	return vaddvq_f32(sum) + dot_prod_f32_scalar(a + i, b + i, count - i);
+}
+
+void install(Kernels & kernels){
+	kernels.add_q15 = add_q15;
+	kernels.sub_q15 = sub_q15;
+	kernels.mult_q15 = mult_q15;
+	kernels.offset_q15 = offset_q15;
+	kernels.abs_q15 = abs_q15;
+	kernels.negate_q15 = negate_q15;
+	kernels.sum_q15 = sum_q15;
+	kernels.min_q15 = min_q15;
+	kernels.max_q15 = max_q15;
+	kernels.add_q31 = add_q31;
+	kernels.sub_q31 = sub_q31;
+	kernels.mult_q31 = mult_q31;
+	kernels.offset_q31 = offset_q31;
+	kernels.abs_q31 = abs_q31;
+	kernels.negate_q31 = negate_q31;
+	kernels.add_f32 = add_f32;
+	kernels.sub_f32 = sub_f32;
+	kernels.mult_f32 = mult_f32;
+	kernels.offset_f32 = offset_f32;
+	kernels.scale_f32 = scale_f32;
+	kernels.abs_f32 = abs_f32;
+	kernels.negate_f32 = negate_f32;
+	kernels.sum_f32 = sum_f32;
+	kernels.power_f32 = power_f32;
+	kernels.dot_prod_f32 = dot_prod_f32;
+}
+
+}
+
+#endif
+
+class KernelSelection {
+public:
+	KernelSelection(){
+		m_kernel = DSP_HOST_KERNEL_SCALAR;
+		m_kernels = scalar_kernels;
+		select(DSP_HOST_KERNEL_AUTO);
+	}
+
+	int select(int kernel){
+		if( kernel == DSP_HOST_KERNEL_AUTO ){
+#if DSP_HOST_USE_X86
+			__builtin_cpu_init();
+			if( __builtin_cpu_supports("avx2") ){
+				kernel = DSP_HOST_KERNEL_AVX2;
+			} else if( __builtin_cpu_supports("sse4.1") ){
+				kernel = DSP_HOST_KERNEL_SSE4_1;
+			} else {
+				kernel = DSP_HOST_KERNEL_SCALAR;
+			}
+#elif DSP_HOST_USE_NEON
+			kernel = DSP_HOST_KERNEL_NEON;
+#else
+			kernel = DSP_HOST_KERNEL_SCALAR;
+#endif
+		}
+
+		Kernels kernels = scalar_kernels;
+		switch(kernel){
+			case DSP_HOST_KERNEL_SCALAR:
+				break;
+#if DSP_HOST_USE_X86
+			case DSP_HOST_KERNEL_SSE4_1:
+				__builtin_cpu_init();
+				if( !__builtin_cpu_supports("sse4.1") ){ return -1; }
+				kernels = sse4_1::kernels;
+				break;
+			case DSP_HOST_KERNEL_AVX2:
+				__builtin_cpu_init();
+				if( !__builtin_cpu_supports("avx2") ){ return -1; }
+				kernels = avx2::kernels;
+				break;
+#endif
+#if DSP_HOST_USE_NEON
+			case DSP_HOST_KERNEL_NEON:
+				neon::install(kernels);
+				break;
+#endif
+			default:
+				return -1;
+		}
+		m_kernels = kernels;
+		m_kernel = kernel;
+		return 0;
+	}
+
+	int kernel() const { return m_kernel; }
+	const Kernels & kernels() const { return m_kernels; }
+
+private:
+	int m_kernel;
+	Kernels m_kernels;
+};
+
+KernelSelection & kernel_selection(){
+	static KernelSelection selection;
+	return selection;
+}
+
+const Kernels & kernels(){
+	return kernel_selection().kernels();
+}
+
+template<typename T> u32 find_index(const T * source, u32 count, T value){
+	for(u32 i=0; i < count; i++){
+		if( source[i] == value ){ return i; }
+	}
+	return 0;
+}
+
+/*
+ * q7
+ *
+ */
+void abs_q7(const q7_t * source, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){
+		destination[i] = source[i] > 0 ? source[i] : (source[i] == INT8_MIN ? INT8_MAX : static_cast<q7_t>(-source[i]));
+	}
+}
+
+void add_q7(const q7_t * a, const q7_t * b, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat8(a[i] + b[i]); }
+}
+
+//arm_dot_prod_q7() adds in a q31_t
+void dot_prod_q7(const q7_t * a, const q7_t * b, uint32_t count, q31_t * result){
+	q31_t sum = 0;
+	for(u32 i=0; i < count; i++){ sum = wrap_add(sum, static_cast<q31_t>(a[i] * b[i])); }
+	*result = sum;
+}
+
+void mult_q7(const q7_t * a, const q7_t * b, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat8((a[i] * b[i]) >> 7); }
+}
+
+void negate_q7(const q7_t * source, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = source[i] == INT8_MIN ? INT8_MAX : static_cast<q7_t>(-source[i]); }
+}
+
+void offset_q7(const q7_t * source, q7_t offset, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat8(source[i] + offset); }
+}
+
+void scale_q7(const q7_t * source, q7_t scale_fraction, int8_t shift, q7_t * destination, uint32_t count){
+	const int right_shift = 7 - shift;
+	for(u32 i=0; i < count; i++){
+		const q31_t product = source[i] * scale_fraction;
+		if( right_shift >= 0 ){
+			destination[i] = ssat8(product >> (right_shift > 31 ? 31 : right_shift));
+		} else {
+			destination[i] = ssat8(clip_q63_to_q31(static_cast<q63_t>(product) << (-right_shift > 31 ? 31 : -right_shift)));
+		}
+	}
+}
+
+void shift_q7(const q7_t * source, int8_t shift, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){
+		if( shift >= 0 ){
+			destination[i] = ssat8(static_cast<q31_t>(source[i]) << (shift > 8 ? 8 : shift));
+		} else {
+			destination[i] = static_cast<q7_t>(source[i] >> (-shift > 7 ? 7 : -shift));
+		}
+	}
+}
+
+void sub_q7(const q7_t * a, const q7_t * b, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat8(a[i] - b[i]); }
+}
+
+void mean_q7(const q7_t * source, uint32_t count, q7_t * result){
+	q31_t sum = 0;
+	for(u32 i=0; i < count; i++){ sum = wrap_add(sum, static_cast<q31_t>(source[i])); }
+	*result = count ? static_cast<q7_t>(sum / static_cast<q31_t>(count)) : 0;
+}
+
+void power_q7(const q7_t * source, uint32_t count, q31_t * result){
+	q31_t sum = 0;
+	for(u32 i=0; i < count; i++){ sum = wrap_add(sum, static_cast<q31_t>(source[i] * source[i])); }
+	*result = sum;
+}
+
+void min_q7(const q7_t * source, uint32_t count, q7_t * result, uint32_t * index){
+	u32 position = 0;
+	for(u32 i=1; i < count; i++){ if( source[i] < source[position] ){ position = i; } }
+	*result = count ? source[position] : 0;
+	*index = position;
+}
+
+void max_q7(const q7_t * source, uint32_t count, q7_t * result, uint32_t * index){
+	u32 position = 0;
+	for(u32 i=1; i < count; i++){ if( source[i] > source[position] ){ position = i; } }
+	*result = count ? source[position] : 0;
+	*index = position;
+}
+
+/*
+ * Shared by q15 and q31
+ *
+ */
+u32 square_root(u64 value){
+	u64 result = static_cast<u64>(std::sqrt(static_cast<double>(value)));
+	//the double estimate can be off by one in either direction
+	while( result * result > value ){ result--; }
+	while( (result + 1) * (result + 1) <= value ){ result++; }
+	return static_cast<u32>(result);
+}
+
+/*
+ * The sine tables have 512 values for one period (plus the first
+ * value again) like the CMSIS tables. Values between the
+ * table entries are interpolated.
+ *
+ */
+class SinTable {
+public:
+	SinTable(){
+		const double pi = 3.14159265358979323846;
+		for(u32 i=0; i <= 512; i++){
+			const double value = std::sin(2.0 * pi * i / 512.0);
+			m_q15[i] = ssat16(static_cast<q31_t>(std::lround(value * 32768.0)));
+			m_q31[i] = clip_q63_to_q31(std::llround(value * 2147483648.0));
+		}
+	}
+
+	q15_t q15(u32 index) const { return m_q15[index]; }
+	q31_t q31(u32 index) const { return m_q31[index]; }
+
+private:
+	q15_t m_q15[513];
+	q31_t m_q31[513];
+};
+
+const SinTable & sin_table(){
+	static const SinTable table;
+	return table;
+}
+
+//the input is 0 to 0x7fff for 0 to 2*pi
+q15_t sin_q15(q15_t x){
+	const SinTable & table = sin_table();
+	x = static_cast<q15_t>(x & 0x7fff);
+	const u32 index = static_cast<u32>(x) >> 6;
+	const q15_t fraction = static_cast<q15_t>((x - static_cast<q15_t>(index << 6)) << 9);
+	const q15_t a = table.q15(index);
+	const q15_t b = table.q15(index+1);
+	q15_t result = static_cast<q15_t>((static_cast<q31_t>(0x8000 - fraction) * a) >> 16);
+	result = static_cast<q15_t>(((static_cast<q31_t>(result) << 16) + static_cast<q31_t>(fraction) * b) >> 16);
+	return static_cast<q15_t>(result << 1);
+}
+
+q15_t cos_q15(q15_t x){
+	return sin_q15(static_cast<q15_t>(static_cast<u16>(x) + 0x2000));
+}
+
+//the input is 0 to 0x7fffffff for 0 to 2*pi
+q31_t sin_q31(q31_t x){
+	const SinTable & table = sin_table();
+	x = x & 0x7fffffff;
+	const u32 index = static_cast<u32>(x) >> 22;
+	const q31_t fraction = (x - static_cast<q31_t>(index << 22)) << 9;
+	const q31_t a = table.q31(index);
+	const q31_t b = table.q31(index+1);
+	q31_t result = static_cast<q31_t>((static_cast<q63_t>(0x80000000u - static_cast<u32>(fraction)) * a) >> 32);
+	result = static_cast<q31_t>(static_cast<q63_t>(
+				(static_cast<u64>(static_cast<u32>(result)) << 32) + static_cast<u64>(static_cast<q63_t>(fraction) * b)
+				) >> 32);
+	return static_cast<q31_t>(static_cast<u32>(result) << 1);
+}
+
+q31_t cos_q31(q31_t x){
+	return sin_q31(static_cast<q31_t>(static_cast<u32>(x) + 0x20000000u));
+}
+
+/*
+ * q15
+ *
+ */
+void abs_q15(const q15_t * source, q15_t * destination, uint32_t count){
+	kernels().abs_q15(source, destination, count);
+}
+
+void add_q15(const q15_t * a, const q15_t * b, q15_t * destination, uint32_t count){
+	kernels().add_q15(a, b, destination, count);
+}
+
+//the result is in 34.30 format
+void dot_prod_q15(const q15_t * a, const q15_t * b, uint32_t count, q63_t * result){
+	*result = kernels().dot_prod_q15(a, b, count);
+}
+
+void mult_q15(const q15_t * a, const q15_t * b, q15_t * destination, uint32_t count){
+	kernels().mult_q15(a, b, destination, count);
+}
+
+void negate_q15(const q15_t * source, q15_t * destination, uint32_t count){
+	kernels().negate_q15(source, destination, count);
+}
+
+void offset_q15(const q15_t * source, q15_t offset, q15_t * destination, uint32_t count){
+	kernels().offset_q15(source, offset, destination, count);
+}
+
+void scale_q15(const q15_t * source, q15_t scale_fraction, int8_t shift, q15_t * destination, uint32_t count){
+	kernels().scale_q15(source, scale_fraction, shift, destination, count);
+}
+
+void shift_q15(const q15_t * source, int8_t shift, q15_t * destination, uint32_t count){
+	kernels().shift_q15(source, shift, destination, count);
+}
+
+void sub_q15(const q15_t * a, const q15_t * b, q15_t * destination, uint32_t count){
+	kernels().sub_q15(a, b, destination, count);
+}
+
+/*
+ * The convolutions are calculated like FIR filters: the longer
+ * signal is copied with zeros on each side and the shorter
+ * signal is reversed so that the kernels can go through both in
+ * the same direction.
+ *
+ */
+template<typename T, typename Correlate> void convolve(
+		const T * a,
+		u32 a_count,
+		const T * b,
+		u32 b_count,
+		T * destination,
+		Correlate correlate
+		){
+	if( a_count == 0 || b_count == 0 ){ return; }
+	if( a_count < b_count ){
+		const T * swap = a; a = b; b = swap;
+		const u32 swap_count = a_count; a_count = b_count; b_count = swap_count;
+	}
+
+	var::Vector<T> padded(a_count + 2*(b_count - 1));
+	var::Vector<T> reversed(b_count);
+	memset(padded.data(), 0, padded.count() * sizeof(T));
+	memcpy(padded.data() + b_count - 1, a, a_count * sizeof(T));
+	for(u32 i=0; i < b_count; i++){
+		reversed.data()[i] = b[b_count - 1 - i];
+	}
+	correlate(padded.data(), reversed.data(), b_count, destination, a_count + b_count - 1);
+}
+
+//arm_conv_q15() adds in a q63_t
+void correlate_q15(const q15_t * source, const q15_t * coefficients, u32 tap_count, q15_t * destination, u32 count){
+	for(u32 n=0; n < count; n++){
+		q63_t sum = 0;
+		for(u32 k=0; k < tap_count; k++){
+			sum += static_cast<q31_t>(coefficients[k]) * source[n+k];
+		}
+		destination[n] = ssat16_truncate(sum >> 15);
+	}
+}
+
+void conv_q15(const q15_t * a, uint32_t a_count, const q15_t * b, uint32_t b_count, q15_t * destination){
+	convolve(a, a_count, b, b_count, destination, correlate_q15);
+}
+
+void conv_fast_q15(const q15_t * a, uint32_t a_count, const q15_t * b, uint32_t b_count, q15_t * destination){
+	convolve(a, a_count, b, b_count, destination, kernels().correlate_fast_q15);
+}
+
+void mean_q15(const q15_t * source, uint32_t count, q15_t * result){
+	*result = count ? static_cast<q15_t>(kernels().sum_q15(source, count) / static_cast<q31_t>(count)) : 0;
+}
+
+//the result is in 34.30 format
+void power_q15(const q15_t * source, uint32_t count, q63_t * result){
+	*result = kernels().power_q15(source, count);
+}
+
+//returns (mean of squares - square of mean) in q31_t like arm_var_q15()
+q31_t variance_q31_q15(const q15_t * source, u32 count){
+	const q63_t sum_of_squares = kernels().power_q15(source, count);
+	const q31_t sum = kernels().sum_q15(source, count);
+	const q31_t mean_of_squares = static_cast<q31_t>(sum_of_squares / static_cast<q63_t>(count - 1));
+	const q31_t square_of_mean = static_cast<q31_t>(
+				static_cast<q63_t>(sum) * sum / static_cast<q63_t>(static_cast<u32>(count * (count - 1)))
+				);
+	return static_cast<q31_t>(static_cast<u32>(mean_of_squares) - static_cast<u32>(square_of_mean));
+}
+
+void var_q15(const q15_t * source, uint32_t count, q15_t * result){
+	if( count <= 1 ){ *result = 0; return; }
+	*result = static_cast<q15_t>(variance_q31_q15(source, count) >> 15);
+}
+
+arm_status sqrt_q15(q15_t value, q15_t * result){
+	if( value > 0 ){
+		*result = static_cast<q15_t>(square_root(static_cast<u64>(value) << 15));
+		return ARM_MATH_SUCCESS;
+	}
+	*result = 0;
+	return ARM_MATH_ARGUMENT_ERROR;
+}
+
+void rms_q15(const q15_t * source, uint32_t count, q15_t * result){
+	if( count == 0 ){ *result = 0; return; }
+	const q63_t sum = kernels().power_q15(source, count);
+	sqrt_q15(ssat16(static_cast<q31_t>(sum / static_cast<q63_t>(count)) >> 15), result);
+}
+
+void std_q15(const q15_t * source, uint32_t count, q15_t * result){
+	if( count <= 1 ){ *result = 0; return; }
+	sqrt_q15(ssat16(variance_q31_q15(source, count) >> 15), result);
+}
+
+void min_q15(const q15_t * source, uint32_t count, q15_t * result, uint32_t * index){
+	if( count == 0 ){ *result = 0; *index = 0; return; }
+	*result = kernels().min_q15(source, count);
+	*index = find_index(source, count, *result);
+}
+
+void max_q15(const q15_t * source, uint32_t count, q15_t * result, uint32_t * index){
+	if( count == 0 ){ *result = 0; *index = 0; return; }
+	*result = kernels().max_q15(source, count);
+	*index = find_index(source, count, *result);
+}
+
+/*
+ * The FIR state has the last (numTaps - 1) samples followed
+ * by room for blockSize samples. Longer inputs are filtered
+ * blockSize samples at a time.
+ *
+ */
+template<typename Instance, typename T, typename Correlate> void filter_fir(
+		const Instance * instance,
+		const T * source,
+		T * destination,
+		u32 count,
+		Correlate correlate
+		){
+	const u32 history = instance->numTaps - 1;
+	T * state = instance->pState;
+	if( instance->numTaps == 0 || instance->blockSize == 0 ){ return; }
+	while( count ){
+		const u32 block = count < instance->blockSize ? count : instance->blockSize;
+		memcpy(state + history, source, block * sizeof(T));
+		correlate(state, instance->pCoeffs, instance->numTaps, destination, block);
+		memmove(state, state + block, history * sizeof(T));
+		source += block;
+		destination += block;
+		count -= block;
+	}
+}
+
+template<typename Instance, typename T> arm_status initialize_fir(
+		Instance * instance,
+		u16 tap_count,
+		const T * coefficients,
+		T * state,
+		u32 block_size
+		){
+	instance->numTaps = tap_count;
+	instance->pCoeffs = coefficients;
+	instance->pState = state;
+	instance->blockSize = block_size;
+	if( tap_count ){
+		memset(state, 0, (tap_count + block_size - 1) * sizeof(T));
+	}
+	return ARM_MATH_SUCCESS;
+}
+
+void fir_q15(const arm_fir_instance_q15 * instance, const q15_t * source, q15_t * destination, uint32_t count){
+	filter_fir(instance, source, destination, count, correlate_q15);
+}
+
+void fir_fast_q15(const arm_fir_instance_q15 * instance, const q15_t * source, q15_t * destination, uint32_t count){
+	filter_fir(instance, source, destination, count, kernels().correlate_fast_q15);
+}
+
+arm_status fir_init_q15(arm_fir_instance_q15 * instance, uint16_t tap_count, const q15_t * coefficients, q15_t * state, uint32_t block_size){
+	return initialize_fir(instance, tap_count, coefficients, state, block_size);
+}
+
+/*
+ * Direct form I biquads: each stage has the state
+ * {x[n-1], x[n-2], y[n-1], y[n-2]} and calculates
+ * y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] + a1*y[n-1] + a2*y[n-2]
+ *
+ */
+template<bool is_fast> void filter_biquad_q15(
+		const arm_biquad_casd_df1_inst_q15 * instance,
+		const q15_t * source,
+		q15_t * destination,
+		u32 count
+		){
+	const int shift = 15 - instance->postShift;
+	const q15_t * coefficients = instance->pCoeffs;
+	q15_t * state = instance->pState;
+	for(int stage=0; stage < instance->numStages; stage++){
+		const q31_t b0 = coefficients[0];
+		const q31_t b1 = coefficients[2];
+		const q31_t b2 = coefficients[3];
+		const q31_t a1 = coefficients[4];
+		const q31_t a2 = coefficients[5];
+		q15_t x1 = state[0];
+		q15_t x2 = state[1];
+		q15_t y1 = state[2];
+		q15_t y2 = state[3];
+		for(u32 n=0; n < count; n++){
+			const q15_t input = source[n];
+			q15_t output;
+			if( is_fast ){
+				//__SMLAD() adds in a q31_t
+				q31_t sum = b0 * input;
+				sum = wrap_add(sum, b1 * x1);
+				sum = wrap_add(sum, b2 * x2);
+				sum = wrap_add(sum, a1 * y1);
+				sum = wrap_add(sum, a2 * y2);
+				output = ssat16(sum >> shift);
+			} else {
+				const q63_t sum = static_cast<q63_t>(b0 * input) + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+				output = ssat16_truncate(sum >> shift);
+			}
+			x2 = x1; x1 = input;
+			y2 = y1; y1 = output;
+			destination[n] = output;
+		}
+		state[0] = x1; state[1] = x2; state[2] = y1; state[3] = y2;
+		state += 4;
+		coefficients += 6;
+		//the next stage filters the output of this stage
+		source = destination;
+	}
+}
+
+void biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 * instance, const q15_t * source, q15_t * destination, uint32_t count){
+	filter_biquad_q15<false>(instance, source, destination, count);
+}
+
+void biquad_cascade_df1_fast_q15(const arm_biquad_casd_df1_inst_q15 * instance, const q15_t * source, q15_t * destination, uint32_t count){
+	filter_biquad_q15<true>(instance, source, destination, count);
+}
+
+void biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 * instance, uint8_t stage_count, const q15_t * coefficients, q15_t * state, int8_t post_shift){
+	instance->numStages = stage_count;
+	instance->pCoeffs = coefficients;
+	instance->pState = state;
+	instance->postShift = post_shift;
+	memset(state, 0, stage_count * 4 * sizeof(q15_t));
+}
+
+/*
+ * q31
+ *
+ */
+void abs_q31(const q31_t * source, q31_t * destination, uint32_t count){
+	kernels().abs_q31(source, destination, count);
+}
+
+void add_q31(const q31_t * a, const q31_t * b, q31_t * destination, uint32_t count){
+	kernels().add_q31(a, b, destination, count);
+}
+
+//the result is in 16.48 format
+void dot_prod_q31(const q31_t * a, const q31_t * b, uint32_t count, q63_t * result){
+	*result = kernels().dot_prod_q31(a, b, count);
+}
+
+void mult_q31(const q31_t * a, const q31_t * b, q31_t * destination, uint32_t count){
+	kernels().mult_q31(a, b, destination, count);
+}
+
+void negate_q31(const q31_t * source, q31_t * destination, uint32_t count){
+	kernels().negate_q31(source, destination, count);
+}
+
+void offset_q31(const q31_t * source, q31_t offset, q31_t * destination, uint32_t count){
+	kernels().offset_q31(source, offset, destination, count);
+}
+
+void scale_q31(const q31_t * source, q31_t scale_fraction, int8_t shift, q31_t * destination, uint32_t count){
+	kernels().scale_q31(source, scale_fraction, shift, destination, count);
+}
+
+void shift_q31(const q31_t * source, int8_t shift, q31_t * destination, uint32_t count){
+	kernels().shift_q31(source, shift, destination, count);
+}
+
+void sub_q31(const q31_t * a, const q31_t * b, q31_t * destination, uint32_t count){
+	kernels().sub_q31(a, b, destination, count);
+}
+
+//arm_conv_q31() adds in a q63_t
+void correlate_q31(const q31_t * source, const q31_t * coefficients, u32 tap_count, q31_t * destination, u32 count){
+	for(u32 n=0; n < count; n++){
+		q63_t sum = 0;
+		for(u32 k=0; k < tap_count; k++){
+			sum = wrap_add(sum, static_cast<q63_t>(coefficients[k]) * source[n+k]);
+		}
+		destination[n] = static_cast<q31_t>(sum >> 31);
+	}
+}
+
+//arm_conv_fast_q31() truncates each product
+void correlate_fast_truncate_q31(const q31_t * source, const q31_t * coefficients, u32 tap_count, q31_t * destination, u32 count){
+	kernels().correlate_fast_q31(source, coefficients, tap_count, destination, count, 0);
+}
+
+//arm_fir_fast_q31() rounds each product
+void correlate_fast_round_q31(const q31_t * source, const q31_t * coefficients, u32 tap_count, q31_t * destination, u32 count){
+	kernels().correlate_fast_q31(source, coefficients, tap_count, destination, count, 0x80000000LL);
+}
+
+void conv_q31(const q31_t * a, uint32_t a_count, const q31_t * b, uint32_t b_count, q31_t * destination){
+	convolve(a, a_count, b, b_count, destination, correlate_q31);
+}
+
+void conv_fast_q31(const q31_t * a, uint32_t a_count, const q31_t * b, uint32_t b_count, q31_t * destination){
+	convolve(a, a_count, b, b_count, destination, correlate_fast_truncate_q31);
+}
+
+void mean_q31(const q31_t * source, uint32_t count, q31_t * result){
+	*result = count ? static_cast<q31_t>(kernels().sum_q31(source, count) / static_cast<q63_t>(count)) : 0;
+}
+
+//the result is in 16.48 format
+void power_q31(const q31_t * source, uint32_t count, q63_t * result){
+	*result = kernels().power_q31(source, count);
+}
+
+//arm_var_q31() uses the upper 24 bits of each value
+q63_t variance_q63_q31(const q31_t * source, u32 count){
+	q63_t sum_of_squares = 0;
+	q63_t sum = 0;
+	for(u32 i=0; i < count; i++){
+		const q31_t value = source[i] >> 8;
+		sum_of_squares += static_cast<q63_t>(value) * value;
+		sum += value;
+	}
+	const q63_t mean_of_squares = sum_of_squares / static_cast<q63_t>(count - 1);
+	const q63_t square_of_mean = sum * sum / static_cast<q63_t>(static_cast<u32>(count * (count - 1)));
+	return (mean_of_squares - square_of_mean) >> 15;
+}
+
+void var_q31(const q31_t * source, uint32_t count, q31_t * result){
+	if( count <= 1 ){ *result = 0; return; }
+	*result = static_cast<q31_t>(variance_q63_q31(source, count));
+}
+
+arm_status sqrt_q31(q31_t value, q31_t * result){
+	if( value > 0 ){
+		*result = static_cast<q31_t>(square_root(static_cast<u64>(value) << 31));
+		return ARM_MATH_SUCCESS;
+	}
+	*result = 0;
+	return ARM_MATH_ARGUMENT_ERROR;
+}
+
+void rms_q31(const q31_t * source, uint32_t count, q31_t * result){
+	if( count == 0 ){ *result = 0; return; }
+	q63_t sum = 0;
+	for(u32 i=0; i < count; i++){
+		sum = wrap_add(sum, static_cast<q63_t>(source[i]) * source[i]);
+	}
+	sqrt_q31(clip_q63_to_q31((sum / static_cast<q63_t>(count)) >> 31), result);
+}
+
+void std_q31(const q31_t * source, uint32_t count, q31_t * result){
+	if( count <= 1 ){ *result = 0; return; }
+	sqrt_q31(static_cast<q31_t>(variance_q63_q31(source, count)), result);
+}
+
+void min_q31(const q31_t * source, uint32_t count, q31_t * result, uint32_t * index){
+	if( count == 0 ){ *result = 0; *index = 0; return; }
+	*result = kernels().min_q31(source, count);
+	*index = find_index(source, count, *result);
+}
+
+void max_q31(const q31_t * source, uint32_t count, q31_t * result, uint32_t * index){
+	if( count == 0 ){ *result = 0; *index = 0; return; }
+	*result = kernels().max_q31(source, count);
+	*index = find_index(source, count, *result);
+}
+
+void fir_q31(const arm_fir_instance_q31 * instance, const q31_t * source, q31_t * destination, uint32_t count){
+	filter_fir(instance, source, destination, count, correlate_q31);
+}
+
+void fir_fast_q31(const arm_fir_instance_q31 * instance, const q31_t * source, q31_t * destination, uint32_t count){
+	filter_fir(instance, source, destination, count, correlate_fast_round_q31);
+}
+
+arm_status fir_init_q31(arm_fir_instance_q31 * instance, uint16_t tap_count, const q31_t * coefficients, q31_t * state, uint32_t block_size){
+	return initialize_fir(instance, tap_count, coefficients, state, block_size);
+}
+
+template<bool is_fast> void filter_fir_decimate_q31(
+		const arm_fir_decimate_instance_q31 * instance,
+		const q31_t * source,
+		q31_t * destination,
+		u32 count
+		){
+	const u32 history = instance->numTaps - 1;
+	const u32 factor = instance->M;
+	q31_t * state = instance->pState;
+	if( instance->numTaps == 0 || factor == 0 || instance->blockSize < factor ){ return; }
+	//only whole groups of M samples are used
+	count -= count % factor;
+	while( count ){
+		const u32 block = count < instance->blockSize ? count : instance->blockSize;
+		const u32 output_count = block / factor;
+		memcpy(state + history, source, block * sizeof(q31_t));
+		for(u32 i=0; i < output_count; i++){
+			if( is_fast ){
+				correlate_fast_round_q31(state + i*factor, instance->pCoeffs, instance->numTaps, destination + i, 1);
+			} else {
+				correlate_q31(state + i*factor, instance->pCoeffs, instance->numTaps, destination + i, 1);
+			}
+		}
+		memmove(state, state + block, history * sizeof(q31_t));
+		source += block;
+		destination += output_count;
+		count -= block;
+	}
+}
+
+void fir_decimate_q31(const arm_fir_decimate_instance_q31 * instance, const q31_t * source, q31_t * destination, uint32_t count){
+	filter_fir_decimate_q31<false>(instance, source, destination, count);
+}
+
+void fir_decimate_fast_q31(const arm_fir_decimate_instance_q31 * instance, const q31_t * source, q31_t * destination, uint32_t count){
+	filter_fir_decimate_q31<true>(instance, source, destination, count);
+}
+
+arm_status fir_decimate_init_q31(arm_fir_decimate_instance_q31 * instance, uint16_t tap_count, uint8_t factor, const q31_t * coefficients, q31_t * state, uint32_t block_size){
+	if( factor == 0 || (block_size % factor) != 0 ){
+		return ARM_MATH_LENGTH_ERROR;
+	}
+	instance->M = factor;
+	instance->numTaps = tap_count;
+	instance->pCoeffs = coefficients;
+	instance->pState = state;
+	instance->blockSize = block_size;
+	if( tap_count ){
+		memset(state, 0, (tap_count + block_size - 1) * sizeof(q31_t));
+	}
+	return ARM_MATH_SUCCESS;
+}
+
+template<bool is_fast> void filter_biquad_q31(
+		const arm_biquad_casd_df1_inst_q31 * instance,
+		const q31_t * source,
+		q31_t * destination,
+		u32 count
+		){
+	const u32 shift = instance->postShift + 1;
+	const q31_t * coefficients = instance->pCoeffs;
+	q31_t * state = instance->pState;
+	for(u32 stage=0; stage < instance->numStages; stage++){
+		const q31_t b0 = coefficients[0];
+		const q31_t b1 = coefficients[1];
+		const q31_t b2 = coefficients[2];
+		const q31_t a1 = coefficients[3];
+		const q31_t a2 = coefficients[4];
+		q31_t x1 = state[0];
+		q31_t x2 = state[1];
+		q31_t y1 = state[2];
+		q31_t y2 = state[3];
+		for(u32 n=0; n < count; n++){
+			const q31_t input = source[n];
+			q31_t output;
+			if( is_fast ){
+				//mult_32x32_keep32_R() rounds each product to the upper 32 bits
+				const q63_t round = 0x80000000LL;
+				q31_t sum = multiply_accumulate_high(0, b1, x1, round);
+				sum = multiply_accumulate_high(sum, b0, input, round);
+				sum = multiply_accumulate_high(sum, b2, x2, round);
+				sum = multiply_accumulate_high(sum, a1, y1, round);
+				sum = multiply_accumulate_high(sum, a2, y2, round);
+				output = static_cast<q31_t>(static_cast<u32>(sum) << shift);
+			} else {
+				q63_t sum = static_cast<q63_t>(b0) * input;
+				sum = wrap_add(sum, static_cast<q63_t>(b1) * x1);
+				sum = wrap_add(sum, static_cast<q63_t>(b2) * x2);
+				sum = wrap_add(sum, static_cast<q63_t>(a1) * y1);
+				sum = wrap_add(sum, static_cast<q63_t>(a2) * y2);
+				output = static_cast<q31_t>(sum >> (32 - shift));
+			}
+			x2 = x1; x1 = input;
+			y2 = y1; y1 = output;
+			destination[n] = output;
+		}
+		state[0] = x1; state[1] = x2; state[2] = y1; state[3] = y2;
+		state += 4;
+		coefficients += 5;
+		source = destination;
+	}
+}
+
+void biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31 * instance, const q31_t * source, q31_t * destination, uint32_t count){
+	filter_biquad_q31<false>(instance, source, destination, count);
+}
+
+void biquad_cascade_df1_fast_q31(const arm_biquad_casd_df1_inst_q31 * instance, const q31_t * source, q31_t * destination, uint32_t count){
+	filter_biquad_q31<true>(instance, source, destination, count);
+}
+
+void biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 * instance, uint8_t stage_count, const q31_t * coefficients, q31_t * state, int8_t post_shift){
+	instance->numStages = stage_count;
+	instance->pCoeffs = coefficients;
+	instance->pState = state;
+	instance->postShift = post_shift;
+	memset(state, 0, stage_count * 4 * sizeof(q31_t));
+}
+
+/*
+ * f32
+ *
+ */
+void abs_f32(const float32_t * source, float32_t * destination, uint32_t count){
+	kernels().abs_f32(source, destination, count);
+}
+
+void add_f32(const float32_t * a, const float32_t * b, float32_t * destination, uint32_t count){
+	kernels().add_f32(a, b, destination, count);
+}
+
+void dot_prod_f32(const float32_t * a, const float32_t * b, uint32_t count, float32_t * result){
+	*result = kernels().dot_prod_f32(a, b, count);
+}
+
+void mult_f32(const float32_t * a, const float32_t * b, float32_t * destination, uint32_t count){
+	kernels().mult_f32(a, b, destination, count);
+}
+
+void negate_f32(const float32_t * source, float32_t * destination, uint32_t count){
+	kernels().negate_f32(source, destination, count);
+}
+
+void offset_f32(const float32_t * source, float32_t offset, float32_t * destination, uint32_t count){
+	kernels().offset_f32(source, offset, destination, count);
+}
+
+void scale_f32(const float32_t * source, float32_t scale, float32_t * destination, uint32_t count){
+	kernels().scale_f32(source, scale, destination, count);
+}
+
+void sub_f32(const float32_t * a, const float32_t * b, float32_t * destination, uint32_t count){
+	kernels().sub_f32(a, b, destination, count);
+}
+
+void conv_f32(const float32_t * a, uint32_t a_count, const float32_t * b, uint32_t b_count, float32_t * destination){
+	convolve(a, a_count, b, b_count, destination, kernels().correlate_f32);
+}
+
+void mean_f32(const float32_t * source, uint32_t count, float32_t * result){
+	*result = count ? kernels().sum_f32(source, count) / static_cast<float32_t>(count) : 0.0f;
+}
+
+void power_f32(const float32_t * source, uint32_t count, float32_t * result){
+	*result = kernels().power_f32(source, count);
+}
+
+void var_f32(const float32_t * source, uint32_t count, float32_t * result){
+	if( count <= 1 ){ *result = 0.0f; return; }
+	const float32_t mean = kernels().sum_f32(source, count) / static_cast<float32_t>(count);
+	*result = kernels().deviation_f32(source, count, mean) / static_cast<float32_t>(count - 1);
+}
+
+arm_status sqrt_f32(float32_t value, float32_t * result){
+	if( value >= 0.0f ){
+		*result = std::sqrt(value);
+		return ARM_MATH_SUCCESS;
+	}
+	*result = 0.0f;
+	return ARM_MATH_ARGUMENT_ERROR;
+}
+
+void rms_f32(const float32_t * source, uint32_t count, float32_t * result){
+	if( count == 0 ){ *result = 0.0f; return; }
+	sqrt_f32(kernels().power_f32(source, count) / static_cast<float32_t>(count), result);
+}
+
+void std_f32(const float32_t * source, uint32_t count, float32_t * result){
+	float32_t variance;
+	var_f32(source, count, &variance);
+	sqrt_f32(variance, result);
+}
+
+void min_f32(const float32_t * source, uint32_t count, float32_t * result, uint32_t * index){
+	if( count == 0 ){ *result = 0.0f; *index = 0; return; }
+	*result = kernels().min_f32(source, count);
+	*index = find_index(source, count, *result);
+}
+
+void max_f32(const float32_t * source, uint32_t count, float32_t * result, uint32_t * index){
+	if( count == 0 ){ *result = 0.0f; *index = 0; return; }
+	*result = kernels().max_f32(source, count);
+	*index = find_index(source, count, *result);
+}
+
+float32_t sin_f32(float32_t x){ return std::sin(x); }
+float32_t cos_f32(float32_t x){ return std::cos(x); }
+
+void fir_f32(const arm_fir_instance_f32 * instance, const float32_t * source, float32_t * destination, uint32_t count){
+	filter_fir(instance, source, destination, count, kernels().correlate_f32);
+}
+
+arm_status fir_init_f32(arm_fir_instance_f32 * instance, uint16_t tap_count, const float32_t * coefficients, float32_t * state, uint32_t block_size){
+	return initialize_fir(instance, tap_count, coefficients, state, block_size);
+}
+
+void biquad_cascade_df1_f32(const arm_biquad_casd_df1_inst_f32 * instance, const float32_t * source, float32_t * destination, uint32_t count){
+	const float32_t * coefficients = instance->pCoeffs;
+	float32_t * state = instance->pState;
+	for(u32 stage=0; stage < instance->numStages; stage++){
+		const float32_t b0 = coefficients[0];
+		const float32_t b1 = coefficients[1];
+		const float32_t b2 = coefficients[2];
+		const float32_t a1 = coefficients[3];
+		const float32_t a2 = coefficients[4];
+		float32_t x1 = state[0];
+		float32_t x2 = state[1];
+		float32_t y1 = state[2];
+		float32_t y2 = state[3];
+		for(u32 n=0; n < count; n++){
+			const float32_t input = source[n];
+			const float32_t output = b0 * input + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+			x2 = x1; x1 = input;
+			y2 = y1; y1 = output;
+			destination[n] = output;
+		}
+		state[0] = x1; state[1] = x2; state[2] = y1; state[3] = y2;
+		state += 4;
+		coefficients += 5;
+		source = destination;
+	}
+}
+
+void biquad_cascade_df1_init_f32(arm_biquad_casd_df1_inst_f32 * instance, uint8_t stage_count, const float32_t * coefficients, float32_t * state){
+	instance->numStages = stage_count;
+	instance->pCoeffs = coefficients;
+	instance->pState = state;
+	memset(state, 0, stage_count * 4 * sizeof(float32_t));
+}
+
+/*
+ * Conversions
+ *
+ */
+void float_to_q7(const float32_t * source, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat8(static_cast<q31_t>(source[i] * 128.0f)); }
+}
+
+void float_to_q15(const float32_t * source, q15_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = ssat16(static_cast<q31_t>(source[i] * 32768.0f)); }
+}
+
+void float_to_q31(const float32_t * source, q31_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = clip_q63_to_q31(static_cast<q63_t>(source[i] * 2147483648.0f)); }
+}
+
+void q7_to_float(const q7_t * source, float32_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<float32_t>(source[i]) / 128.0f; }
+}
+
+void q7_to_q15(const q7_t * source, q15_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<q15_t>(static_cast<u16>(source[i]) << 8); }
+}
+
+void q7_to_q31(const q7_t * source, q31_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<q31_t>(static_cast<u32>(source[i]) << 24); }
+}
+
+void q15_to_float(const q15_t * source, float32_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<float32_t>(source[i]) / 32768.0f; }
+}
+
+void q15_to_q7(const q15_t * source, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<q7_t>(source[i] >> 8); }
+}
+
+void q15_to_q31(const q15_t * source, q31_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<q31_t>(static_cast<u32>(source[i]) << 16); }
+}
+
+void q31_to_float(const q31_t * source, float32_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<float32_t>(source[i]) / 2147483648.0f; }
+}
+
+void q31_to_q7(const q31_t * source, q7_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<q7_t>(source[i] >> 24); }
+}
+
+void q31_to_q15(const q31_t * source, q15_t * destination, uint32_t count){
+	for(u32 i=0; i < count; i++){ destination[i] = static_cast<q15_t>(source[i] >> 16); }
+}
+/*! \endcond */
+
+}
+
+extern "C" {
+
+const arm_dsp_api_q7_t dsp_host_api_q7 = {
+	abs_q7,
+	add_q7,
+	dot_prod_q7,
+	mult_q7,
+	negate_q7,
+	offset_q7,
+	scale_q7,
+	shift_q7,
+	sub_q7,
+	mean_q7,
+	power_q7,
+	min_q7,
+	max_q7
+};
+
+const arm_dsp_api_q15_t dsp_host_api_q15 = {
+	abs_q15,
+	add_q15,
+	dot_prod_q15,
+	mult_q15,
+	negate_q15,
+	offset_q15,
+	scale_q15,
+	shift_q15,
+	sub_q15,
+	conv_q15,
+	conv_fast_q15,
+	mean_q15,
+	power_q15,
+	var_q15,
+	rms_q15,
+	std_q15,
+	min_q15,
+	max_q15,
+	sin_q15,
+	cos_q15,
+	sqrt_q15,
+	fir_q15,
+	fir_fast_q15,
+	fir_init_q15,
+	biquad_cascade_df1_q15,
+	biquad_cascade_df1_fast_q15,
+	biquad_cascade_df1_init_q15,
+	dsp_host::cfft_q15,
+	dsp_host::rfft_q15,
+	dsp_host::rfft_init_q15
+};
+
+const arm_dsp_api_q31_t dsp_host_api_q31 = {
+	abs_q31,
+	add_q31,
+	dot_prod_q31,
+	mult_q31,
+	negate_q31,
+	offset_q31,
+	scale_q31,
+	shift_q31,
+	sub_q31,
+	conv_q31,
+	conv_fast_q31,
+	mean_q31,
+	power_q31,
+	var_q31,
+	rms_q31,
+	std_q31,
+	min_q31,
+	max_q31,
+	sin_q31,
+	cos_q31,
+	sqrt_q31,
+	fir_q31,
+	fir_fast_q31,
+	fir_init_q31,
+	fir_decimate_q31,
+	fir_decimate_fast_q31,
+	fir_decimate_init_q31,
+	biquad_cascade_df1_q31,
+	biquad_cascade_df1_fast_q31,
+	biquad_cascade_df1_init_q31,
+	dsp_host::cfft_q31,
+	dsp_host::rfft_q31,
+	dsp_host::rfft_init_q31
+};
+
+const arm_dsp_api_f32_t dsp_host_api_f32 = {
+	abs_f32,
+	add_f32,
+	dot_prod_f32,
+	mult_f32,
+	negate_f32,
+	offset_f32,
+	scale_f32,
+	sub_f32,
+	conv_f32,
+	mean_f32,
+	power_f32,
+	var_f32,
+	rms_f32,
+	std_f32,
+	min_f32,
+	max_f32,
+	sin_f32,
+	cos_f32,
+	sqrt_f32,
+	fir_f32,
+	fir_init_f32,
+	biquad_cascade_df1_f32,
+	biquad_cascade_df1_init_f32,
+	dsp_host::cfft_f32,
+	dsp_host::rfft_fast_f32,
+	dsp_host::rfft_fast_init_f32
+};
+
+const arm_dsp_conversion_api_t dsp_host_api_conversion = {
+	float_to_q7,
+	float_to_q15,
+	float_to_q31,
+	q7_to_float,
+	q7_to_q15,
+	q7_to_q31,
+	q15_to_float,
+	q15_to_q7,
+	q15_to_q31,
+	q31_to_float,
+	q31_to_q7,
+	q31_to_q15
+};
+
+int dsp_host_api_kernel(){
+	return kernel_selection().kernel();
+}
+
+int dsp_host_api_set_kernel(int kernel){
+	return kernel_selection().select(kernel);
+}
+
+}
@@ -0,0 +1,631 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+/*
+ * This file is included by HostDspApi.cpp once for each
+ * instruction set. Vector has the operations on one register
+ * (16 bytes for SSE4.1 or 32 bytes for AVX2). Each kernel
+ * gives the same result as the scalar kernel with the same name
+ * (except for the order of the floating point sums).
+ *
+ */
+
+enum {
+	q15_lanes = Vector::size / sizeof(q15_t),
+	q31_lanes = Vector::size / sizeof(q31_t),
+	f32_lanes = Vector::size / sizeof(float32_t)
+};
+
+typedef Vector::integer_t integer_t;
+typedef Vector::float_t float_t;
+
+template<typename T> T reduce_min(const T * values, u32 count){
+	T result = values[0];
+	for(u32 i=1; i < count; i++){ if( values[i] < result ){ result = values[i]; } }
+	return result;
+}
+
+template<typename T> T reduce_max(const T * values, u32 count){
+	T result = values[0];
+	for(u32 i=1; i < count; i++){ if( values[i] > result ){ result = values[i]; } }
+	return result;
+}
+
+q63_t reduce_s64(integer_t value){
+	q63_t values[Vector::size / sizeof(q63_t)];
+	Vector::store(values, value);
+	q63_t result = 0;
+	for(u32 i=0; i < Vector::size / sizeof(q63_t); i++){ result = wrap_add(result, values[i]); }
+	return result;
+}
+
+q31_t reduce_s32(integer_t value){
+	q31_t values[q31_lanes];
+	Vector::store(values, value);
+	q31_t result = 0;
+	for(u32 i=0; i < q31_lanes; i++){ result = wrap_add(result, values[i]); }
+	return result;
+}
+
+float32_t reduce_float(float_t value){
+	float32_t values[f32_lanes];
+	Vector::store_float(values, value);
+	float32_t result = 0.0f;
+	for(u32 i=0; i < f32_lanes; i++){ result += values[i]; }
+	return result;
+}
+
+//adds the signed 32-bit items to the 64-bit items of sum
+integer_t accumulate_s32(integer_t sum, integer_t value, integer_t sign){
+	sum = Vector::add_s64(sum, Vector::unpack_low_s32(value, sign));
+	return Vector::add_s64(sum, Vector::unpack_high_s32(value, sign));
+}
+
+//upper 32 bits of the products of the 32-bit items (in the same positions)
+integer_t multiply_high_s32(integer_t a, integer_t b){
+	const integer_t even = Vector::shift_right_u64(Vector::multiply_even_s32(a, b), 32);
+	const integer_t odd = Vector::multiply_even_s32(Vector::shift_right_u64(a, 32), Vector::shift_right_u64(b, 32));
+	return Vector::blend_odd_s32(even, odd);
+}
+
+//value << shift with saturation (like shift_left_saturate())
+integer_t shift_left_saturate_s32(integer_t value, int shift){
+	const integer_t result = Vector::shift_left_s32(value, shift);
+	const integer_t is_overflow = Vector::bit_xor(
+				Vector::equal_s32(Vector::shift_right_s32(result, shift), value),
+				Vector::set_s32(-1)
+				);
+	const integer_t saturated = Vector::bit_xor(Vector::shift_right_s32(value, 31), Vector::set_s32(INT32_MAX));
+	return Vector::select(result, saturated, is_overflow);
+}
+
+//packs saturate(value >> 15) of the 32-bit items in even and odd in the order e0, o0, e1, o1, ...
+integer_t interleave_pack_q15(integer_t even, integer_t odd){
+	even = Vector::shift_right_s32(even, 15);
+	odd = Vector::shift_right_s32(odd, 15);
+	return Vector::pack_saturate_s32(Vector::unpack_low_s32(even, odd), Vector::unpack_high_s32(even, odd));
+}
+
+/*
+ * q15
+ *
+ */
+void add_q15(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		Vector::store(destination + i, Vector::add_saturate_s16(Vector::load(a + i), Vector::load(b + i)));
+	}
+	add_q15_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void sub_q15(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		Vector::store(destination + i, Vector::subtract_saturate_s16(Vector::load(a + i), Vector::load(b + i)));
+	}
+	sub_q15_scalar(a + i, b + i, destination + i, count - i);
+}
+
+//bits 15 to 30 of the product; only -1 * -1 overflows (to 0x8000)
+void mult_q15(const q15_t * a, const q15_t * b, q15_t * destination, u32 count){
+	const integer_t overflow = Vector::set_s16(INT16_MIN);
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		const integer_t x = Vector::load(a + i);
+		const integer_t y = Vector::load(b + i);
+		integer_t result = Vector::bit_or(
+					Vector::shift_left_s16(Vector::multiply_high_s16(x, y), 1),
+					Vector::shift_right_u16(Vector::multiply_low_s16(x, y), 15)
+					);
+		result = Vector::add_s16(result, Vector::equal_s16(result, overflow));
+		Vector::store(destination + i, result);
+	}
+	mult_q15_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void offset_q15(const q15_t * source, q15_t offset, q15_t * destination, u32 count){
+	const integer_t value = Vector::set_s16(offset);
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		Vector::store(destination + i, Vector::add_saturate_s16(Vector::load(source + i), value));
+	}
+	offset_q15_scalar(source + i, offset, destination + i, count - i);
+}
+
+void scale_q15(const q15_t * source, q15_t scale_fraction, s8 shift, q15_t * destination, u32 count){
+	const int right_shift = 15 - shift;
+	if( right_shift < 0 ){
+		scale_q15_scalar(source, scale_fraction, shift, destination, count);
+		return;
+	}
+	const int count_shift = right_shift > 31 ? 31 : right_shift;
+	const integer_t scale = Vector::set_s16(scale_fraction);
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		const integer_t x = Vector::load(source + i);
+		const integer_t low = Vector::multiply_low_s16(x, scale);
+		const integer_t high = Vector::multiply_high_s16(x, scale);
+		Vector::store(destination + i, Vector::pack_saturate_s32(
+										Vector::shift_right_s32(Vector::unpack_low_s16(low, high), count_shift),
+										Vector::shift_right_s32(Vector::unpack_high_s16(low, high), count_shift)
+										));
+	}
+	scale_q15_scalar(source + i, scale_fraction, shift, destination + i, count - i);
+}
+
+void shift_q15(const q15_t * source, s8 shift, q15_t * destination, u32 count){
+	u32 i;
+	if( shift >= 0 ){
+		const int count_shift = shift > 16 ? 16 : shift;
+		for(i=0; i + q15_lanes <= count; i += q15_lanes){
+			const integer_t x = Vector::load(source + i);
+			Vector::store(destination + i, Vector::pack_saturate_s32(
+											Vector::shift_left_s32(Vector::shift_right_s32(Vector::unpack_low_s16(x, x), 16), count_shift),
+											Vector::shift_left_s32(Vector::shift_right_s32(Vector::unpack_high_s16(x, x), 16), count_shift)
+											));
+		}
+	} else {
+		const int count_shift = -shift > 15 ? 15 : -shift;
+		for(i=0; i + q15_lanes <= count; i += q15_lanes){
+			Vector::store(destination + i, Vector::shift_right_s16(Vector::load(source + i), count_shift));
+		}
+	}
+	shift_q15_scalar(source + i, shift, destination + i, count - i);
+}
+
+void abs_q15(const q15_t * source, q15_t * destination, u32 count){
+	const integer_t maximum = Vector::set_s16(INT16_MAX);
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		Vector::store(destination + i, Vector::min_u16(Vector::abs_s16(Vector::load(source + i)), maximum));
+	}
+	abs_q15_scalar(source + i, destination + i, count - i);
+}
+
+void negate_q15(const q15_t * source, q15_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		Vector::store(destination + i, Vector::subtract_saturate_s16(Vector::zero(), Vector::load(source + i)));
+	}
+	negate_q15_scalar(source + i, destination + i, count - i);
+}
+
+q31_t sum_q15(const q15_t * source, u32 count){
+	const integer_t one = Vector::set_s16(1);
+	integer_t sum = Vector::zero();
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		sum = Vector::add_s32(sum, Vector::multiply_add_s16(Vector::load(source + i), one));
+	}
+	return wrap_add(reduce_s32(sum), sum_q15_scalar(source + i, count - i));
+}
+
+//x0*x0 + x1*x1 fits in 32 bits unsigned
+q63_t power_q15(const q15_t * source, u32 count){
+	const integer_t zero = Vector::zero();
+	integer_t sum = Vector::zero();
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		const integer_t x = Vector::load(source + i);
+		sum = accumulate_s32(sum, Vector::multiply_add_s16(x, x), zero);
+	}
+	return reduce_s64(sum) + power_q15_scalar(source + i, count - i);
+}
+
+//a0*b0 + a1*b1 only wraps for (-1*-1) + (-1*-1) which is the only way to get INT32_MIN
+q63_t dot_prod_q15(const q15_t * a, const q15_t * b, u32 count){
+	const integer_t zero = Vector::zero();
+	const integer_t minimum = Vector::set_s32(INT32_MIN);
+	integer_t sum = Vector::zero();
+	u32 i;
+	for(i=0; i + q15_lanes <= count; i += q15_lanes){
+		const integer_t product = Vector::multiply_add_s16(Vector::load(a + i), Vector::load(b + i));
+		const integer_t sign = Vector::bit_and_not(Vector::equal_s32(product, minimum), Vector::greater_s32(zero, product));
+		sum = accumulate_s32(sum, product, sign);
+	}
+	return reduce_s64(sum) + dot_prod_q15_scalar(a + i, b + i, count - i);
+}
+
+q15_t min_q15(const q15_t * source, u32 count){
+	if( count < q15_lanes ){ return min_q15_scalar(source, count); }
+	integer_t result = Vector::load(source);
+	u32 i;
+	for(i=q15_lanes; i + q15_lanes <= count; i += q15_lanes){
+		result = Vector::min_s16(result, Vector::load(source + i));
+	}
+	q15_t values[q15_lanes + 1];
+	Vector::store(values, result);
+	if( i < count ){ values[q15_lanes] = min_q15_scalar(source + i, count - i); }
+	return reduce_min(values, i < count ? q15_lanes + 1 : q15_lanes);
+}
+
+q15_t max_q15(const q15_t * source, u32 count){
+	if( count < q15_lanes ){ return max_q15_scalar(source, count); }
+	integer_t result = Vector::load(source);
+	u32 i;
+	for(i=q15_lanes; i + q15_lanes <= count; i += q15_lanes){
+		result = Vector::max_s16(result, Vector::load(source + i));
+	}
+	q15_t values[q15_lanes + 1];
+	Vector::store(values, result);
+	if( i < count ){ values[q15_lanes] = max_q15_scalar(source + i, count - i); }
+	return reduce_max(values, i < count ? q15_lanes + 1 : q15_lanes);
+}
+
+/*
+ * multiply_add_s16() of source[n+k...] and the coefficient pair
+ * {c[k], c[k+1]} gives the partial sums of outputs n, n+2, ... and
+ * the same for source[n+k+1...] gives outputs n+1, n+3, ...
+ * The sums wrap in 32 bits like the scalar kernel.
+ *
+ */
+void correlate_fast_q15(const q15_t * source, const q15_t * coefficients, u32 tap_count, q15_t * destination, u32 count){
+	u32 n = 0;
+	//the last odd load reads one item past the last output
+	for(n=0; n + q15_lanes + 1 <= count; n += q15_lanes){
+		integer_t even = Vector::zero();
+		integer_t odd = Vector::zero();
+		for(u32 k=0; k < tap_count; k += 2){
+			const u16 first = static_cast<u16>(coefficients[k]);
+			const u16 second = k + 1 < tap_count ? static_cast<u16>(coefficients[k+1]) : 0;
+			const integer_t pair = Vector::set_s32(static_cast<s32>(first | (static_cast<u32>(second) << 16)));
+			even = Vector::add_s32(even, Vector::multiply_add_s16(Vector::load(source + n + k), pair));
+			odd = Vector::add_s32(odd, Vector::multiply_add_s16(Vector::load(source + n + k + 1), pair));
+		}
+		Vector::store(destination + n, interleave_pack_q15(even, odd));
+	}
+	correlate_fast_q15_scalar(source + n, coefficients, tap_count, destination + n, count - n);
+}
+
+/*
+ * q31
+ *
+ */
+void add_q31(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	const integer_t maximum = Vector::set_s32(INT32_MAX);
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(a + i);
+		const integer_t y = Vector::load(b + i);
+		const integer_t result = Vector::add_s32(x, y);
+		const integer_t is_overflow = Vector::shift_right_s32(
+					Vector::bit_and(Vector::bit_xor(x, result), Vector::bit_xor(y, result)), 31
+					);
+		const integer_t saturated = Vector::bit_xor(Vector::shift_right_s32(x, 31), maximum);
+		Vector::store(destination + i, Vector::select(result, saturated, is_overflow));
+	}
+	add_q31_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void sub_q31(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	const integer_t maximum = Vector::set_s32(INT32_MAX);
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(a + i);
+		const integer_t y = Vector::load(b + i);
+		const integer_t result = Vector::subtract_s32(x, y);
+		const integer_t is_overflow = Vector::shift_right_s32(
+					Vector::bit_and(Vector::bit_xor(x, y), Vector::bit_xor(x, result)), 31
+					);
+		const integer_t saturated = Vector::bit_xor(Vector::shift_right_s32(x, 31), maximum);
+		Vector::store(destination + i, Vector::select(result, saturated, is_overflow));
+	}
+	sub_q31_scalar(a + i, b + i, destination + i, count - i);
+}
+
+//the upper half of the product is 0x40000000 only for -1 * -1
+void mult_q31(const q31_t * a, const q31_t * b, q31_t * destination, u32 count){
+	const integer_t overflow = Vector::set_s32(0x40000000);
+	const integer_t two = Vector::set_s32(2);
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t high = multiply_high_s32(Vector::load(a + i), Vector::load(b + i));
+		const integer_t result = Vector::shift_left_s32(high, 1);
+		Vector::store(destination + i, Vector::subtract_s32(result, Vector::bit_and(Vector::equal_s32(high, overflow), two)));
+	}
+	mult_q31_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void offset_q31(const q31_t * source, q31_t offset, q31_t * destination, u32 count){
+	const integer_t maximum = Vector::set_s32(INT32_MAX);
+	const integer_t y = Vector::set_s32(offset);
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(source + i);
+		const integer_t result = Vector::add_s32(x, y);
+		const integer_t is_overflow = Vector::shift_right_s32(
+					Vector::bit_and(Vector::bit_xor(x, result), Vector::bit_xor(y, result)), 31
+					);
+		const integer_t saturated = Vector::bit_xor(Vector::shift_right_s32(x, 31), maximum);
+		Vector::store(destination + i, Vector::select(result, saturated, is_overflow));
+	}
+	offset_q31_scalar(source + i, offset, destination + i, count - i);
+}
+
+void scale_q31(const q31_t * source, q31_t scale_fraction, s8 shift, q31_t * destination, u32 count){
+	const integer_t scale = Vector::set_s32(scale_fraction);
+	const int left_shift = shift + 1;
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t high = multiply_high_s32(Vector::load(source + i), scale);
+		if( left_shift >= 0 ){
+			Vector::store(destination + i, shift_left_saturate_s32(high, left_shift));
+		} else {
+			Vector::store(destination + i, Vector::shift_right_s32(high, -left_shift > 31 ? 31 : -left_shift));
+		}
+	}
+	scale_q31_scalar(source + i, scale_fraction, shift, destination + i, count - i);
+}
+
+void shift_q31(const q31_t * source, s8 shift, q31_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(source + i);
+		if( shift >= 0 ){
+			Vector::store(destination + i, shift_left_saturate_s32(x, shift));
+		} else {
+			Vector::store(destination + i, Vector::shift_right_s32(x, -shift > 31 ? 31 : -shift));
+		}
+	}
+	shift_q31_scalar(source + i, shift, destination + i, count - i);
+}
+
+void abs_q31(const q31_t * source, q31_t * destination, u32 count){
+	const integer_t maximum = Vector::set_s32(INT32_MAX);
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		Vector::store(destination + i, Vector::min_u32(Vector::abs_s32(Vector::load(source + i)), maximum));
+	}
+	abs_q31_scalar(source + i, destination + i, count - i);
+}
+
+void negate_q31(const q31_t * source, q31_t * destination, u32 count){
+	const integer_t minimum = Vector::set_s32(INT32_MIN);
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(source + i);
+		Vector::store(destination + i, Vector::add_s32(Vector::subtract_s32(Vector::zero(), x), Vector::equal_s32(x, minimum)));
+	}
+	negate_q31_scalar(source + i, destination + i, count - i);
+}
+
+q63_t sum_q31(const q31_t * source, u32 count){
+	const integer_t zero = Vector::zero();
+	integer_t sum = Vector::zero();
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(source + i);
+		sum = accumulate_s32(sum, x, Vector::greater_s32(zero, x));
+	}
+	return reduce_s64(sum) + sum_q31_scalar(source + i, count - i);
+}
+
+q63_t power_q31(const q31_t * source, u32 count){
+	integer_t sum = Vector::zero();
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(source + i);
+		const integer_t x_odd = Vector::shift_right_u64(x, 32);
+		//the squares are positive so the shift can be logical
+		sum = Vector::add_s64(sum, Vector::shift_right_u64(Vector::multiply_even_s32(x, x), 14));
+		sum = Vector::add_s64(sum, Vector::shift_right_u64(Vector::multiply_even_s32(x_odd, x_odd), 14));
+	}
+	return wrap_add(reduce_s64(sum), power_q31_scalar(source + i, count - i));
+}
+
+//value >> 14 for signed 64-bit items
+integer_t shift_right_14_s64(integer_t value){
+	return Vector::bit_or(Vector::shift_right_u64(value, 14), Vector::shift_left_s64(Vector::sign_s64(value), 64 - 14));
+}
+
+q63_t dot_prod_q31(const q31_t * a, const q31_t * b, u32 count){
+	integer_t sum = Vector::zero();
+	u32 i;
+	for(i=0; i + q31_lanes <= count; i += q31_lanes){
+		const integer_t x = Vector::load(a + i);
+		const integer_t y = Vector::load(b + i);
+		sum = Vector::add_s64(sum, shift_right_14_s64(Vector::multiply_even_s32(x, y)));
+		sum = Vector::add_s64(sum, shift_right_14_s64(
+														Vector::multiply_even_s32(Vector::shift_right_u64(x, 32), Vector::shift_right_u64(y, 32))
+														));
+	}
+	return wrap_add(reduce_s64(sum), dot_prod_q31_scalar(a + i, b + i, count - i));
+}
+
+q31_t min_q31(const q31_t * source, u32 count){
+	if( count < q31_lanes ){ return min_q31_scalar(source, count); }
+	integer_t result = Vector::load(source);
+	u32 i;
+	for(i=q31_lanes; i + q31_lanes <= count; i += q31_lanes){
+		result = Vector::min_s32(result, Vector::load(source + i));
+	}
+	q31_t values[q31_lanes + 1];
+	Vector::store(values, result);
+	if( i < count ){ values[q31_lanes] = min_q31_scalar(source + i, count - i); }
+	return reduce_min(values, i < count ? q31_lanes + 1 : q31_lanes);
+}
+
+q31_t max_q31(const q31_t * source, u32 count){
+	if( count < q31_lanes ){ return max_q31_scalar(source, count); }
+	integer_t result = Vector::load(source);
+	u32 i;
+	for(i=q31_lanes; i + q31_lanes <= count; i += q31_lanes){
+		result = Vector::max_s32(result, Vector::load(source + i));
+	}
+	q31_t values[q31_lanes + 1];
+	Vector::store(values, result);
+	if( i < count ){ values[q31_lanes] = max_q31_scalar(source + i, count - i); }
+	return reduce_max(values, i < count ? q31_lanes + 1 : q31_lanes);
+}
+
+/*
+ * Adding the upper 32 bits of (sum << 32) + product + round is the
+ * same as adding the upper 32 bits of (product + round) so
+ * the outputs can be calculated in 64-bit lanes: the even outputs use
+ * the even items of source[n+k...] and the odd outputs use the odd items.
+ *
+ */
+void correlate_fast_q31(const q31_t * source, const q31_t * coefficients, u32 tap_count, q31_t * destination, u32 count, q63_t round){
+	const integer_t round_value = Vector::set_s64(round);
+	u32 n;
+	for(n=0; n + q31_lanes <= count; n += q31_lanes){
+		integer_t even = Vector::zero();
+		integer_t odd = Vector::zero();
+		for(u32 k=0; k < tap_count; k++){
+			const integer_t coefficient = Vector::set_s32(coefficients[k]);
+			const integer_t x = Vector::load(source + n + k);
+			even = Vector::add_s64(even, Vector::shift_right_u64(
+															Vector::add_s64(Vector::multiply_even_s32(x, coefficient), round_value), 32)
+														 );
+			odd = Vector::add_s64(odd, Vector::shift_right_u64(
+														 Vector::add_s64(Vector::multiply_even_s32(Vector::shift_right_u64(x, 32), coefficient), round_value), 32)
+														);
+		}
+		const integer_t result = Vector::blend_odd_s32(even, Vector::shift_left_s64(odd, 32));
+		Vector::store(destination + n, Vector::shift_left_s32(result, 1));
+	}
+	correlate_fast_q31_scalar(source + n, coefficients, tap_count, destination + n, count - n, round);
+}
+
+/*
+ * f32
+ *
+ */
+void add_f32(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::add_float(Vector::load_float(a + i), Vector::load_float(b + i)));
+	}
+	add_f32_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void sub_f32(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::subtract_float(Vector::load_float(a + i), Vector::load_float(b + i)));
+	}
+	sub_f32_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void mult_f32(const float32_t * a, const float32_t * b, float32_t * destination, u32 count){
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::multiply_float(Vector::load_float(a + i), Vector::load_float(b + i)));
+	}
+	mult_f32_scalar(a + i, b + i, destination + i, count - i);
+}
+
+void offset_f32(const float32_t * source, float32_t offset, float32_t * destination, u32 count){
+	const float_t value = Vector::set_float(offset);
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::add_float(Vector::load_float(source + i), value));
+	}
+	offset_f32_scalar(source + i, offset, destination + i, count - i);
+}
+
+void scale_f32(const float32_t * source, float32_t scale, float32_t * destination, u32 count){
+	const float_t value = Vector::set_float(scale);
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::multiply_float(Vector::load_float(source + i), value));
+	}
+	scale_f32_scalar(source + i, scale, destination + i, count - i);
+}
+
+void abs_f32(const float32_t * source, float32_t * destination, u32 count){
+	const float_t mask = Vector::cast_float(Vector::set_s32(INT32_MAX));
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::and_float(Vector::load_float(source + i), mask));
+	}
+	abs_f32_scalar(source + i, destination + i, count - i);
+}
+
+void negate_f32(const float32_t * source, float32_t * destination, u32 count){
+	const float_t sign = Vector::cast_float(Vector::set_s32(INT32_MIN));
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		Vector::store_float(destination + i, Vector::xor_float(Vector::load_float(source + i), sign));
+	}
+	negate_f32_scalar(source + i, destination + i, count - i);
+}
+
+float32_t sum_f32(const float32_t * source, u32 count){
+	float_t sum = Vector::zero_float();
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		sum = Vector::add_float(sum, Vector::load_float(source + i));
+	}
+	return reduce_float(sum) + sum_f32_scalar(source + i, count - i);
+}
+
+float32_t power_f32(const float32_t * source, u32 count){
+	float_t sum = Vector::zero_float();
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		const float_t x = Vector::load_float(source + i);
+		sum = Vector::add_float(sum, Vector::multiply_float(x, x));
+	}
+	return reduce_float(sum) + power_f32_scalar(source + i, count - i);
+}
+
+float32_t dot_prod_f32(const float32_t * a, const float32_t * b, u32 count){
+	float_t sum = Vector::zero_float();
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		sum = Vector::add_float(sum, Vector::multiply_float(Vector::load_float(a + i), Vector::load_float(b + i)));
+	}
+	return reduce_float(sum) + dot_prod_f32_scalar(a + i, b + i, count - i);
+}
+
+float32_t deviation_f32(const float32_t * source, u32 count, float32_t mean){
+	const float_t mean_value = Vector::set_float(mean);
+	float_t sum = Vector::zero_float();
+	u32 i;
+	for(i=0; i + f32_lanes <= count; i += f32_lanes){
+		const float_t difference = Vector::subtract_float(Vector::load_float(source + i), mean_value);
+		sum = Vector::add_float(sum, Vector::multiply_float(difference, difference));
+	}
+	return reduce_float(sum) + deviation_f32_scalar(source + i, count - i, mean);
+}
+
+float32_t min_f32(const float32_t * source, u32 count){
+	if( count < f32_lanes ){ return min_f32_scalar(source, count); }
+	float_t result = Vector::load_float(source);
+	u32 i;
+	for(i=f32_lanes; i + f32_lanes <= count; i += f32_lanes){
+		result = Vector::min_float(result, Vector::load_float(source + i));
+	}
+	float32_t values[f32_lanes + 1];
+	Vector::store_float(values, result);
+	if( i < count ){ values[f32_lanes] = min_f32_scalar(source + i, count - i); }
+	return reduce_min(values, i < count ? f32_lanes + 1 : f32_lanes);
+}
+
+float32_t max_f32(const float32_t * source, u32 count){
+	if( count < f32_lanes ){ return max_f32_scalar(source, count); }
+	float_t result = Vector::load_float(source);
+	u32 i;
+	for(i=f32_lanes; i + f32_lanes <= count; i += f32_lanes){
+		result = Vector::max_float(result, Vector::load_float(source + i));
+	}
+	float32_t values[f32_lanes + 1];
+	Vector::store_float(values, result);
+	if( i < count ){ values[f32_lanes] = max_f32_scalar(source + i, count - i); }
+	return reduce_max(values, i < count ? f32_lanes + 1 : f32_lanes);
+}
+
+//each lane is one output and adds the taps in the same order as the scalar kernel
+void correlate_f32(const float32_t * source, const float32_t * coefficients, u32 tap_count, float32_t * destination, u32 count){
+	u32 n;
+	for(n=0; n + f32_lanes <= count; n += f32_lanes){
+		float_t sum = Vector::zero_float();
+		for(u32 k=0; k < tap_count; k++){
+			sum = Vector::add_float(sum, Vector::multiply_float(Vector::set_float(coefficients[k]), Vector::load_float(source + n + k)));
+		}
+		Vector::store_float(destination + n, sum);
+	}
+	correlate_f32_scalar(source + n, coefficients, tap_count, destination + n, count - n);
+}
+
+const Kernels kernels = { DSP_HOST_KERNEL_LIST(, ) };
@@ -0,0 +1,326 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cmath>
+#include <limits>
+#include "var/Vector.hpp"
+#include "HostDspTransform.h"
+
+/*
+ * The FFTs are radix-2 decimation in frequency. The complex
+ * data is stored {re, im, re, im, ...} like CMSIS. The
+ * twiddle factors for every length come from one table
+ * for DSP_HOST_FFT_MAX_LENGTH.
+ *
+ * The fixed-point transforms are calculated in double precision
+ * and scaled by 1/fftLen which is the output format of the CMSIS
+ * fixed-point transforms.
+ *
+ */
+
+namespace {
+
+/*! \cond */
+template<typename R> class TwiddleTable {
+public:
+	TwiddleTable(){
+		const double pi = 3.14159265358979323846;
+		for(u32 i=0; i < DSP_HOST_FFT_MAX_LENGTH/2; i++){
+			const double angle = 2.0 * pi * i / DSP_HOST_FFT_MAX_LENGTH;
+			m_values[2*i] = static_cast<R>(std::cos(angle));
+			m_values[2*i+1] = static_cast<R>(-std::sin(angle));
+		}
+	}
+
+	//exp(-2*pi*i*index/DSP_HOST_FFT_MAX_LENGTH)
+	R real(u32 index) const { return m_values[2*index]; }
+	R imaginary(u32 index) const { return m_values[2*index+1]; }
+
+private:
+	R m_values[DSP_HOST_FFT_MAX_LENGTH];
+};
+
+template<typename R> const TwiddleTable<R> & twiddle_table(){
+	static const TwiddleTable<R> table;
+	return table;
+}
+
+bool is_valid_length(u32 length, u32 minimum){
+	return (length >= minimum) &&
+			(length <= DSP_HOST_FFT_MAX_LENGTH) &&
+			((length & (length - 1)) == 0);
+}
+
+template<typename R> void reverse_bits(R * data, u32 length){
+	u32 j = 0;
+	for(u32 i=0; i < length; i++){
+		if( i < j ){
+			const R real = data[2*i];
+			const R imaginary = data[2*i+1];
+			data[2*i] = data[2*j];
+			data[2*i+1] = data[2*j+1];
+			data[2*j] = real;
+			data[2*j+1] = imaginary;
+		}
+		u32 bit = length >> 1;
+		while( j & bit ){
+			j ^= bit;
+			bit >>= 1;
+		}
+		j |= bit;
+	}
+}
+
+//unscaled in both directions; the output is bit reversed unless is_bit_reversal is true
+template<typename R> void transform_complex(R * data, u32 length, bool is_inverse, bool is_bit_reversal){
+	const TwiddleTable<R> & table = twiddle_table<R>();
+	for(u32 span = length/2; span >= 1; span >>= 1){
+		const u32 stride = DSP_HOST_FFT_MAX_LENGTH / (2*span);
+		for(u32 j=0; j < span; j++){
+			const R twiddle_real = table.real(j*stride);
+			const R twiddle_imaginary = is_inverse ? -table.imaginary(j*stride) : table.imaginary(j*stride);
+			for(u32 start=0; start < length; start += 2*span){
+				R * a = data + 2*(start + j);
+				R * b = a + 2*span;
+				const R difference_real = a[0] - b[0];
+				const R difference_imaginary = a[1] - b[1];
+				a[0] += b[0];
+				a[1] += b[1];
+				b[0] = difference_real * twiddle_real - difference_imaginary * twiddle_imaginary;
+				b[1] = difference_real * twiddle_imaginary + difference_imaginary * twiddle_real;
+			}
+		}
+	}
+
+	if( is_bit_reversal ){
+		reverse_bits(data, length);
+	}
+}
+
+template<typename T> T round_saturate(double value){
+	const double result = std::floor(value + 0.5);
+	if( result > std::numeric_limits<T>::max() ){ return std::numeric_limits<T>::max(); }
+	if( result < std::numeric_limits<T>::min() ){ return std::numeric_limits<T>::min(); }
+	return static_cast<T>(result);
+}
+
+template<typename T> void transform_complex_fixed(T * data, u32 length, bool is_inverse, bool is_bit_reversal){
+	if( is_valid_length(length, 16) == false ){ return; }
+	var::Vector<double> work(2*length);
+	for(u32 i=0; i < 2*length; i++){
+		work.data()[i] = data[i];
+	}
+	transform_complex(work.data(), length, is_inverse, is_bit_reversal);
+	for(u32 i=0; i < 2*length; i++){
+		data[i] = round_saturate<T>(work.data()[i] / length);
+	}
+}
+
+/*
+ * The forward transform writes all fftLenReal complex bins. The inverse
+ * uses bins 0 to fftLenReal/2 (the others are the complex conjugates).
+ *
+ */
+template<typename Instance, typename T> void transform_real_fixed(const Instance * instance, const T * source, T * destination){
+	const u32 length = instance->fftLenReal;
+	if( is_valid_length(length, 32) == false ){ return; }
+	var::Vector<double> work(2*length);
+	double * values = work.data();
+	if( instance->ifftFlagR == 0 ){
+		for(u32 i=0; i < length; i++){
+			values[2*i] = source[i];
+			values[2*i+1] = 0.0;
+		}
+		transform_complex(values, length, false, true);
+		for(u32 i=0; i < 2*length; i++){
+			destination[i] = round_saturate<T>(values[i] / length);
+		}
+	} else {
+		for(u32 i=0; i <= length/2; i++){
+			values[2*i] = source[2*i];
+			values[2*i+1] = source[2*i+1];
+		}
+		for(u32 i=length/2+1; i < length; i++){
+			values[2*i] = source[2*(length - i)];
+			values[2*i+1] = -source[2*(length - i)+1];
+		}
+		transform_complex(values, length, true, true);
+		for(u32 i=0; i < length; i++){
+			destination[i] = round_saturate<T>(values[2*i] / length);
+		}
+	}
+}
+
+//CMSIS uses a complex transform of fftLenReal/2 for the real transforms
+template<typename Instance> const Instance * complex_instance(u32 length){
+	static const Instance instances[] = {
+		{16}, {32}, {64}, {128}, {256}, {512}, {1024}, {2048}, {4096}
+	};
+	u32 index = 0;
+	while( (16u << index) < length ){ index++; }
+	return instances + index;
+}
+
+template<typename Instance, typename ComplexInstance> arm_status initialize_real_fixed(
+		Instance * instance,
+		u32 length,
+		u32 is_inverse,
+		u32 is_bit_reversal
+		){
+	if( is_valid_length(length, 32) == false ){
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	instance->fftLenReal = length;
+	instance->ifftFlagR = static_cast<uint8_t>(is_inverse);
+	instance->bitReverseFlagR = static_cast<uint8_t>(is_bit_reversal);
+	instance->pCfft = complex_instance<ComplexInstance>(length/2);
+	return ARM_MATH_SUCCESS;
+}
+/*! \endcond */
+
+}
+
+namespace dsp_host {
+
+void cfft_q15(const arm_cfft_instance_q15 * instance, q15_t * data, uint8_t is_inverse, uint8_t is_bit_reversal){
+	transform_complex_fixed(data, instance->fftLen, is_inverse, is_bit_reversal);
+}
+
+void rfft_q15(const arm_rfft_instance_q15 * instance, q15_t * source, q15_t * destination){
+	transform_real_fixed(instance, source, destination);
+}
+
+arm_status rfft_init_q15(arm_rfft_instance_q15 * instance, uint32_t length, uint32_t is_inverse, uint32_t is_bit_reversal){
+	return initialize_real_fixed<arm_rfft_instance_q15, arm_cfft_instance_q15>(instance, length, is_inverse, is_bit_reversal);
+}
+
+void cfft_q31(const arm_cfft_instance_q31 * instance, q31_t * data, uint8_t is_inverse, uint8_t is_bit_reversal){
+	transform_complex_fixed(data, instance->fftLen, is_inverse, is_bit_reversal);
+}
+
+void rfft_q31(const arm_rfft_instance_q31 * instance, q31_t * source, q31_t * destination){
+	transform_real_fixed(instance, source, destination);
+}
+
+arm_status rfft_init_q31(arm_rfft_instance_q31 * instance, uint32_t length, uint32_t is_inverse, uint32_t is_bit_reversal){
+	return initialize_real_fixed<arm_rfft_instance_q31, arm_cfft_instance_q31>(instance, length, is_inverse, is_bit_reversal);
+}
+
+//the inverse is scaled by 1/fftLen
+void cfft_f32(const arm_cfft_instance_f32 * instance, float32_t * data, uint8_t is_inverse, uint8_t is_bit_reversal){
+	const u32 length = instance->fftLen;
+	if( is_valid_length(length, 16) == false ){ return; }
+	transform_complex(data, length, is_inverse, is_bit_reversal);
+	if( is_inverse ){
+		const float32_t scale = 1.0f / length;
+		for(u32 i=0; i < 2*length; i++){
+			data[i] *= scale;
+		}
+	}
+}
+
+/*
+ * The real transform packs the N real values in N/2 complex values and
+ * uses a complex transform of N/2. The spectrum is stored as
+ * {X[0], X[N/2], re X[1], im X[1], ... re X[N/2-1], im X[N/2-1]}. The
+ * inverse transform is scaled by 1/fftLenRFFT.
+ *
+ */
+void rfft_fast_f32(const arm_rfft_fast_instance_f32 * instance, float32_t * source, float32_t * destination, uint8_t is_inverse){
+	const u32 length = instance->fftLenRFFT;
+	const u32 half = length / 2;
+	if( is_valid_length(length, 32) == false ){ return; }
+	const TwiddleTable<float32_t> & table = twiddle_table<float32_t>();
+	const u32 stride = DSP_HOST_FFT_MAX_LENGTH / length;
+
+	if( is_inverse == 0 ){
+		for(u32 i=0; i < length; i++){
+			destination[i] = source[i];
+		}
+		transform_complex(destination, half, false, true);
+
+		const float32_t real = destination[0];
+		const float32_t imaginary = destination[1];
+		destination[0] = real + imaginary;
+		destination[1] = real - imaginary;
+
+		//bins k and N/2-k use the same two values
+		for(u32 k=1; k <= half/2; k++){
+			const u32 j = half - k;
+			const float32_t z_real = destination[2*k];
+			const float32_t z_imaginary = destination[2*k+1];
+			const float32_t zc_real = destination[2*j];
+			const float32_t zc_imaginary = -destination[2*j+1];
+
+			const float32_t even_real = 0.5f * (z_real + zc_real);
+			const float32_t even_imaginary = 0.5f * (z_imaginary + zc_imaginary);
+			const float32_t odd_real = 0.5f * (z_imaginary - zc_imaginary);
+			const float32_t odd_imaginary = -0.5f * (z_real - zc_real);
+
+			const float32_t w_real = table.real(k*stride);
+			const float32_t w_imaginary = table.imaginary(k*stride);
+			destination[2*k] = even_real + w_real * odd_real - w_imaginary * odd_imaginary;
+			destination[2*k+1] = even_imaginary + w_real * odd_imaginary + w_imaginary * odd_real;
+
+			if( j != k ){
+				//E[N/2-k] = conj(E[k]) and O[N/2-k] = conj(O[k])
+				const float32_t wj_real = table.real(j*stride);
+				const float32_t wj_imaginary = table.imaginary(j*stride);
+				const float32_t ej_real = even_real;
+				const float32_t ej_imaginary = -even_imaginary;
+				const float32_t oj_real = odd_real;
+				const float32_t oj_imaginary = -odd_imaginary;
+				destination[2*j] = ej_real + wj_real * oj_real - wj_imaginary * oj_imaginary;
+				destination[2*j+1] = ej_imaginary + wj_real * oj_imaginary + wj_imaginary * oj_real;
+			}
+		}
+	} else {
+		const float32_t first = source[0];
+		const float32_t middle = source[1];
+		destination[0] = 0.5f * (first + middle);
+		destination[1] = 0.5f * (first - middle);
+
+		for(u32 k=1; k <= half/2; k++){
+			const u32 j = half - k;
+			const float32_t x_real = source[2*k];
+			const float32_t x_imaginary = source[2*k+1];
+			const float32_t xc_real = source[2*j];
+			const float32_t xc_imaginary = -source[2*j+1];
+
+			const float32_t even_real = 0.5f * (x_real + xc_real);
+			const float32_t even_imaginary = 0.5f * (x_imaginary + xc_imaginary);
+			const float32_t difference_real = 0.5f * (x_real - xc_real);
+			const float32_t difference_imaginary = 0.5f * (x_imaginary - xc_imaginary);
+
+			//O[k] = (X[k] - conj(X[N/2-k]))/2 * W^-k
+			const float32_t w_real = table.real(k*stride);
+			const float32_t w_imaginary = -table.imaginary(k*stride);
+			const float32_t odd_real = difference_real * w_real - difference_imaginary * w_imaginary;
+			const float32_t odd_imaginary = difference_real * w_imaginary + difference_imaginary * w_real;
+
+			//Z[k] = E[k] + i*O[k] and Z[N/2-k] = conj(E[k]) + i*conj(O[k])
+			destination[2*k] = even_real - odd_imaginary;
+			destination[2*k+1] = even_imaginary + odd_real;
+			if( j != k ){
+				destination[2*j] = even_real + odd_imaginary;
+				destination[2*j+1] = -even_imaginary + odd_real;
+			}
+		}
+
+		transform_complex(destination, half, true, true);
+		const float32_t scale = 1.0f / half;
+		for(u32 i=0; i < length; i++){
+			destination[i] *= scale;
+		}
+	}
+}
+
+arm_status rfft_fast_init_f32(arm_rfft_fast_instance_f32 * instance, uint16_t length){
+	if( is_valid_length(length, 32) == false ){
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	instance->fftLenRFFT = length;
+	instance->Sint.fftLen = static_cast<uint16_t>(length / 2);
+	return ARM_MATH_SUCCESS;
+}
+
+}
@@ -0,0 +1,25 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_DSP_HOST_DSP_TRANSFORM_H_
+#define SAPI_DSP_HOST_DSP_TRANSFORM_H_
+
+#include "dsp/dsp_host_api.h"
+
+/*! \cond */
+namespace dsp_host {
+
+void cfft_q15(const arm_cfft_instance_q15 * instance, q15_t * data, uint8_t is_inverse, uint8_t is_bit_reversal);
+void rfft_q15(const arm_rfft_instance_q15 * instance, q15_t * source, q15_t * destination);
+arm_status rfft_init_q15(arm_rfft_instance_q15 * instance, uint32_t length, uint32_t is_inverse, uint32_t is_bit_reversal);
+
+void cfft_q31(const arm_cfft_instance_q31 * instance, q31_t * data, uint8_t is_inverse, uint8_t is_bit_reversal);
+void rfft_q31(const arm_rfft_instance_q31 * instance, q31_t * source, q31_t * destination);
+arm_status rfft_init_q31(arm_rfft_instance_q31 * instance, uint32_t length, uint32_t is_inverse, uint32_t is_bit_reversal);
+
+void cfft_f32(const arm_cfft_instance_f32 * instance, float32_t * data, uint8_t is_inverse, uint8_t is_bit_reversal);
+void rfft_fast_f32(const arm_rfft_fast_instance_f32 * instance, float32_t * source, float32_t * destination, uint8_t is_inverse);
+arm_status rfft_fast_init_f32(arm_rfft_fast_instance_f32 * instance, uint16_t length);
+
+}
+/*! \endcond */
+
+#endif // SAPI_DSP_HOST_DSP_TRANSFORM_H_
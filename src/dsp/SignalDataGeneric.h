@@ -270,7 +270,7 @@ SignalType SignalType::create_sin_wave(u32 wave_frequency, u32 sampling_frequenc
 	u32 i;
 #if IS_FLOAT == 1
 	native_type theta = phase; //theta 0 to max is 0 to 2*pi
-	native_type theta_step = wave_frequency * sampling_frequency;
+	native_type theta_step = 2.0f * MCU_PI_FLOAT * wave_frequency / sampling_frequency;
 #else
 	unsigned_native_type theta = phase; //theta 0 to max is 0 to 2*pi
 	unsigned_native_type theta_step = (big_type)wave_frequency * LOCAL_INT_MAX / sampling_frequency;
@@ -301,7 +301,7 @@ void SignalComplexType::transform(
 		){
 	arm_dsp_api_function()->cfft(
 				fft.instance(),
-				data(),
+				(native_type*)data(),
 				is_inverse,
 				is_bit_reversal
 				);
@@ -316,14 +316,14 @@ void SignalComplexType::transform(
 	fft.instance()->ifftFlagR = is_inverse;
 	arm_dsp_api_function()->rfft(
 				fft.instance(),
-				(q31_t*)data(),
-				(q31_t*)output.data()
+				(native_type*)data(),
+				(native_type*)output.data()
 				);
 #else
 	arm_dsp_api_function()->rfft_fast(
 				fft.instance(),
-				data(),
-				output.data(),
+				(native_type*)data(),
+				(native_type*)output.data(),
 				is_inverse
 				);
 #endif
@@ -337,14 +337,14 @@ SignalComplexType SignalComplexType::transform(FftRealType & fft, bool is_invers
 	fft.instance()->ifftFlagR = is_inverse;
 	arm_dsp_api_function()->rfft(
 				fft.instance(),
-				data(),
-				ret.data()
+				(native_type*)data(),
+				(native_type*)ret.data()
 				);
 #else
 	arm_dsp_api_function()->rfft_fast(
 				fft.instance(),
-				data(),
-				ret.data(),
+				(native_type*)data(),
+				(native_type*)ret.data(),
 				is_inverse);
 #endif
 
@@ -1,5 +1,6 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 #include <errno.h>
+#include <cstring>
 #include "dsp/Transform.hpp"
 #include "dsp/SignalData.hpp"
 
@@ -1,45 +1,133 @@
+#include <errno.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
 #include "fmt/Csv.hpp"
 
 using namespace fmt;
 
+int CsvRow::to_integer(u32 column) const {
+	return static_cast<int>(::strtol(at(column), nullptr, 10));
+}
+
+float CsvRow::to_float(u32 column) const {
+	return ::strtof(at(column), nullptr);
+}
+
+var::StringList CsvRow::to_list() const {
+	var::StringList result;
+	result.reserve(count());
+	for(u32 i=0; i < count(); i++){
+		result.push_back(to_string(i));
+	}
+	return result;
+}
+
 Csv::Csv(fs::File& file, const var::String & delimeters) :
 	m_file(file),
+	m_buffered_file(file),
 	m_delimeters(delimeters){
 	m_header = read_line(true);
 }
 
-var::StringList Csv::read_line(bool is_header){
-	var::StringList result;
+int Csv::read_row(CsvRow & row){
+	row.m_fields.clear();
+	if( m_buffered_file.gets(row.m_buffer) == nullptr ){
+		if( row.m_buffer.length() == 0 ){
+			return -1;
+		}
+		//the last line of the file doesn't have a terminator
+	}
+
+	//quoted fields can span lines: keep reading until the quotes balance
+	u32 quote_count = 0;
+	for(u32 i=0; i < row.m_buffer.length(); i++){
+		if( row.m_buffer.at(i) == '"' ){ quote_count++; }
+	}
 
-	var::String line = m_file.gets();
-	for(u32 i=0; i < line.length(); i++){
-		if( (u8)line.at(i) > 127 ){
-			line.erase(
-						var::String::Position(i),
-						var::String::Length(1)
-						);
-			i--;
+	while( quote_count & 0x01 ){
+		if( m_buffered_file.gets(m_continuation) == nullptr
+				&& m_continuation.length() == 0 ){
+			break;
 		}
+		for(u32 i=0; i < m_continuation.length(); i++){
+			if( m_continuation.at(i) == '"' ){ quote_count++; }
+		}
+		row.m_buffer.append(m_continuation);
 	}
 
-	line
-			.replace(
-				var::String::ToErase("\n"),
-				var::String::ToInsert("")
-				)
-			.replace(
-				var::String::ToErase("\r"),
-				var::String::ToInsert("")
-				);
+	//fields are compacted and null-terminated in place
+	char * buffer = row.m_buffer.to_char();
+	const u32 length = static_cast<u32>(row.m_buffer.length());
+	u32 write_offset = 0;
+	u32 field_offset = 0;
+	bool is_quoted = false;
+	bool is_blank = true;
+
+	for(u32 read_offset = 0; read_offset < length; read_offset++){
+		const char c = buffer[read_offset];
+		if( is_quoted ){
+			if( c == '"' ){
+				if( (read_offset + 1 < length) && (buffer[read_offset+1] == '"') ){
+					buffer[write_offset++] = '"';
+					read_offset++;
+				} else {
+					is_quoted = false;
+				}
+			} else {
+				buffer[write_offset++] = c;
+			}
+		} else if( c == '"' ){
+			is_quoted = true;
+			is_blank = false;
+		} else if( is_delimeter(c) ){
+			buffer[write_offset] = 0;
+			row.m_fields.push_back({field_offset, write_offset - field_offset});
+			write_offset++;
+			field_offset = write_offset;
+			is_blank = false;
+		} else if( (c == '\n') || (c == '\r') ){
+			continue;
+		} else if( is_ascii_only() && (static_cast<u8>(c) > 127) ){
+			continue;
+		} else {
+			buffer[write_offset++] = c;
+			is_blank = false;
+		}
+	}
 
-	if( line.length() == 0 ){
+	if( is_blank ){
+		return 0;
+	}
+
+	buffer[write_offset] = 0;
+	row.m_fields.push_back({field_offset, write_offset - field_offset});
+	return static_cast<int>(row.count());
+}
+
+int Csv::for_each_row(RowCallback callback){
+	int row_count = 0;
+	int result;
+	while( (result = read_row(m_row)) >= 0 ){
+		if( result > 0 ){
+			row_count++;
+			if( callback(m_row) == true ){
+				break;
+			}
+		}
+	}
+	return row_count;
+}
+
+var::StringList Csv::read_line(bool is_header){
+	var::StringList result;
+
+	if( read_row(m_row) <= 0 ){
 		return result;
 	}
-	result = var::Tokenizer(
-				line,
-				var::Tokenizer::Delimeters(m_delimeters),
-				var::Tokenizer::IgnoreBetween("\"")
-				).list();
+
+	result = m_row.to_list();
 
 	if( !is_header ){
 		if( (result.count() > 0) && (result.count() != header().count()) ){
@@ -55,20 +143,25 @@ var::Matrix<var::String> Csv::load(
 		){
 	var::Matrix<var::String> result;
 
-	fs::DataFile data_file = fs::DataFile(
-				fs::File::Path(file_path)
-				);
+	fs::File file;
+	if( file.open(
+				file_path,
+				fs::OpenFlags::read_only()
+				) < 0 ){
+		return result;
+	}
 
-	Csv csv(data_file, delimeters.argument());
+	Csv csv(file, delimeters.argument());
 
-	var::StringList row;
+	const u32 column_count = csv.header().count();
 	result.append( csv.header() );
-	do {
-		row = csv.read_line();
-		if( row.count() > 0 ){
-			result.append( row );
-		}
-	} while( row.count() > 0 );
+	csv.for_each_row(
+				[&](const CsvRow & row) -> bool {
+		var::StringList values = row.to_list();
+		values.resize(column_count);
+		result.append(values);
+		return false;
+	});
 
 	return result;
 }
@@ -79,5 +172,141 @@ int Csv::save(
 		Delimeters delimeters
 		){
 
+	fs::File file;
+	if( file.create(
+				file_path,
+				fs::File::IsOverwrite(true)
+				) < 0 ){
+		return api::error_code_fs_failed_to_create;
+	}
+
+	CsvWriter writer(
+				file,
+				delimeters.argument().length() ? delimeters.argument().at(0) : ','
+				);
+
+	for(const auto & row: m_matrix){
+		for(const auto & field: row){
+			writer.append_field(field);
+		}
+		writer.end_row();
+	}
+
+	if( writer.flush() < 0 ){
+		return api::error_code_fs_failed_to_write;
+	}
+	return 0;
+}
+
+CsvWriter::CsvWriter(
+		const fs::File & file,
+		char delimeter,
+		fs::File::PageSize page_size
+		) :
+	m_file(file),
+	m_buffer(page_size.argument() ? page_size.argument() : SAPI_LINK_DEFAULT_PAGE_SIZE),
+	m_delimeter(delimeter){
+}
+
+void CsvWriter::write_bytes(const char * value, u32 length){
+	while( length ){
+		if( (m_size == m_buffer.size()) && (flush() < 0) ){
+			return;
+		}
+		u32 page_size = m_buffer.size() - m_size;
+		if( page_size > length ){
+			page_size = length;
+		}
+		::memcpy(m_buffer.to_char() + m_size, value, page_size);
+		m_size += page_size;
+		value += page_size;
+		length -= page_size;
+	}
+}
+
+CsvWriter & CsvWriter::append_field(
+		const char * value,
+		u32 length
+		){
+	if( m_is_first_field == false ){
+		write_byte(m_delimeter);
+	}
+	m_is_first_field = false;
+
+	bool is_quote_required = false;
+	for(u32 i=0; i < length; i++){
+		const char c = value[i];
+		if( (c == m_delimeter) || (c == '"') || (c == '\n') || (c == '\r') ){
+			is_quote_required = true;
+			break;
+		}
+	}
+
+	if( is_quote_required == false ){
+		write_bytes(value, length);
+		return *this;
+	}
+
+	write_byte('"');
+	for(u32 i=0; i < length; i++){
+		if( value[i] == '"' ){
+			write_byte('"');
+		}
+		write_byte(value[i]);
+	}
+	write_byte('"');
+	return *this;
+}
+
+CsvWriter & CsvWriter::append_field(int value){
+	char buffer[16];
+	int length = ::snprintf(buffer, sizeof(buffer), "%d", value);
+	return append_field(buffer, static_cast<u32>(length));
+}
+
+CsvWriter & CsvWriter::append_field(float value){
+	char buffer[32];
+	int length = ::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(value));
+	return append_field(buffer, static_cast<u32>(length));
+}
+
+CsvWriter & CsvWriter::end_row(){
+	write_byte('\n');
+	m_is_first_field = true;
+	return *this;
+}
+
+CsvWriter & CsvWriter::append_row(const var::StringList & row){
+	for(const auto & value: row){
+		append_field(value);
+	}
+	return end_row();
+}
+
+int CsvWriter::flush(){
+	if( m_is_write_failed ){
+		return -1;
+	}
+
+	//a file (such as a pipe or socket) can accept less than the whole buffer
+	u32 offset = 0;
+	while( offset < m_size ){
+		int result = m_file.write(
+					m_buffer.to_const_char() + offset,
+					fs::File::Size(m_size - offset)
+					);
+		if( result <= 0 ){
+			m_is_write_failed = true;
+			m_size = 0;
+			if( result == 0 ){
+				set_error_number(EIO);
+				return -1;
+			}
+			return set_error_number_if_error(result);
+		}
+		offset += static_cast<u32>(result);
+		m_bytes_written += static_cast<u32>(result);
+	}
+	m_size = 0;
 	return 0;
 }
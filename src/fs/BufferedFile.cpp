@@ -0,0 +1,178 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+
+#include "fs/BufferedFile.hpp"
+#include "chrono/Timer.hpp"
+
+using namespace fs;
+
+BufferedFile::BufferedFile(
+		const File & file,
+		PageSize page_size
+		) :
+	m_file(file),
+	m_buffer(page_size.argument() ? page_size.argument() : SAPI_LINK_DEFAULT_PAGE_SIZE){
+	m_fd = file.fileno();
+	m_offset = 0;
+	m_end = 0;
+	set_keep_open();
+}
+
+int BufferedFile::fill() const {
+	discard();
+	if( m_buffer.size() == 0 ){
+		return set_error_number_if_error(-1);
+	}
+
+	int result = m_file.read(
+				m_buffer.to_void(),
+				Size(m_buffer.size())
+				);
+	if( result > 0 ){
+		m_end = static_cast<u32>(result);
+	}
+	return result;
+}
+
+int BufferedFile::read(
+		void * buf,
+		Size size
+		) const {
+
+	if( size.argument() == 0 ){
+		return 0;
+	}
+
+	if( bytes_available() == 0 ){
+		//large reads go straight to the file rather than through the buffer
+		if( size.argument() >= m_buffer.size() ){
+			return m_file.read(buf, size);
+		}
+
+		int result = fill();
+		if( result <= 0 ){
+			return result;
+		}
+	}
+
+	u32 size_ready = bytes_available();
+	if( size_ready > size.argument() ){
+		size_ready = size.argument();
+	}
+
+	var::Reference::memory_copy(
+				SourceBuffer(m_buffer.to_const_u8() + m_offset),
+				DestinationBuffer(buf),
+				Size(size_ready)
+				);
+	m_offset += size_ready;
+	return static_cast<int>(size_ready);
+}
+
+int BufferedFile::write(
+		const void * buf,
+		Size size
+		) const {
+	if( bytes_available() ){
+		//move the file back to where the caller thinks it is
+		if( m_file.seek(
+					-1*static_cast<int>(bytes_available()),
+					whence_current
+					) >= 0 ){
+			discard();
+		}
+	}
+	return m_file.write(buf, size);
+}
+
+int BufferedFile::seek(
+		int location,
+		enum whence whence
+		) const {
+	if( whence == whence_current ){
+		location -= static_cast<int>(bytes_available());
+	}
+
+	int result = m_file.seek(location, whence);
+	if( result >= 0 ){
+		discard();
+	}
+	return result;
+}
+
+const char * BufferedFile::gets(
+		var::String & s,
+		char term
+		) const {
+	s.clear();
+	do {
+		if( bytes_available() == 0 ){
+			if( fill() <= 0 ){
+				return nullptr;
+			}
+		}
+
+		const char * start =
+				reinterpret_cast<const char*>(m_buffer.to_const_u8()) + m_offset;
+		const char * end = static_cast<const char*>(
+					::memchr(start, term, bytes_available())
+					);
+
+		u32 length = end ? static_cast<u32>(end - start) + 1 : bytes_available();
+		s.append(start, var::String::Length(length));
+		m_offset += length;
+
+		if( end ){
+			return s.cstring();
+		}
+	} while( 1 );
+
+	return nullptr;
+}
+
+int BufferedFile::readline(
+		char * buf,
+		int nbyte,
+		int timeout_msec,
+		char terminator
+		) const {
+	int t = 0;
+	int bytes_recv = 0;
+
+	while( (bytes_recv < nbyte) && (t < timeout_msec) ){
+		if( bytes_available() == 0 ){
+			if( fill() <= 0 ){
+				t++;
+#if !defined __link
+				chrono::wait(chrono::Milliseconds(1));
+#endif
+				continue;
+			}
+		}
+
+		const char * start =
+				reinterpret_cast<const char*>(m_buffer.to_const_u8()) + m_offset;
+		u32 length = bytes_available();
+		if( length > static_cast<u32>(nbyte - bytes_recv) ){
+			length = static_cast<u32>(nbyte - bytes_recv);
+		}
+
+		const char * end = static_cast<const char*>(
+					::memchr(start, terminator, length)
+					);
+		if( end ){
+			length = static_cast<u32>(end - start) + 1;
+		}
+
+		::memcpy(buf + bytes_recv, start, length);
+		m_offset += length;
+		bytes_recv += static_cast<int>(length);
+
+		if( end ){
+			return bytes_recv;
+		}
+	}
+
+	return bytes_recv;
+}
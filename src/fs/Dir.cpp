@@ -8,6 +8,7 @@
 #include "var/Tokenizer.hpp"
 #include "fs/File.hpp"
 #include "fs/Dir.hpp"
+#include "fs/DirCopy.hpp"
 using namespace fs;
 using namespace arg;
 
@@ -43,16 +44,9 @@ int Dir::remove(
 		if( d.open(path) == 0 ){
 			var::String entry;
 			while( (entry = d.read()).is_empty() == false ){
-				Stat info;
 				var::String entry_path;
 				entry_path << path << "/" << entry;
-				info = File::get_info(
-							entry_path
-			#if defined __link
-							, link_driver
-			#endif
-							);
-				if( info.is_directory() ){
+				if( d.is_directory_entry(entry_path) ){
 					if( entry != "." && entry != ".."){
 						ret = Dir::remove(
 									entry_path,
@@ -108,77 +102,15 @@ int Dir::copy(
 		DestinationLinkDriver destination_driver
 		#endif
 		){
-
-	var::Vector<var::String> source_contents =
-			Dir::read_list(
-				source_path.argument(),
-				IsRecursive(false)
-			#if defined __link
-				, LinkDriver(source_driver.argument())
-			#endif
+	DirCopy dir_copy
+		#if defined __link
+			(source_driver, destination_driver)
+		#endif
+			;
+	return dir_copy.set_progress_callback(progress_callback).copy(
+				source_path,
+				destination_path
 				);
-
-	for(auto entry: source_contents.vector()){
-		var::String entry_path =
-				var::String()
-				<< source_path.argument()
-				<< "/"
-				<< entry;
-
-		var::String destination_entry_path =
-				var::String()
-				<< destination_path.argument()
-				<< "/"
-				<< entry;
-
-		FileInfo info =
-				File::get_info(
-					entry_path
-			#if defined __link
-					, LinkDriver(source_driver.argument())
-			#endif
-					);
-
-		if( info.is_directory() ){
-			//copy recursively
-
-			if( Dir::create(
-						destination_entry_path,
-						Permissions::all_access(),
-						IsRecursive(true)
-			#if defined __link
-						, LinkDriver(destination_driver.argument())
-			#endif
-						) < 0 ){
-				return api::error_code_fs_failed_to_create;
-			}
-
-			copy(SourcePath(entry_path),
-					 DestinationPath(destination_entry_path),
-					 progress_callback
-		 #if defined __link
-					 , source_driver,
-					 destination_driver
-		 #endif
-					 );
-
-		} else if( info.is_file() ){
-			int result;
-			if( (result = File::copy(
-						 SourcePath(entry_path),
-						 DestinationPath(destination_entry_path),
-						 IsOverwrite(true),
-						 progress_callback
-			 #if defined __link
-						 , source_driver,
-						 destination_driver
-			 #endif
-						 )) < 0 ){
-				return result;
-			}
-		}
-	}
-	return 0;
 }
 
 int Dir::create(
@@ -399,14 +331,8 @@ var::Vector<var::String> Dir::read_list(
 			if( is_recursive.argument() ){
 				var::String entry_path;
 				entry_path << m_path << "/" << entry;
-				FileInfo info = File::get_info(
-							entry_path
-			#if defined __link
-							, LinkDriver(driver())
-			#endif
-							);
 
-				if( info.is_directory() ){
+				if( is_directory_entry(entry_path) ){
 
 					var::Vector<var::String> intermediate_result =
 							Dir::read_list(
@@ -479,6 +405,43 @@ const char * Dir::read(){
 	return m_entry.d_name;
 }
 
+enum Dir::entry_types Dir::entry_type() const {
+#if defined DT_DIR
+#if defined __link
+	if( m_driver ){
+		return entry_type_unknown;
+	}
+	const struct dirent & entry = m_entry_local;
+#else
+	const struct dirent & entry = m_entry;
+#endif
+	switch(entry.d_type){
+		case DT_DIR: return entry_type_directory;
+#if defined DT_LNK
+		case DT_LNK: return entry_type_unknown;
+#endif
+		case DT_UNKNOWN: return entry_type_unknown;
+		default: return entry_type_other;
+	}
+#else
+	return entry_type_unknown;
+#endif
+}
+
+bool Dir::is_directory_entry(const var::String & entry_path){
+	switch(entry_type()){
+		case entry_type_directory: return true;
+		case entry_type_other: return false;
+		case entry_type_unknown: break;
+	}
+	return File::get_info(
+				entry_path
+			#if defined __link
+				, LinkDriver(driver())
+			#endif
+				).is_directory();
+}
+
 bool Dir::get_entry(var::String & path_dest){
 	const char * entry = read();
 
@@ -0,0 +1,457 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+
+#include "chrono/Timer.hpp"
+#include "sys/Thread.hpp"
+#include "fs/DirCopy.hpp"
+#include "fs/DirWalker.hpp"
+
+using namespace fs;
+
+namespace {
+
+struct ReadAhead {
+	const File * file;
+	var::Data * page;
+	int result;
+};
+
+void * read_ahead(void * args){
+	ReadAhead * read_ahead = static_cast<ReadAhead*>(args);
+	read_ahead->result = read_ahead->file->read(*read_ahead->page);
+	return nullptr;
+}
+
+}
+
+DirCopy::DirCopy(
+		#if defined __link
+		SourceLinkDriver source_driver,
+		DestinationLinkDriver destination_driver
+		#endif
+		){
+#if defined __link
+	m_source_driver = source_driver.argument();
+	m_destination_driver = destination_driver.argument();
+#endif
+	m_progress_callback = nullptr;
+	m_thread_count = 4;
+	m_page_size = SAPI_LINK_DEFAULT_PAGE_SIZE;
+	m_skip_mode = skip_none;
+	m_is_dry_run = false;
+	m_next_job = 0;
+	m_total = 0;
+	m_progress = 0;
+	m_bytes = 0;
+	m_skipped_count = 0;
+	m_microseconds = 0;
+	m_result = 0;
+	m_reader = nullptr;
+	m_is_aborted = false;
+}
+
+int DirCopy::copy(
+		SourcePath source_path,
+		DestinationPath destination_path
+		){
+	chrono::Timer timer;
+	timer.start();
+
+	m_source_path = source_path.argument();
+	m_destination_path = destination_path.argument();
+	m_job_list.clear();
+	m_copy_list.clear();
+	m_next_job = 0;
+	m_total = 0;
+	m_progress = 0;
+	m_bytes = 0;
+	m_skipped_count = 0;
+	m_result = 0;
+	m_is_aborted = false;
+
+	int result = plan();
+	if( result < 0 ){
+		timer.stop();
+		m_microseconds = timer.microseconds();
+		return result;
+	}
+
+	u32 count = is_one_file_at_a_time() ? 1 : m_thread_count;
+	if( count > m_job_list.count() ){
+		count = m_job_list.count();
+	}
+
+	//with one file at a time, the next page is read while the current page is written
+	bool is_overlapped = false;
+#if defined __link
+	is_overlapped = (count <= 1) &&
+			((m_source_driver == nullptr) || (m_source_driver != m_destination_driver));
+#endif
+
+	if( count <= 1 ){
+		if( is_overlapped && (m_is_dry_run == false) ){
+			//one reader thread is used for every page of every file
+			sys::WorkerThread reader;
+			m_reader = &reader;
+			work();
+			m_reader = nullptr;
+		} else {
+			work();
+		}
+	} else {
+		//the stack size has to be set when the thread is constructed
+		var::Vector<sys::Thread> threads;
+		threads.vector().reserve(count - 1);
+		for(u32 i = 0; i < count - 1; i++){
+			threads.vector().emplace_back(
+						sys::Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE),
+						sys::Thread::IsDetached(false)
+						);
+			if( threads.back().create(
+						sys::Thread::Function(worker),
+						sys::Thread::FunctionArgument(this)
+						) < 0 ){
+				threads.pop_back();
+				break;
+			}
+		}
+
+		work();
+
+		//is_valid() can't be used here: it doesn't change when a thread is created on link builds
+		for(auto & thread: threads){
+			thread.join();
+		}
+	}
+
+	if( m_progress_callback ){
+		m_progress_callback->update(0, 0);
+	}
+
+	timer.stop();
+	m_microseconds = timer.microseconds();
+
+	if( (m_result == 0) && m_is_aborted ){
+		m_result = api::error_code_fs_cancelled;
+	}
+	return m_result;
+}
+
+int DirCopy::plan(){
+	if( m_is_dry_run == false ){
+		Dir::create(
+					m_destination_path,
+					Permissions::all_access(),
+					Dir::IsRecursive(true)
+			#if defined __link
+					, Dir::LinkDriver(m_destination_driver)
+			#endif
+					);
+	}
+
+	int result = 0;
+
+#if defined __link
+	DirWalker walker(m_source_driver);
+#else
+	DirWalker walker;
+#endif
+
+	int walk_result = walker.walk(
+				m_source_path,
+				[&](const DirWalkerEntry & entry){
+		var::String destination_entry_path;
+		destination_entry_path << m_destination_path << "/" << entry.path();
+
+		if( entry.is_directory() ){
+			//the walk visits parents first so the parent already exists
+			if( (m_is_dry_run == false) &&
+					(Dir::create(
+						 destination_entry_path,
+						 Permissions::all_access()
+				 #if defined __link
+						 , Dir::LinkDriver(m_destination_driver)
+				 #endif
+						 ) < 0) &&
+					(Dir::exists(
+						 destination_entry_path
+				 #if defined __link
+						 , Dir::LinkDriver(m_destination_driver)
+				 #endif
+						 ) == false) ){
+				result = api::error_code_fs_failed_to_create;
+				return DirWalker::visit_stop;
+			}
+			return DirWalker::visit_continue;
+		}
+
+		FileInfo info = File::get_info(
+					entry.full_path()
+			#if defined __link
+					, File::LinkDriver(m_source_driver)
+			#endif
+					);
+
+		if( info.is_file() ){
+			Job job;
+			job.path = entry.path();
+			job.size = info.size();
+			m_job_list.push_back(job);
+			m_total += job.size;
+		}
+		return DirWalker::visit_continue;
+	});
+
+	if( walk_result < 0 ){
+		return api::error_code_fs_failed_to_open;
+	}
+
+	return result;
+}
+
+void * DirCopy::worker(void * args){
+	reinterpret_cast<DirCopy*>(args)->work();
+	return nullptr;
+}
+
+void DirCopy::work(){
+	while( 1 ){
+		m_mutex.lock();
+		if( m_is_aborted ||
+				(m_result < 0) ||
+				(m_next_job == m_job_list.count()) ){
+			m_mutex.unlock();
+			return;
+		}
+		const Job & job = m_job_list.at(m_next_job++);
+		m_mutex.unlock();
+
+		if( is_skipped(job) ){
+			m_mutex.lock();
+			m_skipped_count++;
+			m_mutex.unlock();
+			update_progress(job.size, false);
+			continue;
+		}
+
+		if( m_is_dry_run ){
+			m_mutex.lock();
+			m_copy_list.push_back(job.path);
+			m_mutex.unlock();
+			update_progress(job.size, false);
+			continue;
+		}
+
+		int result = copy_job(job);
+
+		m_mutex.lock();
+		if( result < 0 ){
+			if( m_result == 0 ){
+				m_result = result;
+			}
+		} else {
+			m_copy_list.push_back(job.path);
+		}
+		m_mutex.unlock();
+	}
+}
+
+bool DirCopy::is_skipped(const Job & job){
+	if( m_skip_mode == skip_none ){
+		return false;
+	}
+
+	var::String source_path;
+	source_path << m_source_path << "/" << job.path;
+	var::String destination_path;
+	destination_path << m_destination_path << "/" << job.path;
+
+	FileInfo destination_info = File::get_info(
+				destination_path
+			#if defined __link
+				, File::LinkDriver(m_destination_driver)
+			#endif
+				);
+
+	if( (destination_info.is_file() == false) ||
+			(destination_info.size() != job.size) ){
+		return false;
+	}
+
+	if( m_skip_mode == skip_size_and_time ){
+		FileInfo source_info = File::get_info(
+					source_path
+			#if defined __link
+					, File::LinkDriver(m_source_driver)
+			#endif
+					);
+		return destination_info.modification_time() >=
+				source_info.modification_time();
+	}
+
+	//skip_contents: compare the files page by page
+#if defined __link
+	File source(m_source_driver);
+	File destination(m_destination_driver);
+#else
+	File source;
+	File destination;
+#endif
+
+	if( (source.open(source_path, OpenFlags::read_only()) < 0) ||
+			(destination.open(destination_path, OpenFlags::read_only()) < 0) ){
+		return false;
+	}
+
+	var::Data source_page(m_page_size);
+	var::Data destination_page(m_page_size);
+	int source_result;
+	do {
+		source_result = source.read(source_page);
+		if( (source_result < 0) ||
+				(destination.read(destination_page) != source_result) ){
+			return false;
+		}
+		if( ::memcmp(
+					source_page.to_const_void(),
+					destination_page.to_const_void(),
+					static_cast<size_t>(source_result)) != 0 ){
+			return false;
+		}
+	} while( source_result > 0 );
+
+	return true;
+}
+
+int DirCopy::copy_job(const Job & job){
+	var::String source_path;
+	source_path << m_source_path << "/" << job.path;
+	var::String destination_path;
+	destination_path << m_destination_path << "/" << job.path;
+
+#if defined __link
+	File source(m_source_driver);
+	File destination(m_destination_driver);
+#else
+	File source;
+	File destination;
+#endif
+
+	if( source.open(source_path, OpenFlags::read_only()) < 0 ){
+		return api::error_code_fs_failed_to_open;
+	}
+
+	struct SAPI_LINK_STAT st;
+	if( source.fstat(&st) < 0 ){
+		return api::error_code_fs_failed_to_stat;
+	}
+
+	if( (st.st_mode & 0666) == 0 ){
+		st.st_mode = 0666;
+	}
+
+	if( create_destination(
+				destination,
+				destination_path,
+				Permissions(st.st_mode & 0777)
+				) < 0 ){
+		return api::error_code_fs_failed_to_create;
+	}
+
+	var::Data page_list[2] = {
+		var::Data(m_page_size),
+		var::Data(m_page_size)
+	};
+
+	u32 current = 0;
+	int result = source.read(page_list[current]);
+	while( result > 0 ){
+		ReadAhead next;
+		next.file = &source;
+		next.page = page_list + (current ^ 1);
+		next.result = 0;
+
+		if( m_reader ){
+			m_reader->execute(
+						sys::Thread::Function(read_ahead),
+						sys::Thread::FunctionArgument(&next)
+						);
+		}
+
+		const int write_result = write_destination(
+					destination,
+					page_list[current].to_const_void(),
+					static_cast<u32>(result)
+					);
+
+		if( m_reader ){
+			m_reader->wait();
+		} else if( write_result == result ){
+			read_ahead(&next);
+		}
+
+		if( write_result != result ){
+			return api::error_code_fs_failed_to_write;
+		}
+
+		if( update_progress(static_cast<u32>(result), true) ){
+			return api::error_code_fs_cancelled;
+		}
+
+		result = next.result;
+		current ^= 1;
+	}
+
+	if( result < 0 ){
+		return api::error_code_fs_failed_to_read;
+	}
+
+	return 0;
+}
+
+bool DirCopy::is_one_file_at_a_time() const {
+#if defined __link
+	//the link protocol handles one request at a time
+	return (m_source_driver != nullptr) || (m_destination_driver != nullptr);
+#else
+	return true;
+#endif
+}
+
+int DirCopy::create_destination(
+		File & destination,
+		const var::String & path,
+		const Permissions & permissions
+		){
+	return destination.create(
+				path,
+				File::IsOverwrite(true),
+				permissions
+				);
+}
+
+int DirCopy::write_destination(
+		const File & destination,
+		const void * buffer,
+		u32 size
+		){
+	return destination.write(buffer, File::Size(size));
+}
+
+bool DirCopy::update_progress(u32 size, bool is_copied){
+	m_mutex.lock();
+	m_progress += size;
+	if( is_copied ){
+		m_bytes += size;
+	}
+	if( m_progress_callback &&
+			m_progress_callback->update(
+				static_cast<int>(m_progress),
+				static_cast<int>(m_total)) ){
+		m_is_aborted = true;
+	}
+	const bool is_aborted = m_is_aborted;
+	m_mutex.unlock();
+	return is_aborted;
+}
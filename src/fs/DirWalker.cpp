@@ -0,0 +1,233 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+
+#include "sys/Thread.hpp"
+#include "fs/DirWalker.hpp"
+
+using namespace fs;
+
+DirWalker::DirWalker(
+		SAPI_LINK_DRIVER
+		){
+	m_callback = nullptr;
+	m_maximum_depth = static_cast<u32>(-1);
+	m_entry_count = 0;
+	m_is_hidden_skipped = false;
+	m_is_stopped = false;
+	m_busy_count = 0;
+#if defined __link
+	m_driver = link_driver.argument();
+#endif
+}
+
+int DirWalker::walk(
+		const var::String & path,
+		const Callback & callback,
+		ThreadCount thread_count
+		){
+	m_root_path = path;
+	//avoid a double '/' when walking the root directory
+	while( (m_root_path.length() > 1) && (m_root_path.back() == '/') ){
+		m_root_path.pop_back();
+	}
+	m_callback = &callback;
+	m_entry_count = 0;
+	m_is_stopped = false;
+
+	u32 count = thread_count.argument();
+#if defined __link
+	if( m_driver ){
+		//the link protocol handles one request at a time
+		count = 1;
+	}
+#else
+	count = 1;
+#endif
+
+	if( count <= 1 ){
+		int result = walk_directory(var::String(), 0, false);
+		if( result < 0 ){
+			return result;
+		}
+		return m_is_stopped ? 1 : 0;
+	}
+
+	//the root is read first so an error can be returned before any threads start
+	m_pending_list.clear();
+	m_busy_count = 0;
+	int result = walk_directory(var::String(), 0, true);
+	if( result < 0 ){
+		return result;
+	}
+
+	//the stack size has to be set when the thread is constructed
+	var::Vector<sys::Thread> threads;
+	threads.vector().reserve(count - 1);
+	for(u32 i = 0; i < count - 1; i++){
+		threads.vector().emplace_back(
+					sys::Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE),
+					sys::Thread::IsDetached(false)
+					);
+		if( threads.back().create(
+					sys::Thread::Function(worker),
+					sys::Thread::FunctionArgument(this)
+					) < 0 ){
+			//the threads that were created (and this one) do the work
+			threads.pop_back();
+			break;
+		}
+	}
+
+	work();
+
+	//is_valid() can't be used here: it doesn't change when a thread is created on link builds
+	for(auto & thread: threads){
+		thread.join();
+	}
+
+	return m_is_stopped ? 1 : 0;
+}
+
+void * DirWalker::worker(void * args){
+	reinterpret_cast<DirWalker*>(args)->work();
+	return nullptr;
+}
+
+void DirWalker::work(){
+	m_mutex.lock();
+	while( m_is_stopped == false ){
+		if( m_pending_list.count() > 0 ){
+			//taking the most recent directory keeps the list short
+			Pending pending = m_pending_list.back();
+			m_pending_list.pop_back();
+			m_busy_count++;
+			m_mutex.unlock();
+
+			walk_directory(pending.path, pending.depth, true);
+
+			m_mutex.lock();
+			if( --m_busy_count == 0 ){
+				//idle threads exit if nothing else was queued
+				m_pending_cond.broadcast();
+			}
+		} else if( m_busy_count == 0 ){
+			//nothing is queued and nobody is reading a directory
+			break;
+		} else {
+			//another thread may still queue more directories
+			m_pending_cond.wait(m_mutex);
+		}
+	}
+	m_mutex.unlock();
+}
+
+void DirWalker::stop(bool is_threaded){
+	if( is_threaded ){
+		//the flag is set with the mutex held so a waiting thread can't miss it
+		m_mutex.lock();
+		m_is_stopped = true;
+		m_pending_cond.broadcast();
+		m_mutex.unlock();
+	} else {
+		m_is_stopped = true;
+	}
+}
+
+int DirWalker::walk_directory(
+		const var::String & path,
+		u32 depth,
+		bool is_threaded
+		){
+	var::String full_path = m_root_path;
+	if( path.is_empty() == false ){
+		if( full_path != "/" ){ full_path << "/"; }
+		full_path << path;
+	}
+
+#if defined __link
+	Dir directory(m_driver);
+#else
+	Dir directory;
+#endif
+
+	if( directory.open(full_path) < 0 ){
+		return set_error_number_if_error(api::error_code_fs_failed_to_open);
+	}
+
+	const char * name;
+	while( (m_is_stopped == false) &&
+				 ((name = directory.read()) != nullptr) &&
+				 (name[0] != 0) ){
+
+		if( (name[0] == '.') &&
+				(m_is_hidden_skipped ||
+				 (name[1] == 0) ||
+				 ((name[1] == '.') && (name[2] == 0))) ){
+			continue;
+		}
+
+		if( visit(directory, path, name, depth, is_threaded) == visit_stop ){
+			stop(is_threaded);
+		}
+	}
+
+	directory.close();
+	return 0;
+}
+
+enum DirWalker::visit_result DirWalker::visit(
+		Dir & directory,
+		const var::String & parent_path,
+		const char * name,
+		u32 depth,
+		bool is_threaded
+		){
+	DirWalkerEntry entry;
+	if( parent_path.is_empty() == false ){
+		entry.m_path << parent_path << "/";
+	}
+	entry.m_path << name;
+
+	entry.m_full_path = m_root_path;
+	if( m_root_path != "/" ){ entry.m_full_path << "/"; }
+	entry.m_full_path << entry.m_path;
+	entry.m_name_offset = entry.m_full_path.length() - ::strlen(name);
+	entry.m_depth = depth;
+	entry.m_is_directory = directory.is_directory_entry(entry.m_full_path);
+
+	enum visit_result result;
+	if( is_threaded ){
+		m_callback_mutex.lock();
+		if( m_is_stopped ){
+			m_callback_mutex.unlock();
+			return visit_stop;
+		}
+		result = (*m_callback)(entry);
+		m_entry_count++;
+		m_callback_mutex.unlock();
+	} else {
+		result = (*m_callback)(entry);
+		m_entry_count++;
+	}
+
+	if( (result == visit_continue) &&
+			entry.is_directory() &&
+			(depth < m_maximum_depth) ){
+		if( is_threaded ){
+			//another thread frees the path: it can't use a resource installed by this one
+			var::MemoryResourceScope heap_scope(nullptr);
+			Pending pending;
+			pending.path = entry.m_path;
+			pending.depth = depth + 1;
+			m_mutex.lock();
+			m_pending_list.push_back(pending);
+			m_pending_cond.signal();
+			m_mutex.unlock();
+		} else {
+			walk_directory(entry.m_path, depth + 1, false);
+		}
+	}
+
+	return result;
+}
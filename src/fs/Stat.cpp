@@ -103,6 +103,14 @@ bool Stat::is_executable() const {
 	return false;
 }
 
+u32 Stat::modification_time() const {
+#if defined __link
+	return m_stat.st_mtime_;
+#else
+	return m_stat.st_mtime;
+#endif
+}
+
 const var::String Stat::suffix(
 		const var::String & path
 		){
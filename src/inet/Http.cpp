@@ -1,10 +1,13 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 
+#include <climits>
+
 #include "inet/Http.hpp"
 #include "var.hpp"
 #include "sys.hpp"
 #include "fs.hpp"
 #include "inet/Url.hpp"
+#include "inet/SecureSocket.hpp"
 
 #define SHOW_HEADERS 0
 #if defined __link
@@ -18,7 +21,9 @@ using namespace inet;
 Http::Http(Socket & socket) : m_socket(socket){
 }
 
-HttpClient::HttpClient(Socket & socket) : Http(socket){
+HttpClient::HttpClient(Socket & socket) :
+	Http(socket),
+	m_input(socket){
 #if defined __link
 	m_transfer_size = 1024;
 #else
@@ -42,6 +47,21 @@ int HttpClient::get(const var::String & url,
 				);
 }
 
+int HttpClient::get(
+		UrlEncodedString url,
+		const ResponseCallback & response,
+		const sys::ProgressCallback * progress_callback
+		){
+	return query(
+				"GET",
+				url.argument(),
+				SendFile(nullptr),
+				GetFile(nullptr),
+				progress_callback,
+				&response
+				);
+}
+
 int HttpClient::post(
 		const var::String & url,
 		RequestString request,
@@ -141,12 +161,13 @@ int HttpClient::query(const var::String & command,
 							 const var::String & url,
 							 SendFile send_file,
 							 GetFile get_file,
-							 const sys::ProgressCallback * progress_callback
+							 const sys::ProgressCallback * progress_callback,
+							 const ResponseCallback * response_callback
 							 ){
+	SYS_TRACE_SCOPE("HttpClient::query");
 	m_status_code = -1;
 	m_content_length = 0;
 	int result;
-	Url u(url);
 
 	u32 get_file_pos = 0;
 	if( get_file.argument() ){
@@ -157,15 +178,14 @@ int HttpClient::query(const var::String & command,
 					);
 	}
 
-	result = connect_to_server(u.domain_name(), u.port());
-	if( result < 0 ){
-		return result;
+	u32 send_file_pos = 0;
+	if( send_file.argument() ){
+		send_file_pos = static_cast<u32>(send_file.argument()->location());
 	}
 
-	result = send_header(
+	result = send_request(
 				command,
-				u.domain_name(),
-				u.path(),
+				url,
 				send_file.argument(),
 				progress_callback
 				);
@@ -181,8 +201,35 @@ int HttpClient::query(const var::String & command,
 #endif
 
 	if( listen_for_header() < 0 ){
-		return set_error_number_if_error(api::error_code_inet_failed_to_get_header);
+		bool is_recovered = false;
+		//the server may have closed an idle keep-alive connection: try once more
+		if( m_is_connection_reused && (m_status_code < 0) ){
+			close_connection();
+			if( send_file.argument() ){
+				send_file.argument()->seek(
+							fs::File::Location(static_cast<int>(send_file_pos)),
+							File::whence_set
+							);
+			}
+
+			result = send_request(
+						command,
+						url,
+						send_file.argument(),
+						progress_callback
+						);
+			if( result < 0 ){
+				return result;
+			}
+			is_recovered = listen_for_header() >= 0;
+		}
+
+		if( is_recovered == false ){
+			close_connection();
+			return set_error_number_if_error(api::error_code_inet_failed_to_get_header);
+		}
 	}
+	m_pending_response_count--;
 	bool is_redirected = false;
 
 	if( is_follow_redirects() &&
@@ -202,7 +249,17 @@ int HttpClient::query(const var::String & command,
 		callback = progress_callback;
 	}
 
-	if( get_file.argument() && (is_redirected == false)){
+	if( is_redirected ){
+		//the body of a redirect is discarded
+		result = listen_for_data(
+					[](const var::Reference & data) -> int {
+						return static_cast<int>(data.size());
+					},
+					nullptr
+					);
+	} else if( response_callback ){
+		result = listen_for_data(*response_callback, callback);
+	} else if( get_file.argument() ){
 		result = listen_for_data(
 					*(get_file.argument()),
 					callback
@@ -217,6 +274,7 @@ int HttpClient::query(const var::String & command,
 
 
 	if( result < 0 ){
+		close_connection();
 		return -1;
 	}
 
@@ -234,27 +292,102 @@ int HttpClient::query(const var::String & command,
 
 		for(u32 i=0; i < header_response_pairs().count(); i++){
 
-			String key = header_response_pairs().at(i).key();
-			key.to_lower();
-			if( key == "location" ){
+			const String & key = header_response_pairs().at(i).key();
+			if( HttpHeaderPair::is_key_match(key.cstring(), key.length(), "location") ){
 				return query(
 							command,
 							header_response_pairs().at(i).value(),
 							send_file,
 							get_file,
-							progress_callback
+							progress_callback,
+							response_callback
 							);
 			}
 		}
 
 	}
 
-	if( is_keep_alive() == false ){
+	if( (is_keep_alive() == false) || m_is_close_requested ){
+		close_connection();
+	}
+
+	return 0;
+
+}
+
+int HttpClient::send_request(
+		const var::String & method,
+		const var::String & url,
+		const fs::File * request,
+		const sys::ProgressCallback * progress_callback
+		){
+	Url u(url);
+
+	int result = connect_to_server(u.domain_name(), u.port());
+	if( result < 0 ){
+		return result;
+	}
+
+	result = send_header(
+				method,
+				u.domain_name(),
+				u.path(),
+				request,
+				progress_callback
+				);
+	if( result < 0 ){
 		close_connection();
+		return result;
 	}
 
+	m_pending_response_count++;
 	return 0;
+}
+
+int HttpClient::receive_response(
+		ResponseFile response,
+		const sys::ProgressCallback * progress_callback
+		){
+	const fs::File & destination = response.argument();
+	return receive_response(
+				[&destination](const var::Reference & data) -> int {
+					return destination.write(
+								data.to_const_void(),
+								fs::File::Size(data.size())
+								);
+				},
+				progress_callback
+				);
+}
+
+int HttpClient::receive_response(
+		const ResponseCallback & response,
+		const sys::ProgressCallback * progress_callback
+		){
+	if( m_pending_response_count == 0 ){
+		return set_error_number_if_error(api::error_code_inet_failed_to_get_header);
+	}
+
+	m_status_code = -1;
+	m_content_length = 0;
+
+	if( listen_for_header() < 0 ){
+		close_connection();
+		return set_error_number_if_error(api::error_code_inet_failed_to_get_header);
+	}
+	m_pending_response_count--;
+
+	if( listen_for_data(response, progress_callback) < 0 ){
+		close_connection();
+		return -1;
+	}
 
+	if( m_is_close_requested ||
+			((is_keep_alive() == false) && (m_pending_response_count == 0)) ){
+		close_connection();
+	}
+
+	return 0;
 }
 
 
@@ -270,6 +403,10 @@ int HttpClient::send_string(const var::String & str){
 
 
 int HttpClient::close_connection(){
+	m_input.discard();
+	m_alive_domain.clear();
+	m_pending_response_count = 0;
+	m_is_close_requested = false;
 	return socket().close();
 }
 
@@ -278,49 +415,84 @@ int HttpClient::connect_to_server(
 		const var::String & domain_name,
 		u16 port
 		){
-	SocketAddressInfo address_info;
-
-	if( (socket().fileno() >= 0) && is_keep_alive() ){
-		//already connected
-		if( m_alive_domain == domain_name ){
+	SYS_TRACE_SCOPE("HttpClient::connect_to_server");
+	m_is_connection_reused = false;
+
+	if( (socket().fileno() >= 0) || socket().is_valid() ){
+		if( is_keep_alive() &&
+				(m_alive_domain == domain_name) &&
+				(m_alive_port == port) ){
+			//already connected
+			m_is_connection_reused = true;
 			return 0;
-		} else {
-			m_header.format("socket is 0x%X, domain is %s", socket().fileno(), m_alive_domain.cstring());
+		}
+
+		if( m_pending_response_count ){
+			m_header.format(
+						"socket is 0x%X, domain is %s",
+						socket().fileno(),
+						m_alive_domain.cstring()
+						);
 			return set_error_number_if_error(api::error_code_inet_failed_wrong_domain);
 		}
+
+		//connected to a different server
+		close_connection();
 	}
 
 	m_alive_domain.clear();
+	m_input.discard();
+
+	//look in the cache before doing a DNS lookup
+	bool is_cached = false;
+	for(const auto & entry: m_address_cache){
+		if( entry.domain_name == domain_name ){
+			m_address = entry.address;
+			is_cached = true;
+			break;
+		}
+	}
 
-	var::Vector<SocketAddressInfo> address_list = address_info.fetch_node(domain_name);
-	if( address_list.count() > 0 ){
-		m_address = SocketAddress(address_list.at(0));
-		m_address.set_port(port);
-
-		if( socket().create(m_address)  < 0 ){
-			return set_error_number_if_error(
-						api::error_code_inet_failed_to_create_socket
+	if( is_cached == false ){
+		SocketAddressInfo address_info;
+		var::Vector<SocketAddressInfo> address_list = address_info.fetch_node(domain_name);
+		if( address_list.count() == 0 ){
+			m_header.format(
+						"failed to find address with result (%d)",
+						address_info.error_number()
 						);
-		}
 
-		if( socket().connect(m_address) < 0 ){
-			socket().close();
 			return set_error_number_if_error(
-						api::error_code_inet_failed_to_connect_to_socket
+						api::error_code_inet_failed_to_find_address
 						);
 		}
-		m_alive_domain = domain_name;
-		return 0;
+
+		m_address = SocketAddress(address_list.at(0));
+		//the cache outlives any memory resource the caller has installed
+		var::MemoryResourceScope heap_scope(nullptr);
+		AddressCacheEntry entry;
+		entry.domain_name = domain_name;
+		entry.address = m_address;
+		m_address_cache.push_back(entry);
 	}
 
-	m_header.format(
-				"failed to find address with result (%d)",
-				address_info.error_number()
-				);
+	m_address.set_port(port);
 
-	return set_error_number_if_error(
-				api::error_code_inet_failed_to_find_address
-				);
+	if( socket().create(m_address)  < 0 ){
+		return set_error_number_if_error(
+					api::error_code_inet_failed_to_create_socket
+					);
+	}
+
+	if( socket().connect(m_address) < 0 ){
+		socket().close();
+		return set_error_number_if_error(
+					api::error_code_inet_failed_to_connect_to_socket
+					);
+	}
+	m_alive_domain = domain_name;
+	m_alive_port = port;
+	return 0;
 }
 
 int HttpClient::build_header(const var::String & method, const var::String & host, const var::String & path, u32 length){
@@ -398,68 +570,88 @@ int HttpClient::send_header(
 
 
 int HttpClient::listen_for_header(){
+	SYS_TRACE_SCOPE("HttpClient::listen_for_header");
 
-	var::String line;
 	m_header_response_pairs.clear();
 	bool is_first_line = true;
 	m_transfer_encoding = "";
-	socket().clear_error_number();
+	m_is_close_requested = false;
+
 	do {
-		line = socket().gets('\n');
-		if( line.length() > 2 ){
+		if( m_input.gets(m_line) == nullptr ){
+			return -1;
+		}
 
-			m_header << line;
-			AGGREGATE_TRAFFIC(String("> ") + line);
+		if( m_line.length() <= 2 ){
+			//blank line ends the header (leading blank lines are skipped)
+			if( is_first_line ){ continue; }
+			break;
+		}
+
+		m_header << m_line;
+		AGGREGATE_TRAFFIC(String("> ") + m_line);
 #if SHOW_HEADERS
-			printf("> %s", line.cstring());
+		printf("> %s", m_line.cstring());
 #endif
 
-			HttpHeaderPair pair = HttpHeaderPair::from_string(line);
-			m_header_response_pairs.push_back(pair);
-
-			String title = pair.key();
-			title.to_upper();
+		const char * line = m_line.cstring();
+		u32 length = static_cast<u32>(m_line.length());
+		while( length && ((line[length-1] == '\r') || (line[length-1] == '\n')) ){
+			length--;
+		}
 
-			if( title.find("HTTP/") == 0 ){
-				Tokenizer tokens(
-							title,
-							var::Tokenizer::Delimeters(" ")
-							);
-				is_first_line = false;
-				if( tokens.count() < 2 ){
-					m_status_code = -1;
-					return set_error_number_if_error(api::error_code_inet_failed_to_get_status_code);
-				}
-				m_status_code = String(tokens.at(1)).to_integer();
-			}
+		if( is_first_line ){
+			is_first_line = false;
+			m_header_response_pairs.push_back(
+						HttpHeaderPair(String(line, String::Length(length)), String())
+						);
 
-			if( title == "CONTENT-LENGTH" ){
-				m_content_length = static_cast<unsigned int>(pair.value().to_integer());
+			if( HttpHeaderPair::is_key_match(line, length < 5 ? length : 5, "HTTP/") == false ){
+				m_status_code = -1;
+				return set_error_number_if_error(api::error_code_inet_failed_to_get_status_code);
 			}
 
-			if( title == "CONTENT-TYPE" ){
-				//check for evnt streams
-				Tokenizer tokens(
-							pair.value(),
-							var::Tokenizer::Delimeters(" ;")
-							);
-				if( String(tokens.at(0)) == "text/event-stream" ){
-					m_content_length = static_cast<u32>(-1); //accept data until the operation is cancelled
-				}
+			const char * code = static_cast<const char*>(::memchr(line, ' ', length));
+			if( code == nullptr ){
+				m_status_code = -1;
+				return set_error_number_if_error(api::error_code_inet_failed_to_get_status_code);
 			}
+			m_status_code = ::atoi(code + 1);
+			continue;
+		}
 
-			if( title == "TRANSFER-ENCODING" ){
-				m_transfer_encoding = pair.value();
-				m_transfer_encoding.to_upper();
+		const char * colon = static_cast<const char*>(::memchr(line, ':', length));
+		const u32 key_length = colon ? static_cast<u32>(colon - line) : length;
+		const char * value = colon ? colon + 1 : line + length;
+		while( (value < line + length) && (*value == ' ' || *value == '\t') ){
+			value++;
+		}
+		const u32 value_length = static_cast<u32>(line + length - value);
+
+		if( HttpHeaderPair::is_key_match(line, key_length, "content-length") ){
+			m_content_length = static_cast<u32>(::strtoul(value, nullptr, 10));
+		} else if( HttpHeaderPair::is_key_match(line, key_length, "content-type") ){
+			//check for event streams
+			const u32 event_stream_length = sizeof("text/event-stream")-1;
+			if( (value_length >= event_stream_length) &&
+					HttpHeaderPair::is_key_match(value, event_stream_length, "text/event-stream") ){
+				m_content_length = static_cast<u32>(-1); //accept data until the operation is cancelled
 			}
+		} else if( HttpHeaderPair::is_key_match(line, key_length, "transfer-encoding") ){
+			m_transfer_encoding.assign(value, String::Length(value_length));
+			m_transfer_encoding.to_upper();
+		} else if( HttpHeaderPair::is_key_match(line, key_length, "connection") ){
+			m_is_close_requested = HttpHeaderPair::is_key_match(value, value_length, "close");
 		}
 
+		m_header_response_pairs.push_back(
+					HttpHeaderPair(
+						String(line, String::Length(key_length)),
+						String(value, String::Length(value_length))
+						)
+					);
 
-	} while( (line.length() > 2 || is_first_line) && (socket().error_number() == 0) ); //while reading the header
-
-	if( socket().error_number() != 0 ){
-		return -1;
-	}
+	} while( 1 );
 
 	return 0;
 }
@@ -468,73 +660,272 @@ int HttpClient::listen_for_data(
 		const fs::File & destination,
 		const sys::ProgressCallback * progress_callback
 		){
+	return listen_for_data(
+				[&destination](const var::Reference & data) -> int {
+					int result = destination.write(
+								data.to_const_void(),
+								fs::File::Size(data.size())
+								);
+					if( result != static_cast<int>(data.size()) ){
+						return -1;
+					}
+					return result;
+				},
+				progress_callback
+				);
+}
+
+int HttpClient::listen_for_data(
+		const ResponseCallback & response,
+		const sys::ProgressCallback * progress_callback
+		){
+	const u32 transfer_size =
+			m_transfer_size ? m_transfer_size : SAPI_LINK_DEFAULT_PAGE_SIZE;
+
+	//one buffer is re-used for the entire body no matter how big the chunks are
+	if( m_transfer_buffer.size() != transfer_size ){
+		if( m_transfer_buffer.resize(transfer_size) < 0 ){
+			return set_error_number_if_error(api::error_code_inet_failed_to_receive_data);
+		}
+	}
+
+	m_bytes_received = 0;
+	int result = 0;
+
 	if( m_transfer_encoding == "CHUNKED" ){
+		//the total is only known if the server also sent the length (event streams don't have one)
+		const bool is_length_known = (m_content_length != 0) &&
+				(m_content_length != static_cast<u32>(-1)) &&
+				(m_content_length <= static_cast<u32>(INT_MAX));
+		const int progress_total = is_length_known ?
+					static_cast<int>(m_content_length) :
+					sys::ProgressCallback::indeterminate_progress_total();
+
 		u32 bytes_incoming = 0;
 		do {
-			String line = socket().gets();
-			//convert line from hex
-			bytes_incoming = line.to_unsigned_long(String::base_16);
-
-			//read bytes_incoming from the socket and write it to the output file
-			if( destination.write(
-					 socket(),
-					 fs::File::PageSize(bytes_incoming),
-					 fs::File::Size(bytes_incoming)
-					 ) != static_cast<int>(bytes_incoming) ){
-				return set_error_number_if_error(api::error_code_inet_failed_to_write_incoming_data_to_file);
+			if( m_input.gets(m_line) == nullptr ){
+				return set_error_number_if_error(api::error_code_inet_failed_to_parse_chunk);
+			}
+
+			//chunk size is hex and may be followed by ;extensions
+			char * end = nullptr;
+			bytes_incoming = static_cast<u32>(
+						::strtoul(m_line.cstring(), &end, 16)
+						);
+			if( end == m_line.cstring() ){
+				return set_error_number_if_error(api::error_code_inet_failed_to_parse_chunk);
 			}
 
-			//need to call the progress callback -- what is the total?
+			if( bytes_incoming ){
+				result = receive_data(
+							response,
+							bytes_incoming,
+							progress_total,
+							progress_callback
+							);
+				if( result < 0 ){
+					return result;
+				}
 
+				if( result > 0 ){
+					//an event stream was cancelled
+					break;
+				}
+
+				//each chunk is followed by CRLF
+				if( (m_input.gets(m_line) == nullptr) ||
+						((m_line != "\r\n") && (m_line != "\n")) ){
+					return set_error_number_if_error(api::error_code_inet_failed_to_parse_chunk);
+				}
+			}
 		} while( bytes_incoming > 0 );
 
-	} else {
-		//read the response from the socket
-		if( m_content_length != 0 ){
-			int result = destination.write(
-						socket(),
-						fs::File::PageSize(m_transfer_size),
-						fs::File::Size(m_content_length),
-						progress_callback
-						);
-			if( result != static_cast<int>(m_content_length) ){
-				return -1;
+		//trailers follow the last chunk and end with a blank line
+		while( result == 0 ){
+			if( m_input.gets(m_line) == nullptr ){
+				return set_error_number_if_error(api::error_code_inet_failed_to_parse_chunk);
+			}
+			if( (m_line == "\r\n") || (m_line == "\n") ){
+				break;
+			}
+			m_header_response_pairs.push_back(HttpHeaderPair::from_string(m_line));
+		}
+
+	} else if( m_content_length == static_cast<u32>(-1) ){
+		//event streams are received until the operation is cancelled
+		result = receive_data(
+					response,
+					m_content_length,
+					sys::ProgressCallback::indeterminate_progress_total(),
+					progress_callback
+					);
+	} else if( m_content_length != 0 ){
+		result = receive_data(
+					response,
+					m_content_length,
+					static_cast<int>(m_content_length),
+					progress_callback
+					);
+	}
+
+	if( progress_callback ){
+		progress_callback->update(0, 0);
+	}
+
+	return result < 0 ? result : 0;
+}
+
+int HttpClient::receive_data(
+		const ResponseCallback & response,
+		u32 size,
+		int progress_total,
+		const sys::ProgressCallback * progress_callback
+		){
+	const bool is_stream = (size == static_cast<u32>(-1));
+
+	while( size > 0 ){
+		u32 page_size = m_transfer_buffer.size();
+		if( page_size > size ){
+			page_size = size;
+		}
+
+		int result = m_input.read(
+					m_transfer_buffer.to_void(),
+					fs::File::Size(page_size)
+					);
+
+		if( result <= 0 ){
+			if( is_stream ){
+				//the server ended the stream
+				m_is_close_requested = true;
+				return 0;
 			}
+			return set_error_number_if_error(api::error_code_inet_failed_to_receive_data);
+		}
+
+		if( response(
+					var::Reference(
+						var::Reference::ReadOnlyBuffer(m_transfer_buffer.to_const_void()),
+						var::Reference::Size(static_cast<u32>(result))
+						)
+					) < 0 ){
+			//the rest of the body is still on the connection
+			m_is_close_requested = true;
+			return set_error_number_if_error(api::error_code_inet_failed_to_write_incoming_data_to_file);
+		}
+
+		m_bytes_received += static_cast<u32>(result);
+		if( is_stream == false ){
+			size -= static_cast<u32>(result);
+		}
+
+		if( progress_callback &&
+				progress_callback->update(
+					static_cast<int>(m_bytes_received),
+					progress_total
+					) ){
+			m_is_close_requested = true;
+			//cancelling is the normal way to end an event stream
+			return (m_content_length == static_cast<u32>(-1)) ? 1 : -1;
 		}
 	}
+
 	return 0;
 }
 
 HttpHeaderPair HttpHeaderPair::from_string(
 		const var::String & string
 		){
-	String string_copy = string;
-	size_t colon_pos = string_copy.find(":");
+	const char * line = string.cstring();
+	u32 length = static_cast<u32>(string.length());
+	while( length && ((line[length-1] == '\r') || (line[length-1] == '\n')) ){
+		length--;
+	}
+
+	const char * colon = static_cast<const char*>(::memchr(line, ':', length));
+	if( colon == nullptr ){
+		return HttpHeaderPair(String(line, String::Length(length)), String());
+	}
+
+	const char * value = colon + 1;
+	if( (value < line + length) && (*value == ' ') ){
+		value++;
+	}
 
-	String key = string_copy.create_sub_string(
-				String::Position(0),
-				String::Length(colon_pos)
+	return HttpHeaderPair(
+				String(line, String::Length(static_cast<u32>(colon - line))),
+				String(value, String::Length(static_cast<u32>(line + length - value)))
 				);
-	String value;
-	if( colon_pos != String::npos ){
-		value = string_copy.create_sub_string(
-					String::Position(colon_pos+1)
-					);
-		if( value.at(0) == ' ' ){
-			value.erase(
-						String::Position(0),
-						String::Length(1)
-						);
+}
+
+bool HttpHeaderPair::is_key_match(
+		const char * key,
+		u32 key_length,
+		const char * name
+		){
+	u32 i;
+	for(i=0; i < key_length; i++){
+		if( (name[i] == 0) || (::tolower(key[i]) != ::tolower(name[i])) ){
+			return false;
+		}
+	}
+	return name[i] == 0;
+}
+
+HttpClient & HttpConnectionPool::client(const var::String & url){
+	Url u(url);
+	m_sequence++;
+
+	for(auto & entry: m_entries){
+		if( (entry.port == u.port()) &&
+				(entry.protocol == u.protocol()) &&
+				(entry.domain_name == u.domain_name()) ){
+			entry.sequence = m_sequence;
+			return *entry.client;
 		}
-		value.replace(
-					String::ToErase("\r"),
-					String::ToInsert("")
-					);
-		value.replace(
-					String::ToErase("\n"),
-					String::ToInsert("")
-					);
 	}
-	return HttpHeaderPair(key, value);
+
+	if( m_entries.count() >= m_maximum_count ){
+		//close the least recently used connection
+		u32 oldest = 0;
+		for(u32 i=1; i < m_entries.count(); i++){
+			if( m_entries.at(i).sequence < m_entries.at(oldest).sequence ){
+				oldest = i;
+			}
+		}
+		destroy(m_entries.at(oldest));
+		m_entries.remove(oldest);
+	}
+
+	//the connections outlive any memory resource the caller has installed
+	var::MemoryResourceScope heap_scope(nullptr);
+	Entry entry;
+	entry.domain_name = u.domain_name();
+	entry.port = u.port();
+	entry.protocol = u.protocol();
+	entry.sequence = m_sequence;
+	if( u.protocol() == Url::protocol_https ){
+		entry.socket = new SecureSocket();
+	} else {
+		entry.socket = new Socket();
+	}
+	entry.client = new HttpClient(*entry.socket);
+	entry.client->set_keep_alive(true);
+	m_entries.push_back(entry);
+	return *entry.client;
+}
+
+void HttpConnectionPool::close_all(){
+	for(auto & entry: m_entries){
+		destroy(entry);
+	}
+	m_entries.clear();
 }
 
+void HttpConnectionPool::destroy(Entry & entry){
+	entry.client->close_connection();
+	delete entry.client;
+	delete entry.socket;
+	entry.client = nullptr;
+	entry.socket = nullptr;
+}
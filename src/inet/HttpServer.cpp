@@ -0,0 +1,530 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cctype>
+#include <cstdio>
+
+#include "inet/HttpServer.hpp"
+#include "var/Tokenizer.hpp"
+
+using namespace inet;
+
+namespace {
+
+bool is_key_match(const var::String & a, const var::String & b){
+	if( a.length() != b.length() ){
+		return false;
+	}
+	for(u32 i=0; i < a.length(); i++){
+		if( ::tolower(a.at(i)) != ::tolower(b.at(i)) ){
+			return false;
+		}
+	}
+	return true;
+}
+
+void strip_line_ending(var::String & line){
+	while( line.length() &&
+				 ((line.at(line.length()-1) == '\n') || (line.at(line.length()-1) == '\r')) ){
+		line.resize(line.length()-1);
+	}
+}
+
+}
+
+const var::String & HttpServerRequest::get_header_value(
+		const var::String & key
+		) const {
+	for(const auto & pair: m_header_pairs){
+		if( is_key_match(pair.key(), key) ){
+			return pair.value();
+		}
+	}
+	return var::String::empty_string();
+}
+
+int HttpServerResponse::write(const void * buffer, u32 size){
+	if( m_socket.write(buffer, fs::File::Size(size)) != static_cast<int>(size) ){
+		m_is_keep_alive = false;
+		return api::error_code_inet_failed_to_write_data;
+	}
+	return 0;
+}
+
+int HttpServerResponse::send_header(
+		const var::String & content_type,
+		u32 content_length,
+		bool is_chunked
+		){
+	var::String header;
+	header.format(
+				"HTTP/1.1 %d %s\r\n",
+				m_status_code,
+				HttpServer::get_reason_phrase(m_status_code)
+				);
+
+	if( content_type.is_empty() == false ){
+		header << "Content-Type: " << content_type << "\r\n";
+	}
+
+	if( is_chunked ){
+		header << "Transfer-Encoding: chunked\r\n";
+	} else {
+		header << "Content-Length: " << var::String::number(content_length) << "\r\n";
+	}
+
+	header << "Connection: " << (m_is_keep_alive ? "keep-alive" : "close") << "\r\n";
+
+	for(const auto & pair: m_header_pairs){
+		header << pair.to_string() << "\r\n";
+	}
+	header << "\r\n";
+
+	m_is_header_sent = true;
+	if( write(header.cstring(), header.length()) < 0 ){
+		return api::error_code_inet_failed_to_write_header;
+	}
+	return 0;
+}
+
+int HttpServerResponse::send(
+		const var::Reference & body,
+		const var::String & content_type
+		){
+	int result = send_header(content_type, body.size(), false);
+	if( result < 0 ){
+		return result;
+	}
+	if( body.size() ){
+		return write(body.to_const_void(), body.size());
+	}
+	return 0;
+}
+
+int HttpServerResponse::send_file(
+		const fs::File & file,
+		const var::String & content_type
+		){
+	const u32 location = static_cast<u32>(file.location());
+	const u32 size = file.size() - location;
+	int result = send_header(content_type, size, false);
+	if( result < 0 ){
+		return result;
+	}
+
+	if( size == 0 ){
+		return 0;
+	}
+
+	//stream the file to the socket one page at a time
+	if( m_socket.write(
+				file,
+				fs::File::PageSize(m_transfer_size),
+				fs::File::Size(size)
+				) != static_cast<int>(size) ){
+		m_is_keep_alive = false;
+		return api::error_code_inet_failed_to_write_data;
+	}
+	return 0;
+}
+
+int HttpServerResponse::start_chunked(const var::String & content_type){
+	return send_header(content_type, 0, true);
+}
+
+int HttpServerResponse::send_chunk(const var::Reference & data){
+	if( data.size() == 0 ){
+		return 0;
+	}
+
+	char size_line[16];
+	int length = ::snprintf(
+				size_line,
+				sizeof(size_line),
+				"%lX\r\n",
+				static_cast<unsigned long>(data.size())
+				);
+
+	if( (write(size_line, static_cast<u32>(length)) < 0) ||
+			(write(data.to_const_void(), data.size()) < 0) ||
+			(write("\r\n", 2) < 0) ){
+		return api::error_code_inet_failed_to_write_data;
+	}
+	return 0;
+}
+
+int HttpServerResponse::finish_chunked(){
+	return write("0\r\n\r\n", 5);
+}
+
+HttpServer::HttpServer(Socket & socket) : Http(socket){}
+
+HttpServer::~HttpServer(){
+	stop();
+}
+
+HttpServer & HttpServer::add_route(
+		const var::String & method,
+		const var::String & path,
+		Handler handler
+		){
+	Route route;
+	route.method = method;
+	route.path = path;
+	route.handler = handler;
+	m_routes.push_back(route);
+	return *this;
+}
+
+int HttpServer::listen(const SocketAddress & address){
+	if( socket().create(address) < 0 ){
+		return set_error_number_if_error(
+					api::error_code_inet_failed_to_create_socket
+					);
+	}
+
+	socket() << SocketOption().socket_reuse_address();
+
+	if( socket().bind_and_listen(address) < 0 ){
+		socket().close();
+		return set_error_number_if_error(
+					api::error_code_inet_failed_to_listen
+					);
+	}
+
+	m_is_running = true;
+	return 0;
+}
+
+int HttpServer::start(
+		const SocketAddress & address,
+		ThreadCount thread_count
+		){
+	if( is_running() ){
+		return 0;
+	}
+
+	int result = listen(address);
+	if( result < 0 ){
+		return result;
+	}
+
+	const u32 count = thread_count.argument() ? thread_count.argument() : 1;
+	const u32 stack_size = m_thread_stack_size > SAPI_WORKER_THREAD_STACK_SIZE ?
+				m_thread_stack_size : SAPI_WORKER_THREAD_STACK_SIZE;
+
+	//the threads are constructed in place (the stack size can't be changed after construction)
+	m_threads.vector().reserve(count);
+	for(u32 i = 0; i < count; i++){
+		m_threads.vector().emplace_back(
+					sys::Thread::StackSize(stack_size),
+					sys::Thread::IsDetached(false)
+					);
+		if( m_threads.vector().back().create(
+					sys::Thread::Function(worker),
+					sys::Thread::FunctionArgument(this)
+					) < 0 ){
+			//only created threads stay in the list so stop() can join them all
+			m_threads.vector().pop_back();
+			stop();
+			return set_error_number_if_error(-1);
+		}
+	}
+
+	return 0;
+}
+
+int HttpServer::run(const SocketAddress & address){
+	int result = listen(address);
+	if( result < 0 ){
+		return result;
+	}
+	serve();
+	return 0;
+}
+
+int HttpServer::stop(){
+	if( is_running() == false ){
+		return 0;
+	}
+
+	m_is_running = false;
+
+	//wakes up the workers that are blocked in accept()
+	socket().shutdown();
+	socket().close();
+
+	//is_valid() can't be used here: it doesn't change when a thread is created on link builds
+	for(auto & thread: m_threads){
+		thread.join();
+	}
+	m_threads.clear();
+	return 0;
+}
+
+void * HttpServer::worker(void * args){
+	reinterpret_cast<HttpServer*>(args)->serve();
+	return nullptr;
+}
+
+void HttpServer::serve(){
+	while( is_running() ){
+		SocketAddress address;
+		Socket connection = socket().accept(address);
+		if( connection.is_valid() == false ){
+			continue;
+		}
+
+		connection << SocketOption().socket_receive_timeout(
+										chrono::ClockTime::from_seconds(m_keep_alive_timeout)
+										);
+
+		//the header and the body are written separately: without this, the body
+		//waits for the client to acknowledge the header (up to 40ms on some hosts)
+		connection << SocketOption().tcp_no_delay();
+
+		handle_connection(connection);
+	}
+}
+
+void HttpServer::handle_connection(const Socket & connection){
+	fs::BufferedFile input(
+				connection,
+				fs::File::PageSize(m_transfer_size)
+				);
+	HttpServerRequest request;
+
+	while( is_running() ){
+		int result = read_request(input, request);
+		if( result < 0 ){
+			return;
+		}
+
+		HttpServerResponse response(
+					connection,
+					request.is_keep_alive(),
+					m_transfer_size
+					);
+
+		if( result > 0 ){
+			//the request couldn't be read in full
+			response.set_close_connection()
+					.set_status_code(result)
+					.send(var::Reference(), "");
+			return;
+		}
+
+		execute(request, response);
+
+		m_request_count++;
+
+		if( response.is_keep_alive() == false ){
+			return;
+		}
+	}
+}
+
+int HttpServer::read_request(
+		const fs::BufferedFile & input,
+		HttpServerRequest & request
+		){
+	var::String line;
+
+	//skip blank lines between requests
+	do {
+		if( input.gets(line) == nullptr ){
+			return -1;
+		}
+		strip_line_ending(line);
+	} while( line.is_empty() );
+
+	var::TokenScanner request_line(
+				line,
+				var::TokenScanner::Delimeters(" ")
+				);
+
+	var::TokenView target;
+	var::TokenView version;
+	var::TokenView method;
+	if( (request_line.next(method) == false) ||
+			(request_line.next(target) == false) ||
+			(request_line.next(version) == false) ){
+		return 400;
+	}
+
+	request.m_method = method.to_string();
+	request.m_version = version.to_string();
+	request.m_header_pairs.clear();
+	request.m_content_length = 0;
+	request.m_body.free();
+
+	var::TokenScanner target_scanner(
+				target.data(),
+				target.length(),
+				var::TokenScanner::Delimeters("?"),
+				var::TokenScanner::IgnoreBetween(""),
+				var::TokenScanner::MaximumCount(1)
+				);
+	var::TokenView token;
+	target_scanner.next(token);
+	request.m_path = token.to_string();
+	request.m_query.clear();
+	if( target_scanner.next(token) ){
+		request.m_query = token.to_string();
+	}
+
+	request.m_is_keep_alive = (version == "HTTP/1.1");
+
+	do {
+		if( input.gets(line) == nullptr ){
+			return -1;
+		}
+		strip_line_ending(line);
+		if( line.is_empty() == false ){
+			HttpHeaderPair pair = HttpHeaderPair::from_string(line);
+			if( is_key_match(pair.key(), "content-length") ){
+				request.m_content_length =
+						static_cast<u32>(pair.value().to_unsigned_long());
+			} else if( is_key_match(pair.key(), "connection") ){
+				if( is_key_match(pair.value(), "close") ){
+					request.m_is_keep_alive = false;
+				} else if( is_key_match(pair.value(), "keep-alive") ){
+					request.m_is_keep_alive = true;
+				}
+			} else if( is_key_match(pair.key(), "transfer-encoding") ){
+				//chunked request bodies are not supported
+				return 411;
+			}
+			request.m_header_pairs.push_back(pair);
+		}
+	} while( line.is_empty() == false );
+
+	if( request.m_content_length ){
+		if( request.m_content_length > m_maximum_body_size ){
+			return 413;
+		}
+
+		request.m_body.resize(request.m_content_length);
+		u32 bytes_read = 0;
+		while( bytes_read < request.m_content_length ){
+			int result = input.read(
+						request.m_body.to_u8() + bytes_read,
+						fs::File::Size(request.m_content_length - bytes_read)
+						);
+			if( result <= 0 ){
+				return -1;
+			}
+			bytes_read += static_cast<u32>(result);
+		}
+	}
+
+	return 0;
+}
+
+void HttpServer::execute(
+		const HttpServerRequest & request,
+		HttpServerResponse & response
+		){
+
+	for(const auto & route: m_routes){
+		if( (route.method != "*") && (route.method != request.method()) ){
+			continue;
+		}
+
+		bool is_match;
+		const u32 length = static_cast<u32>(route.path.length());
+		if( length && (route.path.at(length-1) == '*') ){
+			is_match = (request.path().length() >= length-1) &&
+					(::strncmp(
+						 request.path().cstring(),
+						 route.path.cstring(),
+						 length-1) == 0);
+		} else {
+			is_match = (route.path == request.path());
+		}
+
+		if( is_match ){
+			route.handler(request, response);
+			if( response.is_sent() == false ){
+				response.set_status_code(500).send(var::Reference(), "");
+			}
+			return;
+		}
+	}
+
+	if( root_path().is_empty() == false ){
+		send_static_file(request, response);
+		return;
+	}
+
+	response.set_status_code(404).send(var::Reference(), "");
+}
+
+int HttpServer::send_static_file(
+		const HttpServerRequest & request,
+		HttpServerResponse & response
+		){
+
+	if( (request.method() != "GET") ){
+		return response.set_status_code(405).send(var::Reference(), "");
+	}
+
+	//don't allow access outside of the root path
+	if( request.path().find("..") != var::String::npos ){
+		return response.set_status_code(403).send(var::Reference(), "");
+	}
+
+	var::String path = root_path() + request.path();
+	if( path.is_empty() || (path.at(path.length()-1) == '/') ){
+		path << "index.html";
+	}
+
+	fs::File file;
+	if( file.open(path, fs::OpenFlags::read_only()) < 0 ){
+		return response.set_status_code(404).send(var::Reference(), "");
+	}
+
+	return response.send_file(
+				file,
+				get_content_type(fs::File::suffix(path))
+				);
+}
+
+const char * HttpServer::get_reason_phrase(int status_code){
+	switch(status_code){
+		case 100: return "Continue";
+		case 200: return "OK";
+		case 201: return "Created";
+		case 202: return "Accepted";
+		case 204: return "No Content";
+		case 206: return "Partial Content";
+		case 301: return "Moved Permanently";
+		case 302: return "Found";
+		case 304: return "Not Modified";
+		case 400: return "Bad Request";
+		case 401: return "Unauthorized";
+		case 403: return "Forbidden";
+		case 404: return "Not Found";
+		case 405: return "Method Not Allowed";
+		case 408: return "Request Timeout";
+		case 411: return "Length Required";
+		case 413: return "Payload Too Large";
+		case 500: return "Internal Server Error";
+		case 501: return "Not Implemented";
+		case 503: return "Service Unavailable";
+	}
+	return "Unknown";
+}
+
+const char * HttpServer::get_content_type(const var::String & suffix){
+	if( suffix == "html" || suffix == "htm" ){ return "text/html"; }
+	if( suffix == "css" ){ return "text/css"; }
+	if( suffix == "js" ){ return "application/javascript"; }
+	if( suffix == "json" ){ return "application/json"; }
+	if( suffix == "txt" ){ return "text/plain"; }
+	if( suffix == "csv" ){ return "text/csv"; }
+	if( suffix == "png" ){ return "image/png"; }
+	if( suffix == "jpg" || suffix == "jpeg" ){ return "image/jpeg"; }
+	if( suffix == "svg" ){ return "image/svg+xml"; }
+	if( suffix == "ico" ){ return "image/x-icon"; }
+	return "application/octet-stream";
+}
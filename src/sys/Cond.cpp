@@ -0,0 +1,45 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include "sys/Cond.hpp"
+#include "chrono.hpp"
+
+using namespace sys;
+
+Cond::Cond(){
+	set_error_number_if_nonzero(pthread_cond_init(&m_item, nullptr));
+}
+
+Cond::~Cond(){
+	pthread_cond_destroy(&m_item);
+}
+
+int Cond::wait(Mutex & mutex){
+	return set_error_number_if_nonzero(pthread_cond_wait(&m_item, &mutex.m_item));
+}
+
+int Cond::wait_timed(Mutex & mutex, const chrono::ClockTime & clock_time){
+	//pthread_cond_timedwait() uses an absolute time on the realtime clock
+	chrono::ClockTime calc_time;
+	calc_time = chrono::Clock::get_time();
+	calc_time += clock_time;
+	return set_error_number_if_nonzero(
+				pthread_cond_timedwait(&m_item, &mutex.m_item, calc_time)
+				);
+}
+
+int Cond::signal(){
+	return set_error_number_if_nonzero(pthread_cond_signal(&m_item));
+}
+
+int Cond::broadcast(){
+	return set_error_number_if_nonzero(pthread_cond_broadcast(&m_item));
+}
+
+int Cond::set_error_number_if_nonzero(int result) const {
+	//pthread_cond functions return the error number rather than setting errno
+	if( result != 0 ){
+		set_error_number(result);
+		return -1;
+	}
+	return 0;
+}
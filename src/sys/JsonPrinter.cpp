@@ -1,4 +1,7 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include "sys/JsonPrinter.hpp"
 
 using namespace sys;
@@ -16,59 +19,80 @@ void JsonPrinter::print(
 		const char * value,
 		bool is_newline
 		){
+	MCU_UNUSED_ARGUMENT(is_newline);
 
-	if(level > verbose_level()){
+	if( is_filtered(level) ){
 		return;
 	}
 
-	for(auto const & c: container_list() ){
-		if(c.verbose_level() > verbose_level()){
-			return;
+	insert_comma();
+	print_key(key);
+
+	if( value != nullptr ){
+		if( flags() & print_value_quotes ){
+			print_string(value);
+		} else {
+			print_final_buffer(value, ::strlen(value));
 		}
 	}
+}
 
-	insert_comma();
-
-	if( container().type() == container_array ){
-		key = nullptr;
+void JsonPrinter::print_integer(u64 magnitude, bool is_negative){
+	char buffer[24];
+	char * end = buffer + sizeof(buffer);
+	char * start = end;
+	do {
+		*(--start) = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while( magnitude );
+	if( is_negative ){
+		*(--start) = '-';
 	}
+	print_final_buffer(start, static_cast<u32>(end - start));
+}
 
-	Printer::print(level, key, value, false);
+void JsonPrinter::print_real(double value, int precision){
+	if( std::isfinite(value) == false ){
+		print_final_buffer("null", 4);
+		return;
+	}
+	char buffer[32];
+	int length = ::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+	print_final_buffer(buffer, static_cast<u32>(length));
 }
 
 void JsonPrinter::print_open_object(
 		enum levels level,
 		const char * key
 		){
-
-	if( verbose_level() >= level ){
-		insert_comma();
-		if( container().type() == container_object ){
-			print_final("\"%s\":{", key);
-		} else {
-			print_final("{", key);
-		}
-	}
-
-	container_list().push_back(
-				Container(level, container_object)
-				);
+	open_container(level, key, container_object);
 }
 
 void JsonPrinter::print_open_array(
 		enum levels level,
 		const char * key
 		){
+	open_container(level, key, container_array);
+}
+
+void JsonPrinter::open_container(
+		enum levels level,
+		const char * key,
+		enum container_type type
+		){
+	//a container is filtered whenever its parent is filtered
+	if( container().verbose_level() > level ){
+		level = container().verbose_level();
+	}
+
 	if( verbose_level() >= level ){
 		insert_comma();
-		if( container().type() == container_object ){
-			print_final("\"%s\":[", key);
-		} else {
-			print_final("[", key);
-		}
+		print_key(key == nullptr ? "" : key);
+		print_final_buffer(type == container_object ? "{" : "[", 1);
 	}
+
 	container_list().push_back(
-				Container(level, container_array)
+				Container(level, type)
 				);
 }
 
@@ -76,9 +100,9 @@ void JsonPrinter::print_close_object(){
 	if( container_list().count() > 1 ){
 		if( verbose_level() >= container().verbose_level() ){
 			if( container().type() == container_array ){
-				print_final("]");
+				print_final_buffer("]", 1);
 			} else if( container().type() == container_object ){
-				print_final("}");
+				print_final_buffer("}", 1);
 			}
 		}
 		container_list().pop_back();
@@ -87,9 +111,66 @@ void JsonPrinter::print_close_object(){
 
 void JsonPrinter::insert_comma(){
 	if( container().count() > 1 ){
-		print_final(",");
+		print_final_buffer(",", 1);
 	}
 	container().count() = container().count() + 1;
 }
 
+void JsonPrinter::print_key(const char * key){
+	//keys are only used inside objects
+	if( (key == nullptr) || (container().type() != container_object) ){
+		return;
+	}
+
+	if( flags() & print_key_quotes ){
+		print_string(key);
+	} else {
+		print_final_buffer(key, ::strlen(key));
+	}
+	print_final_buffer(":", 1);
+}
 
+void JsonPrinter::print_string(const char * value){
+	print_final_buffer("\"", 1);
+
+	const char * run = value;
+	for(const char * c = value; *c != 0; c++){
+		const u8 character = static_cast<u8>(*c);
+		if( (character >= 0x20) && (character != '"') && (character != '\\') ){
+			continue;
+		}
+
+		//write the characters that don't need escaping in one block
+		if( c > run ){
+			print_final_buffer(run, static_cast<u32>(c - run));
+		}
+		run = c + 1;
+
+		char escape[6] = {'\\', 0};
+		u32 size = 2;
+		switch(character){
+			case '"': escape[1] = '"'; break;
+			case '\\': escape[1] = '\\'; break;
+			case '\n': escape[1] = 'n'; break;
+			case '\r': escape[1] = 'r'; break;
+			case '\t': escape[1] = 't'; break;
+			case '\b': escape[1] = 'b'; break;
+			case '\f': escape[1] = 'f'; break;
+			default:
+				escape[1] = 'u';
+				escape[2] = '0';
+				escape[3] = '0';
+				escape[4] = "0123456789abcdef"[character >> 4];
+				escape[5] = "0123456789abcdef"[character & 0x0f];
+				size = 6;
+				break;
+		}
+		print_final_buffer(escape, size);
+	}
+
+	if( *run != 0 ){
+		print_final_buffer(run, static_cast<u32>(::strlen(run)));
+	}
+
+	print_final_buffer("\"", 1);
+}
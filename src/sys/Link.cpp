@@ -16,6 +16,7 @@
 #include "sys/Link.hpp"
 #include "sys/Appfs.hpp"
 #include "chrono/Timer.hpp"
+#include "sys/TraceRecorder.hpp"
 
 using namespace sys;
 using namespace fs;
@@ -277,6 +278,7 @@ int Link::read(
 		void * buf,
 		File::Size nbyte
 		){
+	SYS_TRACE_SCOPE("Link::read", fd.argument(), nbyte.argument());
 	int err = -1;
 	if ( m_is_bootloader ){
 		return -1;
@@ -302,6 +304,7 @@ int Link::write(
 		FileDescriptor fd,
 		const void * buf,
 		fs::File::Size nbyte){
+	SYS_TRACE_SCOPE("Link::write", fd.argument(), nbyte.argument());
 	int err = -1;
 	if ( m_is_bootloader ){
 		return -1;
@@ -325,6 +328,7 @@ int Link::write(
 }
 
 int Link::read_flash(int addr, void * buf, int nbyte){
+	SYS_TRACE_SCOPE("Link::read_flash", addr, nbyte);
 	int err = -1;
 
 	for(int tries = 0; tries < MAX_TRIES; tries++){
@@ -397,6 +401,7 @@ int Link::get_is_executing(
 }
 
 int Link::write_flash(int addr, const void * buf, int nbyte){
+	SYS_TRACE_SCOPE("Link::write_flash", addr, nbyte);
 	int err = -1;
 
 	for(int tries = 0; tries < MAX_TRIES; tries++){
@@ -833,24 +838,153 @@ int Link::copy(
 		IsCopyToDevice is_to_device,
 		const ProgressCallback * progress_callback
 		){
-	int err;
-	struct link_stat st;
-	File host_file;
-	File device_file = File(
-				fs::File::LinkDriver(driver())
+
+	if ( m_is_bootloader ){
+		return -1;
+	}
+
+	m_transfer_statistics = TransferStatistics();
+	m_progress = 0;
+	m_progress_max = 0;
+
+	int result = copy_file_contents(
+				src,
+				dest,
+				permissions,
+				is_to_device,
+				progress_callback
 				);
-	int copy_page_size = 4096;
+
+	if( progress_callback ){ progress_callback->update(0,0); }
+	return result;
+}
+
+int Link::copy(
+		SourceFile source,
+		DestinationFile destination,
+		const ProgressCallback * progress_callback
+		){
 
 	if ( m_is_bootloader ){
 		return -1;
 	}
 
-	err = 0;
+	const u32 size = source.argument().size();
+	m_transfer_statistics = TransferStatistics();
+	m_progress = 0;
+	m_progress_max = static_cast<int>(size);
 
-	if ( is_to_device.argument() == true ){
+	int result = transfer(
+				destination.argument(),
+				source.argument(),
+				size,
+				progress_callback
+				);
 
-		m_progress_max = 0;
-		m_progress = 0;
+	if( progress_callback ){ progress_callback->update(0,0); }
+	return result < 0 ? -1 : 0;
+}
+
+int Link::copy_directory(
+		SourcePath src,
+		DestinationPath dest,
+		const Permissions & permissions,
+		IsCopyToDevice is_to_device,
+		const ProgressCallback * progress_callback
+		){
+
+	if ( m_is_bootloader ){
+		return -1;
+	}
+
+	link_transport_mdriver_t * source_driver =
+			is_to_device.argument() ? nullptr : driver();
+	link_transport_mdriver_t * destination_driver =
+			is_to_device.argument() ? driver() : nullptr;
+
+	var::Vector<var::String> list = Dir::read_list(
+				src.argument(),
+				Dir::IsRecursive(true),
+				Dir::LinkDriver(source_driver)
+				);
+
+	m_transfer_statistics = TransferStatistics();
+	m_progress = 0;
+	m_progress_max = 0;
+
+	//the total is needed up front so progress covers the whole tree
+	for(const auto & entry: list){
+		m_progress_max += static_cast<int>(
+					File::get_info(
+						src.argument() + "/" + entry,
+						File::LinkDriver(source_driver)
+						).size()
+					);
+	}
+
+	if( Dir::create(
+				dest.argument(),
+				Permissions(0777),
+				Dir::IsRecursive(true),
+				Dir::LinkDriver(destination_driver)
+				) < 0 && !Dir::exists(dest.argument(), Dir::LinkDriver(destination_driver)) ){
+		m_error_message.format("Failed to create directory %s", dest.argument().cstring());
+		return -1;
+	}
+
+	int result = 0;
+	for(const auto & entry: list){
+		const var::String source_path = src.argument() + "/" + entry;
+		const var::String destination_path = dest.argument() + "/" + entry;
+
+		const var::String parent_path = File::parent_directory(destination_path);
+		if( (parent_path != dest.argument()) &&
+				!Dir::exists(parent_path, Dir::LinkDriver(destination_driver)) ){
+			if( Dir::create(
+						parent_path,
+						Permissions(0777),
+						Dir::IsRecursive(true),
+						Dir::LinkDriver(destination_driver)
+						) < 0 ){
+				m_error_message.format("Failed to create directory %s", parent_path.cstring());
+				result = -1;
+				break;
+			}
+		}
+
+		if( (result = copy_file_contents(
+					 SourcePath(source_path),
+					 DestinationPath(destination_path),
+					 permissions,
+					 is_to_device,
+					 progress_callback
+					 )) < 0 ){
+			break;
+		}
+	}
+
+	if( progress_callback ){ progress_callback->update(0,0); }
+	return result;
+}
+
+int Link::copy_file_contents(
+		SourcePath src,
+		DestinationPath dest,
+		const Permissions & permissions,
+		IsCopyToDevice is_to_device,
+		const ProgressCallback * progress_callback
+		){
+	SYS_TRACE_SCOPE("Link::copy_file_contents", is_to_device.argument());
+	struct link_stat st;
+	File host_file;
+	File device_file = File(
+				fs::File::LinkDriver(driver())
+				);
+
+	//when copying a single file, m_progress_max is zero at this point
+	const bool is_single_file = (m_progress_max == 0);
+
+	if ( is_to_device.argument() == true ){
 
 		//Open the host file
 		if( host_file.open(
@@ -861,13 +995,8 @@ int Link::copy(
 			return -1;
 		}
 
-		m_progress_max =
-				static_cast<int>(host_file.size());
-		if( host_file.size() > 256*50 ){
-			copy_page_size = host_file.size() / 50;
-			copy_page_size -= (copy_page_size % 1024);
-		} else {
-			copy_page_size = 256;
+		if( is_single_file ){
+			m_progress_max = static_cast<int>(host_file.size());
 		}
 
 		var::String dest_file = dest.argument();
@@ -888,7 +1017,11 @@ int Link::copy(
 						);
 			if( result < 0 ){
 				m_error_message.format("Failed to write file %s on device", dest.argument().cstring());
+				return -1;
 			}
+			m_progress += static_cast<int>(host_file.size());
+			m_transfer_statistics.m_bytes += host_file.size();
+			m_transfer_statistics.m_file_count++;
 
 		} else {
 
@@ -904,27 +1037,26 @@ int Link::copy(
 			}
 
 			m_error_message = "";
-			int result = device_file.write(
+			int result = transfer(
+						device_file,
 						host_file,
-						fs::File::PageSize(
-							static_cast<u32>(copy_page_size)
-							),
-						fs::File::Size(host_file.size()),
+						host_file.size(),
 						progress_callback
 						);
-			if( result < 0 ){
 
-			}
 			if( device_file.close() < 0 ){
 				m_error_message.format("Failed to close Link device file (%d)", link_errno);
 
 				return -1;
 			}
 
-		}
+			if( result < 0 ){
+				return -1;
+			}
 
+		}
 
-		return err;
+		return 0;
 
 	} else {
 
@@ -934,8 +1066,6 @@ int Link::copy(
 			return -1;
 		}
 
-		m_progress = 0;
-		m_progress_max = 0;
 		//Copy the source file from the device to the host
 		if( host_file.create(
 					dest.argument(),
@@ -960,23 +1090,16 @@ int Link::copy(
 			return -1;
 		}
 
-		m_progress_max = st.st_size;
-		if( device_file.size() > 256*50 ){
-			copy_page_size = device_file.size() / 50;
-		} else {
-			copy_page_size = 256;
+		if( is_single_file ){
+			m_progress_max = st.st_size;
 		}
 
-		if( host_file.write(
+		int result = transfer(
+					host_file,
 					device_file,
-					fs::File::PageSize(copy_page_size),
-					fs::File::Size(device_file.size()),
+					st.st_size,
 					progress_callback
-					) < 0 ){
-			m_error_message.format(
-						"failed to write to host file"
-						);
-		}
+					);
 
 		if( device_file.close() < 0 ){
 			m_error_message.format(
@@ -995,10 +1118,106 @@ int Link::copy(
 			return -1;
 		}
 
+		if( result < 0 ){
+			return -1;
+		}
+
 	}
 	return 0;
 }
 
+int Link::transfer(
+		const fs::File & destination,
+		const fs::File & source,
+		u32 size,
+		const ProgressCallback * progress_callback
+		){
+
+	//start where the last transfer left off
+	u32 page_size = m_transfer_statistics.m_page_size;
+	if( page_size < m_transfer_page_size_minimum ){
+		page_size = m_transfer_page_size_minimum;
+	}
+	if( page_size > m_transfer_page_size_maximum ){
+		page_size = m_transfer_page_size_maximum;
+	}
+
+	var::Data buffer(
+				size < m_transfer_page_size_maximum ?
+					size : m_transfer_page_size_maximum
+				);
+
+	chrono::Timer timer;
+	float best_rate = 0.0f;
+	bool is_page_size_settled = false;
+	u32 bytes_transferred = 0;
+
+	while( bytes_transferred < size ){
+		u32 page = size - bytes_transferred;
+		if( page > page_size ){
+			page = page_size;
+		}
+
+		timer.restart();
+		int bytes_read = source.read(
+					buffer.to_void(),
+					File::Size(page)
+					);
+		if( bytes_read <= 0 ){
+			m_error_message = "Failed to read source file";
+			return -1;
+		}
+
+		int bytes_written = destination.write(
+					buffer.to_const_void(),
+					File::Size(static_cast<u32>(bytes_read))
+					);
+		timer.stop();
+
+		if( bytes_written != bytes_read ){
+			m_error_message.format("Failed to write destination file (%d)", link_errno);
+			return -1;
+		}
+
+		const u32 microseconds = timer.microseconds();
+		bytes_transferred += static_cast<u32>(bytes_read);
+		m_transfer_statistics.m_bytes += static_cast<u32>(bytes_read);
+		m_transfer_statistics.m_microseconds += microseconds;
+
+		//only full pages are a fair measure of the page size
+		if( (microseconds > 0) && (static_cast<u32>(bytes_read) == page_size) ){
+			const float rate =
+					static_cast<float>(bytes_read) / static_cast<float>(microseconds);
+			if( rate > best_rate * 1.1f ){
+				//fewer round trips are still paying off
+				best_rate = rate;
+				if( (is_page_size_settled == false) && (page_size * 2 <= buffer.size()) ){
+					page_size *= 2;
+				}
+			} else if( rate < best_rate * 0.5f ){
+				//best_rate is kept so the smaller page isn't mistaken for
+				//an improvement and doubled again: the size stays put
+				//for the rest of this transfer
+				is_page_size_settled = true;
+				if( page_size / 2 >= m_transfer_page_size_minimum ){
+					page_size /= 2;
+				}
+			}
+		}
+
+		m_progress += bytes_read;
+		if( progress_callback &&
+				(progress_callback->update(m_progress, m_progress_max) == true) ){
+			m_error_message = "Operation cancelled";
+			return -1;
+		}
+	}
+
+	m_transfer_statistics.m_page_size = page_size;
+	m_transfer_statistics.m_file_count++;
+	return static_cast<int>(bytes_transferred);
+}
+
 int Link::run_app(const var::String & path){
 	int err = -1;
 	if ( m_is_bootloader ){
@@ -1178,11 +1397,7 @@ int Link::get_bootloader_attr(bootloader_attr_t & attr){
 		return -1;
 	}
 
-	if( m_is_legacy ){
-		err = link_bootloader_attr_legacy(driver(), &attr, 0);
-	} else {
-		err = link_bootloader_attr(driver(), &attr, 0);
-	}
+	err = read_bootloader_attributes(attr);
 	if( err < 0 ){
 		m_error_message = "Failed to read attributes";
 		return -1;
@@ -1191,6 +1406,54 @@ int Link::get_bootloader_attr(bootloader_attr_t & attr){
 	return 0;
 }
 
+int Link::read_bootloader_attributes(bootloader_attr_t & attributes){
+	if( m_is_legacy ){
+		return link_bootloader_attr_legacy(driver(), &attributes, 0);
+	}
+	return link_bootloader_attr(driver(), &attributes, 0);
+}
+
+int Link::read_bootloader_flash(u32 address, void * buffer, u32 size){
+	return link_readflash(driver(), address, buffer, size);
+}
+
+int Link::write_bootloader_flash(u32 address, const void * buffer, u32 size){
+	return link_writeflash(driver(), address, buffer, size);
+}
+
+int Link::erase_bootloader_flash(){
+	return link_eraseflash(driver());
+}
+
+int Link::wait_for_bootloader(
+		BootloaderRetryCount bootloader_retry_total,
+		const ProgressCallback * progress_callback
+		){
+	bootloader_attr_t attr;
+	memset(&attr, 0, sizeof(attr));
+	int err;
+	int retry = 0;
+	do {
+		chrono::wait(chrono::Milliseconds(500));
+		err = get_bootloader_attr(attr);
+		if( progress_callback ){
+			progress_callback->update(
+						retry,
+						ProgressCallback::indeterminate_progress_total()
+						);
+		}
+	} while (
+					 (err < 0) &&
+					 (retry++ < bootloader_retry_total.argument())
+					 );
+
+	chrono::wait(chrono::Milliseconds(250));
+
+	//flush just incase the protocol gets filled with get attr requests
+	driver()->phy_driver.flush( driver()->phy_driver.handle );
+	return err;
+}
+
 u32 Link::validate_os_image_id_with_connected_bootloader(
 		const File & source_image
 		){
@@ -1261,7 +1524,7 @@ int Link::erase_os(
 		progress_callback->update(0, ProgressCallback::indeterminate_progress_total());
 	}
 	//first erase the flash
-	err = link_eraseflash(driver());
+	err = erase_bootloader_flash();
 
 	if ( err < 0 ){
 		if( progress_callback ){ progress_callback->update(0, 0); }
@@ -1269,27 +1532,7 @@ int Link::erase_os(
 		return check_error(err);
 	}
 
-	bootloader_attr_t attr;
-	memset(&attr, 0, sizeof(attr));
-	int retry = 0;
-	do {
-		chrono::wait(chrono::Milliseconds(500));
-		err = get_bootloader_attr(attr);
-		if( progress_callback ){
-			progress_callback->update(
-						retry,
-						ProgressCallback::indeterminate_progress_total()
-						);
-		}
-	} while (
-					 (err < 0) &&
-					 (retry++ < bootloader_retry_total.argument())
-					 );
-
-	chrono::wait(chrono::Milliseconds(250));
-
-	//flush just incase the protocol gets filled with get attr requests
-	driver()->phy_driver.flush( driver()->phy_driver.handle );
+	err = wait_for_bootloader(bootloader_retry_total, progress_callback);
 
 	if( progress_callback ){ progress_callback->update(0, 0); }
 
@@ -1304,11 +1547,112 @@ int Link::erase_os(
 	return 0;
 }
 
+static bool is_erased_page(const var::Data & page, int size){
+	const u8 * bytes = page.to_const_u8();
+	for(int i=0; i < size; i++){
+		if( bytes[i] != 0xff ){
+			return false;
+		}
+	}
+	return true;
+}
+
+int Link::compare_os(
+		const fs::File & image,
+		HardwareId image_id,
+		Printer & progress_printer
+		){
+
+	int err = 0;
+	int bytes_read;
+	const int buffer_size = 1024;
+
+	const sys::ProgressCallback * progress_callback =
+			progress_printer.progress_callback();
+
+	var::Data buffer(buffer_size);
+	var::Data compare_buffer(buffer_size);
+
+	if( image.seek(File::Location(0), File::whence_set) < 0 ){
+		m_error_message = "Failed to seek bootloader image start";
+		return -1;
+	}
+
+	const u32 start_address = m_bootloader_attributes.startaddr;
+	u32 loc = start_address;
+	int result = 0;
+
+	progress_printer.progress_key() = "comparing";
+	m_progress = 0;
+
+	while(
+				(bytes_read = image.read(buffer)) > 0
+				){
+
+		if( (err = read_bootloader_flash(
+					 loc,
+					 compare_buffer.to_void(),
+					 bytes_read)
+				 ) != bytes_read ){
+			m_error_message.format("Failed to read flash memory at 0x%x (%d)", loc, err);
+			result = -1;
+			break;
+		}
+
+		m_update_statistics.m_bytes_compared += static_cast<u32>(bytes_read);
+
+		if( (loc == start_address) &&
+				(image_id.argument() != m_bootloader_attributes.hardware_id) &&
+				(bytes_read >= static_cast<int>(BOOTLOADER_HARDWARE_ID_OFFSET + sizeof(u32))) ){
+			//install_os() corrects the hardware ID in the start block
+			var::Reference::memory_copy(
+						var::Reference::SourceBuffer(&m_bootloader_attributes.hardware_id),
+						var::Reference::DestinationBuffer(buffer.to_u8() + BOOTLOADER_HARDWARE_ID_OFFSET),
+						File::Size( sizeof(u32) )
+						);
+		}
+
+		if( memcmp(
+					buffer.to_const_void(),
+					compare_buffer.to_const_void(),
+					static_cast<size_t>(bytes_read)
+					) != 0 ){
+			//the first page that differs means the OS must be re-installed
+			result = 1;
+			break;
+		}
+
+		loc += bytes_read;
+		m_progress += bytes_read;
+		if( progress_callback && (progress_callback->update(m_progress, m_progress_max) == true)){
+			m_error_message = "Operation cancelled";
+			result = -1;
+			break;
+		}
+	}
+
+	if( bytes_read < 0 ){
+		m_error_message = "Failed to read bootloader image";
+		result = -1;
+	}
+
+	if( progress_callback ){ progress_callback->update(0,0); }
+
+	m_progress = 0;
+	if( image.seek(File::Location(0), File::whence_set) < 0 ){
+		m_error_message = "Failed to seek bootloader image start";
+		return -1;
+	}
+
+	return result;
+}
+
 int Link::install_os(
 		const fs::File & image,
 		IsVerify is_verify,
 		HardwareId image_id,
-		Printer & progress_printer
+		Printer & progress_printer,
+		IsSkipIfIdentical is_skip_if_identical
 		){
 
 	//must be connected to the bootloader with an erased OS
@@ -1371,10 +1715,19 @@ int Link::install_os(
 						var::Reference::Count(start_address_buffer.size())
 						);
 
+		} else if( is_skip_if_identical.argument() && is_erased_page(buffer, bytes_read) ){
+			//the erased flash already matches this page
+			m_update_statistics.m_bytes_skipped += static_cast<u32>(bytes_read);
+			loc += bytes_read;
+			m_progress += bytes_read;
+			if( progress_callback && (progress_callback->update(m_progress, m_progress_max) == true)){
+				break;
+			}
+			err = 0;
+			continue;
 		}
 
-		if ( (err = link_writeflash(
-						driver(),
+		if ( (err = write_bootloader_flash(
 						loc,
 						buffer.to_const_void(),
 						bytes_read
@@ -1390,7 +1743,7 @@ int Link::install_os(
 			break;
 		}
 
-
+		m_update_statistics.m_bytes_written += static_cast<u32>(bytes_read);
 		loc += bytes_read;
 		m_progress += bytes_read;
 		if( progress_callback && (progress_callback->update(m_progress, m_progress_max) == true)){
@@ -1413,8 +1766,7 @@ int Link::install_os(
 						(bytes_read = image.read(buffer)) > 0
 						){
 
-				if ( (err = link_readflash(
-								driver(),
+				if ( (err = read_bootloader_flash(
 								loc,
 								compare_buffer.to_void(),
 								bytes_read)
@@ -1427,6 +1779,8 @@ int Link::install_os(
 
 				} else {
 
+					m_update_statistics.m_bytes_verified += static_cast<u32>(bytes_read);
+
 					if( loc == start_address ){
 						buffer.fill(
 									(u8)0xff,
@@ -1464,8 +1818,7 @@ int Link::install_os(
 		}
 
 		//write the start block
-		if( (err = link_writeflash(
-					 driver(),
+		if( (err = write_bootloader_flash(
 					 start_address,
 					 start_address_buffer.to_const_void(),
 					 start_address_buffer.size())
@@ -1484,16 +1837,16 @@ int Link::install_os(
 						SYSFS_GET_RETURN_ERRNO(err)
 						);
 
-			link_eraseflash(driver());
+			erase_bootloader_flash();
 			return -1;
 		}
 
+		m_update_statistics.m_bytes_written += start_address_buffer.size();
 
 		if( is_verify.argument() == true ){
 			//verify the stack address
 			buffer.resize( start_address_buffer.size() );
-			if( (err = link_readflash(
-						 driver(),
+			if( (err = read_bootloader_flash(
 						 start_address,
 						 buffer.to_void(),
 						 start_address_buffer.size())
@@ -1507,7 +1860,7 @@ int Link::install_os(
 			if( buffer != start_address_buffer ){
 				m_error_message = "Failed to verify stack address block";
 				if( progress_callback ){ progress_callback->update(0,0); }
-				link_eraseflash(driver());
+				erase_bootloader_flash();
 				return -1;
 			}
 		}
@@ -1522,9 +1875,12 @@ int Link::update_os(
 		const fs::File & image,
 		IsVerify is_verify,
 		sys::Printer & progress_printer,
-		BootloaderRetryCount bootloader_retry_total
+		BootloaderRetryCount bootloader_retry_total,
+		IsSkipIfIdentical is_skip_if_identical
 		){
 
+	m_update_statistics = UpdateStatistics();
+
 	u32 image_id = validate_os_image_id_with_connected_bootloader(
 				image
 				);
@@ -1539,6 +1895,30 @@ int Link::update_os(
 
 	var::String progress_key = progress_printer.progress_key();
 
+	if( is_skip_if_identical.argument() ){
+		int result = compare_os(
+					image,
+					HardwareId(image_id),
+					progress_printer
+					);
+
+		if( result < 0 ){
+			progress_printer.error("failed to compare os '%s'",
+														 error_message().cstring()
+														 );
+			progress_printer.progress_key() = progress_key;
+			return -1;
+		}
+
+		if( result == 0 ){
+			//the installed image is identical: nothing to erase or write
+			m_update_statistics.m_bytes_skipped = static_cast<u32>(image.size());
+			m_update_statistics.m_is_up_to_date = true;
+			progress_printer.progress_key() = progress_key;
+			return 0;
+		}
+	}
+
 	if( erase_os(
 				progress_printer,
 				bootloader_retry_total
@@ -1555,7 +1935,8 @@ int Link::update_os(
 				image,
 				is_verify,
 				HardwareId(image_id),
-				progress_printer
+				progress_printer,
+				is_skip_if_identical
 				) < 0 ){
 		progress_printer.error("failed to install os '%s'",
 													 error_message().cstring()
@@ -1818,6 +2199,12 @@ int Link::install_app(
 
 		bytes_total = application_image.size();
 		bytes_cumm = 0;
+
+		//the install page size is fixed by the appfs protocol
+		m_transfer_statistics = TransferStatistics();
+		m_transfer_statistics.m_page_size = APPFS_PAGE_SIZE;
+		chrono::Timer timer;
+		timer.start();
 		//make sure to instal from the beginning -- file is already open
 		application_image.seek( File::Location(0), File::whence_set );
 
@@ -1876,6 +2263,11 @@ int Link::install_app(
 			}
 		} while( bytes_read == APPFS_PAGE_SIZE );
 
+		timer.stop();
+		m_transfer_statistics.m_bytes = static_cast<u32>(bytes_cumm);
+		m_transfer_statistics.m_microseconds = timer.microseconds();
+		m_transfer_statistics.m_file_count = 1;
+
 		if( close(fd) < 0 ){
 			m_error_message.format(
 						"Failed to close file on device (%d)",
@@ -1904,12 +2296,19 @@ int Link::install_app(
 			return -1;
 		}
 
-		if( f.write(
+		m_transfer_statistics = TransferStatistics();
+		m_progress = 0;
+		m_progress_max = static_cast<int>(application_image.size());
+		application_image.seek( File::Location(0), File::whence_set );
+
+		if( transfer(
+					f,
 					application_image,
-					File::PageSize(APPFS_PAGE_SIZE),
-					File::Size(application_image.size()),
+					application_image.size(),
 					progress_callback
 					) < 0 ){
+			f.close();
+			if( progress_callback ){ progress_callback->update(0,0); }
 			return -1;
 		}
 
@@ -1,6 +1,7 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 
 #include <cstdarg>
+#include <cstring>
 #if defined __win32
 #include <windows.h>
 #endif
@@ -33,6 +34,8 @@ unsigned int sys::Printer::m_default_color = static_cast<unsigned int>(-1);
 
 using namespace sys;
 
+StandardOutputPrinterSink Printer::m_standard_output_sink;
+
 Printer::Printer() : m_progress_callback(Printer::update_progress_callback, this){
 	m_o_flags = print_8 | print_hex;
 	m_indent = 0;
@@ -40,6 +43,9 @@ Printer::Printer() : m_progress_callback(Printer::update_progress_callback, this
 	m_progress_state = 0;
 	m_verbose_level = level_info;
 	m_progress_key = "progress";
+	m_sink = &m_standard_output_sink;
+	m_buffer_size = 1024;
+	m_flush_mode = flush_newline;
 #if defined __win32
 	if( m_default_color == static_cast<unsigned int>(-1) ){
 		CONSOLE_SCREEN_BUFFER_INFO info;
@@ -79,6 +85,8 @@ void Printer::set_color_code(u32 code){
 #endif
 
 #if defined __link && defined __win32
+	//text that is already buffered must be printed in the old color
+	flush();
 	WORD color = static_cast<WORD>(m_default_color);
 	switch(code){
 		case color_code_default: color = static_cast<WORD>(m_default_color); break;
@@ -162,9 +170,68 @@ void Printer::print(
 void Printer::print_final(const char * fmt, ...){
 	va_list list;
 	va_start(list, fmt);
-	vprintf(fmt, list);
+	if( ::strchr(fmt, '%') == nullptr ){
+		print_final_buffer(fmt, ::strlen(fmt));
+	} else if( ::strcmp(fmt, "%s") == 0 ){
+		const char * value = va_arg(list, const char *);
+		print_final_buffer(value, ::strlen(value));
+	} else {
+		char scratch[128];
+		va_list copy;
+		va_copy(copy, list);
+		int length = vsnprintf(scratch, sizeof(scratch), fmt, list);
+		if( length >= static_cast<int>(sizeof(scratch)) ){
+			var::String formatted;
+			formatted.vformat(fmt, copy);
+			print_final_buffer(formatted.cstring(), formatted.length());
+		} else if( length > 0 ){
+			print_final_buffer(scratch, static_cast<u32>(length));
+		}
+		va_end(copy);
+	}
 	va_end(list);
-	fflush(stdout);
+}
+
+void Printer::print_final_buffer(const char * buffer, u32 size){
+	m_output.string().append(buffer, size);
+
+	if( m_flush_mode == flush_explicit ){
+		return;
+	}
+
+	if( (m_flush_mode == flush_newline) &&
+			(::memchr(buffer, '\n', size) != nullptr) ){
+		flush();
+	} else if( m_output.length() >= m_buffer_size ){
+		write_output();
+	}
+}
+
+int Printer::write_output(){
+	int result = 0;
+	if( m_output.is_empty() == false ){
+		result = m_sink->write(m_output.cstring(), m_output.length());
+		//clear() keeps the capacity so the buffer is only allocated once
+		m_output.string().clear();
+	}
+	return result;
+}
+
+int Printer::flush(){
+	if( write_output() < 0 ){
+		return -1;
+	}
+	return m_sink->flush();
+}
+
+Printer & Printer::set_sink(PrinterSink & sink){
+	flush();
+	m_sink = &sink;
+	return *this;
+}
+
+Printer & Printer::set_standard_output_sink(){
+	return set_sink(m_standard_output_sink);
 }
 
 Printer & Printer::open_object(
@@ -250,7 +317,9 @@ u32 Printer::color_code(const var::String & color){
 }
 
 
-Printer::~Printer(){}
+Printer::~Printer(){
+	flush();
+}
 
 #if 0
 void Printer::vprint(const char * fmt, va_list list){
@@ -394,7 +463,7 @@ bool Printer::update_progress(int progress, int total){
 				}
 			}
 			m_progress_state++;
-			fflush(stdout);
+			flush();
 		}
 
 		if( m_progress_state	> 0 ){
@@ -428,7 +497,6 @@ bool Printer::update_progress(int progress, int total){
 						 ){
 					print_final("#");
 					m_progress_state++;
-					fflush(stdout);
 				}
 
 				if( (progress >= total) || (total == 0) ){
@@ -444,6 +512,7 @@ bool Printer::update_progress(int progress, int total){
 				print_final("\"");
 			}
 		}
+		flush();
 	}
 
 	return false;
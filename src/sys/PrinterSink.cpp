@@ -0,0 +1,19 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstdio>
+#include "sys/PrinterSink.hpp"
+#include "fs/File.hpp"
+
+using namespace sys;
+
+int StandardOutputPrinterSink::write(const char * buffer, u32 size){
+	return static_cast<int>(fwrite(buffer, 1, size, stdout));
+}
+
+int StandardOutputPrinterSink::flush(){
+	return fflush(stdout);
+}
+
+int FilePrinterSink::write(const char * buffer, u32 size){
+	return m_file.write(buffer, fs::File::Size(size));
+}
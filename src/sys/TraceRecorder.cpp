@@ -0,0 +1,415 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+#include <time.h>
+#include <unistd.h>
+#include "sys/TraceRecorder.hpp"
+#include "sys/Mutex.hpp"
+#include "sys/Thread.hpp"
+#include "var/SpscRing.hpp"
+#include "fs/File.hpp"
+
+using namespace sys;
+
+std::atomic<bool> TraceRecorder::m_is_active(false);
+
+namespace {
+
+struct ThreadBuffer {
+	ThreadBuffer(u32 count, u32 id) : ring(count){
+		buffer_count = count;
+		thread_id = id;
+		dropped_count = 0;
+		is_orphaned = false;
+	}
+
+	var::SpscRing<TraceRecord> ring;
+	u32 buffer_count;
+	u32 thread_id;
+	std::atomic<u32> dropped_count;
+	//set (while holding the mutex) when the thread that owns the buffer exits
+	bool is_orphaned;
+};
+
+//only the owning thread pushes to its buffer so only it (or its exit) can release the buffer
+struct ThreadBufferReference {
+	~ThreadBufferReference();
+	ThreadBuffer * buffer;
+	u32 generation;
+};
+
+//the state is only touched while holding the mutex (except the per-thread ring buffers)
+struct State {
+	Mutex mutex;
+	var::Vector<var::String> event_name_list;
+	var::Vector<ThreadBuffer*> buffer_list;
+	var::Vector<TraceRecord> record_list;
+	u32 buffer_count = 4096;
+	u32 drain_interval = 10000;
+	u32 dropped_count = 0;
+	u32 next_thread_id = 1;
+	std::atomic<u32> generation{1};
+	std::atomic<bool> is_drain_stopped{true};
+	//a new thread is created by each start() (nullptr while stopped)
+	Thread * drain_thread = nullptr;
+	u64 start_timestamp = 0;
+};
+
+State & state(){
+	//the recorder outlives any memory resource the caller has installed
+	static State * result = [](){
+		var::MemoryResourceScope heap_scope(nullptr);
+		return new State();
+	}();
+	return *result;
+}
+
+thread_local ThreadBufferReference thread_buffer_reference = { nullptr, 0 };
+
+ThreadBufferReference::~ThreadBufferReference(){
+	if( buffer ){
+		State & s = state();
+		s.mutex.lock();
+		//start() frees it (the records are drained until then)
+		buffer->is_orphaned = true;
+		s.mutex.unlock();
+	}
+}
+
+u64 get_timestamp(){
+	struct timespec now;
+	::clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<u64>(now.tv_sec) * 1000000000ULL + static_cast<u64>(now.tv_nsec);
+}
+
+ThreadBuffer * get_thread_buffer(){
+	State & s = state();
+	const u32 generation = s.generation.load(std::memory_order_acquire);
+	ThreadBuffer * buffer = thread_buffer_reference.buffer;
+	if( thread_buffer_reference.generation == generation ){
+		return buffer;
+	}
+
+	//first record on this thread since start()
+	var::MemoryResourceScope heap_scope(nullptr);
+	s.mutex.lock();
+	if( buffer && (buffer->buffer_count != s.buffer_count) ){
+		//start() changed the size: this thread is the only one that can be using the buffer
+		for(u32 i=0; i < s.buffer_list.count(); i++){
+			if( s.buffer_list.at(i) == buffer ){
+				s.buffer_list.vector().erase(s.buffer_list.vector().begin() + i);
+				break;
+			}
+		}
+		delete buffer;
+		buffer = nullptr;
+	}
+
+	if( buffer == nullptr ){
+		buffer = new ThreadBuffer(
+					s.buffer_count,
+					s.next_thread_id++
+					);
+		s.buffer_list.push_back(buffer);
+	}
+	s.mutex.unlock();
+
+	thread_buffer_reference.buffer = buffer;
+	thread_buffer_reference.generation = generation;
+	return buffer;
+}
+
+void drain(){
+	State & s = state();
+	TraceRecord record_list[128];
+	s.mutex.lock();
+	for(ThreadBuffer * buffer: s.buffer_list){
+		u32 count;
+		while( (count = buffer->ring.pop_batch(record_list, 128)) > 0 ){
+			for(u32 i=0; i < count; i++){
+				//recorded while start() was discarding the last recording
+				if( record_list[i].timestamp >= s.start_timestamp ){
+					s.record_list.push_back(record_list[i]);
+				}
+			}
+		}
+	}
+	s.mutex.unlock();
+}
+
+void * drain_thread_function(void * args){
+	MCU_UNUSED_ARGUMENT(args);
+	State & s = state();
+	while( s.is_drain_stopped == false ){
+		drain();
+		chrono::wait(chrono::Microseconds(s.drain_interval));
+	}
+	return nullptr;
+}
+
+void append_json_string(var::String & output, const var::String & value){
+	output << "\"";
+	for(u32 i=0; i < value.length(); i++){
+		const char c = value.cstring()[i];
+		if( (c == '"') || (c == '\\') ){
+			output << "\\";
+		}
+		if( static_cast<u8>(c) >= 0x20 ){
+			output.string().push_back(c);
+		} else {
+			//control characters aren't allowed in a JSON string
+			output << "\\u00";
+			output.string().push_back("0123456789abcdef"[static_cast<u8>(c) >> 4]);
+			output.string().push_back("0123456789abcdef"[static_cast<u8>(c) & 0x0f]);
+		}
+	}
+	output << "\"";
+}
+
+}
+
+int TraceRecorder::start(
+		BufferCount buffer_count,
+		DrainInterval drain_interval
+		){
+	stop();
+
+	State & s = state();
+	TraceRecord record_list[128];
+	s.mutex.lock();
+	//other threads may be recording: their buffers are emptied rather than freed
+	var::Vector<ThreadBuffer*> buffer_list;
+	for(ThreadBuffer * buffer: s.buffer_list){
+		if( buffer->is_orphaned ){
+			delete buffer;
+			continue;
+		}
+		while( buffer->ring.pop_batch(record_list, 128) > 0 ){}
+		buffer->dropped_count.store(0, std::memory_order_relaxed);
+		buffer_list.push_back(buffer);
+	}
+	s.buffer_list = buffer_list;
+	s.record_list.clear();
+	s.dropped_count = 0;
+	s.buffer_count = buffer_count.argument();
+	s.drain_interval = drain_interval.argument().microseconds();
+	s.start_timestamp = get_timestamp();
+	//threads that recorded before check the buffer size on their next record
+	s.generation.fetch_add(1, std::memory_order_release);
+	s.is_drain_stopped = false;
+	s.mutex.unlock();
+
+	//the stack size has to be set when the thread is constructed
+	s.drain_thread = new Thread(
+				Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE),
+				Thread::IsDetached(false)
+				);
+	if( s.drain_thread->create(
+				Thread::Function(drain_thread_function),
+				Thread::FunctionArgument(nullptr)
+				) < 0 ){
+		delete s.drain_thread;
+		s.drain_thread = nullptr;
+		s.is_drain_stopped = true;
+		return -1;
+	}
+
+	m_is_active.store(true, std::memory_order_release);
+	return 0;
+}
+
+void TraceRecorder::stop(){
+	State & s = state();
+	m_is_active.store(false, std::memory_order_release);
+	s.is_drain_stopped = true;
+	if( s.drain_thread ){
+		s.drain_thread->join();
+		delete s.drain_thread;
+		s.drain_thread = nullptr;
+	}
+	drain();
+
+	s.mutex.lock();
+	u32 dropped_count = 0;
+	for(ThreadBuffer * buffer: s.buffer_list){
+		dropped_count += buffer->dropped_count.load(std::memory_order_relaxed);
+	}
+	s.dropped_count = dropped_count;
+	s.mutex.unlock();
+}
+
+u16 TraceRecorder::register_event(const char * name){
+	State & s = state();
+	var::MemoryResourceScope heap_scope(nullptr);
+	s.mutex.lock();
+	u32 result;
+	for(result = 0; result < s.event_name_list.count(); result++){
+		if( s.event_name_list.at(result) == name ){
+			break;
+		}
+	}
+	if( result == s.event_name_list.count() ){
+		s.event_name_list.push_back(var::String(name));
+	}
+	s.mutex.unlock();
+	return static_cast<u16>(result);
+}
+
+var::String TraceRecorder::event_name(u16 event_id){
+	State & s = state();
+	var::String result;
+	s.mutex.lock();
+	if( event_id < s.event_name_list.count() ){
+		result = s.event_name_list.at(event_id);
+	}
+	s.mutex.unlock();
+	return result;
+}
+
+void TraceRecorder::record_active(
+		enum TraceRecord::types type,
+		u16 event_id,
+		const TraceArgumentList & argument_list
+		){
+	ThreadBuffer * buffer = get_thread_buffer();
+	TraceRecord record;
+	record.timestamp = get_timestamp();
+	record.thread_id = buffer->thread_id;
+	record.event_id = event_id;
+	record.type = static_cast<u8>(type);
+	record.argument_count = argument_list.count();
+	for(u8 i=0; i < argument_list.count(); i++){
+		record.argument_list[i] = argument_list.at(i);
+	}
+
+	if( buffer->ring.push(record) < 0 ){
+		buffer->dropped_count.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+var::Vector<TraceRecord> TraceRecorder::record_list(){
+	State & s = state();
+	s.mutex.lock();
+	var::Vector<TraceRecord> result = s.record_list;
+	s.mutex.unlock();
+	return result;
+}
+
+u32 TraceRecorder::dropped_count(){
+	State & s = state();
+	s.mutex.lock();
+	u32 result = s.dropped_count;
+	s.mutex.unlock();
+	return result;
+}
+
+var::String TraceRecorder::to_chrome_trace(){
+	State & s = state();
+	var::String result;
+	s.mutex.lock();
+
+	const int pid = ::getpid();
+	result << "{\"traceEvents\":[";
+	for(u32 i=0; i < s.record_list.count(); i++){
+		const TraceRecord & record = s.record_list.at(i);
+		const char * phase;
+		switch(record.type){
+			case TraceRecord::type_begin: phase = "B"; break;
+			case TraceRecord::type_end: phase = "E"; break;
+			case TraceRecord::type_counter: phase = "C"; break;
+			default: phase = "i"; break;
+		}
+
+		if( i ){ result << ","; }
+		result << "\n{\"name\":";
+		append_json_string(
+					result,
+					record.event_id < s.event_name_list.count() ?
+						s.event_name_list.at(record.event_id) :
+						var::String()
+						);
+
+		//chrome timestamps are microseconds
+		const u64 nanoseconds = record.timestamp - s.start_timestamp;
+		result << var::String().format(
+								",\"ph\":\"%s\",\"ts\":%llu.%03u,\"pid\":%d,\"tid\":%lu",
+								phase,
+								static_cast<unsigned long long>(nanoseconds / 1000),
+								static_cast<unsigned>(nanoseconds % 1000),
+								pid,
+								static_cast<unsigned long>(record.thread_id)
+								);
+
+		if( record.type == TraceRecord::type_instant ){
+			result << ",\"s\":\"t\"";
+		}
+
+		if( record.argument_count ){
+			result << ",\"args\":{";
+			for(u8 j=0; j < record.argument_count; j++){
+				if( record.type == TraceRecord::type_counter ){
+					result << "\"value\":";
+				} else {
+					result << var::String().format("%s\"arg%d\":", j ? "," : "", j);
+				}
+				result << var::String::number(record.argument_list[j]);
+				if( record.type == TraceRecord::type_counter ){ break; }
+			}
+			result << "}";
+		}
+		result << "}";
+	}
+	result << "\n]}\n";
+
+	s.mutex.unlock();
+	return result;
+}
+
+int TraceRecorder::save_chrome_trace(const var::String & path){
+	const var::String trace = to_chrome_trace();
+	fs::File file;
+	if( file.create(path, fs::File::IsOverwrite(true)) < 0 ){
+		return -1;
+	}
+	if( file.write(trace.cstring(), fs::File::Size(trace.length())) !=
+			static_cast<int>(trace.length()) ){
+		return -1;
+	}
+	return 0;
+}
+
+var::Vector<TraceEvent> TraceRecorder::to_trace_event_list(){
+	State & s = state();
+	var::Vector<TraceEvent> result;
+	s.mutex.lock();
+	for(u32 i=0; i < s.record_list.count(); i++){
+		const TraceRecord & record = s.record_list.at(i);
+		TraceEvent trace_event;
+		link_trace_event_t & event = trace_event.event();
+		event.posix_trace_event.posix_event_id = LINK_POSIX_TRACE_MESSAGE;
+		event.posix_trace_event.posix_thread_id = static_cast<u16>(record.thread_id);
+		event.posix_trace_event.posix_timestamp_tv_sec =
+				static_cast<u32>(record.timestamp / 1000000000ULL);
+		event.posix_trace_event.posix_timestamp_tv_nsec =
+				static_cast<u32>(record.timestamp % 1000000000ULL);
+
+		var::String message;
+		if( record.type == TraceRecord::type_begin ){ message << ">"; }
+		if( record.type == TraceRecord::type_end ){ message << "<"; }
+		if( record.event_id < s.event_name_list.count() ){
+			message << s.event_name_list.at(record.event_id);
+		}
+		if( (record.type == TraceRecord::type_counter) && record.argument_count ){
+			message << "=" << var::String::number(record.argument_list[0]);
+		}
+
+		//data is a null-terminated string truncated to fit
+		const u32 length = message.length() < LINK_POSIX_TRACE_DATA_SIZE - 1 ?
+					message.length() : LINK_POSIX_TRACE_DATA_SIZE - 1;
+		::memcpy(event.posix_trace_event.data, message.cstring(), length);
+		event.posix_trace_event.data[length] = 0;
+		result.push_back(trace_event);
+	}
+	s.mutex.unlock();
+	return result;
+}
@@ -0,0 +1,86 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include "sys/WorkerThread.hpp"
+
+using namespace sys;
+
+WorkerThread::WorkerThread(Thread::StackSize stack_size) :
+	m_thread(stack_size, Thread::IsDetached(false)){
+	m_is_running = m_thread.create(
+				Thread::Function(work),
+				Thread::FunctionArgument(this)
+				) == 0;
+}
+
+WorkerThread::~WorkerThread(){
+	if( m_is_running ){
+		m_mutex.lock();
+		while( m_is_busy ){
+			m_cond.wait(m_mutex);
+		}
+		m_is_stop_requested = true;
+		m_cond.broadcast();
+		m_mutex.unlock();
+		m_thread.join();
+	}
+}
+
+int WorkerThread::execute(
+		Thread::Function function,
+		Thread::FunctionArgument argument
+		){
+	if( m_is_running == false ){
+		function.argument()(argument.argument());
+		return 0;
+	}
+
+	m_mutex.lock();
+	while( m_is_busy ){
+		m_cond.wait(m_mutex);
+	}
+	m_function = function.argument();
+	m_argument = argument.argument();
+	m_is_busy = true;
+	m_cond.broadcast();
+	m_mutex.unlock();
+	return 0;
+}
+
+int WorkerThread::wait(){
+	if( m_is_running == false ){
+		return 0;
+	}
+
+	m_mutex.lock();
+	while( m_is_busy ){
+		m_cond.wait(m_mutex);
+	}
+	m_mutex.unlock();
+	return 0;
+}
+
+void * WorkerThread::work(void * args){
+	return static_cast<WorkerThread*>(args)->work();
+}
+
+void * WorkerThread::work(){
+	m_mutex.lock();
+	while( true ){
+		while( (m_is_busy == false) && (m_is_stop_requested == false) ){
+			m_cond.wait(m_mutex);
+		}
+
+		if( m_is_busy == false ){
+			break;
+		}
+
+		m_mutex.unlock();
+		m_function(m_argument);
+		m_mutex.lock();
+
+		m_is_busy = false;
+		m_cond.broadcast();
+	}
+	m_mutex.unlock();
+	return nullptr;
+}
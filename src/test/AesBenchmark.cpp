@@ -0,0 +1,174 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include "test/AesBenchmark.hpp"
+#include "crypto/AesGcm.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace crypto;
+
+AesBenchmark::AesBenchmark(){
+	m_size = 64*1024;
+	m_key_size = 16;
+}
+
+AesBenchmark & AesBenchmark::run(test::Benchmark & benchmark){
+	if( (m_key_size != 16) && (m_key_size != 24) && (m_key_size != 32) ){
+		set_error_number(EINVAL);
+		return *this;
+	}
+
+	var::Data key(m_key_size);
+	var::Data plain(m_size);
+	if( (key.size() != m_key_size) || (plain.size() != m_size) ){
+		set_error_number(ENOMEM);
+		return *this;
+	}
+
+	u32 value = 1;
+	for(u32 i=0; i < m_key_size; i++){
+		value = value * 1664525u + 1013904223u;
+		key.to_u8()[i] = static_cast<u8>(value >> 24);
+	}
+	for(u32 i=0; i < m_size; i++){
+		value = value * 1664525u + 1013904223u;
+		plain.to_u8()[i] = static_cast<u8>(value >> 24);
+	}
+
+	const var::String name =
+			m_prefix + "aes" + var::String::number(m_key_size*8) + ".";
+
+	if( Aes(Aes::backend_auto).is_software() ){
+		run_aes(benchmark, Aes::backend_software, name, key, plain);
+	} else {
+		run_aes(benchmark, Aes::backend_auto, name, key, plain);
+		run_aes(benchmark, Aes::backend_software, name + "software.", key, plain);
+	}
+	run_gcm(benchmark, name, key, plain);
+
+	return *this;
+}
+
+int AesBenchmark::run_aes(
+		test::Benchmark & benchmark,
+		enum Aes::backend backend,
+		const var::String & name,
+		const var::Data & key,
+		const var::Data & plain
+		){
+	var::Data cipher(m_size);
+	var::Data output(m_size);
+	if( (cipher.size() != m_size) || (output.size() != m_size) ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	const Iv iv;
+	Aes aes(backend);
+	if( (aes.initialize() < 0) || (aes.set_key(key).set_initialization_vector(iv).error_number() != 0) ){
+		set_error_number(aes.error_number());
+		return -1;
+	}
+
+	const test::Benchmark::BytesPerIteration bytes(m_size);
+
+	benchmark.run(name + "ecb.encrypt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(
+						aes.encrypt_ecb(
+							Aes::SourcePlainData(plain),
+							Aes::DestinationCipherData(cipher)
+							)
+						);
+		}
+	}, bytes);
+	benchmark.run(name + "ecb.decrypt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(
+						aes.decrypt_ecb(
+							Aes::SourceCipherData(cipher),
+							Aes::DestinationPlainData(output)
+							)
+						);
+		}
+	}, bytes);
+	benchmark.run(name + "cbc.encrypt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(
+						aes.encrypt_cbc(
+							Aes::SourcePlainData(plain),
+							Aes::DestinationCipherData(cipher)
+							)
+						);
+		}
+	}, bytes);
+	benchmark.run(name + "cbc.decrypt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(
+						aes.decrypt_cbc(
+							Aes::SourceCipherData(cipher),
+							Aes::DestinationPlainData(output)
+							)
+						);
+		}
+	}, bytes);
+	benchmark.run(name + "ctr", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(
+						aes.encrypt_ctr(
+							Aes::SourcePlainData(plain),
+							Aes::DestinationCipherData(cipher)
+							)
+						);
+		}
+	}, bytes);
+
+	return 0;
+}
+
+int AesBenchmark::run_gcm(
+		test::Benchmark & benchmark,
+		const var::String & name,
+		const var::Data & key,
+		const var::Data & plain
+		){
+	var::Data cipher(m_size);
+	var::Data output(m_size);
+	if( (cipher.size() != m_size) || (output.size() != m_size) ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	//the same initialization vector is only acceptable because the data is discarded
+	var::Data iv(12);
+	iv.fill<u8>(0);
+
+	AesGcm gcm;
+	gcm.set_key(key);
+	if( (gcm.start(AesGcm::mode_encrypt, iv) < 0) ||
+			(gcm.update(AesGcm::SourceData(plain), AesGcm::DestinationData(cipher)) < 0) ||
+			(gcm.finish() < 0) ){
+		set_error_number(gcm.error_number());
+		return -1;
+	}
+	const AesGcm::Tag tag = gcm.tag();
+
+	const test::Benchmark::BytesPerIteration bytes(m_size);
+
+	benchmark.run(name + "gcm.encrypt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			gcm.start(AesGcm::mode_encrypt, iv);
+			gcm.update(AesGcm::SourceData(plain), AesGcm::DestinationData(output));
+			test::do_not_optimize(gcm.finish());
+		}
+	}, bytes);
+	benchmark.run(name + "gcm.decrypt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			gcm.start(AesGcm::mode_decrypt, iv);
+			gcm.update(AesGcm::SourceData(cipher), AesGcm::DestinationData(output));
+			test::do_not_optimize(gcm.verify(tag));
+		}
+	}, bytes);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include "test/Base64Benchmark.hpp"
+#include "calc/Base64.hpp"
+#include "var/Data.hpp"
+#include "fs/File.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace calc;
+
+Base64Benchmark::Base64Benchmark(){
+	m_size = 1024*1024;
+}
+
+Base64Benchmark & Base64Benchmark::run(test::Benchmark & benchmark){
+	var::Data raw(m_size);
+	if( raw.size() != m_size ){
+		set_error_number(ENOMEM);
+		return *this;
+	}
+
+	u32 value = 1;
+	for(u32 i=0; i < m_size; i++){
+		value = value * 1664525u + 1013904223u;
+		raw.to_u8()[i] = static_cast<u8>(value >> 24);
+	}
+
+	const test::Benchmark::BytesPerIteration bytes(m_size);
+	const var::String encoded = Base64::encode(raw);
+	const var::String encoded_url = Base64::encode(raw, Base64::alphabet_url);
+	var::Data decoded;
+
+	benchmark.run(m_prefix + "base64.encode", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Base64::encode(raw).length());
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "base64.decode", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Base64::decode(encoded, decoded));
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "base64.encode.url", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Base64::encode(raw, Base64::alphabet_url).length());
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "base64.decode.url", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Base64::decode(encoded_url, decoded, Base64::alphabet_url));
+		}
+	}, bytes);
+
+	fs::DataFile raw_file;
+	raw_file.data() = raw;
+	fs::DataFile encoded_file;
+	encoded_file.data().copy_contents(var::Reference(encoded));
+	fs::DataFile output_file(fs::OpenFlags::append_read_write());
+
+	benchmark.run(m_prefix + "base64.encode.file", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			raw_file.seek(0);
+			output_file.data().resize(0);
+			test::do_not_optimize(
+						Base64::encode(
+							Base64::SourceFile(raw_file),
+							Base64::DestinationFile(output_file)
+							)
+						);
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "base64.decode.file", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			encoded_file.seek(0);
+			output_file.data().resize(0);
+			test::do_not_optimize(
+						Base64::decode(
+							Base64::SourceFile(encoded_file),
+							Base64::DestinationFile(output_file)
+							)
+						);
+		}
+	}, bytes);
+
+	return *this;
+}
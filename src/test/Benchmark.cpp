@@ -0,0 +1,149 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <algorithm>
+#include <cmath>
+#include "chrono/Timer.hpp"
+#include "sys/JsonPrinter.hpp"
+#include "var/Data.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+
+Benchmark::Benchmark(){
+	m_warmup_duration = 50000;
+	m_sample_duration = 10000;
+	m_sample_count = 20;
+}
+
+u32 Benchmark::measure(const Function & function, u32 iterations){
+	chrono::Timer timer;
+	timer.start();
+	function(iterations);
+	timer.stop();
+	return timer.microseconds();
+}
+
+const BenchmarkResult & Benchmark::run(
+		const var::String & name,
+		const Function & function,
+		BytesPerIteration bytes_per_iteration,
+		ItemsPerIteration items_per_iteration
+		){
+	chrono::Timer warmup_timer;
+	warmup_timer.start();
+
+	//find the number of iterations that lasts at least the sample duration
+	u32 iterations = 1;
+	u32 elapsed;
+	while( (elapsed = measure(function, iterations)) < m_sample_duration ){
+		//aim a little past the target so the next try is likely to be long enough
+		u32 multiplier = elapsed ? (m_sample_duration + m_sample_duration / 4) / elapsed + 1 : 10;
+		if( multiplier > 10 ){ multiplier = 10; }
+		if( multiplier < 2 ){ multiplier = 2; }
+		if( iterations > static_cast<u32>(-1) / multiplier ){ break; }
+		iterations *= multiplier;
+	}
+
+	//the calibration runs count as part of the warmup
+	while( warmup_timer.microseconds() < m_warmup_duration ){
+		measure(function, iterations);
+	}
+
+	var::Vector<float> sample_list;
+	sample_list.reserve(m_sample_count);
+	var::DataInfo start_info;
+	for(u32 i=0; i < m_sample_count; i++){
+		sample_list.push_back(
+					measure(function, iterations) * 1000.0f / iterations
+					);
+	}
+	var::DataInfo end_info;
+
+	BenchmarkResult result;
+	result.m_name = name;
+	result.m_iteration_count = iterations;
+	result.m_sample_count = m_sample_count;
+
+	std::sort(sample_list.begin(), sample_list.end());
+	const u32 count = sample_list.count();
+	float sum = 0.0f;
+	for(float sample: sample_list){ sum += sample; }
+	result.m_mean = sum / count;
+	float variance = 0.0f;
+	for(float sample: sample_list){
+		variance += (sample - result.m_mean) * (sample - result.m_mean);
+	}
+	result.m_standard_deviation = count > 1 ? std::sqrt(variance / (count - 1)) : 0.0f;
+	result.m_minimum = sample_list.at(0);
+	result.m_median = (count & 1) ?
+				sample_list.at(count/2) :
+				(sample_list.at(count/2 - 1) + sample_list.at(count/2)) / 2.0f;
+	//nearest rank
+	u32 p99_index = (count * 99 + 99) / 100;
+	result.m_p99 = sample_list.at(p99_index ? p99_index - 1 : 0);
+
+	if( result.m_median > 0.0f ){
+		result.m_bytes_per_second =
+				bytes_per_iteration.argument() * 1000000000.0f / result.m_median;
+		result.m_items_per_second =
+				static_cast<float>(items_per_iteration.argument()) * 1000000000.0f / result.m_median;
+	}
+
+	result.m_heap_bytes_per_iteration =
+			(static_cast<float>(end_info.used_size()) -
+			 static_cast<float>(start_info.used_size())) /
+			(static_cast<float>(iterations) * m_sample_count);
+
+	m_result_list.push_back(result);
+	return m_result_list.back();
+}
+
+u32 Benchmark::compare(
+		const var::JsonObject & baseline,
+		Threshold threshold
+		){
+	u32 result = 0;
+	for(BenchmarkResult & benchmark_result: m_result_list){
+		var::JsonValue value = baseline.at(benchmark_result.name());
+		if( value.is_object() == false ){
+			continue;
+		}
+
+		const float baseline_median = value.to_object().at("medianNs").to_float();
+		benchmark_result.m_baseline_median = baseline_median;
+		benchmark_result.m_is_regression = (baseline_median > 0.0f) &&
+				(benchmark_result.median() > baseline_median * (1.0f + threshold.argument()));
+		if( benchmark_result.m_is_regression ){
+			result++;
+		}
+	}
+	return result;
+}
+
+void Benchmark::print(sys::JsonPrinter & printer) const {
+	//keys are dropped at the root (an array): the results need an enclosing object
+	printer.open_object("benchmarks");
+	for(const BenchmarkResult & result: m_result_list){
+		printer.open_object(result.name());
+		printer.number("iterations", result.iteration_count());
+		printer.number("samples", result.sample_count());
+		printer.number("minimumNs", result.minimum());
+		printer.number("medianNs", result.median());
+		printer.number("p99Ns", result.p99());
+		printer.number("meanNs", result.mean());
+		printer.number("stddevNs", result.standard_deviation());
+		if( result.bytes_per_second() > 0.0f ){
+			printer.number("bytesPerSecond", result.bytes_per_second());
+		}
+		if( result.items_per_second() > 0.0f ){
+			printer.number("itemsPerSecond", result.items_per_second());
+		}
+		printer.number("heapBytesPerIteration", result.heap_bytes_per_iteration());
+		if( result.baseline_median() > 0.0f ){
+			printer.number("baselineMedianNs", result.baseline_median());
+			printer.key("regression", result.is_regression());
+		}
+		printer.close_object();
+	}
+	printer.close_object();
+}
@@ -0,0 +1,252 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include <sched.h>
+#include "test/BoundedQueueBenchmark.hpp"
+#include "var/BoundedQueue.hpp"
+#include "var/Queue.hpp"
+#include "var/Vector.hpp"
+#include "sys/Mutex.hpp"
+#include "sys/Thread.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace var;
+
+namespace {
+
+/*! \cond */
+enum {
+	batch_size = 32,
+	//pushed after all the items so the consumers know when to stop
+	stop_value = 0xffffffff
+};
+
+struct Context {
+	Context(u32 capacity) : queue(capacity){}
+	BoundedQueue<u32> queue;
+	Queue<u32> locked_queue;
+	sys::Mutex mutex;
+	u32 item_count;
+};
+
+void push_locked(Context * context, u32 value){
+	context->mutex.lock();
+	context->locked_queue.push(value);
+	context->mutex.unlock();
+}
+
+void * produce(void * args){
+	Context * context = static_cast<Context*>(args);
+	for(u32 i=0; i < context->item_count; i++){
+		while( context->queue.try_push(i) < 0 ){
+			::sched_yield();
+		}
+	}
+	return nullptr;
+}
+
+void * consume(void * args){
+	Context * context = static_cast<Context*>(args);
+	u32 values[batch_size];
+	u32 sum = 0;
+	while( 1 ){
+		u32 count = context->queue.pop_batch(values, batch_size);
+		if( count == 0 ){
+			context->queue.pop(values[0]);
+			count = 1;
+		}
+
+		u32 stop_count = 0;
+		for(u32 i=0; i < count; i++){
+			if( values[i] == stop_value ){
+				stop_count++;
+			} else {
+				sum += values[i];
+			}
+		}
+
+		if( stop_count ){
+			//stop values that were popped for other consumers are put back
+			for(u32 i=1; i < stop_count; i++){
+				while( context->queue.try_push(stop_value) < 0 ){
+					::sched_yield();
+				}
+			}
+			test::do_not_optimize(sum);
+			return nullptr;
+		}
+	}
+}
+
+void * produce_locked(void * args){
+	Context * context = static_cast<Context*>(args);
+	for(u32 i=0; i < context->item_count; i++){
+		push_locked(context, i);
+	}
+	return nullptr;
+}
+
+void * consume_locked(void * args){
+	Context * context = static_cast<Context*>(args);
+	u32 sum = 0;
+	while( 1 ){
+		context->mutex.lock();
+		if( context->locked_queue.is_empty() ){
+			context->mutex.unlock();
+			::sched_yield();
+			continue;
+		}
+		const u32 value = context->locked_queue.front();
+		context->locked_queue.pop();
+		context->mutex.unlock();
+
+		if( value == stop_value ){
+			test::do_not_optimize(sum);
+			return nullptr;
+		}
+		sum += value;
+	}
+}
+
+void push_stop(Context * context){
+	while( context->queue.try_push(stop_value) < 0 ){
+		::sched_yield();
+	}
+}
+
+void push_stop_locked(Context * context){
+	push_locked(context, stop_value);
+}
+
+bool create_thread(
+		var::Vector<sys::Thread> & threads,
+		void * (*function)(void*),
+		Context * context
+		){
+	threads.vector().emplace_back(
+				sys::Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE),
+				sys::Thread::IsDetached(false)
+				);
+	if( threads.back().create(
+				sys::Thread::Function(function),
+				sys::Thread::FunctionArgument(context)
+				) < 0 ){
+		threads.pop_back();
+		return false;
+	}
+	return true;
+}
+
+void join_threads(var::Vector<sys::Thread> & threads, u32 count){
+	//is_valid() can't be used here: it doesn't change when a thread is created on link builds
+	while( threads.count() > count ){
+		threads.back().join();
+		threads.pop_back();
+	}
+}
+
+int run_threads(
+		var::Vector<sys::Thread> & threads,
+		u32 producer_count,
+		u32 consumer_count,
+		void * (*produce_function)(void*),
+		void * (*consume_function)(void*),
+		void (*stop_function)(Context*),
+		Context * context
+		){
+	for(u32 i=0; i < consumer_count; i++){
+		create_thread(threads, consume_function, context);
+	}
+
+	const u32 started_count = threads.count();
+	if( started_count == 0 ){
+		return -1;
+	}
+
+	for(u32 i=0; i < producer_count; i++){
+		if( create_thread(threads, produce_function, context) == false ){
+			//the calling thread pushes the items instead
+			produce_function(context);
+		}
+	}
+
+	//the consumers stop after all the items have been pushed
+	join_threads(threads, started_count);
+	for(u32 i=0; i < started_count; i++){
+		stop_function(context);
+	}
+	join_threads(threads, 0);
+	return 0;
+}
+/*! \endcond */
+
+}
+
+BoundedQueueBenchmark::BoundedQueueBenchmark(){
+	m_item_count = 65536;
+	m_capacity = 1024;
+	m_maximum_thread_count = 16;
+}
+
+BoundedQueueBenchmark & BoundedQueueBenchmark::run(test::Benchmark & benchmark){
+	Context context(m_capacity);
+	const test::Benchmark::ItemsPerIteration items(m_item_count);
+
+	benchmark.run(m_prefix + "bounded_queue.threads.1", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			u32 sum = 0;
+			for(u32 j=0; j < m_item_count; j++){
+				u32 value;
+				context.queue.try_push(j);
+				context.queue.try_pop(value);
+				sum += value;
+			}
+			test::do_not_optimize(sum);
+		}
+	}, test::Benchmark::BytesPerIteration(0), items);
+
+	benchmark.run(m_prefix + "mutex_queue.threads.1", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			u32 sum = 0;
+			for(u32 j=0; j < m_item_count; j++){
+				push_locked(&context, j);
+				context.mutex.lock();
+				sum += context.locked_queue.front();
+				context.locked_queue.pop();
+				context.mutex.unlock();
+			}
+			test::do_not_optimize(sum);
+		}
+	}, test::Benchmark::BytesPerIteration(0), items);
+
+	var::Vector<sys::Thread> threads;
+	threads.vector().reserve(m_maximum_thread_count);
+	for(u32 thread_count = 2; thread_count <= m_maximum_thread_count; thread_count *= 2){
+		const u32 producer_count = thread_count / 2;
+		const u32 consumer_count = thread_count - producer_count;
+		context.item_count = m_item_count / producer_count;
+		const test::Benchmark::ItemsPerIteration thread_items(
+					context.item_count * producer_count
+					);
+
+		benchmark.run(m_prefix + var::String().format("bounded_queue.threads.%ld", thread_count), [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				if( run_threads(threads, producer_count, consumer_count, produce, consume, push_stop, &context) < 0 ){
+					set_error_number(EAGAIN);
+					return;
+				}
+			}
+		}, test::Benchmark::BytesPerIteration(0), thread_items);
+
+		benchmark.run(m_prefix + var::String().format("mutex_queue.threads.%ld", thread_count), [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				if( run_threads(threads, producer_count, consumer_count, produce_locked, consume_locked, push_stop_locked, &context) < 0 ){
+					set_error_number(EAGAIN);
+					return;
+				}
+			}
+		}, test::Benchmark::BytesPerIteration(0), thread_items);
+	}
+
+	return *this;
+}
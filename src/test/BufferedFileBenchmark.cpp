@@ -0,0 +1,99 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include "test/BufferedFileBenchmark.hpp"
+#include "fs/BufferedFile.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace fs;
+
+BufferedFileBenchmark::BufferedFileBenchmark(){
+	m_line_count = 1000;
+	m_page_size = SAPI_LINK_DEFAULT_PAGE_SIZE;
+}
+
+var::String BufferedFileBenchmark::create_lines() const {
+	var::String result;
+	result.reserve(m_line_count * 32);
+	for(u32 i=0; i < m_line_count; i++){
+		result << var::String().format(
+								"%ld,sensor%ld,%ld.%03ld,ok\n",
+								i,
+								i % 16,
+								(i * 7919) % 1000,
+								(i * 104729) % 1000
+								);
+	}
+	return result;
+}
+
+BufferedFileBenchmark & BufferedFileBenchmark::run(test::Benchmark & benchmark){
+	DataFile data_file(OpenFlags::append_read_write());
+	const var::String lines = create_lines();
+	data_file.write(lines.cstring(), File::Size(lines.length()));
+	return run(benchmark, data_file, "data_file");
+}
+
+BufferedFileBenchmark & BufferedFileBenchmark::run(
+		test::Benchmark & benchmark,
+		const var::String & path
+		SAPI_LINK_DRIVER_LAST
+		){
+	File file
+		#if defined __link
+			(link_driver)
+		#endif
+			;
+
+	if( file.create(path, File::IsOverwrite(true)) < 0 ){
+		set_error_number(file.error_number());
+		return *this;
+	}
+
+	const var::String lines = create_lines();
+	if( file.write(lines.cstring(), File::Size(lines.length())) != static_cast<int>(lines.length()) ){
+		set_error_number(file.error_number());
+	} else {
+		run(benchmark, file, "file");
+	}
+
+	file.close();
+	File::remove(
+				path
+			#if defined __link
+				, link_driver
+			#endif
+				);
+	return *this;
+}
+
+BufferedFileBenchmark & BufferedFileBenchmark::run(
+		test::Benchmark & benchmark,
+		const fs::File & file,
+		const var::String & name
+		){
+	const u32 size = file.size();
+	const test::Benchmark::BytesPerIteration bytes(size);
+	const test::Benchmark::ItemsPerIteration items(m_line_count);
+	var::String line;
+
+	benchmark.run(m_prefix + name + ".gets", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			file.seek(0);
+			while( file.gets(line) != nullptr ){
+				test::do_not_optimize(line.cstring());
+			}
+		}
+	}, bytes, items);
+
+	BufferedFile buffered_file(file, File::PageSize(m_page_size));
+	benchmark.run(m_prefix + name + ".buffered.gets", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			buffered_file.seek(0);
+			while( buffered_file.gets(line) != nullptr ){
+				test::do_not_optimize(line.cstring());
+			}
+		}
+	}, bytes, items);
+
+	return *this;
+}
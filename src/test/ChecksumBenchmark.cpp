@@ -0,0 +1,62 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include "test/ChecksumBenchmark.hpp"
+#include "calc/Checksum.hpp"
+#include "var/Data.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace calc;
+
+ChecksumBenchmark::ChecksumBenchmark(){
+	m_size = 64*1024;
+}
+
+ChecksumBenchmark & ChecksumBenchmark::run(test::Benchmark & benchmark){
+	var::Data data(m_size);
+	if( data.size() != m_size ){
+		set_error_number(ENOMEM);
+		return *this;
+	}
+
+	u32 value = 1;
+	for(u32 i=0; i < m_size; i++){
+		value = value * 1664525u + 1013904223u;
+		data.to_u8()[i] = static_cast<u8>(value >> 24);
+	}
+
+	const test::Benchmark::BytesPerIteration bytes(m_size);
+
+	benchmark.run(m_prefix + "crc32.ieee", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Crc32::calculate(data, Crc32::polynomial_ieee));
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "crc32.castagnoli", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Crc32::calculate(data, Crc32::polynomial_castagnoli));
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "crc16.ccitt", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Crc16::calculate(data));
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "adler32", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Adler32::calculate(data));
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "zero_sum.u8", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Checksum::calculate_zero_sum<u8>(data));
+		}
+	}, bytes);
+	benchmark.run(m_prefix + "zero_sum.u32", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(Checksum::calculate_zero_sum<u32>(data));
+		}
+	}, bytes);
+
+	return *this;
+}
@@ -0,0 +1,143 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include "test/DirCopyBenchmark.hpp"
+#include "fs/Dir.hpp"
+#include "fs/DirCopy.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace fs;
+
+namespace {
+
+/*! \cond */
+//copies to the host but takes as long as a link would
+class SimulatedLinkDirCopy : public DirCopy {
+public:
+	SimulatedLinkDirCopy(
+			const chrono::MicroTime & latency,
+			u32 bytes_per_second
+			) : m_latency(latency), m_bytes_per_second(bytes_per_second){}
+
+protected:
+	bool is_one_file_at_a_time() const override {
+		return true;
+	}
+
+	int create_destination(
+			File & destination,
+			const var::String & path,
+			const Permissions & permissions
+			) override {
+		wait_for_request(0);
+		return DirCopy::create_destination(destination, path, permissions);
+	}
+
+	int write_destination(
+			const File & destination,
+			const void * buffer,
+			u32 size
+			) override {
+		wait_for_request(size);
+		return DirCopy::write_destination(destination, buffer, size);
+	}
+
+private:
+	chrono::MicroTime m_latency;
+	u32 m_bytes_per_second;
+
+	void wait_for_request(u32 size) const {
+		u32 microseconds = m_latency.microseconds();
+		if( m_bytes_per_second ){
+			microseconds += static_cast<u32>(
+						static_cast<u64>(size) * 1000000UL / m_bytes_per_second
+						);
+		}
+		if( microseconds ){
+			chrono::MicroTime(microseconds).wait();
+		}
+	}
+};
+/*! \endcond */
+
+}
+
+DirCopyBenchmark::DirCopyBenchmark() : m_latency(1000){
+	m_file_count = 100;
+	m_file_size = 16*1024;
+	m_thread_count = 4;
+	m_bytes_per_second = 1000000;
+}
+
+int DirCopyBenchmark::create_tree(const var::String & path){
+	var::Data contents(m_file_size);
+	for(u32 i=0; i < m_file_size; i++){
+		contents.to_u8()[i] = static_cast<u8>(i);
+	}
+
+	for(u32 i=0; i < m_file_count; i++){
+		var::String directory_path;
+		directory_path << path << var::String().format("/source/dir%04ld", i / 10);
+		if( (i % 10 == 0) &&
+				(Dir::create(
+					 directory_path,
+					 Permissions(0777),
+					 Dir::IsRecursive(true)
+					 ) < 0) ){
+			return set_error_number_if_error(-1);
+		}
+
+		File file;
+		if( (file.create(
+					 directory_path + var::String().format("/file%05ld.bin", i),
+					 File::IsOverwrite(true)
+					 ) < 0) ||
+				(file.write(contents) != static_cast<int>(m_file_size)) ){
+			set_error_number(file.error_number());
+			return -1;
+		}
+		file.close();
+	}
+	return 0;
+}
+
+DirCopyBenchmark & DirCopyBenchmark::run(
+		test::Benchmark & benchmark,
+		const var::String & path
+		){
+	const var::String source_path = path + "/source";
+	const test::Benchmark::BytesPerIteration bytes(m_file_count * m_file_size);
+	const test::Benchmark::ItemsPerIteration items(m_file_count);
+
+	auto run_copy = [&](const var::String & name, DirCopy & dir_copy, const var::String & destination){
+		benchmark.run(m_prefix + name, [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				if( dir_copy.copy(DirCopy::SourcePath(source_path), DirCopy::DestinationPath(destination)) < 0 ){
+					set_error_number(EIO);
+					return;
+				}
+			}
+		}, bytes, items);
+
+		if( (dir_copy.file_count() != m_file_count) ||
+				(dir_copy.bytes() != m_file_count * m_file_size) ||
+				(dir_copy.microseconds() == 0) ){
+			set_error_number(EIO);
+		}
+	};
+
+	DirCopy host_copy;
+	run_copy("dir_copy.host", host_copy.set_thread_count(1), path + "/host");
+
+	if( m_thread_count > 1 ){
+		const var::String name =
+				var::String().format("host.threads.%ld", m_thread_count);
+		DirCopy threaded_copy;
+		run_copy(var::String("dir_copy.") + name, threaded_copy.set_thread_count(m_thread_count), path + "/" + name);
+	}
+
+	SimulatedLinkDirCopy link_copy(m_latency, m_bytes_per_second);
+	run_copy("dir_copy.link", link_copy, path + "/link");
+
+	return *this;
+}
@@ -0,0 +1,106 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include "test/DirWalkerBenchmark.hpp"
+#include "fs/Dir.hpp"
+#include "fs/DirWalker.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace fs;
+
+DirWalkerBenchmark::DirWalkerBenchmark(){
+	m_thread_count = 4;
+	m_files_per_directory = 1000;
+}
+
+int DirWalkerBenchmark::create_tree(
+		const var::String & path,
+		u32 file_count
+		SAPI_LINK_DRIVER_LAST
+		){
+	const u32 directory_count =
+			(file_count + m_files_per_directory - 1) / m_files_per_directory;
+
+	for(u32 i=0; i < directory_count; i++){
+		var::String directory_path;
+		directory_path << path << var::String().format("/group%03ld/dir%05ld", i / 10, i);
+		if( Dir::create(
+					directory_path,
+					Permissions(0777),
+					Dir::IsRecursive(true)
+			#if defined __link
+					, link_driver
+			#endif
+					) < 0 ){
+			return set_error_number_if_error(-1);
+		}
+
+		for(u32 j = i * m_files_per_directory; (j < (i+1) * m_files_per_directory) && (j < file_count); j++){
+			File file
+				#if defined __link
+					(link_driver)
+				#endif
+					;
+			if( file.create(
+						directory_path + var::String().format("/file%07ld.txt", j),
+						File::IsOverwrite(true)
+						) < 0 ){
+				set_error_number(file.error_number());
+				return -1;
+			}
+			file.close();
+		}
+	}
+	return 0;
+}
+
+DirWalkerBenchmark & DirWalkerBenchmark::run(
+		test::Benchmark & benchmark,
+		const var::String & path
+		SAPI_LINK_DRIVER_LAST
+		){
+	DirWalker walker
+		#if defined __link
+			(link_driver)
+		#endif
+			;
+	const DirWalker::Callback callback = [](const DirWalkerEntry & entry){
+		test::do_not_optimize(entry.name());
+		return DirWalker::visit_continue;
+	};
+
+	if( walker.walk(path, callback) < 0 ){
+		set_error_number(walker.error_number());
+		return *this;
+	}
+	const test::Benchmark::ItemsPerIteration items(walker.entry_count());
+
+	benchmark.run(m_prefix + "dir.read_list", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(
+						Dir::read_list(
+							path,
+							Dir::IsRecursive(true)
+				#if defined __link
+							, link_driver
+				#endif
+							).count()
+						);
+		}
+	}, test::Benchmark::BytesPerIteration(0), items);
+
+	benchmark.run(m_prefix + "dir_walker", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			walker.walk(path, callback);
+		}
+	}, test::Benchmark::BytesPerIteration(0), items);
+
+	if( m_thread_count > 1 ){
+		benchmark.run(m_prefix + var::String().format("dir_walker.threads.%ld", m_thread_count), [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				walker.walk(path, callback, DirWalker::ThreadCount(m_thread_count));
+			}
+		}, test::Benchmark::BytesPerIteration(0), items);
+	}
+
+	return *this;
+}
@@ -0,0 +1,365 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include "test/DspKernelBenchmark.hpp"
+#include "dsp/SignalData.hpp"
+#include "dsp/Filter.hpp"
+#include "dsp/Transform.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace dsp;
+
+namespace {
+
+/*! \cond */
+enum {
+	convolve_length = 16,
+	fir_tap_count = 32,
+	biquad_stage_count = 2,
+	fft_length = 1024
+};
+
+//the same values on every platform (from a linear congruential generator)
+class Sequence {
+public:
+	explicit Sequence(u32 seed) : m_value(seed){}
+	s32 next(){
+		m_value = m_value * 1664525u + 1013904223u;
+		return static_cast<s32>(m_value);
+	}
+private:
+	u32 m_value;
+};
+
+//values are less than half of full scale so sums and products don't saturate
+void fill(q15_t * data, u32 count, u32 seed){
+	Sequence sequence(seed);
+	for(u32 i=0; i < count; i++){ data[i] = static_cast<q15_t>(sequence.next() >> 18); }
+}
+
+void fill(q31_t * data, u32 count, u32 seed){
+	Sequence sequence(seed);
+	for(u32 i=0; i < count; i++){ data[i] = sequence.next() >> 2; }
+}
+
+void fill(float32_t * data, u32 count, u32 seed){
+	Sequence sequence(seed);
+	for(u32 i=0; i < count; i++){ data[i] = (sequence.next() >> 8) / 16777216.0f; }
+}
+/*! \endcond */
+
+}
+
+DspKernelBenchmark::DspKernelBenchmark(){
+	m_sample_count = 1024;
+}
+
+var::String DspKernelBenchmark::name(const char * value) const {
+	return m_prefix + value;
+}
+
+DspKernelBenchmark & DspKernelBenchmark::run(test::Benchmark & benchmark){
+	run_q15(benchmark);
+	run_q31(benchmark);
+	run_f32(benchmark);
+	return *this;
+}
+
+DspKernelBenchmark & DspKernelBenchmark::run_q15(test::Benchmark & benchmark){
+	if( api_q15().is_valid() == false ){
+		set_error_number(ENOENT);
+		return *this;
+	}
+
+	const u32 count = m_sample_count;
+	const test::Benchmark::BytesPerIteration bytes(count * sizeof(q15_t));
+	const test::Benchmark::ItemsPerIteration items(count);
+	SignalQ15 a(count);
+	SignalQ15 b(count);
+	SignalQ15 output(count + convolve_length - 1);
+	SignalQ15 kernel(convolve_length);
+	fill(a.data(), count, 1);
+	fill(b.data(), count, 2);
+	fill(kernel.data(), convolve_length, 3);
+	const q15_t * x = a.data();
+	const q15_t * y = b.data();
+	q15_t * z = output.data();
+
+	benchmark.run(name("q15.add"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->add(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.sub"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->sub(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.mult"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->mult(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.offset"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->offset(x, 0x1000, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.scale"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->scale(x, 0x6000, 1, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.shift"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->shift(x, 2, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.abs"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->abs(x, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.negate"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q15()->negate(x, z, count); test::clobber_memory(); }
+	}, bytes, items);
+
+	//each method allocates a new signal; the operators evaluate one expression
+	SignalQ15 result(count);
+	benchmark.run(name("q15.expression.eager"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ result = a.multiply(0x6000).add(b).shift(-2); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q15.expression"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ result = (a * (q15_t)0x6000 + b) >> 2; test::clobber_memory(); }
+	}, bytes, items);
+
+	benchmark.run(name("q15.mean"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q15_t result; api_q15()->mean(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q15.power"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q63_t result; api_q15()->power(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q15.variance"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q15_t result; api_q15()->var(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q15.dot_product"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q63_t result; api_q15()->dot_prod(x, y, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q15.max"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q15_t result; u32 index; api_q15()->max(x, count, &result, &index); test::do_not_optimize(result); }
+	}, bytes, items);
+
+	benchmark.run(name("q15.convolve.16"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.convolve(output, kernel); test::clobber_memory(); }
+	}, bytes, items);
+
+	SignalQ15 fir_coefficients(fir_tap_count);
+	fill(fir_coefficients.data(), fir_tap_count, 4);
+	FirFilterQ15 fir(fir_coefficients, count);
+	benchmark.run(name("q15.fir.32"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.filter(output, fir); test::clobber_memory(); }
+	}, bytes, items);
+
+	BiquadCoefficientsQ15 biquad_coefficients(biquad_stage_count);
+	fill(biquad_coefficients.data(), biquad_coefficients.count(), 5);
+	BiquadFilterQ15 biquad(biquad_coefficients, 1);
+	benchmark.run(name("q15.biquad.2"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.filter(output, biquad); test::clobber_memory(); }
+	}, bytes, items);
+
+	FftRealQ15 fft(fft_length);
+	SignalComplexQ15 time_signal = fft.create_time_signal();
+	SignalComplexQ15 frequency_signal = fft.create_frequency_signal();
+	fill(reinterpret_cast<q15_t*>(time_signal.data()), fft_length, 6);
+	benchmark.run(name("q15.rfft.1024"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ time_signal.transform(frequency_signal, fft); test::clobber_memory(); }
+	}, test::Benchmark::BytesPerIteration(fft_length * sizeof(q15_t)), test::Benchmark::ItemsPerIteration(fft_length));
+
+	return *this;
+}
+
+DspKernelBenchmark & DspKernelBenchmark::run_q31(test::Benchmark & benchmark){
+	if( api_q31().is_valid() == false ){
+		set_error_number(ENOENT);
+		return *this;
+	}
+
+	const u32 count = m_sample_count;
+	const test::Benchmark::BytesPerIteration bytes(count * sizeof(q31_t));
+	const test::Benchmark::ItemsPerIteration items(count);
+	SignalQ31 a(count);
+	SignalQ31 b(count);
+	SignalQ31 output(count + convolve_length - 1);
+	SignalQ31 kernel(convolve_length);
+	fill(a.data(), count, 1);
+	fill(b.data(), count, 2);
+	fill(kernel.data(), convolve_length, 3);
+	const q31_t * x = a.data();
+	const q31_t * y = b.data();
+	q31_t * z = output.data();
+
+	benchmark.run(name("q31.add"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->add(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.sub"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->sub(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.mult"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->mult(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.offset"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->offset(x, 0x10000000, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.scale"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->scale(x, 0x60000000, 1, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.shift"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->shift(x, 2, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.abs"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->abs(x, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.negate"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_q31()->negate(x, z, count); test::clobber_memory(); }
+	}, bytes, items);
+
+	SignalQ31 result(count);
+	benchmark.run(name("q31.expression.eager"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ result = a.multiply(0x60000000).add(b).shift(-2); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("q31.expression"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ result = (a * (q31_t)0x60000000 + b) >> 2; test::clobber_memory(); }
+	}, bytes, items);
+
+	benchmark.run(name("q31.mean"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q31_t result; api_q31()->mean(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q31.power"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q63_t result; api_q31()->power(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q31.variance"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q31_t result; api_q31()->var(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q31.dot_product"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q63_t result; api_q31()->dot_prod(x, y, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("q31.max"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ q31_t result; u32 index; api_q31()->max(x, count, &result, &index); test::do_not_optimize(result); }
+	}, bytes, items);
+
+	benchmark.run(name("q31.convolve.16"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.convolve(output, kernel); test::clobber_memory(); }
+	}, bytes, items);
+
+	SignalQ31 fir_coefficients(fir_tap_count);
+	fill(fir_coefficients.data(), fir_tap_count, 4);
+	FirFilterQ31 fir(fir_coefficients, count);
+	benchmark.run(name("q31.fir.32"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.filter(output, fir); test::clobber_memory(); }
+	}, bytes, items);
+
+	BiquadCoefficientsQ31 biquad_coefficients(biquad_stage_count);
+	fill(biquad_coefficients.data(), biquad_coefficients.count(), 5);
+	BiquadFilterQ31 biquad(biquad_coefficients, 1);
+	benchmark.run(name("q31.biquad.2"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.filter(output, biquad); test::clobber_memory(); }
+	}, bytes, items);
+
+	FftRealQ31 fft(fft_length);
+	SignalComplexQ31 time_signal = fft.create_time_signal();
+	SignalComplexQ31 frequency_signal = fft.create_frequency_signal();
+	fill(reinterpret_cast<q31_t*>(time_signal.data()), fft_length, 6);
+	benchmark.run(name("q31.rfft.1024"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ time_signal.transform(frequency_signal, fft); test::clobber_memory(); }
+	}, test::Benchmark::BytesPerIteration(fft_length * sizeof(q31_t)), test::Benchmark::ItemsPerIteration(fft_length));
+
+	return *this;
+}
+
+DspKernelBenchmark & DspKernelBenchmark::run_f32(test::Benchmark & benchmark){
+	if( api_f32().is_valid() == false ){
+		set_error_number(ENOENT);
+		return *this;
+	}
+
+	const u32 count = m_sample_count;
+	const test::Benchmark::BytesPerIteration bytes(count * sizeof(float32_t));
+	const test::Benchmark::ItemsPerIteration items(count);
+	SignalF32 a(count);
+	SignalF32 b(count);
+	SignalF32 output(count + convolve_length - 1);
+	SignalF32 kernel(convolve_length);
+	fill(a.data(), count, 1);
+	fill(b.data(), count, 2);
+	fill(kernel.data(), convolve_length, 3);
+	const float32_t * x = a.data();
+	const float32_t * y = b.data();
+	float32_t * z = output.data();
+
+	benchmark.run(name("f32.add"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->add(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.sub"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->sub(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.mult"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->mult(x, y, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.offset"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->offset(x, 0.125f, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.scale"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->scale(x, 0.75f, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.abs"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->abs(x, z, count); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.negate"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ api_f32()->negate(x, z, count); test::clobber_memory(); }
+	}, bytes, items);
+
+	SignalF32 result(count);
+	benchmark.run(name("f32.expression.eager"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ result = a.multiply(0.75f).add(b).multiply(b).add(0.125f); test::clobber_memory(); }
+	}, bytes, items);
+	benchmark.run(name("f32.expression"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ result = (a * 0.75f + b) * b + 0.125f; test::clobber_memory(); }
+	}, bytes, items);
+
+	benchmark.run(name("f32.mean"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ float32_t result; api_f32()->mean(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("f32.power"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ float32_t result; api_f32()->power(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("f32.variance"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ float32_t result; api_f32()->var(x, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("f32.dot_product"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ float32_t result; api_f32()->dot_prod(x, y, count, &result); test::do_not_optimize(result); }
+	}, bytes, items);
+	benchmark.run(name("f32.max"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ float32_t result; u32 index; api_f32()->max(x, count, &result, &index); test::do_not_optimize(result); }
+	}, bytes, items);
+
+	benchmark.run(name("f32.convolve.16"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.convolve(output, kernel); test::clobber_memory(); }
+	}, bytes, items);
+
+	SignalF32 fir_coefficients(fir_tap_count);
+	fill(fir_coefficients.data(), fir_tap_count, 4);
+	FirFilterF32 fir(fir_coefficients, count);
+	benchmark.run(name("f32.fir.32"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.filter(output, fir); test::clobber_memory(); }
+	}, bytes, items);
+
+	//a stable low pass filter for each stage
+	BiquadCoefficientsF32 biquad_coefficients(biquad_stage_count);
+	for(u32 stage=0; stage < biquad_stage_count; stage++){
+		biquad_coefficients.b0(stage) = 0.2f;
+		biquad_coefficients.b1(stage) = 0.4f;
+		biquad_coefficients.b2(stage) = 0.2f;
+		biquad_coefficients.a1(stage) = 0.3f;
+		biquad_coefficients.a2(stage) = -0.1f;
+	}
+	BiquadFilterF32 biquad(biquad_coefficients);
+	benchmark.run(name("f32.biquad.2"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ a.filter(output, biquad); test::clobber_memory(); }
+	}, bytes, items);
+
+	FftRealF32 fft(fft_length);
+	SignalComplexF32 time_signal = fft.create_time_signal();
+	SignalComplexF32 frequency_signal = fft.create_frequency_signal();
+	fill(reinterpret_cast<float32_t*>(time_signal.data()), fft_length, 6);
+	benchmark.run(name("f32.rfft.1024"), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){ time_signal.transform(frequency_signal, fft); test::clobber_memory(); }
+	}, test::Benchmark::BytesPerIteration(fft_length * sizeof(float32_t)), test::Benchmark::ItemsPerIteration(fft_length));
+
+	return *this;
+}
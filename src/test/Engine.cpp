@@ -1,16 +1,526 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 
 #include <cstdio>
-#include <cstdarg>
+#include <cstring>
+#include <algorithm>
 
-#include "hal.hpp"
-#include "sys.hpp"
+#if defined __link && !defined __win32
+#define ENGINE_USE_WORKERS 1
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#else
+#define ENGINE_USE_WORKERS 0
+#endif
+
+#include "sys/Cli.hpp"
 #include "test/Engine.hpp"
 
 using namespace test;
 
+Engine * Engine::m_active = nullptr;
+
+namespace {
+
+//sent from a worker to the engine (writes smaller than PIPE_BUF are never split)
+struct EngineMessage {
+	enum types {
+		type_case_open,
+		type_case_close,
+		type_test_close
+	};
+	u8 type;
+	u8 result;
+	u16 resd;
+	u32 microseconds;
+	char name[56];
+};
+
+}
+
 Engine::Engine(){
+	m_case_timeout = 0;
+	m_status_fd = -1;
+	m_entry = nullptr;
+#if ENGINE_USE_WORKERS
+	long processor_count = ::sysconf(_SC_NPROCESSORS_ONLN);
+	m_worker_count = processor_count > 0 ? processor_count : 1;
+#else
+	m_worker_count = 1;
+#endif
+}
+
+Engine & Engine::add(const var::String & name, Factory factory){
+	Entry entry;
+	entry.name = name;
+	entry.factory = factory;
+	m_entry_list.push_back(entry);
+	return *this;
+}
+
+u32 Engine::execute(const sys::Cli & cli){
+	u32 o_flags = Test::parse_execution_flags(cli);
+	if( o_flags == 0 ){
+		o_flags = Test::execute_api;
+	}
+
+	const var::String workers = cli.get_option(
+				"workers",
+				sys::Cli::Description("number of tests to execute at the same time")
+				);
+	if( workers.is_empty() == false ){
+		set_worker_count(workers.to_integer());
+	}
+
+	const var::String timeout = cli.get_option(
+				"timeout",
+				sys::Cli::Description("maximum duration of each case in milliseconds")
+				);
+	if( timeout.is_empty() == false ){
+		set_case_timeout(chrono::Milliseconds(timeout.to_integer()));
+	}
+
+	return execute(o_flags);
+}
+
+u32 Engine::execute(u32 o_flags){
+	if( Test::m_is_initialized == false ){
+		Test::initialize(
+					Test::Name("unknown"),
+					Test::Version("0.0")
+					);
+	}
+
+	m_case_result_list.clear();
+
+#if ENGINE_USE_WORKERS
+	u32 result = execute_workers(o_flags);
+#else
+	u32 result = execute_serially(o_flags);
+#endif
+
+	std::stable_sort(
+				m_case_result_list.begin(),
+				m_case_result_list.end(),
+				[](const EngineCaseResult & a, const EngineCaseResult & b){
+		return a.microseconds() > b.microseconds();
+	});
+
+	print_case_durations();
+	return result;
+}
+
+bool Engine::execute_entry(const Entry & entry, u32 o_flags, u32 & microseconds){
+	Test * test = entry.factory();
+	if( test == nullptr ){
+		microseconds = 0;
+		return false;
+	}
+	test->execute(o_flags);
+	const bool result = test->result();
+	microseconds = test->m_test_duration_microseconds;
+	delete test;
+	return result;
+}
+
+u32 Engine::execute_serially(u32 o_flags){
+	u32 result = 0;
+	m_active = this;
+	for(const Entry & entry: m_entry_list){
+		u32 microseconds;
+		m_entry = &entry;
+		if( execute_entry(entry, o_flags, microseconds) == false ){
+			result++;
+		}
+	}
+	m_entry = nullptr;
+	m_active = nullptr;
+	return result;
+}
+
+void Engine::case_opened(const Test & test, const var::String & case_name){
+	MCU_UNUSED_ARGUMENT(test);
+	if( m_status_fd >= 0 ){
+		send_message(EngineMessage::type_case_open, false, 0, case_name);
+	}
+}
+
+void Engine::case_closed(
+		const Test & test,
+		const var::String & case_name,
+		bool result,
+		u32 microseconds
+		){
+	if( m_status_fd >= 0 ){
+		send_message(EngineMessage::type_case_close, result, microseconds, case_name);
+		return;
+	}
+
+	EngineCaseResult case_result;
+	case_result.m_test_name = m_entry ? m_entry->name : test.name();
+	case_result.m_name = case_name;
+	case_result.m_result = result;
+	case_result.m_microseconds = microseconds;
+	m_case_result_list.push_back(case_result);
+}
+
+void Engine::send_message(u8 type, bool result, u32 microseconds, const var::String & name){
+#if ENGINE_USE_WORKERS
+	EngineMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type = type;
+	message.result = result;
+	message.microseconds = microseconds;
+	strncpy(message.name, name.cstring(), sizeof(message.name)-1);
+	if( ::write(m_status_fd, &message, sizeof(message)) != sizeof(message) ){
+		m_status_fd = -1;
+	}
+#else
+	MCU_UNUSED_ARGUMENT(type);
+	MCU_UNUSED_ARGUMENT(result);
+	MCU_UNUSED_ARGUMENT(microseconds);
+	MCU_UNUSED_ARGUMENT(name);
+#endif
+}
+
+void Engine::print_case_durations(){
+	if( m_case_result_list.count() == 0 ){
+		return;
+	}
+	Test::print_indent(1, "\"caseMicroseconds\": {\n");
+	for(u32 i=0; i < m_case_result_list.count(); i++){
+		const EngineCaseResult & case_result = m_case_result_list.at(i);
+		Test::print_indent(
+					2,
+					"\"%s.%s\": %ld.0%s\n",
+					case_result.test_name().cstring(),
+					case_result.name().cstring(),
+					case_result.microseconds(),
+					i < m_case_result_list.count() - 1 ? "," : ""
+					);
+	}
+	Test::print_indent(1, "},\n");
+}
+
+#if ENGINE_USE_WORKERS
+
+struct Engine::Worker {
+	u32 entry_index;
+	pid_t pid;
+	int output_fd;
+	int status_fd;
+	var::String output;
+	u8 status_buffer[sizeof(EngineMessage)];
+	u32 status_count;
+	chrono::Timer case_timer;
+	var::String case_name;
+	bool is_case_open;
+	bool is_timed_out;
+	bool is_test_closed;
+	bool test_result;
+	u32 test_microseconds;
+	var::Vector<EngineCaseResult> case_result_list;
+};
+
+namespace {
 
+//appends a line to a report that is created by the engine
+void append_line(var::String & output, int indent, const var::String & line){
+	for(int i=0; i < indent; i++){
+		output << "  ";
+	}
+	output << line << "\n";
 }
 
+}
+
+int Engine::start_worker(Worker & worker, u32 o_flags){
+	worker.pid = -1;
+	worker.output_fd = -1;
+	worker.status_fd = -1;
+	worker.status_count = 0;
+	worker.is_case_open = false;
+	worker.is_timed_out = false;
+	worker.is_test_closed = false;
+	worker.test_result = false;
+	worker.test_microseconds = 0;
+
+	int output_pipe[2];
+	int status_pipe[2];
+	if( ::pipe(output_pipe) < 0 ){
+		return -1;
+	}
+	if( ::pipe(status_pipe) < 0 ){
+		::close(output_pipe[0]);
+		::close(output_pipe[1]);
+		return -1;
+	}
+
+	//anything buffered would be printed by both processes
+	fflush(stdout);
+
+	const pid_t pid = ::fork();
+	if( pid < 0 ){
+		::close(output_pipe[0]);
+		::close(output_pipe[1]);
+		::close(status_pipe[0]);
+		::close(status_pipe[1]);
+		return -1;
+	}
+
+	if( pid == 0 ){
+		//worker process: the report goes to the pipe instead of stdout
+		::close(output_pipe[0]);
+		::close(status_pipe[0]);
+		::dup2(output_pipe[1], STDOUT_FILENO);
+		::close(output_pipe[1]);
+		m_status_fd = status_pipe[1];
+		m_active = this;
+
+		const Entry & entry = m_entry_list.at(worker.entry_index);
+		u32 microseconds;
+		const bool result = execute_entry(entry, o_flags, microseconds);
+		fflush(stdout);
+		send_message(EngineMessage::type_test_close, result, microseconds, entry.name);
+		//don't run the destructors of objects owned by the engine process
+		::_exit(0);
+	}
+
+	::close(output_pipe[1]);
+	::close(status_pipe[1]);
+	worker.pid = pid;
+	worker.output_fd = output_pipe[0];
+	worker.status_fd = status_pipe[0];
+	return 0;
+}
+
+void Engine::receive_message(Worker & worker){
+	const EngineMessage * message =
+			reinterpret_cast<const EngineMessage*>(worker.status_buffer);
+	switch(message->type){
+		case EngineMessage::type_case_open:
+			worker.is_case_open = true;
+			worker.case_name = var::String(message->name);
+			worker.case_timer.restart();
+			break;
+		case EngineMessage::type_case_close: {
+			EngineCaseResult case_result;
+			case_result.m_test_name = m_entry_list.at(worker.entry_index).name;
+			case_result.m_name = var::String(message->name);
+			case_result.m_result = message->result != 0;
+			case_result.m_microseconds = message->microseconds;
+			worker.case_result_list.push_back(case_result);
+			worker.is_case_open = false;
+			worker.case_timer.stop();
+			break;
+		}
+		case EngineMessage::type_test_close:
+			worker.is_test_closed = true;
+			worker.test_result = message->result != 0;
+			worker.test_microseconds = message->microseconds;
+			break;
+	}
+}
+
+int Engine::read_worker(Worker & worker, int fd){
+	char buffer[512];
+	int bytes_read = ::read(fd, buffer, sizeof(buffer));
+	if( bytes_read <= 0 ){
+		return bytes_read;
+	}
+
+	if( fd == worker.output_fd ){
+		worker.output.string().append(buffer, bytes_read);
+		return bytes_read;
+	}
+
+	for(int i=0; i < bytes_read; i++){
+		worker.status_buffer[worker.status_count++] = buffer[i];
+		if( worker.status_count == sizeof(EngineMessage) ){
+			receive_message(worker);
+			worker.status_count = 0;
+		}
+	}
+	return bytes_read;
+}
+
+bool Engine::finish_worker(Worker & worker){
+	int status = 0;
+	if( worker.pid > 0 ){
+		while( (::waitpid(worker.pid, &status, 0) < 0) && (errno == EINTR) ){}
+	}
+
+	const Entry & entry = m_entry_list.at(worker.entry_index);
+	bool result;
+	u32 microseconds;
+
+	if( worker.is_test_closed && WIFEXITED(status) && (WEXITSTATUS(status) == 0) ){
+		result = worker.test_result;
+		microseconds = worker.test_microseconds;
+	} else {
+		//the worker didn't finish so its report is incomplete: make one from the cases that closed
+		var::String reason;
+		if( worker.pid < 0 ){
+			reason = "failed to create worker process";
+		} else if( worker.is_timed_out ){
+			reason.format("timed out after %ld microseconds", m_case_timeout);
+		} else if( WIFSIGNALED(status) ){
+			reason.format("terminated by signal %d", WTERMSIG(status));
+		} else {
+			reason.format("exited with status %d", WEXITSTATUS(status));
+		}
+
+		result = false;
+		microseconds = 0;
+		worker.output.clear();
+		append_line(worker.output, 1, var::String().format("\"%s\": {", entry.name.cstring()));
+		for(const EngineCaseResult & case_result: worker.case_result_list){
+			microseconds += case_result.microseconds();
+			append_line(worker.output, 2, var::String().format("\"%s\": {", case_result.name().cstring()));
+			append_line(worker.output, 3, case_result.result() ? "\"result\": true," : "\"result\": false,");
+			append_line(worker.output, 3, var::String().format("\"microseconds\": %ld.0", case_result.microseconds()));
+			append_line(worker.output, 2, "},");
+		}
+
+		if( worker.is_case_open ){
+			EngineCaseResult case_result;
+			case_result.m_test_name = entry.name;
+			case_result.m_name = worker.case_name;
+			case_result.m_result = false;
+			case_result.m_is_timed_out = worker.is_timed_out;
+			case_result.m_microseconds = worker.case_timer.microseconds();
+			worker.case_result_list.push_back(case_result);
+			microseconds += case_result.microseconds();
+
+			append_line(worker.output, 2, var::String().format("\"%s\": {", worker.case_name.cstring()));
+			append_line(worker.output, 3, "\"result\": false,");
+			append_line(worker.output, 3, var::String().format("\"msg-0\": \"%s\",", reason.cstring()));
+			append_line(worker.output, 3, var::String().format("\"microseconds\": %ld.0", case_result.microseconds()));
+			append_line(worker.output, 2, "},");
+		} else {
+			append_line(worker.output, 2, var::String().format("\"error\": \"%s\",", reason.cstring()));
+		}
+
+		append_line(worker.output, 2, "\"result\": false,");
+		append_line(worker.output, 2, var::String().format("\"microseconds\": %ld.0", microseconds));
+		append_line(worker.output, 1, "},");
+	}
+
+	if( result == false ){
+		Test::m_all_test_result = false;
+	}
+	Test::m_all_test_duration_microseconds += microseconds;
+
+	for(const EngineCaseResult & case_result: worker.case_result_list){
+		m_case_result_list.push_back(case_result);
+	}
+	return result;
+}
+
+u32 Engine::execute_workers(u32 o_flags){
+	const u32 entry_count = m_entry_list.count();
+	var::Vector<Worker*> report_list(entry_count);
+	var::Vector<Worker*> running_list;
+	u32 next_entry = 0;
+	u32 next_report = 0;
+	u32 result = 0;
+	//performance cases (such as test::Benchmark runs) are timed without other workers competing
+	const u32 worker_count = (o_flags & Test::execute_performance) ? 1 : m_worker_count;
+
+	while( next_report < entry_count ){
+
+		while( (running_list.count() < worker_count) && (next_entry < entry_count) ){
+			Worker * worker = new Worker();
+			worker->entry_index = next_entry++;
+			if( start_worker(*worker, o_flags) < 0 ){
+				//the test fails without running
+				if( finish_worker(*worker) == false ){
+					result++;
+				}
+				report_list.at(worker->entry_index) = worker;
+				continue;
+			}
+			running_list.push_back(worker);
+		}
+
+		if( running_list.count() ){
+			var::Vector<struct pollfd> poll_list;
+			int timeout = 100;
+			for(Worker * worker: running_list){
+				struct pollfd entry;
+				entry.events = POLLIN;
+				entry.revents = 0;
+				if( worker->output_fd >= 0 ){
+					entry.fd = worker->output_fd;
+					poll_list.push_back(entry);
+				}
+				if( worker->status_fd >= 0 ){
+					entry.fd = worker->status_fd;
+					poll_list.push_back(entry);
+				}
+				if( m_case_timeout && worker->is_case_open ){
+					const u32 elapsed = worker->case_timer.microseconds();
+					const int remaining = elapsed < m_case_timeout ?
+								(m_case_timeout - elapsed + 999) / 1000 : 0;
+					if( remaining < timeout ){ timeout = remaining; }
+				}
+			}
+
+			::poll(poll_list.data(), poll_list.count(), timeout);
+
+			for(const struct pollfd & entry: poll_list){
+				if( entry.revents == 0 ){ continue; }
+				for(Worker * worker: running_list){
+					if( (entry.fd != worker->output_fd) && (entry.fd != worker->status_fd) ){
+						continue;
+					}
+					if( read_worker(*worker, entry.fd) <= 0 ){
+						::close(entry.fd);
+						if( entry.fd == worker->output_fd ){
+							worker->output_fd = -1;
+						} else {
+							worker->status_fd = -1;
+						}
+					}
+					break;
+				}
+			}
+
+			for(u32 i=0; i < running_list.count();){
+				Worker * worker = running_list.at(i);
+				if( m_case_timeout &&
+						worker->is_case_open &&
+						(worker->is_timed_out == false) &&
+						(worker->case_timer.microseconds() >= m_case_timeout) ){
+					worker->is_timed_out = true;
+					::kill(worker->pid, SIGKILL);
+				}
+
+				if( (worker->output_fd < 0) && (worker->status_fd < 0) ){
+					if( finish_worker(*worker) == false ){
+						result++;
+					}
+					report_list.at(worker->entry_index) = worker;
+					running_list.remove(i);
+				} else {
+					i++;
+				}
+			}
+		}
+
+		//print the reports in the order the tests were added
+		while( (next_report < entry_count) && report_list.at(next_report) ){
+			Worker * worker = report_list.at(next_report);
+			fwrite(worker->output.cstring(), 1, worker->output.length(), stdout);
+			delete worker;
+			report_list.at(next_report) = nullptr;
+			next_report++;
+		}
+	}
+
+	fflush(stdout);
+	return result;
+}
 
+#endif
@@ -0,0 +1,188 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include <cstring>
+#include "test/HttpServerBenchmark.hpp"
+#include "chrono/Timer.hpp"
+#include "inet/HttpServer.hpp"
+#include "inet/Socket.hpp"
+#include "sys/Thread.hpp"
+#include "var/Data.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace inet;
+
+namespace {
+
+/*! \cond */
+struct Client {
+	const SocketAddress * address;
+	const var::String * request;
+	u32 response_size;
+	u32 iterations;
+	var::Vector<u32> latency_list;
+	int result;
+};
+
+//returns the number of bytes in the response header or zero if it isn't complete
+u32 find_header_end(const char * buffer, u32 size){
+	for(u32 i=3; i < size; i++){
+		if( ::memcmp(buffer + i - 3, "\r\n\r\n", 4) == 0 ){
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+int read_response(const Socket & socket, var::Data & buffer, u32 response_size){
+	char * response = buffer.to_char();
+	u32 size = 0;
+	u32 header_size = 0;
+	do {
+		if( size == buffer.size() ){
+			return -1;
+		}
+		int result = socket.read(response + size, fs::File::Size(buffer.size() - size));
+		if( result <= 0 ){
+			return -1;
+		}
+		size += result;
+		if( header_size == 0 ){
+			header_size = find_header_end(response, size);
+		}
+	} while( (header_size == 0) || (size < header_size + response_size) );
+	return ::strncmp(response, "HTTP/1.1 200", 12) == 0 ? 0 : -1;
+}
+
+void * run_client(void * args){
+	Client * client = static_cast<Client*>(args);
+	client->result = -1;
+
+	Socket socket;
+	if( (socket.create(*client->address) < 0) ||
+			(socket.connect(*client->address) < 0) ){
+		return nullptr;
+	}
+
+	//the response header is well under 256 bytes
+	var::Data buffer(client->response_size + 256);
+	chrono::Timer timer;
+	for(u32 i=0; i < client->iterations; i++){
+		timer.restart();
+		if( (socket.write(client->request->cstring(), fs::File::Size(client->request->length())) < 0) ||
+				(read_response(socket, buffer, client->response_size) < 0) ){
+			socket.close();
+			return nullptr;
+		}
+		client->latency_list.push_back(timer.microseconds());
+	}
+
+	socket.close();
+	client->result = 0;
+	return nullptr;
+}
+/*! \endcond */
+
+}
+
+HttpServerBenchmark::HttpServerBenchmark(){
+	m_port = 8090;
+	m_response_size = 128;
+	m_maximum_concurrency = 16;
+}
+
+HttpServerBenchmark & HttpServerBenchmark::run(test::Benchmark & benchmark){
+	m_latency_list.clear();
+
+	const var::Data body(m_response_size);
+	Socket server_socket;
+	HttpServer server(server_socket);
+	server.add_route(
+				"GET",
+				"/benchmark",
+				[&](const HttpServerRequest & request, HttpServerResponse & response) -> int {
+		MCU_UNUSED_ARGUMENT(request);
+		return response.send(body, "text/plain");
+	});
+
+	const SocketAddress address(
+				SocketAddressIpv4(SocketAddressIpv4::address(127,0,0,1), m_port)
+				);
+
+	//each worker serves one connection at a time so there is one for each client
+	if( server.start(address, HttpServer::ThreadCount(m_maximum_concurrency)) < 0 ){
+		set_error_number(server.error_number());
+		return *this;
+	}
+
+	const var::String request("GET /benchmark HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+
+	var::Vector<Client> client_list;
+	var::Vector<sys::Thread> threads;
+	client_list.vector().reserve(m_maximum_concurrency);
+	threads.vector().reserve(m_maximum_concurrency);
+	for(u32 concurrency = 1; concurrency <= m_maximum_concurrency; concurrency *= 2){
+		client_list.clear();
+		for(u32 i=0; i < concurrency; i++){
+			Client client;
+			client.address = &address;
+			client.request = &request;
+			client.response_size = m_response_size;
+			client_list.push_back(client);
+		}
+
+		benchmark.run(m_prefix + var::String().format("http_server.concurrency.%ld", concurrency), [&](u32 iterations){
+			for(auto & client: client_list){
+				client.iterations = iterations;
+				threads.vector().emplace_back(
+							sys::Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE),
+							sys::Thread::IsDetached(false)
+							);
+				if( threads.back().create(
+							sys::Thread::Function(run_client),
+							sys::Thread::FunctionArgument(&client)
+							) < 0 ){
+					threads.pop_back();
+					set_error_number(EAGAIN);
+					break;
+				}
+			}
+
+			//is_valid() can't be used here: it doesn't change when a thread is created on link builds
+			while( threads.count() ){
+				threads.back().join();
+				threads.pop_back();
+			}
+
+			for(const auto & client: client_list){
+				if( client.result < 0 ){
+					set_error_number(ECONNREFUSED);
+				}
+			}
+		}, test::Benchmark::BytesPerIteration(0), test::Benchmark::ItemsPerIteration(concurrency));
+
+		//includes the requests sent during the warmup
+		var::Vector<u32> latency_list;
+		for(const auto & client: client_list){
+			for(u32 latency: client.latency_list){
+				latency_list.push_back(latency);
+			}
+		}
+		latency_list.sort(var::Vector<u32>::ascending);
+
+		HttpServerLatency latency;
+		const u32 count = latency_list.count();
+		latency.m_concurrency = concurrency;
+		latency.m_request_count = count;
+		if( count ){
+			latency.m_minimum = latency_list.at(0);
+			latency.m_median = latency_list.at(count/2);
+			latency.m_p99 = latency_list.at(count*99/100);
+			latency.m_maximum = latency_list.at(count-1);
+		}
+		m_latency_list.push_back(latency);
+	}
+
+	server.stop();
+	return *this;
+}
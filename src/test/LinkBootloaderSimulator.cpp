@@ -0,0 +1,86 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#if defined __link
+
+#include <cstring>
+#include "test/LinkBootloaderSimulator.hpp"
+
+using namespace test;
+
+LinkBootloaderSimulator::LinkBootloaderSimulator(
+		FlashSize flash_size,
+		HardwareId hardware_id
+		) : m_flash(flash_size.argument()){
+	m_flash.fill<u8>(0xff);
+	::memset(&m_attributes, 0, sizeof(m_attributes));
+	m_attributes.startaddr = 0;
+	m_attributes.hardware_id = hardware_id.argument();
+	set_bootloader_attributes(m_attributes);
+}
+
+void LinkBootloaderSimulator::wait_for_request(u32 size){
+	u32 microseconds = m_latency.microseconds();
+	if( m_bytes_per_second ){
+		microseconds += static_cast<u32>(
+					static_cast<u64>(size) * 1000000UL / m_bytes_per_second
+					);
+	}
+	m_request_count++;
+	if( microseconds ){
+		chrono::MicroTime(microseconds).wait();
+	}
+}
+
+bool LinkBootloaderSimulator::is_in_flash(u32 address, u32 size) const {
+	return (address <= m_flash.size()) && (size <= m_flash.size() - address);
+}
+
+int LinkBootloaderSimulator::read_bootloader_flash(u32 address, void * buffer, u32 size){
+	wait_for_request(size);
+	if( is_in_flash(address, size) == false ){
+		return -1;
+	}
+	::memcpy(buffer, m_flash.to_const_u8() + address, size);
+	m_bytes_read += size;
+	return static_cast<int>(size);
+}
+
+int LinkBootloaderSimulator::write_bootloader_flash(u32 address, const void * buffer, u32 size){
+	wait_for_request(size);
+	if( is_in_flash(address, size) == false ){
+		return -1;
+	}
+	//programming flash can only clear bits
+	u8 * flash = m_flash.to_u8() + address;
+	const u8 * data = static_cast<const u8*>(buffer);
+	for(u32 i=0; i < size; i++){
+		flash[i] &= data[i];
+	}
+	m_bytes_written += size;
+	return static_cast<int>(size);
+}
+
+int LinkBootloaderSimulator::erase_bootloader_flash(){
+	wait_for_request(0);
+	m_flash.fill<u8>(0xff);
+	m_erase_count++;
+	return 0;
+}
+
+int LinkBootloaderSimulator::wait_for_bootloader(
+		BootloaderRetryCount bootloader_retry_total,
+		const sys::ProgressCallback * progress_callback
+		){
+	MCU_UNUSED_ARGUMENT(bootloader_retry_total);
+	MCU_UNUSED_ARGUMENT(progress_callback);
+	//the simulated bootloader doesn't restart after the erase
+	bootloader_attr_t attributes;
+	return read_bootloader_attributes(attributes);
+}
+
+int LinkBootloaderSimulator::read_bootloader_attributes(bootloader_attr_t & attributes){
+	wait_for_request(sizeof(attributes));
+	attributes = m_attributes;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,49 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#if defined __link
+
+#include "test/LinkFileSimulator.hpp"
+
+using namespace test;
+
+LinkFileSimulator::LinkFileSimulator(
+		const fs::OpenFlags & flags
+		) : fs::DataFile(flags){}
+
+void LinkFileSimulator::wait_for_request(u32 size) const {
+	u32 microseconds = m_latency.microseconds();
+	if( m_bytes_per_second ){
+		microseconds += static_cast<u32>(
+					static_cast<u64>(size) * 1000000UL / m_bytes_per_second
+					);
+	}
+	m_request_count++;
+	if( microseconds ){
+		chrono::MicroTime(microseconds).wait();
+	}
+}
+
+int LinkFileSimulator::read(
+		void * buf,
+		Size nbyte
+		) const {
+	int result = DataFile::read(buf, nbyte);
+	wait_for_request(result > 0 ? static_cast<u32>(result) : 0);
+	if( result > 0 ){
+		m_bytes_transferred += static_cast<u32>(result);
+	}
+	return result;
+}
+
+int LinkFileSimulator::write(
+		const void * buf,
+		Size nbyte
+		) const {
+	wait_for_request(nbyte.argument());
+	int result = DataFile::write(buf, nbyte);
+	if( result > 0 ){
+		m_bytes_transferred += static_cast<u32>(result);
+	}
+	return result;
+}
+
+#endif
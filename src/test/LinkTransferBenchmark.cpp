@@ -0,0 +1,84 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#if defined __link
+
+#include <errno.h>
+#include "test/LinkTransferBenchmark.hpp"
+#include "test/LinkFileSimulator.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace sys;
+
+LinkTransferBenchmark::LinkTransferBenchmark() : m_latency(1000){
+	m_file_size = 256*1024;
+	m_bytes_per_second = 1000000;
+	m_page_size_minimum = 1024;
+	m_page_size_maximum = 64*1024;
+}
+
+LinkTransferBenchmark & LinkTransferBenchmark::run(test::Benchmark & benchmark){
+	fs::DataFile host_file;
+	host_file.data().resize(m_file_size);
+	u8 * host_bytes = host_file.data().to_u8();
+	for(u32 i=0; i < m_file_size; i++){
+		host_bytes[i] = static_cast<u8>(i);
+	}
+
+	LinkFileSimulator device_file;
+	device_file.data().resize(m_file_size);
+	device_file.set_latency(m_latency).set_bytes_per_second(m_bytes_per_second);
+
+	Link link;
+
+	auto copy = [&](const fs::File & source, fs::File & destination){
+		source.seek(0);
+		destination.seek(0);
+		if( link.copy(
+					Link::SourceFile(source),
+					Link::DestinationFile(destination)
+					) < 0 ){
+			set_error_number(EIO);
+			return false;
+		}
+		return true;
+	};
+
+	auto check_copy = [&](){
+		if( device_file.data() != host_file.data() ){
+			set_error_number(EIO);
+		}
+	};
+
+	const test::Benchmark::BytesPerIteration bytes(m_file_size);
+
+	auto run_direction = [&](const char * direction, bool is_to_device){
+		const fs::File & source = is_to_device ?
+					static_cast<const fs::File&>(host_file) : device_file;
+		fs::File & destination = is_to_device ?
+					static_cast<fs::File&>(device_file) : host_file;
+
+		link.set_transfer_page_size_range(m_page_size_minimum, m_page_size_minimum);
+		benchmark.run(m_prefix + "link_transfer." + direction + ".fixed", [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				if( copy(source, destination) == false ){ return; }
+			}
+		}, bytes);
+		check_copy();
+
+		link.set_transfer_page_size_range(m_page_size_minimum, m_page_size_maximum);
+		benchmark.run(m_prefix + "link_transfer." + direction + ".adaptive", [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				if( copy(source, destination) == false ){ return; }
+			}
+		}, bytes);
+		check_copy();
+		return link.transfer_statistics();
+	};
+
+	m_to_device_statistics = run_direction("to_device", true);
+	m_from_device_statistics = run_direction("from_device", false);
+
+	return *this;
+}
+
+#endif
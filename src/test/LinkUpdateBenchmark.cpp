@@ -0,0 +1,113 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#if defined __link
+
+#include <errno.h>
+#include <cstring>
+#include "test/LinkUpdateBenchmark.hpp"
+#include "test/LinkBootloaderSimulator.hpp"
+#include "fs/File.hpp"
+#include "sys/Printer.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace sys;
+
+namespace {
+
+/*! \cond */
+enum {
+	//the size of the pages written by Link::install_os()
+	page_size = 1024,
+	hardware_id = 0x00000003
+};
+/*! \endcond */
+
+}
+
+LinkUpdateBenchmark::LinkUpdateBenchmark() : m_latency(1000){
+	m_image_size = 64*1024;
+	m_bytes_per_second = 1000000;
+	m_is_verify = false;
+}
+
+LinkUpdateBenchmark & LinkUpdateBenchmark::run(test::Benchmark & benchmark){
+	//whole pages (at least four) keep the changed page easy to place
+	u32 image_size = (m_image_size + page_size - 1) / page_size * page_size;
+	if( image_size < 4*page_size ){
+		image_size = 4*page_size;
+	}
+	const u32 data_size = image_size / page_size * 3 / 4 * page_size;
+
+	fs::DataFile image;
+	image.data().resize(image_size);
+	u8 * image_bytes = image.data().to_u8();
+	for(u32 i=0; i < data_size; i++){
+		//never 0xFF so no page with data looks erased
+		image_bytes[i] = static_cast<u8>(i % 251);
+	}
+	::memset(image_bytes + data_size, 0xff, image_size - data_size);
+	const u32 image_id = hardware_id;
+	::memcpy(image_bytes + BOOTLOADER_HARDWARE_ID_OFFSET, &image_id, sizeof(image_id));
+
+	//the same image with a change in the last page that has data
+	var::Data changed(image.data());
+	changed.to_u8()[data_size - page_size] ^= 0x01;
+
+	const LinkBootloaderSimulator::FlashSize flash_size(image_size);
+	LinkBootloaderSimulator link(flash_size, Link::HardwareId(image_id));
+	link.set_latency(m_latency).set_bytes_per_second(m_bytes_per_second);
+
+	Printer printer;
+	printer.set_verbose_level(Printer::level_fatal);
+
+	auto update = [&](const var::Data & installed, bool is_skip_if_identical) -> bool {
+		link.flash() = installed;
+		if( link.update_os(
+					image,
+					Link::IsVerify(m_is_verify),
+					printer,
+					Link::BootloaderRetryCount(0),
+					Link::IsSkipIfIdentical(is_skip_if_identical)
+					) < 0 ){
+			set_error_number(EIO);
+			return false;
+		}
+		return true;
+	};
+
+	auto check_flash = [&](){
+		if( link.flash() != image.data() ){
+			set_error_number(EIO);
+		}
+	};
+
+	const test::Benchmark::BytesPerIteration bytes(image_size);
+
+	benchmark.run(m_prefix + "link_update.full", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			if( update(changed, false) == false ){ return; }
+		}
+	}, bytes);
+	m_full_statistics = link.update_statistics();
+	check_flash();
+
+	benchmark.run(m_prefix + "link_update.skip_if_identical.same", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			if( update(image.data(), true) == false ){ return; }
+		}
+	}, bytes);
+	m_same_statistics = link.update_statistics();
+	check_flash();
+
+	benchmark.run(m_prefix + "link_update.skip_if_identical.changed", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			if( update(changed, true) == false ){ return; }
+		}
+	}, bytes);
+	m_changed_statistics = link.update_statistics();
+	check_flash();
+
+	return *this;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include "test/MatrixBenchmark.hpp"
+#include "var/Matrix.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace var;
+
+namespace {
+
+template<typename T> void create_matrix(Matrix<T> & matrix, u32 size, u32 & seed){
+	matrix.resize(size, size);
+	T * data = matrix.data();
+	for(u32 i=0; i < size*size; i++){
+		seed = seed * 1664525u + 1013904223u;
+		//values between -1 and 1
+		data[i] = static_cast<T>(static_cast<s32>(seed >> 8) - 0x800000) / static_cast<T>(0x800000);
+	}
+}
+
+template<typename T> void run_matrix(
+		test::Benchmark & benchmark,
+		const var::String & name,
+		u32 size
+		){
+	u32 seed = size;
+	Matrix<T> a;
+	Matrix<T> b;
+	Matrix<T> result(size, size);
+	create_matrix(a, size, seed);
+	create_matrix(b, size, seed);
+
+	const u64 operation_count = 2ULL * size * size * size;
+	benchmark.run(name + "multiply." + var::String::number(size), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			Matrix<T>::multiply(result.view(), a.view(), b.view());
+			test::do_not_optimize(result.data()[i % (size*size)]);
+		}
+	},
+	test::Benchmark::BytesPerIteration(0),
+	test::Benchmark::ItemsPerIteration(operation_count)
+	);
+
+	benchmark.run(name + "transpose." + var::String::number(size), [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			Matrix<T>::transpose(result.view(), a.view());
+			test::do_not_optimize(result.data()[i % (size*size)]);
+		}
+	},
+	test::Benchmark::BytesPerIteration(2 * size * size * sizeof(T)),
+	test::Benchmark::ItemsPerIteration(size * size)
+	);
+}
+
+}
+
+MatrixBenchmark::MatrixBenchmark(){
+	m_minimum_size = 64;
+	m_maximum_size = SAPI_MATRIX_BENCHMARK_MAXIMUM_SIZE;
+}
+
+MatrixBenchmark & MatrixBenchmark::run(test::Benchmark & benchmark){
+	for(u32 size = m_minimum_size; size <= m_maximum_size; size *= 2){
+		run_matrix<float>(benchmark, m_prefix + "matrix.float.", size);
+		run_matrix<double>(benchmark, m_prefix + "matrix.double.", size);
+	}
+	return *this;
+}
@@ -0,0 +1,81 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include "test/MemoryResourceBenchmark.hpp"
+#include "var/Data.hpp"
+#include "var/Tokenizer.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace var;
+
+u32 MemoryResourceBenchmark::parse_row(u32 row){
+	u32 result = 0;
+
+	String line;
+	for(u32 i=0; i < 12; i++){
+		line << "field_value_" << String::number(row * i) << ",";
+	}
+
+	StringList field_list = line.split(",");
+	Tokenizer tokenizer(line, Tokenizer::Delimeters(","));
+	result += field_list.count() + tokenizer.count();
+
+	const char * header_list[] = {
+		"Content-Type: application/json; charset=utf-8",
+		"Cache-Control: no-cache, no-store, must-revalidate",
+		"Set-Cookie: session=38afes7a8; Path=/; Secure; HttpOnly"
+	};
+	for(const char * header: header_list){
+		Tokenizer header_tokenizer(header, Tokenizer::Delimeters(":;"));
+		result += header_tokenizer.count();
+	}
+
+	Data data;
+	for(const String & field: field_list){
+		data.append(
+					Reference(
+						Reference::ReadOnlyBuffer(field.cstring()),
+						Reference::Size(field.length())
+						)
+					);
+	}
+	result += data.size();
+	return result;
+}
+
+MemoryResourceBenchmark & MemoryResourceBenchmark::run(test::Benchmark & benchmark){
+	const test::Benchmark::ItemsPerIteration rows(1);
+
+	benchmark.run(m_prefix + "memory_resource.heap", [&](u32 iterations){
+		MemoryResourceScope scope(nullptr);
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(parse_row(i));
+		}
+	}, test::Benchmark::BytesPerIteration(0), rows);
+
+#if defined __link
+	ArenaResource arena(ArenaResource::BlockSize(16384));
+	benchmark.run(m_prefix + "memory_resource.arena", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			{
+				MemoryResourceScope scope(&arena);
+				test::do_not_optimize(parse_row(i));
+			}
+			m_arena_info = arena.info();
+			if( arena.release() < 0 ){
+				set_error_number(arena.error_number());
+			}
+		}
+	}, test::Benchmark::BytesPerIteration(0), rows);
+
+	PoolResource pool(PoolResource::BlockSize(64), PoolResource::BlockCount(256));
+	benchmark.run(m_prefix + "memory_resource.pool", [&](u32 iterations){
+		MemoryResourceScope scope(&pool);
+		for(u32 i=0; i < iterations; i++){
+			test::do_not_optimize(parse_row(i));
+		}
+	}, test::Benchmark::BytesPerIteration(0), rows);
+	m_pool_info = pool.info();
+#endif
+
+	return *this;
+}
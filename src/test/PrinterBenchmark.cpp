@@ -0,0 +1,74 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include "test/PrinterBenchmark.hpp"
+#include "sys/JsonPrinter.hpp"
+#include "sys/YamlPrinter.hpp"
+#include "sys/MarkdownPrinter.hpp"
+#include "var/Json.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace sys;
+
+PrinterBenchmark::PrinterBenchmark(){
+	m_entry_count = 10000;
+	m_flush_mode = Printer::flush_size;
+}
+
+var::JsonValue PrinterBenchmark::create_value() const {
+	var::JsonArray result;
+	for(u32 i=0; i < m_entry_count; i++){
+		result.append(
+					var::JsonObject()
+					.insert("id", var::JsonInteger(i))
+					.insert("name", var::JsonString(var::String().format("entry%ld", i)))
+					.insert("value", var::JsonReal(i * 0.125f))
+					.insert("enabled", (i & 1) ? var::JsonValue(var::JsonTrue()) : var::JsonValue(var::JsonFalse()))
+					);
+	}
+	return result;
+}
+
+PrinterBenchmark & PrinterBenchmark::run(test::Benchmark & benchmark){
+	var::String output;
+	StringPrinterSink sink(output);
+	const var::JsonValue value = create_value();
+	run_printer<Printer>(benchmark, "printer", sink, "string", value, &output);
+	run_printer<JsonPrinter>(benchmark, "json_printer", sink, "string", value, &output);
+	run_printer<YamlPrinter>(benchmark, "yaml_printer", sink, "string", value, &output);
+	run_printer<MarkdownPrinter>(benchmark, "markdown_printer", sink, "string", value, &output);
+	return *this;
+}
+
+PrinterBenchmark & PrinterBenchmark::run(
+		test::Benchmark & benchmark,
+		PrinterSink & sink,
+		const var::String & name
+		){
+	const var::JsonValue value = create_value();
+	run_printer<Printer>(benchmark, "printer", sink, name, value, nullptr);
+	run_printer<JsonPrinter>(benchmark, "json_printer", sink, name, value, nullptr);
+	run_printer<YamlPrinter>(benchmark, "yaml_printer", sink, name, value, nullptr);
+	run_printer<MarkdownPrinter>(benchmark, "markdown_printer", sink, name, value, nullptr);
+	return *this;
+}
+
+template<class T> void PrinterBenchmark::run_printer(
+		test::Benchmark & benchmark,
+		const char * printer_name,
+		PrinterSink & sink,
+		const var::String & sink_name,
+		const var::JsonValue & value,
+		var::String * output
+		){
+	benchmark.run(m_prefix + printer_name + "." + sink_name, [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			if( output ){
+				output->clear();
+			}
+			T printer;
+			printer.set_sink(sink).set_flush_mode(m_flush_mode);
+			printer << value;
+			printer.flush();
+		}
+	}, test::Benchmark::BytesPerIteration(0), test::Benchmark::ItemsPerIteration(m_entry_count));
+}
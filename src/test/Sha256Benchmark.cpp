@@ -0,0 +1,71 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include <cstring>
+#include "test/Sha256Benchmark.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace crypto;
+
+Sha256Benchmark::Sha256Benchmark(){
+	m_size = 1024;
+	m_count = 64;
+}
+
+Sha256Benchmark & Sha256Benchmark::run(test::Benchmark & benchmark){
+	var::Data buffer(m_size * m_count);
+	if( buffer.size() != m_size * m_count ){
+		set_error_number(ENOMEM);
+		return *this;
+	}
+
+	u32 value = 1;
+	for(u32 i=0; i < buffer.size(); i++){
+		value = value * 1664525u + 1013904223u;
+		buffer.to_u8()[i] = static_cast<u8>(value >> 24);
+	}
+
+	var::Vector<var::Reference> input_list;
+	for(u32 i=0; i < m_count; i++){
+		input_list.push_back(
+					var::Reference(
+						var::Reference::ReadOnlyBuffer(buffer.to_const_u8() + i*m_size),
+						var::Reference::Size(m_size)
+						)
+					);
+	}
+
+	Sha256::set_instruction_set(Sha256::instruction_set_portable);
+	const var::Vector<var::Array<u8, 32>> expected = Sha256::calculate(input_list);
+
+	const test::Benchmark::BytesPerIteration bytes(m_size * m_count);
+	const test::Benchmark::ItemsPerIteration items(m_count);
+
+	auto run_instruction_set = [&](const char * name, u32 instruction_set){
+		Sha256::set_instruction_set(instruction_set);
+		if( Sha256::instruction_set() != instruction_set ){
+			//not supported by this CPU
+			return;
+		}
+
+		const var::Vector<var::Array<u8, 32>> output_list = Sha256::calculate(input_list);
+		for(u32 i=0; i < m_count; i++){
+			if( ::memcmp(output_list.at(i).data(), expected.at(i).data(), Sha256::length()) != 0 ){
+				set_error_number(EIO);
+			}
+		}
+
+		benchmark.run(m_prefix + "sha256." + name, [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				test::do_not_optimize(Sha256::calculate(input_list));
+			}
+		}, bytes, items);
+	};
+
+	run_instruction_set("portable", Sha256::instruction_set_portable);
+	run_instruction_set("sha", Sha256::instruction_set_sha);
+	run_instruction_set("multi_buffer", Sha256::instruction_set_avx2);
+
+	Sha256::set_instruction_set(Sha256::instruction_set_all);
+	return *this;
+}
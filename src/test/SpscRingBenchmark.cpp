@@ -0,0 +1,222 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include <errno.h>
+#include <sched.h>
+#include "test/SpscRingBenchmark.hpp"
+#include "var/SpscRing.hpp"
+#include "var/Vector.hpp"
+#include "sys/Thread.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace var;
+
+namespace {
+
+/*! \cond */
+enum {
+	batch_size = 64,
+	//checked before giving up the processor (the other thread may need it)
+	spin_count = 64
+};
+
+struct Context {
+	Context(u32 capacity) : ring(capacity), reply_ring(capacity){}
+	SpscRing<u32> ring;
+	SpscRing<u32> reply_ring;
+	u32 item_count;
+	bool is_ok;
+};
+
+void wait_for_other_thread(u32 & count){
+	if( ++count == spin_count ){
+		count = 0;
+		::sched_yield();
+	}
+}
+
+void * produce(void * args){
+	Context * context = static_cast<Context*>(args);
+	u32 values[batch_size];
+	u32 spin = 0;
+	for(u32 next = 0; next < context->item_count;){
+		u32 count = context->item_count - next;
+		if( count > batch_size ){ count = batch_size; }
+		for(u32 i=0; i < count; i++){
+			values[i] = next + i;
+		}
+
+		u32 pushed = 0;
+		while( pushed < count ){
+			const u32 result = context->ring.push_batch(values + pushed, count - pushed);
+			if( result == 0 ){
+				wait_for_other_thread(spin);
+			}
+			pushed += result;
+		}
+		next += count;
+	}
+	return nullptr;
+}
+
+void * consume(void * args){
+	Context * context = static_cast<Context*>(args);
+	u32 spin = 0;
+	bool is_ok = true;
+	for(u32 next = 0; next < context->item_count;){
+		const SpscRing<u32>::Span span = context->ring.peek_span();
+		if( span.is_empty() ){
+			wait_for_other_thread(spin);
+			continue;
+		}
+		//items are used in place
+		for(u32 i=0; i < span.count(); i++){
+			if( span.at(i) != next + i ){
+				is_ok = false;
+			}
+		}
+		context->ring.consume(span.count());
+		next += span.count();
+	}
+	context->is_ok = is_ok;
+	return nullptr;
+}
+
+void * ping(void * args){
+	Context * context = static_cast<Context*>(args);
+	u32 spin = 0;
+	bool is_ok = true;
+	for(u32 i=0; i < context->item_count; i++){
+		while( context->ring.push(i) < 0 ){
+			wait_for_other_thread(spin);
+		}
+		u32 value;
+		while( context->reply_ring.pop(value) < 0 ){
+			wait_for_other_thread(spin);
+		}
+		if( value != i ){
+			is_ok = false;
+		}
+	}
+	context->is_ok = is_ok;
+	return nullptr;
+}
+
+void * pong(void * args){
+	Context * context = static_cast<Context*>(args);
+	u32 spin = 0;
+	for(u32 i=0; i < context->item_count; i++){
+		u32 value;
+		while( context->ring.pop(value) < 0 ){
+			wait_for_other_thread(spin);
+		}
+		while( context->reply_ring.push(value) < 0 ){
+			wait_for_other_thread(spin);
+		}
+	}
+	return nullptr;
+}
+
+bool create_thread(
+		var::Vector<sys::Thread> & threads,
+		void * (*function)(void*),
+		Context * context
+		){
+	threads.vector().emplace_back(
+				sys::Thread::StackSize(SAPI_WORKER_THREAD_STACK_SIZE),
+				sys::Thread::IsDetached(false)
+				);
+	if( threads.back().create(
+				sys::Thread::Function(function),
+				sys::Thread::FunctionArgument(context)
+				) < 0 ){
+		threads.pop_back();
+		return false;
+	}
+	return true;
+}
+
+int run_threads(
+		var::Vector<sys::Thread> & threads,
+		void * (*producer_function)(void*),
+		void * (*consumer_function)(void*),
+		Context * context
+		){
+	if( create_thread(threads, consumer_function, context) == false ){
+		return -1;
+	}
+
+	if( create_thread(threads, producer_function, context) == false ){
+		//the calling thread produces the items instead
+		producer_function(context);
+	}
+
+	//is_valid() can't be used here: it doesn't change when a thread is created on link builds
+	while( threads.count() ){
+		threads.back().join();
+		threads.pop_back();
+	}
+	return 0;
+}
+/*! \endcond */
+
+}
+
+SpscRingBenchmark::SpscRingBenchmark(){
+	m_item_count = 1024*1024;
+	m_round_trip_count = 16*1024;
+	m_capacity = 4096;
+}
+
+SpscRingBenchmark & SpscRingBenchmark::run(test::Benchmark & benchmark){
+	Context context(m_capacity);
+	if( context.ring.count() == 0 ){
+		set_error_number(ENOMEM);
+		return *this;
+	}
+
+	const test::Benchmark::ItemsPerIteration items(m_item_count);
+	const test::Benchmark::BytesPerIteration bytes(m_item_count * sizeof(u32));
+
+	benchmark.run(m_prefix + "spsc_ring.threads.1", [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			u32 sum = 0;
+			for(u32 j=0; j < m_item_count; j++){
+				u32 value;
+				context.ring.push(j);
+				context.ring.pop(value);
+				sum += value;
+			}
+			test::do_not_optimize(sum);
+		}
+	}, bytes, items);
+
+	var::Vector<sys::Thread> threads;
+	threads.vector().reserve(2);
+
+	auto run_pair = [&](
+			const char * name,
+			u32 item_count,
+			void * (*producer_function)(void*),
+			void * (*consumer_function)(void*)
+			){
+		context.item_count = item_count;
+		benchmark.run(m_prefix + "spsc_ring." + name, [&](u32 iterations){
+			for(u32 i=0; i < iterations; i++){
+				context.is_ok = false;
+				if( run_threads(threads, producer_function, consumer_function, &context) < 0 ){
+					set_error_number(EAGAIN);
+					return;
+				}
+				if( context.is_ok == false ){
+					set_error_number(EIO);
+					return;
+				}
+			}
+		}, test::Benchmark::BytesPerIteration(item_count * sizeof(u32)), test::Benchmark::ItemsPerIteration(item_count));
+	};
+
+	run_pair("throughput", m_item_count, produce, consume);
+	run_pair("round_trip", m_round_trip_count, ping, pong);
+
+	return *this;
+}
@@ -2,6 +2,8 @@
 
 #include <cstdio>
 #include "test/Test.hpp"
+#include "test/Benchmark.hpp"
+#include "test/Engine.hpp"
 #include "sys.hpp"
 #include "hal/Core.hpp"
 #include "var/String.hpp"
@@ -73,6 +75,29 @@ void Test::print_case_score(){
 	print_case_message_with_key("score", "%ld", score());
 }
 
+void Test::print_case_benchmark(const BenchmarkResult & result){
+	const var::String & name = result.name();
+	print_case_message_with_key(name + ".iterations", F32U, result.iteration_count());
+	print_case_message_with_key(name + ".minimumNs", "%0.3f", static_cast<double>(result.minimum()));
+	print_case_message_with_key(name + ".medianNs", "%0.3f", static_cast<double>(result.median()));
+	print_case_message_with_key(name + ".p99Ns", "%0.3f", static_cast<double>(result.p99()));
+	print_case_message_with_key(name + ".stddevNs", "%0.3f", static_cast<double>(result.standard_deviation()));
+	if( result.bytes_per_second() > 0.0f ){
+		print_case_message_with_key(name + ".bytesPerSecond", "%0.0f", static_cast<double>(result.bytes_per_second()));
+	}
+	if( result.items_per_second() > 0.0f ){
+		print_case_message_with_key(name + ".itemsPerSecond", "%0.0f", static_cast<double>(result.items_per_second()));
+	}
+	if( result.is_regression() ){
+		print_case_failed(
+					"%s is slower than the baseline (%0.3fns > %0.3fns)",
+					name.cstring(),
+					static_cast<double>(result.median()),
+					static_cast<double>(result.baseline_median())
+					);
+	}
+}
+
 void Test::execute(const sys::Cli & cli){
 	u32 o_flags = 0;
 
@@ -95,6 +120,10 @@ void Test::open_case(const var::String & case_name){
 	increment_indent();
 	m_case_message_number = 0;
 	m_case_result = true;
+	m_case_name = case_name;
+	if( Engine::m_active ){
+		Engine::m_active->case_opened(*this, case_name);
+	}
 	m_case_timer.restart();
 }
 
@@ -105,6 +134,14 @@ void Test::close_case(){
 void Test::close_case(bool result){
 	m_case_timer.stop();
 	m_test_duration_microseconds += m_case_timer.microseconds();
+	if( Engine::m_active ){
+		Engine::m_active->case_closed(
+					*this,
+					m_case_name,
+					result,
+					m_case_timer.microseconds()
+					);
+	}
 	if( result == false ){
 		m_all_test_result = false;
 		m_test_result = false;
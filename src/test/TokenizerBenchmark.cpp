@@ -0,0 +1,86 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#include "test/TokenizerBenchmark.hpp"
+#include "var/Tokenizer.hpp"
+#include "test/Benchmark.hpp"
+
+using namespace test;
+using namespace var;
+
+TokenizerBenchmark & TokenizerBenchmark::run(test::Benchmark & benchmark){
+	StringList header_list;
+	header_list.push_back("Host: api.stratifylabs.co");
+	header_list.push_back("User-Agent: StratifyAPI/4.0 (link; x86_64)");
+	header_list.push_back("Accept: application/json, text/plain; q=0.9, */*; q=0.8");
+	header_list.push_back("Content-Type: application/json; charset=utf-8");
+	header_list.push_back("Cache-Control: no-cache, no-store, must-revalidate");
+	header_list.push_back("Set-Cookie: session=38afes7a8; Path=/; Secure; HttpOnly");
+	run(benchmark, "header", header_list, ":;,");
+
+	StringList csv_list;
+	for(u32 i=0; i < 16; i++){
+		csv_list.push_back(
+					String().format(
+						"%ld,2020-10-%02ld 12:%02ld:00,\"Sensor %ld, rack %ld\",%ld.%03ld,%ld,ok,,",
+						i,
+						i + 1,
+						(i * 7) % 60,
+						i % 4,
+						i / 4,
+						(i * 7919) % 1000,
+						(i * 104729) % 1000,
+						i * 13
+						)
+					);
+	}
+	run(benchmark, "csv", csv_list, ",", "\"");
+	return *this;
+}
+
+TokenizerBenchmark & TokenizerBenchmark::run(
+		test::Benchmark & benchmark,
+		const var::String & name,
+		const var::StringList & line_list,
+		const var::String & delimeters,
+		const var::String & ignore_between
+		){
+	u32 size = 0;
+	for(const String & line: line_list){
+		size += line.length();
+	}
+	const test::Benchmark::BytesPerIteration bytes(size);
+	const test::Benchmark::ItemsPerIteration items(line_list.count());
+
+	Tokenizer tokenizer;
+	benchmark.run(m_prefix + "tokenizer." + name, [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			for(const String & line: line_list){
+				tokenizer.parse(
+							line,
+							Tokenizer::Delimeters(delimeters),
+							Tokenizer::IgnoreBetween(ignore_between)
+							);
+				test::do_not_optimize(tokenizer.count());
+			}
+		}
+	}, bytes, items);
+
+	benchmark.run(m_prefix + "token_scanner." + name, [&](u32 iterations){
+		for(u32 i=0; i < iterations; i++){
+			for(const String & line: line_list){
+				TokenScanner scanner(
+							line,
+							TokenScanner::Delimeters(delimeters),
+							TokenScanner::IgnoreBetween(ignore_between)
+							);
+				TokenView token;
+				u32 length = 0;
+				while( scanner.next(token) ){
+					length += token.length();
+				}
+				test::do_not_optimize(length);
+			}
+		}
+	}, bytes, items);
+
+	return *this;
+}
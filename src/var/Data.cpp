@@ -21,6 +21,13 @@ sys::Printer& sys::operator << (sys::Printer& printer, const var::DataInfo & a){
 	printer.key("freeBlockCount", F32U, a.free_block_count());
 	printer.key("freeSize", F32U, a.free_size());
 	printer.key("usedSize", F32U, a.used_size());
+	if( a.resource_info().capacity() ){
+		printer.key("resourceAllocationCount", F32U, a.resource_info().allocation_count());
+		printer.key("resourceUsedSize", F32U, a.resource_info().used_size());
+		printer.key("resourcePeakUsedSize", F32U, a.resource_info().peak_used_size());
+		printer.key("resourceCapacity", F32U, a.resource_info().capacity());
+		printer.key("resourceHeapBlockCount", F32U, a.resource_info().heap_block_count());
+	}
 	return printer;
 }
 #endif
@@ -43,7 +50,8 @@ int Data::free(){
 	//swapping with an empty vector forces the vector to free the memory
 	//other requests to free the memory are non-binding
 	//such as resize(), shrink_to_fit(), clear() and erase()
-	m_data = std::vector<u8>();
+	//the empty vector uses the same allocator so the swap is allowed
+	std::vector<u8, Allocator<u8>>(m_data.get_allocator()).swap(m_data);
 	update_reference();
 	return 0;
 }
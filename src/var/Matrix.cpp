@@ -1,6 +1,303 @@
-#include "Matrix.hpp"
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 
-Matrix::Matrix()
-{
+#include "var/Matrix.hpp"
 
+#if defined __link && defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+#define MATRIX_USE_X86 1
+#include <immintrin.h>
+#else
+#define MATRIX_USE_X86 0
+#endif
+
+using namespace var;
+
+namespace {
+
+/*
+ * The product is calculated the same way as most BLAS libraries:
+ * a block of b (inner_block x column_block) is copied (packed) so it
+ * is read sequentially and stays in the cache, then blocks of a (row_block x
+ * inner_block) are packed to fit in the L2 cache. The micro-kernel
+ * keeps a kernel_rows x kernel_columns block of the destination
+ * in registers while it reads the packed data.
+ */
+const u32 row_block = 96;
+const u32 inner_block = 256;
+const u32 column_block = 2048;
+
+template<typename T> struct Kernel {
+	//destination (stride items between rows) += packed_a * packed_b
+	using Function = void (*)(u32 inner_count, const T * packed_a, const T * packed_b, T * destination, u32 stride);
+};
+
+const u32 kernel_rows = 6;
+
+template<typename T> constexpr u32 kernel_columns(){
+	return 64 / sizeof(T);
+}
+
+template<typename T> void pack_a(
+		const T * a,
+		u32 a_stride,
+		u32 row_count,
+		u32 inner_count,
+		T * packed
+		){
+	for(u32 row = 0; row < row_count; row += kernel_rows){
+		const u32 count = row_count - row < kernel_rows ? row_count - row : kernel_rows;
+		for(u32 k = 0; k < inner_count; k++){
+			for(u32 i = 0; i < count; i++){
+				packed[i] = a[(row + i)*a_stride + k];
+			}
+			for(u32 i = count; i < kernel_rows; i++){
+				packed[i] = T();
+			}
+			packed += kernel_rows;
+		}
+	}
+}
+
+template<typename T> void pack_b(
+		const T * b,
+		u32 b_stride,
+		u32 inner_count,
+		u32 column_count,
+		T * packed
+		){
+	const u32 columns = kernel_columns<T>();
+	for(u32 column = 0; column < column_count; column += columns){
+		const u32 count = column_count - column < columns ? column_count - column : columns;
+		for(u32 k = 0; k < inner_count; k++){
+			const T * b_row = b + k*b_stride + column;
+			for(u32 j = 0; j < count; j++){
+				packed[j] = b_row[j];
+			}
+			for(u32 j = count; j < columns; j++){
+				packed[j] = T();
+			}
+			packed += columns;
+		}
+	}
+}
+
+//portable micro-kernel (the compiler vectorizes the inner loops)
+template<typename T> void kernel_generic(
+		u32 inner_count,
+		const T * packed_a,
+		const T * packed_b,
+		T * destination,
+		u32 stride
+		){
+	const u32 columns = kernel_columns<T>();
+	T accumulator[kernel_rows][kernel_columns<T>()] = {};
+	for(u32 k = 0; k < inner_count; k++){
+		for(u32 i = 0; i < kernel_rows; i++){
+			const T value = packed_a[i];
+			for(u32 j = 0; j < columns; j++){
+				accumulator[i][j] += value * packed_b[j];
+			}
+		}
+		packed_a += kernel_rows;
+		packed_b += columns;
+	}
+	for(u32 i = 0; i < kernel_rows; i++){
+		for(u32 j = 0; j < columns; j++){
+			destination[i*stride + j] += accumulator[i][j];
+		}
+	}
+}
+
+#if MATRIX_USE_X86
+
+//6x16 floats: 12 accumulators, 2 loads and 6 broadcasts per 12 multiply-adds
+__attribute__((target("avx2,fma")))
+void kernel_avx2(
+		u32 inner_count,
+		const float * packed_a,
+		const float * packed_b,
+		float * destination,
+		u32 stride
+		){
+	__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+	__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+	__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+	__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+	__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+	__m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+	for(u32 k = 0; k < inner_count; k++){
+		const __m256 b0 = _mm256_loadu_ps(packed_b);
+		const __m256 b1 = _mm256_loadu_ps(packed_b + 8);
+		__m256 a;
+		a = _mm256_broadcast_ss(packed_a + 0); c00 = _mm256_fmadd_ps(a, b0, c00); c01 = _mm256_fmadd_ps(a, b1, c01);
+		a = _mm256_broadcast_ss(packed_a + 1); c10 = _mm256_fmadd_ps(a, b0, c10); c11 = _mm256_fmadd_ps(a, b1, c11);
+		a = _mm256_broadcast_ss(packed_a + 2); c20 = _mm256_fmadd_ps(a, b0, c20); c21 = _mm256_fmadd_ps(a, b1, c21);
+		a = _mm256_broadcast_ss(packed_a + 3); c30 = _mm256_fmadd_ps(a, b0, c30); c31 = _mm256_fmadd_ps(a, b1, c31);
+		a = _mm256_broadcast_ss(packed_a + 4); c40 = _mm256_fmadd_ps(a, b0, c40); c41 = _mm256_fmadd_ps(a, b1, c41);
+		a = _mm256_broadcast_ss(packed_a + 5); c50 = _mm256_fmadd_ps(a, b0, c50); c51 = _mm256_fmadd_ps(a, b1, c51);
+		packed_a += 6;
+		packed_b += 16;
+	}
+#define MATRIX_STORE_ROW(row, low, high) \
+	_mm256_storeu_ps(destination + row*stride, _mm256_add_ps(_mm256_loadu_ps(destination + row*stride), low)); \
+	_mm256_storeu_ps(destination + row*stride + 8, _mm256_add_ps(_mm256_loadu_ps(destination + row*stride + 8), high))
+	MATRIX_STORE_ROW(0, c00, c01);
+	MATRIX_STORE_ROW(1, c10, c11);
+	MATRIX_STORE_ROW(2, c20, c21);
+	MATRIX_STORE_ROW(3, c30, c31);
+	MATRIX_STORE_ROW(4, c40, c41);
+	MATRIX_STORE_ROW(5, c50, c51);
+#undef MATRIX_STORE_ROW
+}
+
+//6x8 doubles
+__attribute__((target("avx2,fma")))
+void kernel_avx2(
+		u32 inner_count,
+		const double * packed_a,
+		const double * packed_b,
+		double * destination,
+		u32 stride
+		){
+	__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+	__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+	__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+	__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+	__m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+	__m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+	for(u32 k = 0; k < inner_count; k++){
+		const __m256d b0 = _mm256_loadu_pd(packed_b);
+		const __m256d b1 = _mm256_loadu_pd(packed_b + 4);
+		__m256d a;
+		a = _mm256_broadcast_sd(packed_a + 0); c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+		a = _mm256_broadcast_sd(packed_a + 1); c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+		a = _mm256_broadcast_sd(packed_a + 2); c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+		a = _mm256_broadcast_sd(packed_a + 3); c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+		a = _mm256_broadcast_sd(packed_a + 4); c40 = _mm256_fmadd_pd(a, b0, c40); c41 = _mm256_fmadd_pd(a, b1, c41);
+		a = _mm256_broadcast_sd(packed_a + 5); c50 = _mm256_fmadd_pd(a, b0, c50); c51 = _mm256_fmadd_pd(a, b1, c51);
+		packed_a += 6;
+		packed_b += 8;
+	}
+#define MATRIX_STORE_ROW(row, low, high) \
+	_mm256_storeu_pd(destination + row*stride, _mm256_add_pd(_mm256_loadu_pd(destination + row*stride), low)); \
+	_mm256_storeu_pd(destination + row*stride + 4, _mm256_add_pd(_mm256_loadu_pd(destination + row*stride + 4), high))
+	MATRIX_STORE_ROW(0, c00, c01);
+	MATRIX_STORE_ROW(1, c10, c11);
+	MATRIX_STORE_ROW(2, c20, c21);
+	MATRIX_STORE_ROW(3, c30, c31);
+	MATRIX_STORE_ROW(4, c40, c41);
+	MATRIX_STORE_ROW(5, c50, c51);
+#undef MATRIX_STORE_ROW
+}
+
+#endif
+
+template<typename T> typename Kernel<T>::Function select_kernel(){
+#if MATRIX_USE_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ){
+		return kernel_avx2;
+	}
+#endif
+	return kernel_generic<T>;
+}
+
+template<typename T> void multiply_packed(
+		const T * a,
+		u32 a_stride,
+		const T * b,
+		u32 b_stride,
+		T * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count,
+		u32 inner_count
+		){
+	static const typename Kernel<T>::Function kernel = select_kernel<T>();
+	const u32 columns = kernel_columns<T>();
+
+	for(u32 i = 0; i < row_count; i++){
+		T * destination_row = destination + i*destination_stride;
+		for(u32 j = 0; j < column_count; j++){
+			destination_row[j] = T();
+		}
+	}
+
+	if( (row_count == 0) || (column_count == 0) || (inner_count == 0) ){
+		return;
+	}
+
+	const u32 packed_columns = column_count < column_block ? column_count : column_block;
+	const u32 packed_inner = inner_count < inner_block ? inner_count : inner_block;
+	const u32 packed_rows = row_count < row_block ? row_count : row_block;
+	var::Vector<T> packed_b(
+				((packed_columns + columns - 1) / columns) * columns * packed_inner
+				);
+	var::Vector<T> packed_a(
+				((packed_rows + kernel_rows - 1) / kernel_rows) * kernel_rows * packed_inner
+				);
+
+	for(u32 column = 0; column < column_count; column += column_block){
+		const u32 block_columns = column_count - column < column_block ? column_count - column : column_block;
+		for(u32 inner = 0; inner < inner_count; inner += inner_block){
+			const u32 block_inner = inner_count - inner < inner_block ? inner_count - inner : inner_block;
+			pack_b(b + inner*b_stride + column, b_stride, block_inner, block_columns, packed_b.data());
+
+			for(u32 row = 0; row < row_count; row += row_block){
+				const u32 block_rows = row_count - row < row_block ? row_count - row : row_block;
+				pack_a(a + row*a_stride + inner, a_stride, block_rows, block_inner, packed_a.data());
+
+				for(u32 j = 0; j < block_columns; j += columns){
+					const u32 tile_columns = block_columns - j < columns ? block_columns - j : columns;
+					for(u32 i = 0; i < block_rows; i += kernel_rows){
+						const u32 tile_rows = block_rows - i < kernel_rows ? block_rows - i : kernel_rows;
+						const T * tile_a = packed_a.data() + i*block_inner;
+						const T * tile_b = packed_b.data() + j*block_inner;
+						T * tile_destination = destination + (row + i)*destination_stride + column + j;
+						if( (tile_rows == kernel_rows) && (tile_columns == columns) ){
+							kernel(block_inner, tile_a, tile_b, tile_destination, destination_stride);
+						} else {
+							//edges are calculated in a full size tile then copied
+							T edge[kernel_rows * kernel_columns<T>()] = {};
+							kernel(block_inner, tile_a, tile_b, edge, columns);
+							for(u32 r = 0; r < tile_rows; r++){
+								for(u32 c = 0; c < tile_columns; c++){
+									tile_destination[r*destination_stride + c] += edge[r*columns + c];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+}
+
+void matrix_kernel::multiply(
+		const float * a,
+		u32 a_stride,
+		const float * b,
+		u32 b_stride,
+		float * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count,
+		u32 inner_count
+		){
+	multiply_packed(a, a_stride, b, b_stride, destination, destination_stride, row_count, column_count, inner_count);
+}
+
+void matrix_kernel::multiply(
+		const double * a,
+		u32 a_stride,
+		const double * b,
+		u32 b_stride,
+		double * destination,
+		u32 destination_stride,
+		u32 row_count,
+		u32 column_count,
+		u32 inner_count
+		){
+	multiply_packed(a, a_stride, b, b_stride, destination, destination_stride, row_count, column_count, inner_count);
 }
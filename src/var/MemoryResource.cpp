@@ -0,0 +1,187 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <errno.h>
+#include "var/MemoryResource.hpp"
+
+using namespace var;
+
+namespace {
+
+#if defined __link
+thread_local MemoryResource * current_resource = nullptr;
+#endif
+
+//enough for any type
+const u32 maximum_alignment = alignof(std::max_align_t);
+//size of ArenaResource::Block rounded up so the memory after it is aligned
+const u32 header_size = (sizeof(void*) + sizeof(u32) + maximum_alignment - 1) & ~(maximum_alignment - 1);
+
+u8 * align_pointer(u8 * pointer, u32 alignment){
+	const size_t value = reinterpret_cast<size_t>(pointer);
+	return reinterpret_cast<u8*>((value + alignment - 1) & ~static_cast<size_t>(alignment - 1));
+}
+
+}
+
+MemoryResource * MemoryResource::current(){
+#if defined __link
+	return current_resource;
+#else
+	//Stratify OS has no per-thread storage so scopes aren't supported
+	return nullptr;
+#endif
+}
+
+void MemoryResource::set_current(MemoryResource * resource){
+#if defined __link
+	current_resource = resource;
+#else
+	MCU_UNUSED_ARGUMENT(resource);
+#endif
+}
+
+ArenaResource::ArenaResource(BlockSize block_size){
+	m_block = nullptr;
+	m_position = nullptr;
+	m_end = nullptr;
+	m_buffer = nullptr;
+	m_buffer_size = 0;
+	m_block_size = block_size.argument();
+}
+
+ArenaResource::ArenaResource(void * buffer, u32 size, BlockSize block_size){
+	m_block = nullptr;
+	m_buffer = static_cast<u8*>(buffer);
+	m_buffer_size = size;
+	m_position = m_buffer;
+	m_end = m_buffer + size;
+	m_block_size = block_size.argument();
+	m_info.add_capacity(size);
+}
+
+ArenaResource::~ArenaResource(){
+	//objects that outlived the arena keep their memory (see release())
+	if( m_info.used_size() == 0 ){
+		free_blocks();
+	}
+}
+
+void * ArenaResource::allocate(u32 size, u32 alignment){
+	u8 * result = m_position ? align_pointer(m_position, alignment) : nullptr;
+	if( (result == nullptr) || (result > m_end) || (size > static_cast<u32>(m_end - result)) ){
+		//the block header is followed by the memory given out
+		u32 block_size = m_block_size;
+		if( size + alignment > block_size ){
+			block_size = size + alignment;
+		}
+
+		Block * block = static_cast<Block*>(::operator new(header_size + block_size));
+		block->next = m_block;
+		block->size = header_size + block_size;
+		m_block = block;
+		m_info.add_heap_block(block->size);
+
+		m_position = reinterpret_cast<u8*>(block) + header_size;
+		m_end = m_position + block_size;
+		result = align_pointer(m_position, alignment);
+	}
+
+	m_position = result + size;
+	m_info.add_allocation(size);
+	return result;
+}
+
+void ArenaResource::deallocate(void * pointer, u32 size, u32 alignment){
+	MCU_UNUSED_ARGUMENT(alignment);
+	//take back the last allocation (a vector or string that is growing)
+	if( static_cast<u8*>(pointer) + size == m_position ){
+		m_position = static_cast<u8*>(pointer);
+	}
+	m_info.add_free(size);
+}
+
+int ArenaResource::release(){
+	if( m_info.used_size() != 0 ){
+		//an object that was created in a scope is still alive
+		set_error_number(EBUSY);
+		return -1;
+	}
+
+	m_info.clear();
+	m_info.add_capacity(m_buffer_size);
+
+	//keep the newest block so an arena that is reused doesn't go back to the heap
+	Block * block = m_block;
+	if( block ){
+		m_block = block->next;
+		block->next = nullptr;
+	}
+	free_blocks();
+	m_block = block;
+
+	if( block ){
+		m_info.add_heap_block(block->size);
+		m_position = reinterpret_cast<u8*>(block) + header_size;
+		m_end = reinterpret_cast<u8*>(block) + block->size;
+	} else {
+		m_position = m_buffer;
+		m_end = m_buffer + m_buffer_size;
+	}
+	return 0;
+}
+
+void ArenaResource::free_blocks(){
+	while( m_block ){
+		Block * next = m_block->next;
+		::operator delete(m_block);
+		m_block = next;
+	}
+}
+
+PoolResource::PoolResource(BlockSize block_size, BlockCount block_count){
+	//each block must hold the free list pointer and keep the next block aligned
+	u32 size = block_size.argument();
+	if( size < sizeof(FreeBlock) ){
+		size = sizeof(FreeBlock);
+	}
+	m_block_size = (size + maximum_alignment - 1) & ~(maximum_alignment - 1);
+	m_block_count = block_count.argument();
+	m_overflow_count = 0;
+	m_free_list = nullptr;
+
+	m_pool = static_cast<u8*>(::operator new(m_block_size * m_block_count));
+	m_info.add_heap_block(m_block_size * m_block_count);
+	for(u32 i = m_block_count; i > 0; i--){
+		FreeBlock * block = reinterpret_cast<FreeBlock*>(m_pool + (i-1)*m_block_size);
+		block->next = m_free_list;
+		m_free_list = block;
+	}
+}
+
+PoolResource::~PoolResource(){
+	::operator delete(m_pool);
+}
+
+void * PoolResource::allocate(u32 size, u32 alignment){
+	m_info.add_allocation(size);
+	if( (size <= m_block_size) && (alignment <= maximum_alignment) && m_free_list ){
+		FreeBlock * result = m_free_list;
+		m_free_list = result->next;
+		return result;
+	}
+	m_overflow_count++;
+	return ::operator new(size);
+}
+
+void PoolResource::deallocate(void * pointer, u32 size, u32 alignment){
+	MCU_UNUSED_ARGUMENT(alignment);
+	m_info.add_free(size);
+	u8 * location = static_cast<u8*>(pointer);
+	if( (location >= m_pool) && (location < m_pool + m_block_size * m_block_count) ){
+		FreeBlock * block = reinterpret_cast<FreeBlock*>(location);
+		block->next = m_free_list;
+		m_free_list = block;
+		return;
+	}
+	::operator delete(pointer);
+}
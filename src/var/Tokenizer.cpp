@@ -8,6 +8,14 @@
 #include "var/Tokenizer.hpp"
 #include "sys/Printer.hpp"
 
+#if defined __SSE2__ || defined _M_X64
+#include <emmintrin.h>
+#define SAPI_TOKENIZER_SSE2 1
+#elif defined __ARM_NEON && defined __aarch64__
+#include <arm_neon.h>
+#define SAPI_TOKENIZER_NEON 1
+#endif
+
 using namespace var;
 
 sys::Printer& operator << (sys::Printer& printer, const var::Tokenizer & a){
@@ -62,43 +70,18 @@ void Tokenizer::parse(
 		MaximumCount maximum_count
 		){
 
-	const u32 max_delimeter_count = maximum_count.argument();
-	const u32 length = input.length();
 	m_token_list = StringList();
-	u32 cursor = 0;
-	u32 sub_position = 0;
-
-	while( cursor < length ){
-		if( delim.argument().find( input.at(cursor) ) != String::npos ){
-			m_token_list.push_back(
-						input.create_sub_string(
-							String::Position(sub_position),
-							String::Length(cursor - sub_position)
-							)
-						);
-			sub_position = cursor + 1;
-			if( max_delimeter_count && (m_token_list.count() == max_delimeter_count) ){
-				cursor = length-1;
-			}
-		} else if( ignore.argument().find( input.at(cursor) ) != String::npos ){
-			//skip the space between specific characters
-			char end = input.at(cursor);
-			cursor++;
-			while( (cursor < length) && (input.at(cursor) != end) ){
-				cursor++;
-			}
-		}
+	TokenScanner scanner(
+				input,
+				delim,
+				ignore,
+				maximum_count
+				);
 
-		cursor++;
+	TokenView token;
+	while( scanner.next(token) ){
+		m_token_list.push_back(token.to_string());
 	}
-
-	//push the last token
-	m_token_list.push_back(
-				input.create_sub_string(
-					String::Position(sub_position),
-					String::Length(cursor - sub_position)
-					)
-				);
 }
 
 const String& Tokenizer::at(u32 n) const {
@@ -122,6 +105,160 @@ void Tokenizer::sort(var::Tokenizer::sort_option sort_option){
 	}
 }
 
+TokenScanner::TokenScanner(
+		const char * input,
+		u32 length,
+		Delimeters delimeters,
+		IgnoreBetween ignore,
+		MaximumCount maximum_count
+		) :
+	m_input(input),
+	m_length(input ? length : 0),
+	m_maximum_count(maximum_count.argument()){
 
+	memset(m_delimeter_table, 0, sizeof(m_delimeter_table));
+	memset(m_ignore_table, 0, sizeof(m_ignore_table));
+	add_to_table(m_delimeter_table, delimeters.argument());
+	add_to_table(m_ignore_table, ignore.argument());
 
+	//build the list used by the vector scan
+	for(u32 i=0; i < 256; i++){
+		const char c = static_cast<char>(i);
+		if( is_in_table(m_delimeter_table, c) || is_in_table(m_ignore_table, c) ){
+			if( m_special_count < sizeof(m_special_list) ){
+				m_special_list[m_special_count] = c;
+			}
+			m_special_count++;
+		}
+	}
+}
+
+void TokenScanner::add_to_table(
+		u32 * table,
+		const var::String & characters
+		){
+	for(u32 i=0; i < characters.length(); i++){
+		const u8 value = static_cast<u8>(characters.at(i));
+		if( value ){
+			table[value >> 5] |= (1UL << (value & 0x1f));
+		}
+	}
+}
+
+u32 TokenScanner::find_special(u32 cursor) const {
 
+#if defined SAPI_TOKENIZER_SSE2
+	if( m_special_count <= sizeof(m_special_list) ){
+		while( cursor + 16 <= m_length ){
+			const __m128i block = _mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(m_input + cursor)
+						);
+			__m128i match = _mm_setzero_si128();
+			for(u32 i=0; i < m_special_count; i++){
+				match = _mm_or_si128(
+							match,
+							_mm_cmpeq_epi8(block, _mm_set1_epi8(m_special_list[i]))
+							);
+			}
+			int mask = _mm_movemask_epi8(match);
+			if( mask ){
+				while( (mask & 0x01) == 0 ){
+					mask >>= 1;
+					cursor++;
+				}
+				return cursor;
+			}
+			cursor += 16;
+		}
+	}
+#elif defined SAPI_TOKENIZER_NEON
+	if( m_special_count <= sizeof(m_special_list) ){
+		while( cursor + 16 <= m_length ){
+			const uint8x16_t block = vld1q_u8(
+						reinterpret_cast<const u8*>(m_input + cursor)
+						);
+			uint8x16_t match = vdupq_n_u8(0);
+			for(u32 i=0; i < m_special_count; i++){
+				match = vorrq_u8(
+							match,
+							vceqq_u8(block, vdupq_n_u8(static_cast<u8>(m_special_list[i])))
+							);
+			}
+			if( vmaxvq_u8(match) ){
+				//the scalar loop below finds the position within this block
+				break;
+			}
+			cursor += 16;
+		}
+	}
+#endif
+
+	while( (cursor < m_length)
+				 && !is_in_table(m_delimeter_table, m_input[cursor])
+				 && !is_in_table(m_ignore_table, m_input[cursor]) ){
+		cursor++;
+	}
+	return cursor;
+}
+
+bool TokenScanner::next(TokenView & token){
+	if( m_is_complete ){
+		return false;
+	}
+
+	const u32 start = m_cursor;
+	m_count++;
+
+	if( m_maximum_count && (m_count > m_maximum_count) ){
+		//the rest of the input is the last token
+		token = TokenView(m_input + start, m_length - start);
+		m_is_complete = true;
+		return true;
+	}
+
+	u32 cursor = start;
+	while( (cursor = find_special(cursor)) < m_length ){
+		const char c = m_input[cursor];
+		if( is_delimeter(c) ){
+			token = TokenView(m_input + start, cursor - start);
+			m_cursor = cursor + 1;
+			return true;
+		}
+
+		//skip the space between specific characters
+		const char * end = static_cast<const char*>(
+					memchr(m_input + cursor + 1, c, m_length - cursor - 1)
+					);
+		if( end == nullptr ){
+			cursor = m_length;
+		} else {
+			cursor = static_cast<u32>(end - m_input) + 1;
+		}
+	}
+
+	token = TokenView(m_input + start, m_length - start);
+	m_is_complete = true;
+	return true;
+}
+
+u32 TokenScanner::count(){
+	u32 result = 0;
+	TokenView token;
+	reset();
+	while( next(token) ){
+		result++;
+	}
+	reset();
+	return result;
+}
+
+TokenView TokenScanner::at(u32 offset){
+	TokenView token;
+	reset();
+	for(u32 i=0; i <= offset; i++){
+		if( next(token) == false ){
+			return TokenView();
+		}
+	}
+	return token;
+}